@@ -0,0 +1,70 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern "C" {
+#include "xtimer.h"
+}
+
+/*!
+ * @brief Minimum run time of one timed loop, in microseconds.
+ */
+#ifndef CONFIG_BENCH_MIN_US
+#define CONFIG_BENCH_MIN_US 200000
+#endif
+
+/*!
+ * @name Shell commands, one per check or benchmark
+ *
+ * Each prints its measurements and ends with "<name>: OK" or "<name>: FAILED".
+ */
+//@{
+int bench_crc(int argc, char **argv);
+int bench_codec(int argc, char **argv);
+int bench_final(int argc, char **argv);
+int bench_bulk(int argc, char **argv);
+int bench_view(int argc, char **argv);
+int bench_pool(int argc, char **argv);
+int bench_lanes(int argc, char **argv);
+int bench_dense(int argc, char **argv);
+int bench_prepared(int argc, char **argv);
+int bench_stream(int argc, char **argv);
+int bench_flow(int argc, char **argv);
+#ifdef CPU_NATIVE
+int bench_steal(int argc, char **argv);
+int bench_overload(int argc, char **argv);
+int bench_cache(int argc, char **argv);
+int bench_lb(int argc, char **argv);
+int bench_hedge(int argc, char **argv);
+int bench_stall(int argc, char **argv);
+int bench_tcpcrc(int argc, char **argv);
+#endif
+//@}
+
+/*!
+ * @brief Print the time of @p ops operations that took @p us microseconds, per operation.
+ *
+ * Adds CPU cycles per operation on boards that define CLOCK_CORECLOCK.
+ */
+static inline void bench_report(const char *name, uint32_t ops, uint32_t us)
+{
+    double ns = (ops != 0U) ? (1000.0 * us / ops) : 0.0;
+#ifdef CLOCK_CORECLOCK
+    printf("  %-28s %10.1f ns/op %10.1f cycles/op\n", name, ns, ns * (CLOCK_CORECLOCK / 1e9));
+#else
+    printf("  %-28s %10.1f ns/op\n", name, ns);
+#endif
+}
+
+/*!
+ * @brief Print the end line of a command and turn @p failures into its return value.
+ */
+static inline int bench_result(const char *name, unsigned failures)
+{
+    printf("%s: %s\n", name, (failures == 0U) ? "OK" : "FAILED");
+    return (failures == 0U) ? 0 : 1;
+}
+
+#endif /* _BENCH_H_ */
@@ -0,0 +1,255 @@
+// bench_bulk.cpp — POD list path: byte swap kernels, list encoding, SensorSamples shims, bulk vs per element
+#include "bench.h"
+#include "direct_transport.hpp"
+#include "sensor_samples.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <string.h>
+
+using namespace erpc;
+using namespace erpcShim;
+
+static uint16_t swapRef(uint16_t v) { return __builtin_bswap16(v); }
+static uint32_t swapRef(uint32_t v) { return __builtin_bswap32(v); }
+static uint64_t swapRef(uint64_t v) { return __builtin_bswap64(v); }
+
+// Every count up to 40 at every misalignment, copied and in place, against __builtin_bswap.
+template <typename T>
+static unsigned checkSwapKernel(void (*kernel)(void *, const void *, uint32_t))
+{
+    static uint8_t src[8 * 40 + 8];
+    static uint8_t dst[8 * 40 + 8];
+    unsigned failures = 0;
+
+    for (unsigned i = 0; i < sizeof(src); ++i) {
+        src[i] = static_cast<uint8_t>(i * 37U + 11U);
+    }
+
+    for (uint32_t count = 0; count <= 40U; ++count) {
+        for (uint32_t offset = 0; offset < 4U; ++offset) {
+            memset(dst, 0, sizeof(dst));
+            kernel(dst + offset, src + offset, count);
+            for (uint32_t i = 0; i < count; ++i) {
+                T value, swapped;
+                memcpy(&value, src + offset + i * sizeof(T), sizeof(T));
+                memcpy(&swapped, dst + offset + i * sizeof(T), sizeof(T));
+                failures += (swapped != swapRef(value)) ? 1U : 0U;
+            }
+            // Nothing written past the last element.
+            failures += (dst[offset + count * sizeof(T)] != 0U) ? 1U : 0U;
+
+            // In place, twice: back to the original.
+            memcpy(dst, src, sizeof(dst));
+            kernel(dst + offset, dst + offset, count);
+            kernel(dst + offset, dst + offset, count);
+            failures += (memcmp(dst, src, sizeof(dst)) != 0) ? 1U : 0U;
+        }
+    }
+    if (failures != 0U) {
+        printf("  %u results of the %u bit byte swap differ from __builtin_bswap\n", failures,
+               static_cast<unsigned>(8U * sizeof(T)));
+    }
+    return failures;
+}
+
+// writeList() produces what per-element BasicCodec writes produce, and readList() reads it back.
+static unsigned checkListEncoding(void)
+{
+    uint8_t bulkData[256];
+    uint8_t refData[256];
+    MessageBuffer bulkBuffer(bulkData, sizeof(bulkData));
+    MessageBuffer refBuffer(refData, sizeof(refData));
+    FinalBasicCodec bulk;
+    BasicCodec ref;
+    int32_t values[37];
+    int32_t decoded[37];
+    uint32_t count = 0;
+    unsigned failures = 0;
+
+    for (int i = 0; i < 37; ++i) {
+        values[i] = i * 100003 - 1000000;
+    }
+
+    bulk.setBuffer(bulkBuffer);
+    bulk.writeList(values, 37U);
+    ref.setBuffer(refBuffer);
+    ref.startWriteList(37U);
+    for (int i = 0; i < 37; ++i) {
+        ref.write(values[i]);
+    }
+#if !CONFIG_ERPC_WIRE_SWAP
+    if ((bulk.getBuffer().getUsed() != ref.getBuffer().getUsed()) ||
+        (memcmp(bulkData, refData, ref.getBuffer().getUsed()) != 0)) {
+        puts("  writeList() differs from per-element BasicCodec writes");
+        ++failures;
+    }
+#endif
+
+    MessageBuffer received = bulk.getBuffer();
+    bulk.setBuffer(received);
+    bulk.readList(decoded, 37U, count);
+    if (!bulk.isStatusOk() || (count != 37U) || (memcmp(values, decoded, sizeof(values)) != 0)) {
+        puts("  readList() does not return what was written");
+        ++failures;
+    }
+
+    // Too small a destination must not be written past.
+    bulk.setBuffer(received);
+    bulk.readList(decoded, 36U, count);
+    if (bulk.getStatus() != kErpcStatus_BufferOverrun) {
+        puts("  readList() into a short array did not fail");
+        ++failures;
+    }
+    return failures;
+}
+
+// Calls through the typed client and server shims.
+static unsigned checkShims(SensorSamples_typed_client<FinalBasicCodec> &client)
+{
+    int32_t samples[CONFIG_SENSOR_SAMPLES_MAX + 1];
+    float values[CONFIG_SENSOR_SAMPLES_MAX];
+    float scaled[CONFIG_SENSOR_SAMPLES_MAX];
+    unsigned failures = 0;
+
+    for (uint32_t count = 0; count <= CONFIG_SENSOR_SAMPLES_MAX; ++count) {
+        int64_t expected = 0;
+        int64_t result = -1;
+        for (uint32_t i = 0; i < count; ++i) {
+            samples[i] = static_cast<int32_t>(i * 65537U) - 70000;
+            values[i] = 0.5f * static_cast<float>(i);
+            expected += samples[i];
+        }
+        if ((client.sum(samples, count, result) != kErpcStatus_Success) || (result != expected)) {
+            printf("  sum() of %u samples failed\n", static_cast<unsigned>(count));
+            ++failures;
+        }
+
+        uint32_t scaledCount = 0;
+        if ((client.scale(values, count, 4.0f, scaled, CONFIG_SENSOR_SAMPLES_MAX, scaledCount) !=
+             kErpcStatus_Success) ||
+            (scaledCount != count)) {
+            printf("  scale() of %u samples failed\n", static_cast<unsigned>(count));
+            ++failures;
+            continue;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            if (scaled[i] != 2.0f * static_cast<float>(i)) {
+                printf("  scale() result %u wrong\n", static_cast<unsigned>(i));
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    // One sample more than the server shim takes.
+    int64_t result = 0;
+    if (client.sum(samples, CONFIG_SENSOR_SAMPLES_MAX + 1U, result) != kErpcStatus_BufferOverrun) {
+        puts("  sum() of an oversized list was not refused");
+        ++failures;
+    }
+    return failures;
+}
+
+template <class CodecT>
+static __attribute__((noinline)) int32_t perElementList(CodecT *codec, MessageBuffer &buffer, const int32_t *values,
+                                                         int32_t *decoded, uint32_t count)
+{
+    uint32_t length = 0;
+
+    codec->setBuffer(buffer);
+    codec->startWriteList(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        codec->write(values[i]);
+    }
+    MessageBuffer received = codec->getBuffer();
+    codec->setBuffer(received);
+    codec->startReadList(length);
+    for (uint32_t i = 0; (i < length) && (i < count); ++i) {
+        codec->read(decoded[i]);
+    }
+    return decoded[count - 1U];
+}
+
+static __attribute__((noinline)) int32_t bulkList(FinalBasicCodec *codec, MessageBuffer &buffer,
+                                                  const int32_t *values, int32_t *decoded, uint32_t count)
+{
+    uint32_t length = 0;
+
+    codec->setBuffer(buffer);
+    codec->writeList(values, count);
+    MessageBuffer received = codec->getBuffer();
+    codec->setBuffer(received);
+    codec->readList(decoded, count, length);
+    return decoded[count - 1U];
+}
+
+// Encode and decode one list of CONFIG_SENSOR_SAMPLES_MAX int32 samples, per element through Codec * and in bulk.
+static void timeLists(void)
+{
+    uint8_t data[8 + 4 * CONFIG_SENSOR_SAMPLES_MAX];
+    MessageBuffer buffer(data, sizeof(data));
+    int32_t values[CONFIG_SENSOR_SAMPLES_MAX];
+    int32_t decoded[CONFIG_SENSOR_SAMPLES_MAX];
+    FinalBasicCodec codec;
+    volatile int32_t sink = 0;
+    uint32_t rounds;
+    uint32_t start;
+    uint32_t elapsed;
+
+    for (int i = 0; i < CONFIG_SENSOR_SAMPLES_MAX; ++i) {
+        values[i] = i;
+    }
+
+    rounds = 0;
+    start = xtimer_now_usec();
+    do {
+        sink = perElementList<Codec>(&codec, buffer, values, decoded, CONFIG_SENSOR_SAMPLES_MAX);
+        ++rounds;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    bench_report("list<int32> per element", rounds, elapsed);
+
+    rounds = 0;
+    start = xtimer_now_usec();
+    do {
+        sink = bulkList(&codec, buffer, values, decoded, CONFIG_SENSOR_SAMPLES_MAX);
+        ++rounds;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    bench_report("list<int32> writeList/readList", rounds, elapsed);
+    (void)sink;
+}
+
+int bench_bulk(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    unsigned failures = checkSwapKernel<uint16_t>(erpc_bswap16_copy);
+    failures += checkSwapKernel<uint32_t>(erpc_bswap32_copy);
+    failures += checkSwapKernel<uint64_t>(erpc_bswap64_copy);
+    failures += checkListEncoding();
+
+    erpc_mbf_t mbf = erpc_mbf_dynamic_init();
+    if (mbf == NULL) {
+        puts("  no message buffer factory");
+        return bench_result("bulk", 1U);
+    }
+    MessageBufferFactory *messageFactory = reinterpret_cast<MessageBufferFactory *>(mbf);
+
+    SensorSamples_typed_service<FinalBasicCodec> service(get_sensor_samples_impl());
+    DirectTransport<FinalBasicCodec> transport(&service, messageFactory);
+    ClientManager manager;
+    manager.setTransport(&transport);
+    manager.setMessageBufferFactory(messageFactory);
+    SensorSamples_typed_client<FinalBasicCodec> client(&manager);
+
+    failures += checkShims(client);
+    timeLists();
+
+    erpc_mbf_dynamic_deinit(mbf);
+    return bench_result("bulk", failures);
+}
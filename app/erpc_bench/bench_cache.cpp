@@ -0,0 +1,212 @@
+// bench_cache.cpp — native only: hit ratio and latency of the reply cache on NativeTcpServer
+#include "bench.h"
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+/*!
+ * @brief Client connections, each on a thread of its own.
+ */
+#ifndef CONFIG_BENCH_CACHE_CLIENTS
+#define CONFIG_BENCH_CACHE_CLIENTS 4
+#endif
+
+/*!
+ * @brief Calls per connection and run.
+ */
+#ifndef CONFIG_BENCH_CACHE_CALLS
+#define CONFIG_BENCH_CACHE_CALLS 1000
+#endif
+
+/*!
+ * @brief Distinct arguments, drawn with Zipf weights 1, 1/2, 1/3, ...
+ */
+#ifndef CONFIG_BENCH_CACHE_KEYS
+#define CONFIG_BENCH_CACHE_KEYS 64
+#endif
+
+/*!
+ * @brief CPU time of each call that reaches the handler, in microseconds.
+ */
+#ifndef CONFIG_BENCH_CACHE_WORK_US
+#define CONFIG_BENCH_CACHE_WORK_US 200
+#endif
+
+#ifndef CONFIG_BENCH_CACHE_WORKERS
+#define CONFIG_BENCH_CACHE_WORKERS 2
+#endif
+
+#ifndef CONFIG_BENCH_CACHE_PORT
+#define CONFIG_BENCH_CACHE_PORT 50580
+#endif
+
+struct CacheRun
+{
+    int32_t id;
+    uint32_t keys; /*!< 1: every call has the same arguments. */
+    LatencyLog *log;
+    erpc::MessageBufferFactory *messageFactory;
+    unsigned failures;
+};
+
+// Cumulative Zipf weights of the keys, scaled to UINT32_MAX.
+static uint32_t s_zipf[CONFIG_BENCH_CACHE_KEYS];
+
+static void initZipf(void)
+{
+    double total = 0.0, sum = 0.0;
+
+    for (unsigned k = 0; k < CONFIG_BENCH_CACHE_KEYS; ++k)
+    {
+        total += 1.0 / (k + 1U);
+    }
+    for (unsigned k = 0; k < CONFIG_BENCH_CACHE_KEYS; ++k)
+    {
+        sum += 1.0 / (k + 1U);
+        s_zipf[k] = static_cast<uint32_t>(sum / total * UINT32_MAX);
+    }
+    s_zipf[CONFIG_BENCH_CACHE_KEYS - 1] = UINT32_MAX;
+}
+
+static int32_t nextKey(uint32_t &state, uint32_t keys)
+{
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    int32_t key = 0;
+    while ((static_cast<uint32_t>(key) + 1U < keys) && (state > s_zipf[key]))
+    {
+        ++key;
+    }
+    return key;
+}
+
+static void *clientThread(void *arg)
+{
+    CacheRun *run = static_cast<CacheRun *>(arg);
+    TcpBenchClient client(run->messageFactory);
+    uint32_t state = 0x9E3779B9U * static_cast<uint32_t>(run->id);
+
+    if (!client.connect(CONFIG_BENCH_CACHE_PORT))
+    {
+        run->failures = CONFIG_BENCH_CACHE_CALLS;
+        return NULL;
+    }
+    for (uint32_t i = 0; i < CONFIG_BENCH_CACHE_CALLS; ++i)
+    {
+        int32_t key = nextKey(state, run->keys);
+        int32_t result = 0;
+        uint32_t start = erpc_native_now_us();
+        if ((client.mul(key, 7, result) != kErpcStatus_Success) || (result != key * 7))
+        {
+            ++run->failures;
+        }
+        run->log->add(erpc_native_now_us() - start);
+    }
+    return NULL;
+}
+
+// All clients against a fresh server, with @p cache or without; counts hits and handler calls.
+static unsigned runClients(const char *name, ReplyCache *cache, uint32_t keys, erpc::MessageBufferFactory *messageFactory,
+                           LatencyLog &log)
+{
+    TcpBenchServer server;
+    CacheRun runs[CONFIG_BENCH_CACHE_CLIENTS];
+    pthread_t threads[CONFIG_BENCH_CACHE_CLIENTS];
+    unsigned failures = 0;
+    uint32_t hits = 0, misses = 0;
+
+    if (cache != NULL)
+    {
+        cache->clear();
+        hits = cache->getHits();
+        misses = cache->getMisses();
+    }
+    server.setReplyCache(cache);
+    if (server.start(CONFIG_BENCH_CACHE_PORT, CONFIG_BENCH_CACHE_WORKERS) != kErpcStatus_Success)
+    {
+        printf("  %s: server did not start\n", name);
+        return 1;
+    }
+    server.service().setWorkUs(CONFIG_BENCH_CACHE_WORK_US);
+
+    log.clear();
+    uint32_t start = erpc_native_now_us();
+    for (unsigned c = 0; c < CONFIG_BENCH_CACHE_CLIENTS; ++c)
+    {
+        runs[c] = { static_cast<int32_t>(c + 1U), keys, &log, messageFactory, 0 };
+        if (pthread_create(&threads[c], NULL, clientThread, &runs[c]) != 0)
+        {
+            runs[c].failures = CONFIG_BENCH_CACHE_CALLS;
+            threads[c] = 0;
+        }
+    }
+    for (unsigned c = 0; c < CONFIG_BENCH_CACHE_CLIENTS; ++c)
+    {
+        if (threads[c] != 0)
+        {
+            pthread_join(threads[c], NULL);
+        }
+        failures += runs[c].failures;
+    }
+    uint32_t elapsed = erpc_native_now_us() - start;
+    uint32_t handled = server.service().getCalls();
+    server.stop();
+
+    printf("  %-24s %8.0f calls/s   p50 %6lu us   p99 %6lu us", name,
+           (elapsed != 0U) ? (1e6 * log.count() / elapsed) : 0.0, static_cast<unsigned long>(log.percentile(50)),
+           static_cast<unsigned long>(log.percentile(99)));
+    if (cache == NULL)
+    {
+        puts("");
+        return failures;
+    }
+
+    hits = cache->getHits() - hits;
+    misses = cache->getMisses() - misses;
+    printf("   hits %5.1f %%\n", (hits + misses != 0U) ? (100.0 * hits / (hits + misses)) : 0.0);
+    // Every call is a hit or a miss, and only misses reach the handler.
+    if ((hits + misses != log.count()) || (handled != misses) || (hits == 0U))
+    {
+        printf("  %lu hits, %lu misses, %lu handler calls\n", static_cast<unsigned long>(hits),
+               static_cast<unsigned long>(misses), static_cast<unsigned long>(handled));
+        ++failures;
+    }
+    return failures;
+}
+
+int bench_cache(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    static ReplyCache s_cache;
+    static bool s_marked;
+    erpc::MessageBufferFactory *messageFactory =
+        reinterpret_cast<erpc::MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    LatencyLog log(CONFIG_BENCH_CACHE_CLIENTS * CONFIG_BENCH_CACHE_CALLS);
+    unsigned failures = 0;
+
+    if (!s_marked)
+    {
+        initZipf();
+        s_marked = s_cache.addMethod(BenchMulService::kServiceId, BenchMulService::kMulId);
+        if (!s_marked)
+        {
+            return bench_result("cache", 1);
+        }
+    }
+
+    printf("  %u connections x %u calls, %u us per handler call, %u cache entries, %u keys\n",
+           static_cast<unsigned>(CONFIG_BENCH_CACHE_CLIENTS), static_cast<unsigned>(CONFIG_BENCH_CACHE_CALLS),
+           static_cast<unsigned>(CONFIG_BENCH_CACHE_WORK_US), static_cast<unsigned>(CONFIG_ERPC_CACHE_ENTRIES),
+           static_cast<unsigned>(CONFIG_BENCH_CACHE_KEYS));
+    failures += runClients("no cache, Zipf keys", NULL, CONFIG_BENCH_CACHE_KEYS, messageFactory, log);
+    failures += runClients("cache, Zipf keys", &s_cache, CONFIG_BENCH_CACHE_KEYS, messageFactory, log);
+    failures += runClients("cache, one key", &s_cache, 1, messageFactory, log);
+
+    return bench_result("cache", failures);
+}
@@ -0,0 +1,141 @@
+// bench_codec.cpp — BasicCodec against CompactCodec: frame sizes and round trip time over a simulated UART
+#include "bench.h"
+#include "erpc_compact_codec.hpp"
+
+using namespace erpc;
+
+/*!
+ * @brief Baud rate of the simulated UART, 8N1: 10 bit times per byte.
+ */
+#ifndef CONFIG_BENCH_UART_BAUD
+#define CONFIG_BENCH_UART_BAUD 115200
+#endif
+
+//! Frame header of RiotFramedTransport in front of every message.
+static const uint32_t kFrameHeader = 6U;
+
+//! One call of multiply.erpc or calculator.erpc: two int32 arguments and the result.
+struct CodecCase {
+    const char *name;
+    uint32_t service;
+    uint32_t method;
+    int32_t a;
+    int32_t b;
+    int32_t result; /*!< Written as a float when isFloat is set. */
+    bool isFloat;
+};
+
+static const CodecCase s_cases[] = {
+    { "multiply(5, 28)", 1, 1, 5, 28, 140, false },
+    { "add(1000, -2000)", 1, 1, 1000, -2000, -1000, false },
+    { "subtract(7, 100000)", 1, 2, 7, 100000, -99993, false },
+    { "divide(7, 2)", 1, 4, 7, 2, 3, true },
+};
+
+/*!
+ * @brief One call: client encodes the request, server decodes it and encodes the reply, client decodes it.
+ *
+ * @return false if a decoded value differs from the encoded one.
+ */
+template <class C>
+static bool roundTrip(const CodecCase &c, uint32_t sequence, uint32_t &requestSize, uint32_t &replySize)
+{
+    uint8_t request[32];
+    uint8_t reply[32];
+    MessageBuffer requestBuffer(request, sizeof(request));
+    MessageBuffer replyBuffer(reply, sizeof(reply));
+    message_type_t type;
+    uint32_t service, method, seq;
+    int32_t a, b, result = 0;
+    float fresult = 0.0f;
+    C client;
+    C server;
+
+    client.setBuffer(requestBuffer);
+    client.startWriteMessage(message_type_t::kInvocationMessage, c.service, c.method, sequence);
+    client.write(c.a);
+    client.write(c.b);
+    requestSize = client.getBuffer().getUsed();
+
+    MessageBuffer received = client.getBuffer();
+    server.setBuffer(received);
+    server.startReadMessage(type, service, method, seq);
+    server.read(a);
+    server.read(b);
+    bool ok = server.isStatusOk() && (service == c.service) && (method == c.method) && (seq == sequence) &&
+              (a == c.a) && (b == c.b);
+
+    server.setBuffer(replyBuffer);
+    server.startWriteMessage(message_type_t::kReplyMessage, c.service, c.method, sequence);
+    if (c.isFloat) {
+        server.write(static_cast<float>(a) / static_cast<float>(b));
+    } else {
+        server.write(c.result);
+    }
+    replySize = server.getBuffer().getUsed();
+
+    received = server.getBuffer();
+    client.setBuffer(received);
+    client.startReadMessage(type, service, method, seq);
+    if (c.isFloat) {
+        client.read(fresult);
+        ok = ok && (static_cast<int32_t>(fresult) == c.result);
+    } else {
+        client.read(result);
+        ok = ok && (result == c.result);
+    }
+    return ok && client.isStatusOk() && (type == message_type_t::kReplyMessage) && (seq == sequence);
+}
+
+template <class C>
+static unsigned runCodec(const char *codecName)
+{
+    unsigned failures = 0;
+
+    printf("  %s\n", codecName);
+    for (unsigned i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); ++i) {
+        const CodecCase &c = s_cases[i];
+        uint32_t requestSize = 0;
+        uint32_t replySize = 0;
+
+        // A sequence number past the first varint byte, as after a few hundred calls.
+        if (!roundTrip<C>(c, 300U, requestSize, replySize)) {
+            printf("    %-20s decoded values differ\n", c.name);
+            ++failures;
+            continue;
+        }
+
+        uint32_t rounds = 0;
+        uint32_t start = xtimer_now_usec();
+        uint32_t elapsed;
+        do {
+            uint32_t rs, ps;
+            if (!roundTrip<C>(c, 300U + rounds, rs, ps)) {
+                ++failures;
+            }
+            ++rounds;
+            elapsed = xtimer_now_usec() - start;
+        } while (elapsed < CONFIG_BENCH_MIN_US);
+
+        uint32_t wireBytes = 2U * kFrameHeader + requestSize + replySize;
+        double wireUs = (wireBytes * 10.0 * 1e6) / CONFIG_BENCH_UART_BAUD;
+        double cpuUs = static_cast<double>(elapsed) / rounds;
+        printf("    %-20s req %2u B rep %2u B frames %2u B  wire %7.1f us  codec %6.2f us  call %7.1f us\n", c.name,
+               static_cast<unsigned>(kFrameHeader + requestSize), static_cast<unsigned>(kFrameHeader + replySize),
+               static_cast<unsigned>(wireBytes), wireUs, cpuUs, wireUs + cpuUs);
+    }
+    return failures;
+}
+
+int bench_codec(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    printf("  round trip over a simulated %u baud UART (8N1, 6 B frame header per message)\n",
+           static_cast<unsigned>(CONFIG_BENCH_UART_BAUD));
+    unsigned failures = runCodec<BasicCodec>("BasicCodec");
+    failures += runCodec<CompactCodec>("CompactCodec");
+
+    return bench_result("codec", failures);
+}
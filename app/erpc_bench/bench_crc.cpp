@@ -0,0 +1,77 @@
+// bench_crc.cpp — CRC16 engines: results against the bitwise reference, throughput
+#include "bench.h"
+#include "erpc_crc16_fast.h"
+
+#include <string.h>
+
+/*!
+ * @brief Bytes of the buffer each engine is timed on.
+ */
+#ifndef CONFIG_BENCH_CRC_SIZE
+#define CONFIG_BENCH_CRC_SIZE 4096
+#endif
+
+static const char *const s_names[ERPC_CRC16_IMPL_NUMOF] = { "bitwise", "table", "slice", "hw" };
+
+static uint8_t s_data[CONFIG_BENCH_CRC_SIZE];
+
+int bench_crc(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    uint32_t seed = 0x12345678U;
+    for (unsigned i = 0; i < sizeof(s_data); ++i) {
+        seed = seed * 1103515245U + 12345U;
+        s_data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    erpc_crc16_fn_t ref = erpc_crc16_get(ERPC_CRC16_IMPL_BITWISE);
+    unsigned failures = 0;
+
+    for (int impl = 0; impl < ERPC_CRC16_IMPL_NUMOF; ++impl) {
+        erpc_crc16_fn_t fn = erpc_crc16_get(static_cast<erpc_crc16_impl_t>(impl));
+        if (fn == NULL) {
+            printf("  %-8s not available\n", s_names[impl]);
+            continue;
+        }
+
+        // Every length up to 300 at every alignment, in one piece and split in two.
+        unsigned mismatches = 0;
+        for (uint32_t size = 0; size <= 300U; ++size) {
+            for (uint32_t offset = 0; offset < 8U; ++offset) {
+                const uint8_t *data = s_data + offset;
+                uint16_t expected = ref(0xEF4AU, data, size);
+                uint32_t half = size / 2U;
+                if ((fn(0xEF4AU, data, size) != expected) ||
+                    (fn(fn(0xEF4AU, data, half), data + half, size - half) != expected)) {
+                    ++mismatches;
+                }
+            }
+        }
+        if (mismatches != 0U) {
+            printf("  %-8s %u results differ from bitwise\n", s_names[impl], mismatches);
+            failures += mismatches;
+        }
+
+        uint32_t rounds = 0;
+        volatile uint16_t crc = 0;
+        uint32_t start = xtimer_now_usec();
+        uint32_t elapsed;
+        do {
+            crc = fn(crc, s_data, sizeof(s_data));
+            ++rounds;
+            elapsed = xtimer_now_usec() - start;
+        } while (elapsed < CONFIG_BENCH_MIN_US);
+
+        double bytes = static_cast<double>(rounds) * sizeof(s_data);
+#ifdef CLOCK_CORECLOCK
+        printf("  %-8s %9.1f MB/s %7.2f cycles/byte\n", s_names[impl], bytes / elapsed,
+               (static_cast<double>(elapsed) * (CLOCK_CORECLOCK / 1e6)) / bytes);
+#else
+        printf("  %-8s %9.1f MB/s\n", s_names[impl], bytes / elapsed);
+#endif
+    }
+
+    return bench_result("crc", failures);
+}
@@ -0,0 +1,129 @@
+// bench_dense.cpp — DenseServer service lookup against the list walk of erpc::SimpleServer
+#include "bench.h"
+#include "dense_server.hpp"
+
+using namespace erpc;
+
+/*!
+ * @brief Services registered with each server; looked up round robin.
+ */
+#ifndef CONFIG_BENCH_DENSE_SERVICES
+#define CONFIG_BENCH_DENSE_SERVICES 64
+#endif
+
+#if CONFIG_BENCH_DENSE_SERVICES > CONFIG_ERPC_SERVICE_TABLE_SIZE
+#error "CONFIG_BENCH_DENSE_SERVICES must not exceed CONFIG_ERPC_SERVICE_TABLE_SIZE"
+#endif
+
+class NullService : public Service
+{
+public:
+    NullService(uint32_t serviceId)
+    : Service(serviceId)
+    {
+    }
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, Codec *codec,
+                                           MessageBufferFactory *messageFactory, Transport *transport) override
+    {
+        (void)methodId;
+        (void)sequence;
+        (void)codec;
+        (void)messageFactory;
+        (void)transport;
+        return kErpcStatus_Success;
+    }
+};
+
+// Exposes the lookup the server runs for every request.
+template <class S>
+class LookupServer : public S
+{
+public:
+    Service *lookup(uint32_t serviceId) { return this->findServiceWithId(serviceId); }
+};
+
+static LookupServer<SimpleServer> s_listServer;
+static LookupServer<DenseServer> s_denseServer;
+static NullService *s_listServices[CONFIG_BENCH_DENSE_SERVICES];
+static NullService *s_denseServices[CONFIG_BENCH_DENSE_SERVICES];
+
+template <class S>
+static void timeLookups(S &server, const char *name)
+{
+    uintptr_t sink = 0;
+    uint32_t lookups = 0;
+    uint32_t start = xtimer_now_usec();
+    uint32_t elapsed;
+
+    do {
+        for (uint32_t id = 0; id < CONFIG_BENCH_DENSE_SERVICES; ++id) {
+            sink += reinterpret_cast<uintptr_t>(server.lookup(id));
+        }
+        lookups += CONFIG_BENCH_DENSE_SERVICES;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+
+    bench_report(name, lookups, elapsed);
+    if (sink == 0U) {
+        puts("  no service found");
+    }
+}
+
+// Every id finds its own service; a removed one is gone after the rebuild.
+static unsigned checkTable(void)
+{
+    unsigned failures = 0;
+
+    for (uint32_t id = 0; id < CONFIG_BENCH_DENSE_SERVICES; ++id) {
+        if (s_denseServer.lookup(id) != s_denseServices[id]) {
+            printf("  service %lu not found\n", static_cast<unsigned long>(id));
+            ++failures;
+        }
+    }
+
+    NullService *removed = s_denseServices[CONFIG_BENCH_DENSE_SERVICES / 2];
+    uint32_t id = removed->getServiceId();
+    s_denseServer.Server::removeService(removed);
+    s_denseServer.rebuildServiceTable();
+    if (s_denseServer.lookup(id) != NULL) {
+        puts("  removed service still found");
+        ++failures;
+    }
+    // Back through erpc::Server, as the C API does: found by the list walk until the next rebuild.
+    s_denseServer.Server::addService(removed);
+    if (s_denseServer.lookup(id) != removed) {
+        puts("  re-added service not found");
+        ++failures;
+    }
+    s_denseServer.rebuildServiceTable();
+    return failures;
+}
+
+int bench_dense(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    static bool s_registered;
+
+    if (!s_registered) {
+        // Registered the way erpc_add_service_to_server() does; erpc_server_run() would rebuild.
+        for (uint32_t id = 0; id < CONFIG_BENCH_DENSE_SERVICES; ++id) {
+            s_listServices[id] = new NullService(id);
+            s_denseServices[id] = new NullService(id);
+            s_listServer.addService(s_listServices[id]);
+            s_denseServer.Server::addService(s_denseServices[id]);
+        }
+        s_denseServer.rebuildServiceTable();
+        s_registered = true;
+    }
+
+    unsigned failures = checkTable();
+
+    printf("  %u services, looked up round robin\n", static_cast<unsigned>(CONFIG_BENCH_DENSE_SERVICES));
+    timeLookups(s_listServer, "list walk (SimpleServer)");
+    timeLookups(s_denseServer, "table (DenseServer)");
+
+    return bench_result("dense", failures);
+}
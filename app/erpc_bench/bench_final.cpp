@@ -0,0 +1,247 @@
+// bench_final.cpp — per-call codec cost of the generated shims (erpc::Codec *) against the typed shims (final codec)
+#include "bench.h"
+#include "erpc_final_codec.hpp"
+
+#include <string.h>
+
+using namespace erpc;
+
+/*!
+ * @brief What a multiply call does with its codec on both ends, as the shims do it.
+ *
+ * With CodecT = Codec every field goes through the vtable, as in the
+ * generated shims; with a final codec the calls are bound statically.
+ */
+template <class CodecT>
+static __attribute__((noinline)) int32_t multiplyCall(CodecT *codec, MessageBuffer &buffer, int32_t a, int32_t b,
+                                                       uint32_t sequence)
+{
+    message_type_t type;
+    uint32_t service, method, seq;
+    int32_t x = 0, y = 0, result = 0;
+
+    // Client: request
+    codec->setBuffer(buffer);
+    codec->startWriteMessage(message_type_t::kInvocationMessage, 1, 1, sequence);
+    codec->write(a);
+    codec->write(b);
+
+    // Server: arguments, then the reply in the same buffer
+    MessageBuffer received = codec->getBuffer();
+    codec->setBuffer(received);
+    codec->startReadMessage(type, service, method, seq);
+    codec->read(x);
+    codec->read(y);
+    codec->setBuffer(buffer);
+    codec->startWriteMessage(message_type_t::kReplyMessage, service, method, seq);
+    codec->write(x * y);
+
+    // Client: result
+    received = codec->getBuffer();
+    codec->setBuffer(received);
+    codec->startReadMessage(type, service, method, seq);
+    codec->read(result);
+    return codec->isStatusOk() ? result : -1;
+}
+
+// Every integer width through both compact codecs: same bytes, same values back, same errors.
+static unsigned checkCompact(void)
+{
+    static const int64_t kValues[] = { 0, 1, -1, 63, -64, 64, 127, 128, 300, -300, 32767, -32768, 70000,
+                                       INT32_MAX, INT32_MIN, INT64_MAX, INT64_MIN };
+    unsigned failures = 0;
+
+    for (unsigned i = 0; i < sizeof(kValues) / sizeof(kValues[0]); ++i) {
+        int64_t v = kValues[i];
+        for (uint32_t room = 1; room <= 48U; ++room) {
+            uint8_t compactData[48] = {};
+            uint8_t finalData[48] = {};
+            MessageBuffer compactBuffer(compactData, room);
+            MessageBuffer finalBuffer(finalData, room);
+            CompactCodec compact;
+            FinalCompactCodec fin;
+            compact.setBuffer(compactBuffer);
+            fin.setBuffer(finalBuffer);
+
+            compact.startWriteMessage(message_type_t::kInvocationMessage, 300, 70000, static_cast<uint32_t>(v));
+            fin.startWriteMessage(message_type_t::kInvocationMessage, 300, 70000, static_cast<uint32_t>(v));
+            compact.write(static_cast<int16_t>(v));
+            fin.write(static_cast<int16_t>(v));
+            compact.write(static_cast<int32_t>(v));
+            fin.write(static_cast<int32_t>(v));
+            compact.write(v);
+            fin.write(v);
+            compact.write(static_cast<uint16_t>(v));
+            fin.write(static_cast<uint16_t>(v));
+            compact.write(static_cast<uint32_t>(v));
+            fin.write(static_cast<uint32_t>(v));
+            compact.write(static_cast<uint64_t>(v));
+            fin.write(static_cast<uint64_t>(v));
+            if ((compact.getStatus() != fin.getStatus()) ||
+                (compact.getBuffer().getUsed() != fin.getBuffer().getUsed()) ||
+                (memcmp(compactData, finalData, compact.getBuffer().getUsed()) != 0)) {
+                printf("  FinalCompactCodec encodes %lld differently in %lu bytes\n", static_cast<long long>(v),
+                       static_cast<unsigned long>(room));
+                ++failures;
+                continue;
+            }
+
+            // Decode what fit, cut short at every length, with both codecs.
+            for (uint32_t used = 0; used <= compact.getBuffer().getUsed(); ++used) {
+                MessageBuffer in(compactData, sizeof(compactData));
+                in.setUsed(used);
+                compact.setBuffer(in);
+                fin.setBuffer(in);
+                message_type_t type;
+                uint32_t service, method, seq;
+                int16_t s16[2] = {};
+                int32_t s32[2] = {};
+                int64_t s64[2] = {};
+                uint16_t u16[2] = {};
+                uint32_t u32[2] = {};
+                uint64_t u64[2] = {};
+                compact.startReadMessage(type, service, method, seq);
+                fin.startReadMessage(type, service, method, seq);
+                compact.read(s16[0]);
+                fin.read(s16[1]);
+                compact.read(s32[0]);
+                fin.read(s32[1]);
+                compact.read(s64[0]);
+                fin.read(s64[1]);
+                compact.read(u16[0]);
+                fin.read(u16[1]);
+                compact.read(u32[0]);
+                fin.read(u32[1]);
+                compact.read(u64[0]);
+                fin.read(u64[1]);
+                if ((compact.getStatus() != fin.getStatus()) || (s16[0] != s16[1]) || (s32[0] != s32[1]) ||
+                    (s64[0] != s64[1]) || (u16[0] != u16[1]) || (u32[0] != u32[1]) || (u64[0] != u64[1])) {
+                    printf("  FinalCompactCodec decodes %lld differently from %lu bytes\n",
+                           static_cast<long long>(v), static_cast<unsigned long>(used));
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    // Random bytes after a valid first header byte: overlong and oversized varints must fail alike.
+    uint32_t seed = 1;
+    for (unsigned run = 0; run < 4000U; ++run) {
+        uint8_t data[12];
+        data[0] = static_cast<uint8_t>((CompactCodec::kCompactCodecVersion << 4) | 1U);
+        for (unsigned i = 1; i < sizeof(data); ++i) {
+            seed = seed * 1103515245U + 12345U;
+            data[i] = static_cast<uint8_t>(seed >> 16);
+        }
+        MessageBuffer in(data, sizeof(data));
+        in.setUsed(sizeof(data));
+        CompactCodec compact;
+        FinalCompactCodec fin;
+        compact.setBuffer(in);
+        fin.setBuffer(in);
+        uint16_t u16[2] = {};
+        int32_t s32[2] = {};
+        uint32_t u32[2] = {};
+        int64_t s64[2] = {};
+        compact.read(u16[0]);
+        fin.read(u16[1]);
+        compact.read(s32[0]);
+        fin.read(s32[1]);
+        compact.read(u32[0]);
+        fin.read(u32[1]);
+        compact.read(s64[0]);
+        fin.read(s64[1]);
+        if ((compact.getStatus() != fin.getStatus()) || (u16[0] != u16[1]) || (s32[0] != s32[1]) ||
+            (u32[0] != u32[1]) || (s64[0] != s64[1])) {
+            printf("  FinalCompactCodec decodes random bytes %u differently\n", run);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+template <class CodecT>
+static uint32_t timeCalls(CodecT *codec, const char *name, unsigned &failures)
+{
+    uint8_t data[32];
+    MessageBuffer buffer(data, sizeof(data));
+    uint32_t calls = 0;
+    uint32_t start = xtimer_now_usec();
+    uint32_t elapsed;
+
+    do {
+        int32_t a = static_cast<int32_t>(calls & 0x7FFFU);
+        if (multiplyCall(codec, buffer, a, 3, calls) != a * 3) {
+            ++failures;
+        }
+        ++calls;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+
+    bench_report(name, calls, elapsed);
+    return calls;
+}
+
+int bench_final(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    unsigned failures = 0;
+
+#if !CONFIG_ERPC_WIRE_SWAP
+    // Same bytes on the wire as BasicCodec; with CONFIG_ERPC_WIRE_SWAP that holds only if eRPC swaps too.
+    {
+        uint8_t basicData[64];
+        uint8_t finalData[64];
+        MessageBuffer basicBuffer(basicData, sizeof(basicData));
+        MessageBuffer finalBuffer(finalData, sizeof(finalData));
+        BasicCodec basic;
+        FinalBasicCodec fin;
+        basic.setBuffer(basicBuffer);
+        fin.setBuffer(finalBuffer);
+        basic.startWriteMessage(message_type_t::kInvocationMessage, 2, 3, 77);
+        fin.startWriteMessage(message_type_t::kInvocationMessage, 2, 3, 77);
+        basic.write(static_cast<int32_t>(-5));
+        fin.write(static_cast<int32_t>(-5));
+        basic.write(2.5);
+        fin.write(2.5);
+        basic.write(true);
+        fin.write(true);
+        if ((basic.getBuffer().getUsed() != fin.getBuffer().getUsed()) ||
+            (memcmp(basicData, finalData, basic.getBuffer().getUsed()) != 0)) {
+            puts("  FinalBasicCodec encodes differently from BasicCodec");
+            ++failures;
+        }
+    }
+#endif
+
+    // Any nonzero byte is true, as with BasicCodec.
+    for (unsigned byte = 0; byte < 256U; ++byte) {
+        uint8_t data[1] = { static_cast<uint8_t>(byte) };
+        MessageBuffer buffer(data, sizeof(data));
+        buffer.setUsed(sizeof(data));
+        FinalBasicCodec fin;
+        bool value = false;
+        fin.setBuffer(buffer);
+        fin.read(value);
+        if (!fin.isStatusOk() || (value != (byte != 0U))) {
+            printf("  bool byte 0x%02x decoded as %d\n", byte, value);
+            ++failures;
+        }
+    }
+
+    failures += checkCompact();
+
+    // One multiply call, both ends, per operation.
+    BasicCodec basic;
+    FinalBasicCodec finalBasic;
+    CompactCodec compact;
+    FinalCompactCodec finalCompact;
+    timeCalls<Codec>(&basic, "BasicCodec via Codec *", failures);
+    timeCalls(&finalBasic, "FinalBasicCodec", failures);
+    timeCalls<Codec>(&compact, "CompactCodec via Codec *", failures);
+    timeCalls(&finalCompact, "FinalCompactCodec", failures);
+
+    return bench_result("final", failures);
+}
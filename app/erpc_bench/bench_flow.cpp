@@ -0,0 +1,407 @@
+// bench_flow.cpp — link flow control over a slow, distant receiver: RX buffer overrun and stream throughput per window
+#include "bench.h"
+#include "queue_transport.hpp"
+#include "riot_stream.hpp"
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_crc16.hpp"
+
+extern "C" {
+#include "thread.h"
+}
+
+using namespace erpc;
+
+/*!
+ * @brief One way latency of the link, in microseconds.
+ */
+#ifndef CONFIG_BENCH_FLOW_LATENCY_US
+#define CONFIG_BENCH_FLOW_LATENCY_US 1000
+#endif
+
+/*!
+ * @brief RX buffer of the receiving board, in bytes: a higher fill would overrun it.
+ */
+#ifndef CONFIG_BENCH_FLOW_RX_BUF
+#define CONFIG_BENCH_FLOW_RX_BUF 256
+#endif
+
+/*!
+ * @brief Oneway requests sent back to back to the slow handler.
+ */
+#ifndef CONFIG_BENCH_FLOW_BURST
+#define CONFIG_BENCH_FLOW_BURST 24
+#endif
+
+/*!
+ * @brief Time the handler spends on each of them, in microseconds.
+ */
+#ifndef CONFIG_BENCH_FLOW_WORK_US
+#define CONFIG_BENCH_FLOW_WORK_US 300
+#endif
+
+/*!
+ * @brief Bytes streamed per run for the throughput figure.
+ */
+#ifndef CONFIG_BENCH_FLOW_STREAM_SIZE
+#define CONFIG_BENCH_FLOW_STREAM_SIZE (32U * 1024U)
+#endif
+
+static const uint8_t kServiceId = 15;
+static const uint8_t kWorkId = 1;   // oneway work(uint32 us, binary padding), sleeps us
+static const uint8_t kAttachId = 2; // attach() -> int32, attaches the sink to kStreamId
+static const uint8_t kStopId = 3;   // stop() -> int32, ends the run
+static const uint16_t kStreamId = 3;
+static const uint32_t kPadding = 64; // each work() request is about 90 bytes on the wire
+
+// Window 0: flow control off.
+struct FlowRun
+{
+    uint32_t window;
+    uint32_t latencyUs;
+};
+
+static const FlowRun s_runs[] = {
+    { 0, CONFIG_BENCH_FLOW_LATENCY_US },
+    { 128, CONFIG_BENCH_FLOW_LATENCY_US },
+    // What the RX buffer holds besides a few 14 byte control frames.
+    { CONFIG_BENCH_FLOW_RX_BUF - 4U * 14U, CONFIG_BENCH_FLOW_LATENCY_US },
+    { CONFIG_BENCH_FLOW_RX_BUF - 4U * 14U, 0 },
+};
+
+/*!
+ * @brief Counts what it is given.
+ */
+class CountingSink : public RiotStreamSink
+{
+public:
+    virtual erpc_status_t onData(const uint8_t *data, uint32_t size) override
+    {
+        (void)data;
+        m_bytes += size;
+        return kErpcStatus_Success;
+    }
+
+    virtual void onEnd(erpc_status_t status) override { m_status = status; }
+
+    uint32_t m_bytes;
+    erpc_status_t m_status;
+};
+
+// The runs share one link and one server thread, reset in between.
+static DelayLine s_toServer;
+static DelayLine s_toClient;
+static DelayTransport s_serverLink(&s_toServer, &s_toClient);
+static DelayTransport s_clientLink(&s_toClient, &s_toServer);
+static Crc16 s_crc;
+static CountingSink s_sink;
+static char s_serverStack[THREAD_STACKSIZE_MAIN];
+static mutex_t s_runLock;
+static cond_t s_runChanged;
+static const FlowRun *s_run; // set by the shell thread, cleared by the server when the run ends
+static erpc_status_t s_serverStatus;
+
+// Encode one request into @p data; the used size, 0 if it does not fit.
+static uint32_t encodeRequest(uint8_t *data, uint32_t size, message_type_t type, uint8_t methodId, uint32_t sequence)
+{
+    static const uint8_t s_padding[kPadding] = { 0 };
+    const uint8_t hdrSize = s_clientLink.reserveHeaderSize();
+    BasicCodec codec;
+
+    MessageBuffer request(data, size);
+    request.setUsed(hdrSize);
+    codec.setBuffer(request, hdrSize);
+    codec.startWriteMessage(type, kServiceId, methodId, sequence);
+    if (methodId == kWorkId)
+    {
+        codec.write(static_cast<uint32_t>(CONFIG_BENCH_FLOW_WORK_US));
+        codec.writeBinary(kPadding, s_padding);
+    }
+    return codec.isStatusOk() ? codec.getBuffer().getUsed() : 0U;
+}
+
+// Answer requests until stop(); work() sleeps like a receiver busy with something else.
+static erpc_status_t serve(void)
+{
+    const uint8_t hdrSize = s_serverLink.reserveHeaderSize();
+    uint8_t data[ERPC_DEFAULT_BUFFER_SIZE];
+    BasicCodec codec;
+    erpc_status_t err = kErpcStatus_Success;
+    bool stop = false;
+
+    while ((err == kErpcStatus_Success) && !stop)
+    {
+        MessageBuffer message(data, sizeof(data));
+        message_type_t type;
+        uint32_t serviceId = 0, methodId = 0, sequence = 0, us = 0;
+        int32_t result = kErpcStatus_Success;
+
+        err = s_serverLink.receive(&message);
+        if (err != kErpcStatus_Success)
+        {
+            break;
+        }
+        codec.setBuffer(message, hdrSize);
+        codec.startReadMessage(type, serviceId, methodId, sequence);
+        if (methodId == kWorkId)
+        {
+            codec.read(us);
+            xtimer_usleep(us);
+        }
+        else if (methodId == kAttachId)
+        {
+            s_sink.m_bytes = 0;
+            s_sink.m_status = kErpcStatus_Timeout;
+            result = s_serverLink.attachStreamSink(kStreamId, &s_sink);
+        }
+        stop = (methodId == kStopId);
+        err = codec.getStatus();
+        if ((err == kErpcStatus_Success) && (type == message_type_t::kInvocationMessage))
+        {
+            MessageBuffer reply(data, sizeof(data));
+            reply.setUsed(hdrSize);
+            codec.setBuffer(reply, hdrSize);
+            codec.startWriteMessage(message_type_t::kReplyMessage, kServiceId, methodId, sequence);
+            codec.write(result);
+            MessageBuffer sent = codec.getBuffer();
+            err = s_serverLink.send(&sent);
+        }
+    }
+    return err;
+}
+
+static void *serverThread(void *arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        mutex_lock(&s_runLock);
+        while (s_run == NULL)
+        {
+            cond_wait(&s_runChanged, &s_runLock);
+        }
+        const FlowRun *run = s_run;
+        mutex_unlock(&s_runLock);
+
+        erpc_status_t err = kErpcStatus_Success;
+        if (run->window != 0U)
+        {
+            err = s_serverLink.enableFlowControl(run->window);
+        }
+        if (err == kErpcStatus_Success)
+        {
+            err = serve();
+        }
+
+        mutex_lock(&s_runLock);
+        s_serverStatus = err;
+        s_run = NULL;
+        cond_broadcast(&s_runChanged);
+        mutex_unlock(&s_runLock);
+    }
+    return NULL;
+}
+
+// One request and its reply.
+static erpc_status_t call(uint8_t methodId, uint32_t sequence, int32_t &result)
+{
+    const uint8_t hdrSize = s_clientLink.reserveHeaderSize();
+    uint8_t data[ERPC_DEFAULT_BUFFER_SIZE];
+    BasicCodec codec;
+
+    uint32_t used = encodeRequest(data, sizeof(data), message_type_t::kInvocationMessage, methodId, sequence);
+    MessageBuffer request(data, sizeof(data));
+    request.setUsed(used);
+    erpc_status_t err = (used != 0U) ? s_clientLink.send(&request) : kErpcStatus_MemoryError;
+    if (err == kErpcStatus_Success)
+    {
+        MessageBuffer reply(data, sizeof(data));
+        err = s_clientLink.receive(&reply);
+        if (err == kErpcStatus_Success)
+        {
+            message_type_t type;
+            uint32_t serviceId, replyMethod, replySequence;
+            codec.setBuffer(reply, hdrSize);
+            codec.startReadMessage(type, serviceId, replyMethod, replySequence);
+            codec.read(result);
+            err = codec.getStatus();
+            if ((err == kErpcStatus_Success) && ((replyMethod != methodId) || (replySequence != sequence)))
+            {
+                err = kErpcStatus_ExpectedReply;
+            }
+        }
+    }
+    return err;
+}
+
+// CONFIG_BENCH_FLOW_BURST oneway work() requests as fast as the link takes them, then a call behind them.
+static erpc_status_t burst(uint32_t &sequence)
+{
+    uint8_t data[ERPC_DEFAULT_BUFFER_SIZE];
+    erpc_status_t err = kErpcStatus_Success;
+    int32_t result = 0;
+
+    for (uint32_t i = 0; (err == kErpcStatus_Success) && (i < CONFIG_BENCH_FLOW_BURST); ++i)
+    {
+        uint32_t used = encodeRequest(data, sizeof(data), message_type_t::kOnewayMessage, kWorkId, sequence++);
+        MessageBuffer request(data, sizeof(data));
+        request.setUsed(used);
+        err = (used != 0U) ? s_clientLink.send(&request) : kErpcStatus_MemoryError;
+    }
+    // Its reply comes once every work() has been done.
+    if (err == kErpcStatus_Success)
+    {
+        err = call(kAttachId, sequence++, result);
+    }
+    return (err != kErpcStatus_Success) ? err : static_cast<erpc_status_t>(result);
+}
+
+// Stream CONFIG_BENCH_FLOW_STREAM_SIZE bytes into the sink attached by burst(); the time it took.
+static erpc_status_t stream(uint32_t &elapsed)
+{
+    static uint8_t s_chunk[CONFIG_ERPC_STREAM_CHUNK];
+    RiotStreamWriter writer(&s_clientLink, kStreamId);
+    erpc_status_t err = kErpcStatus_Success;
+
+    uint32_t start = xtimer_now_usec();
+    for (uint32_t sent = 0; (err == kErpcStatus_Success) && (sent < CONFIG_BENCH_FLOW_STREAM_SIZE);
+         sent += sizeof(s_chunk))
+    {
+        err = writer.write(s_chunk, sizeof(s_chunk));
+    }
+    erpc_status_t closed = writer.close();
+    elapsed = xtimer_now_usec() - start;
+    return (err != kErpcStatus_Success) ? err : closed;
+}
+
+// One run on a fresh link; the number of failed checks.
+static unsigned runOnce(const FlowRun &run)
+{
+    uint32_t sequence = 0;
+    uint32_t elapsed = 0;
+    int32_t result = 0;
+    erpc_status_t err = kErpcStatus_Success;
+    unsigned failures = 0;
+
+    s_toServer.reset(run.latencyUs);
+    s_toClient.reset(run.latencyUs);
+    s_serverLink.resetLink();
+    s_clientLink.resetLink();
+
+    mutex_lock(&s_runLock);
+    s_run = &run;
+    cond_broadcast(&s_runChanged);
+    mutex_unlock(&s_runLock);
+
+    if (run.window != 0U)
+    {
+        err = s_clientLink.enableFlowControl(run.window);
+    }
+    if (err == kErpcStatus_Success)
+    {
+        err = burst(sequence);
+    }
+    uint32_t burstPeak = s_toServer.getPeak();
+    if (err == kErpcStatus_Success)
+    {
+        err = stream(elapsed);
+    }
+    if (err == kErpcStatus_Success)
+    {
+        err = call(kStopId, sequence++, result);
+    }
+
+    mutex_lock(&s_runLock);
+    while (s_run != NULL)
+    {
+        cond_wait(&s_runChanged, &s_runLock);
+    }
+    mutex_unlock(&s_runLock);
+
+    uint32_t peak = s_toServer.getPeak();
+    uint32_t rate = (elapsed != 0U) ? static_cast<uint32_t>(1000000ULL * s_sink.m_bytes / 1024U / elapsed) : 0U;
+    // Per round trip the writer sends a stream window of sub-frames, or as many whole ones as the link
+    // window takes; at least one, which goes out alone.
+    uint32_t frames = CONFIG_ERPC_STREAM_WINDOW;
+    if (run.window != 0U)
+    {
+        uint32_t fit = run.window / (s_clientLink.reserveHeaderSize() + sizeof(riot_stream_header_t) +
+                                     CONFIG_ERPC_STREAM_CHUNK);
+        frames = (fit < 1U) ? 1U : ((fit < frames) ? fit : frames);
+    }
+    uint32_t bound = (run.latencyUs != 0U) ?
+                         static_cast<uint32_t>(1000000ULL * frames * CONFIG_ERPC_STREAM_CHUNK / 1024U /
+                                               (2U * run.latencyUs)) :
+                         0U;
+
+    if (run.window != 0U)
+    {
+        printf("  window %4lu, latency %5lu us: peak RX %4lu bytes (burst %4lu), stream %6lu KB/s",
+               static_cast<unsigned long>(run.window), static_cast<unsigned long>(run.latencyUs),
+               static_cast<unsigned long>(peak), static_cast<unsigned long>(burstPeak),
+               static_cast<unsigned long>(rate));
+    }
+    else
+    {
+        printf("  no window,   latency %5lu us: peak RX %4lu bytes (burst %4lu), stream %6lu KB/s",
+               static_cast<unsigned long>(run.latencyUs), static_cast<unsigned long>(peak),
+               static_cast<unsigned long>(burstPeak), static_cast<unsigned long>(rate));
+    }
+    if (bound != 0U)
+    {
+        printf(", bound %6lu KB/s", static_cast<unsigned long>(bound));
+    }
+    printf("\n");
+
+    if ((err != kErpcStatus_Success) || (s_serverStatus != kErpcStatus_Success) ||
+        (s_sink.m_status != kErpcStatus_Success) || (s_sink.m_bytes != CONFIG_BENCH_FLOW_STREAM_SIZE))
+    {
+        printf("  run failed: client %d, server %d, sink %d after %lu bytes\n", static_cast<int>(err),
+               static_cast<int>(s_serverStatus), static_cast<int>(s_sink.m_status),
+               static_cast<unsigned long>(s_sink.m_bytes));
+        ++failures;
+    }
+    if ((run.window != 0U) && (peak > CONFIG_BENCH_FLOW_RX_BUF))
+    {
+        printf("  overrun: %lu bytes waiting for a %u byte RX buffer\n", static_cast<unsigned long>(peak),
+               static_cast<unsigned>(CONFIG_BENCH_FLOW_RX_BUF));
+        ++failures;
+    }
+    if ((run.window == 0U) && (burstPeak <= CONFIG_BENCH_FLOW_RX_BUF))
+    {
+        // Without flow control the burst must pile up, or the check above proves nothing.
+        puts("  the burst did not fill the RX buffer");
+        ++failures;
+    }
+    return failures;
+}
+
+int bench_flow(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    static bool s_started;
+    unsigned failures = 0;
+
+    if (!s_started)
+    {
+        mutex_init(&s_runLock);
+        cond_init(&s_runChanged);
+        s_serverLink.setCrc16(&s_crc);
+        s_clientLink.setCrc16(&s_crc);
+        thread_create(s_serverStack, sizeof(s_serverStack), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                      serverThread, NULL, "flow");
+        s_started = true;
+    }
+
+    printf("  %u oneway requests of %u us each, then %u bytes streamed; %u byte RX buffer\n",
+           static_cast<unsigned>(CONFIG_BENCH_FLOW_BURST), static_cast<unsigned>(CONFIG_BENCH_FLOW_WORK_US),
+           static_cast<unsigned>(CONFIG_BENCH_FLOW_STREAM_SIZE), static_cast<unsigned>(CONFIG_BENCH_FLOW_RX_BUF));
+    for (unsigned i = 0; i < sizeof(s_runs) / sizeof(s_runs[0]); ++i)
+    {
+        failures += runOnce(s_runs[i]);
+    }
+    return bench_result("flow", failures);
+}
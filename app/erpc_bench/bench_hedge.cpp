@@ -0,0 +1,194 @@
+// bench_hedge.cpp — native only: p99 latency of ClientPool calls with one server that stalls, hedged and not
+#include "bench.h"
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+/*!
+ * @brief Servers, on consecutive ports; the last one stalls now and then.
+ */
+#ifndef CONFIG_BENCH_HEDGE_SERVERS
+#define CONFIG_BENCH_HEDGE_SERVERS 2
+#endif
+
+/*!
+ * @brief Pool connections to each server; more than the callers need, so hedges find a free one.
+ */
+#ifndef CONFIG_BENCH_HEDGE_CONNECTIONS
+#define CONFIG_BENCH_HEDGE_CONNECTIONS 3
+#endif
+
+/*!
+ * @brief Threads calling through the pool at once.
+ */
+#ifndef CONFIG_BENCH_HEDGE_CALLERS
+#define CONFIG_BENCH_HEDGE_CALLERS 3
+#endif
+
+/*!
+ * @brief Calls per caller and run.
+ */
+#ifndef CONFIG_BENCH_HEDGE_CALLS
+#define CONFIG_BENCH_HEDGE_CALLS 1000
+#endif
+
+/*!
+ * @brief CPU time of each call in its handler, in microseconds.
+ */
+#ifndef CONFIG_BENCH_HEDGE_WORK_US
+#define CONFIG_BENCH_HEDGE_WORK_US 200
+#endif
+
+/*!
+ * @brief Percentage of the calls of the slow server that stall.
+ *
+ * Few enough to stay above the p95 of its latest CONFIG_ERPC_CLIENT_HEDGE_SAMPLES
+ * calls, but enough to reach the p99 of all calls.
+ */
+#ifndef CONFIG_BENCH_HEDGE_STALL_PERCENT
+#define CONFIG_BENCH_HEDGE_STALL_PERCENT 3
+#endif
+
+/*!
+ * @brief Length of a stall, in microseconds.
+ *
+ * Short enough that the stalls do not lift the average latency of the slow
+ * server to an ejection: it keeps getting calls, and without hedging the
+ * stalled ones wait for it.
+ */
+#ifndef CONFIG_BENCH_HEDGE_STALL_US
+#define CONFIG_BENCH_HEDGE_STALL_US 5000
+#endif
+
+#ifndef CONFIG_BENCH_HEDGE_PORT
+#define CONFIG_BENCH_HEDGE_PORT 50560
+#endif
+
+#if CONFIG_BENCH_HEDGE_SERVERS * CONFIG_BENCH_HEDGE_CONNECTIONS > CONFIG_ERPC_CLIENT_POOL_SIZE
+#error "CONFIG_BENCH_HEDGE_SERVERS * CONFIG_BENCH_HEDGE_CONNECTIONS exceeds CONFIG_ERPC_CLIENT_POOL_SIZE"
+#endif
+
+struct CallerRun
+{
+    ClientPool *pool;
+    int32_t id;
+    LatencyLog *log;
+    unsigned failures;
+};
+
+static void *callerThread(void *arg)
+{
+    CallerRun *run = static_cast<CallerRun *>(arg);
+
+    for (int32_t i = 0; i < CONFIG_BENCH_HEDGE_CALLS; ++i)
+    {
+        int32_t result = 0;
+        uint32_t start = erpc_native_now_us();
+        if ((bench_mul(*run->pool, i, run->id, result) != kErpcStatus_Success) || (result != i * run->id))
+        {
+            ++run->failures;
+        }
+        run->log->add(erpc_native_now_us() - start);
+    }
+    return NULL;
+}
+
+// All callers through a fresh pool, hedging mul() or not; returns the p99.
+static uint32_t runCallers(const char *name, bool hedge, erpc::MessageBufferFactory *messageFactory, LatencyLog &log,
+                           unsigned &failures)
+{
+    TcpBenchPool client(messageFactory);
+    CallerRun runs[CONFIG_BENCH_HEDGE_CALLERS];
+    pthread_t threads[CONFIG_BENCH_HEDGE_CALLERS];
+
+    if (!client.connect(CONFIG_BENCH_HEDGE_PORT, CONFIG_BENCH_HEDGE_SERVERS, CONFIG_BENCH_HEDGE_CONNECTIONS) ||
+        (hedge && (client.pool().hedgeMethod(BenchMulService::kServiceId, BenchMulService::kMulId) !=
+                   kErpcStatus_Success)))
+    {
+        printf("  %s: pool did not connect\n", name);
+        ++failures;
+        return 0;
+    }
+
+    log.clear();
+    for (unsigned c = 0; c < CONFIG_BENCH_HEDGE_CALLERS; ++c)
+    {
+        runs[c] = { &client.pool(), static_cast<int32_t>(c + 1U), &log, 0 };
+        if (pthread_create(&threads[c], NULL, callerThread, &runs[c]) != 0)
+        {
+            runs[c].failures = CONFIG_BENCH_HEDGE_CALLS;
+            threads[c] = 0;
+        }
+    }
+    for (unsigned c = 0; c < CONFIG_BENCH_HEDGE_CALLERS; ++c)
+    {
+        if (threads[c] != 0)
+        {
+            pthread_join(threads[c], NULL);
+        }
+        failures += runs[c].failures;
+    }
+
+    uint32_t p99 = log.percentile(99);
+    printf("  %-12s p50 %6lu us   p99 %6lu us   hedged %5.1f %% of calls, %lu won\n", name,
+           static_cast<unsigned long>(log.percentile(50)), static_cast<unsigned long>(p99),
+           100.0 * client.pool().getHedgedCount() / (CONFIG_BENCH_HEDGE_CALLERS * CONFIG_BENCH_HEDGE_CALLS),
+           static_cast<unsigned long>(client.pool().getHedgeWinCount()));
+    if (!hedge)
+    {
+        return p99;
+    }
+    for (unsigned s = 0; s < CONFIG_BENCH_HEDGE_SERVERS; ++s)
+    {
+        printf("    hedge after %6lu us to server %u\n",
+               static_cast<unsigned long>(client.pool().getEndpointP95(static_cast<uint8_t>(s))), s);
+    }
+    if (client.pool().getHedgeWinCount() == 0U)
+    {
+        puts("  no hedge won");
+        ++failures;
+    }
+    return p99;
+}
+
+int bench_hedge(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    erpc::MessageBufferFactory *messageFactory =
+        reinterpret_cast<erpc::MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    TcpBenchServer servers[CONFIG_BENCH_HEDGE_SERVERS];
+    LatencyLog log(CONFIG_BENCH_HEDGE_CALLERS * CONFIG_BENCH_HEDGE_CALLS);
+    unsigned failures = 0;
+
+    for (unsigned s = 0; s < CONFIG_BENCH_HEDGE_SERVERS; ++s)
+    {
+        if (servers[s].start(static_cast<uint16_t>(CONFIG_BENCH_HEDGE_PORT + s), 2) != kErpcStatus_Success)
+        {
+            printf("  server %u did not start\n", s);
+            return bench_result("hedge", 1);
+        }
+        servers[s].service().setWorkUs(CONFIG_BENCH_HEDGE_WORK_US);
+    }
+    servers[CONFIG_BENCH_HEDGE_SERVERS - 1].service().setStall(CONFIG_BENCH_HEDGE_STALL_PERCENT,
+                                                               CONFIG_BENCH_HEDGE_STALL_US);
+
+    printf("  %u servers x %u connections, %u callers, %u us per call; server %u stalls %u %% of calls for %u us\n",
+           static_cast<unsigned>(CONFIG_BENCH_HEDGE_SERVERS), static_cast<unsigned>(CONFIG_BENCH_HEDGE_CONNECTIONS),
+           static_cast<unsigned>(CONFIG_BENCH_HEDGE_CALLERS), static_cast<unsigned>(CONFIG_BENCH_HEDGE_WORK_US),
+           static_cast<unsigned>(CONFIG_BENCH_HEDGE_SERVERS - 1), static_cast<unsigned>(CONFIG_BENCH_HEDGE_STALL_PERCENT),
+           static_cast<unsigned>(CONFIG_BENCH_HEDGE_STALL_US));
+    uint32_t plainP99 = runCallers("not hedged", false, messageFactory, log, failures);
+    uint32_t hedgedP99 = runCallers("hedged", true, messageFactory, log, failures);
+
+    // A stalled call is answered by the other server after about the p95, not after the stall.
+    if ((hedgedP99 >= CONFIG_BENCH_HEDGE_STALL_US) || (hedgedP99 * 4U > plainP99 * 3U))
+    {
+        puts("  hedging did not cut the p99");
+        ++failures;
+    }
+    return bench_result("hedge", failures);
+}
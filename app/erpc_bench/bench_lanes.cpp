@@ -0,0 +1,303 @@
+// bench_lanes.cpp — RiotPoolServer lanes: latency of an urgent method while bulk calls fill lane 0
+#include "bench.h"
+#include "queue_transport.hpp"
+#include "riot_pool_server.hpp"
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_client_manager.h"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+#include "thread.h"
+}
+
+#include <stdlib.h>
+
+using namespace erpc;
+
+#if CONFIG_ERPC_POOL_LANES < 2
+#error "bench_lanes needs CONFIG_ERPC_POOL_LANES >= 2"
+#endif
+
+/*!
+ * @brief Time a bulk call spends in its handler, in microseconds.
+ */
+#ifndef CONFIG_BENCH_LANES_BULK_US
+#define CONFIG_BENCH_LANES_BULK_US 10000
+#endif
+
+/*!
+ * @brief Client threads calling bulk() back to back while the load is on.
+ *
+ * One more than the lane 0 workers keeps a bulk call queued at all times
+ * and still leaves a CONFIG_ERPC_POOL_QUEUE slot for the timed call.
+ */
+#ifndef CONFIG_BENCH_LANES_BULK_CLIENTS
+#define CONFIG_BENCH_LANES_BULK_CLIENTS (CONFIG_ERPC_POOL_WORKERS + 1)
+#endif
+
+/*!
+ * @brief Calls timed per method and run.
+ */
+#ifndef CONFIG_BENCH_LANES_CALLS
+#define CONFIG_BENCH_LANES_CALLS 200
+#endif
+
+#if CONFIG_BENCH_LANES_BULK_CLIENTS >= CONFIG_ERPC_POOL_QUEUE
+#error "CONFIG_BENCH_LANES_BULK_CLIENTS must leave a CONFIG_ERPC_POOL_QUEUE slot"
+#endif
+
+#if CONFIG_BENCH_LANES_BULK_CLIENTS + 1 > CONFIG_ERPC_POOL_TRANSPORTS
+#error "CONFIG_BENCH_LANES_BULK_CLIENTS needs more CONFIG_ERPC_POOL_TRANSPORTS"
+#endif
+
+static const uint8_t kServiceId = 14;
+static const uint8_t kBulkId = 1;   // bulk(uint32 us) -> uint32, sleeps us in its handler, lane 0
+static const uint8_t kAddId = 2;    // add(uint32 a, uint32 b) -> uint32, lane 0
+static const uint8_t kUrgentId = 3; // urgent(uint32 a, uint32 b) -> uint32, add() in lane 1
+
+class LanesBenchService : public Service
+{
+public:
+    LanesBenchService(void)
+    : Service(kServiceId)
+    {
+    }
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, Codec *codec,
+                                           MessageBufferFactory *messageFactory, Transport *transport) override
+    {
+        uint32_t a = 0, b = 0;
+
+        if (methodId == kBulkId)
+        {
+            codec->read(a);
+            xtimer_usleep(a);
+        }
+        else if ((methodId == kAddId) || (methodId == kUrgentId))
+        {
+            codec->read(a);
+            codec->read(b);
+        }
+        else
+        {
+            return kErpcStatus_InvalidArgument;
+        }
+
+        erpc_status_t err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(), transport->reserveHeaderSize());
+        }
+        if (err == kErpcStatus_Success)
+        {
+            codec->reset(transport->reserveHeaderSize());
+            codec->startWriteMessage(message_type_t::kReplyMessage, kServiceId, methodId, sequence);
+            codec->write(a + b);
+            err = codec->getStatus();
+        }
+        return err;
+    }
+};
+
+static erpc_status_t call(ClientManager &manager, uint8_t methodId, uint32_t a, uint32_t b, uint32_t &result)
+{
+    erpc_status_t err;
+
+    RequestContext request = manager.createRequest(false);
+    Codec *codec = request.getCodec();
+
+    if (codec == NULL)
+    {
+        err = kErpcStatus_MemoryError;
+    }
+    else
+    {
+        codec->startWriteMessage(message_type_t::kInvocationMessage, kServiceId, methodId, request.getSequence());
+        codec->write(a);
+        if (methodId != kBulkId)
+        {
+            codec->write(b);
+        }
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            manager.performRequest(request);
+            codec->read(result);
+            err = codec->getStatus();
+        }
+    }
+
+    manager.releaseRequest(request);
+    return err;
+}
+
+static RiotPoolServer s_server;
+static LanesBenchService s_service;
+static BasicCodecFactory s_codecFactory;
+static QueueLink s_callLink; // timed add() and urgent() calls
+static QueueLink s_bulkLinks[CONFIG_BENCH_LANES_BULK_CLIENTS];
+static MessageBufferFactory *s_messageFactory;
+static char s_runStack[THREAD_STACKSIZE_MAIN];
+static char s_bulkStacks[CONFIG_BENCH_LANES_BULK_CLIENTS][THREAD_STACKSIZE_MAIN];
+static mutex_t s_loadLock;
+static cond_t s_loadChanged;
+static bool s_loadOn;
+static unsigned s_loadFailures;
+static uint32_t s_samples[CONFIG_BENCH_LANES_CALLS];
+
+static void *runThread(void *arg)
+{
+    (void)arg;
+    erpc_status_t err = s_server.run();
+    printf("  lanes server stopped: %d\n", static_cast<int>(err));
+    return NULL;
+}
+
+static void *bulkThread(void *arg)
+{
+    ClientManager manager;
+    manager.setTransport(&static_cast<QueueLink *>(arg)->client);
+    manager.setCodecFactory(&s_codecFactory);
+    manager.setMessageBufferFactory(s_messageFactory);
+
+    for (;;)
+    {
+        uint32_t result = 0;
+
+        mutex_lock(&s_loadLock);
+        while (!s_loadOn)
+        {
+            cond_wait(&s_loadChanged, &s_loadLock);
+        }
+        mutex_unlock(&s_loadLock);
+
+        if ((call(manager, kBulkId, CONFIG_BENCH_LANES_BULK_US, 0, result) != kErpcStatus_Success) ||
+            (result != CONFIG_BENCH_LANES_BULK_US))
+        {
+            ++s_loadFailures;
+        }
+    }
+    return NULL;
+}
+
+static bool startServer(void)
+{
+    static bool s_started;
+
+    if (s_started)
+    {
+        return true;
+    }
+    s_messageFactory = reinterpret_cast<MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    if (s_messageFactory == NULL)
+    {
+        return false;
+    }
+    mutex_init(&s_loadLock);
+    cond_init(&s_loadChanged);
+
+    s_server.setTransport(&s_callLink.server);
+    s_server.setRxEvents(&s_callLink.server);
+    s_server.setCodecFactory(&s_codecFactory);
+    s_server.setMessageBufferFactory(s_messageFactory);
+    s_server.addService(&s_service);
+    for (unsigned i = 0; i < CONFIG_BENCH_LANES_BULK_CLIENTS; ++i)
+    {
+        if (s_server.addTransport(&s_bulkLinks[i].server) != kErpcStatus_Success)
+        {
+            return false;
+        }
+    }
+    if ((s_server.setPriorityClass(kServiceId, kUrgentId, 1) != kErpcStatus_Success) ||
+        (s_server.start(THREAD_PRIORITY_MAIN - 1) != kErpcStatus_Success))
+    {
+        return false;
+    }
+    thread_create(s_runStack, sizeof(s_runStack), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST, runThread, NULL,
+                  "lanes_run");
+    for (unsigned i = 0; i < CONFIG_BENCH_LANES_BULK_CLIENTS; ++i)
+    {
+        thread_create(s_bulkStacks[i], sizeof(s_bulkStacks[i]), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                      bulkThread, &s_bulkLinks[i], "lanes_bulk");
+    }
+    s_started = true;
+    return true;
+}
+
+static void setLoad(bool on)
+{
+    mutex_lock(&s_loadLock);
+    s_loadOn = on;
+    cond_broadcast(&s_loadChanged);
+    mutex_unlock(&s_loadLock);
+}
+
+static int compareSamples(const void *a, const void *b)
+{
+    uint32_t x = *static_cast<const uint32_t *>(a);
+    uint32_t y = *static_cast<const uint32_t *>(b);
+    return (x > y) - (x < y);
+}
+
+// CONFIG_BENCH_LANES_CALLS calls of @p methodId; returns their p99 latency.
+static uint32_t timeCalls(ClientManager &manager, uint8_t methodId, const char *name, unsigned &failures)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (uint32_t i = 0; i < CONFIG_BENCH_LANES_CALLS; ++i)
+    {
+        uint32_t result = 0;
+        uint32_t callStart = xtimer_now_usec();
+        if ((call(manager, methodId, i, 1000, result) != kErpcStatus_Success) || (result != i + 1000U))
+        {
+            ++failures;
+        }
+        s_samples[i] = xtimer_now_usec() - callStart;
+    }
+
+    bench_report(name, CONFIG_BENCH_LANES_CALLS, xtimer_now_usec() - start);
+    qsort(s_samples, CONFIG_BENCH_LANES_CALLS, sizeof(s_samples[0]), compareSamples);
+    uint32_t p99 = s_samples[(CONFIG_BENCH_LANES_CALLS * 99 + 99) / 100 - 1];
+    printf("  %-28s %10lu us\n", "  p99", static_cast<unsigned long>(p99));
+    return p99;
+}
+
+int bench_lanes(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    unsigned failures = 0;
+
+    if (!startServer())
+    {
+        puts("  lanes server did not start");
+        return bench_result("lanes", 1U);
+    }
+
+    ClientManager manager;
+    manager.setTransport(&s_callLink.client);
+    manager.setCodecFactory(&s_codecFactory);
+    manager.setMessageBufferFactory(s_messageFactory);
+
+    printf("  lane 0: %u workers, %u clients calling bulk() of %u us; lane 1: %u workers\n",
+           static_cast<unsigned>(CONFIG_ERPC_POOL_WORKERS), static_cast<unsigned>(CONFIG_BENCH_LANES_BULK_CLIENTS),
+           static_cast<unsigned>(CONFIG_BENCH_LANES_BULK_US), static_cast<unsigned>(CONFIG_ERPC_POOL_LANE_WORKERS));
+    (void)timeCalls(manager, kUrgentId, "urgent(), server idle", failures);
+
+    s_loadFailures = 0;
+    setLoad(true);
+    (void)timeCalls(manager, kAddId, "add() in lane 0, bulk load", failures);
+    uint32_t urgentP99 = timeCalls(manager, kUrgentId, "urgent() in lane 1, bulk load", failures);
+    setLoad(false);
+    failures += s_loadFailures;
+
+    // Its own lane and workers: it never waits for a bulk call.
+    if (urgentP99 >= CONFIG_BENCH_LANES_BULK_US)
+    {
+        puts("  urgent() waited for bulk()");
+        ++failures;
+    }
+    return bench_result("lanes", failures);
+}
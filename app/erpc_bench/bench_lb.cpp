@@ -0,0 +1,217 @@
+// bench_lb.cpp — native only: ClientPool balancing over several TcpBenchServers, ejecting and readmitting a slow one
+#include "bench.h"
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+/*!
+ * @brief Servers, on consecutive ports; the last one turns slow for a while.
+ */
+#ifndef CONFIG_BENCH_LB_SERVERS
+#define CONFIG_BENCH_LB_SERVERS 3
+#endif
+
+/*!
+ * @brief Pool connections to each server.
+ */
+#ifndef CONFIG_BENCH_LB_CONNECTIONS
+#define CONFIG_BENCH_LB_CONNECTIONS 2
+#endif
+
+/*!
+ * @brief Threads calling through the pool at once.
+ */
+#ifndef CONFIG_BENCH_LB_CALLERS
+#define CONFIG_BENCH_LB_CALLERS 3
+#endif
+
+/*!
+ * @brief Calls per caller and phase.
+ */
+#ifndef CONFIG_BENCH_LB_CALLS
+#define CONFIG_BENCH_LB_CALLS 300
+#endif
+
+/*!
+ * @brief CPU time of a call in the handler of a healthy server, in microseconds.
+ */
+#ifndef CONFIG_BENCH_LB_WORK_US
+#define CONFIG_BENCH_LB_WORK_US 200
+#endif
+
+/*!
+ * @brief CPU time of a call in the handler of the slow server, in microseconds.
+ */
+#ifndef CONFIG_BENCH_LB_SLOW_US
+#define CONFIG_BENCH_LB_SLOW_US 20000
+#endif
+
+#ifndef CONFIG_BENCH_LB_PORT
+#define CONFIG_BENCH_LB_PORT 50570
+#endif
+
+#if CONFIG_BENCH_LB_SERVERS * CONFIG_BENCH_LB_CONNECTIONS > CONFIG_ERPC_CLIENT_POOL_SIZE
+#error "CONFIG_BENCH_LB_SERVERS * CONFIG_BENCH_LB_CONNECTIONS exceeds CONFIG_ERPC_CLIENT_POOL_SIZE"
+#endif
+
+#if CONFIG_BENCH_LB_SERVERS > CONFIG_ERPC_CLIENT_POOL_ENDPOINTS
+#error "CONFIG_BENCH_LB_SERVERS exceeds CONFIG_ERPC_CLIENT_POOL_ENDPOINTS"
+#endif
+
+static const unsigned kSlow = CONFIG_BENCH_LB_SERVERS - 1;
+
+struct CallerRun
+{
+    ClientPool *pool;
+    int32_t id;
+    uint32_t calls;
+    unsigned failures;
+};
+
+static void *callerThread(void *arg)
+{
+    CallerRun *run = static_cast<CallerRun *>(arg);
+
+    for (int32_t i = 0; i < static_cast<int32_t>(run->calls); ++i)
+    {
+        int32_t result = 0;
+        if ((bench_mul(*run->pool, i, run->id, result) != kErpcStatus_Success) || (result != i * run->id))
+        {
+            ++run->failures;
+        }
+    }
+    return NULL;
+}
+
+// @p calls calls from each caller at once; @p handled receives the calls each server got.
+static unsigned runCallers(ClientPool &pool, TcpBenchServer *servers, uint32_t calls, uint32_t *handled)
+{
+    CallerRun runs[CONFIG_BENCH_LB_CALLERS];
+    pthread_t threads[CONFIG_BENCH_LB_CALLERS];
+    uint32_t before[CONFIG_BENCH_LB_SERVERS];
+    unsigned failures = 0;
+
+    for (unsigned s = 0; s < CONFIG_BENCH_LB_SERVERS; ++s)
+    {
+        before[s] = servers[s].service().getCalls();
+    }
+    for (unsigned c = 0; c < CONFIG_BENCH_LB_CALLERS; ++c)
+    {
+        runs[c] = { &pool, static_cast<int32_t>(c + 1U), calls, 0 };
+        if (pthread_create(&threads[c], NULL, callerThread, &runs[c]) != 0)
+        {
+            runs[c].failures = calls;
+            threads[c] = 0;
+        }
+    }
+    for (unsigned c = 0; c < CONFIG_BENCH_LB_CALLERS; ++c)
+    {
+        if (threads[c] != 0)
+        {
+            pthread_join(threads[c], NULL);
+        }
+        failures += runs[c].failures;
+    }
+    for (unsigned s = 0; s < CONFIG_BENCH_LB_SERVERS; ++s)
+    {
+        handled[s] = servers[s].service().getCalls() - before[s];
+    }
+    return failures;
+}
+
+static void printShares(const char *name, ClientPool &pool, const uint32_t *handled)
+{
+    uint32_t total = 0;
+
+    for (unsigned s = 0; s < CONFIG_BENCH_LB_SERVERS; ++s)
+    {
+        total += handled[s];
+    }
+    printf("  %s\n", name);
+    for (unsigned s = 0; s < CONFIG_BENCH_LB_SERVERS; ++s)
+    {
+        printf("    server %u %5.1f %% of calls, average %6lu us%s\n", s,
+               (total != 0U) ? (100.0 * handled[s] / total) : 0.0,
+               static_cast<unsigned long>(pool.getEndpointLatency(static_cast<uint8_t>(s))),
+               pool.isEjected(static_cast<uint8_t>(s)) ? ", ejected" : "");
+    }
+}
+
+int bench_lb(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    erpc::MessageBufferFactory *messageFactory =
+        reinterpret_cast<erpc::MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    TcpBenchServer servers[CONFIG_BENCH_LB_SERVERS];
+    TcpBenchPool client(messageFactory);
+    uint32_t handled[CONFIG_BENCH_LB_SERVERS];
+    unsigned failures = 0;
+
+    for (unsigned s = 0; s < CONFIG_BENCH_LB_SERVERS; ++s)
+    {
+        if (servers[s].start(static_cast<uint16_t>(CONFIG_BENCH_LB_PORT + s), 2) != kErpcStatus_Success)
+        {
+            printf("  server %u did not start\n", s);
+            return bench_result("lb", 1);
+        }
+        servers[s].service().setWorkUs(CONFIG_BENCH_LB_WORK_US);
+    }
+    if (!client.connect(CONFIG_BENCH_LB_PORT, CONFIG_BENCH_LB_SERVERS, CONFIG_BENCH_LB_CONNECTIONS))
+    {
+        puts("  pool did not connect");
+        return bench_result("lb", 1);
+    }
+    ClientPool &pool = client.pool();
+    printf("  %u servers x %u connections, %u callers, %u us per call, server %u slow: %u us\n",
+           static_cast<unsigned>(CONFIG_BENCH_LB_SERVERS), static_cast<unsigned>(CONFIG_BENCH_LB_CONNECTIONS),
+           static_cast<unsigned>(CONFIG_BENCH_LB_CALLERS), static_cast<unsigned>(CONFIG_BENCH_LB_WORK_US), kSlow,
+           static_cast<unsigned>(CONFIG_BENCH_LB_SLOW_US));
+
+    // Alike servers share the calls; none is ejected.
+    failures += runCallers(pool, servers, CONFIG_BENCH_LB_CALLS, handled);
+    printShares("all servers alike", pool, handled);
+    for (unsigned s = 0; s < CONFIG_BENCH_LB_SERVERS; ++s)
+    {
+        if ((handled[s] * CONFIG_BENCH_LB_SERVERS * 2U < CONFIG_BENCH_LB_CALLERS * CONFIG_BENCH_LB_CALLS) ||
+            pool.isEjected(static_cast<uint8_t>(s)))
+        {
+            printf("  server %u left out\n", s);
+            ++failures;
+        }
+    }
+
+    // The slow server is ejected and gets next to no calls.
+    servers[kSlow].service().setWorkUs(CONFIG_BENCH_LB_SLOW_US);
+    failures += runCallers(pool, servers, CONFIG_BENCH_LB_CALLS, handled);
+    printShares("one server slow", pool, handled);
+    if (!pool.isEjected(kSlow) || (handled[kSlow] * 10U > CONFIG_BENCH_LB_CALLERS * CONFIG_BENCH_LB_CALLS))
+    {
+        puts("  slow server not ejected");
+        ++failures;
+    }
+
+    // Healthy again: readmitted once its ejection runs out, and called again.
+    servers[kSlow].service().setWorkUs(CONFIG_BENCH_LB_WORK_US);
+    uint32_t start = erpc_native_now_us();
+    uint32_t readmitted = 0;
+    do
+    {
+        failures += runCallers(pool, servers, CONFIG_BENCH_LB_CALLS / 10U, handled);
+        readmitted += pool.isEjected(kSlow) ? 0U : handled[kSlow];
+    } while ((readmitted == 0U) && (erpc_native_now_us() - start < 10U * CONFIG_ERPC_CLIENT_LB_EJECT_US));
+    uint32_t elapsed = erpc_native_now_us() - start;
+    failures += runCallers(pool, servers, CONFIG_BENCH_LB_CALLS, handled);
+    printShares("slow server healthy again", pool, handled);
+    printf("  called again after %lu ms\n", static_cast<unsigned long>(elapsed / 1000U));
+    if ((readmitted == 0U) || pool.isEjected(kSlow) || (handled[kSlow] == 0U))
+    {
+        puts("  server not readmitted");
+        ++failures;
+    }
+
+    return bench_result("lb", failures);
+}
@@ -0,0 +1,373 @@
+// bench_overload.cpp — native only: NativeTcpServer admission control at twice its capacity
+#include "bench.h"
+#include "tcp_bench.hpp"
+#include "erpc_status_ext.h"
+#include "erpc_status_reply.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace erpc;
+
+/*!
+ * @brief Workers of the server; its capacity is this times 1e6 / CONFIG_BENCH_OVERLOAD_WORK_US calls/s.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_WORKERS
+#define CONFIG_BENCH_OVERLOAD_WORKERS 1
+#endif
+
+/*!
+ * @brief CPU time of each call in its handler, in microseconds.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_WORK_US
+#define CONFIG_BENCH_OVERLOAD_WORK_US 1000
+#endif
+
+/*!
+ * @brief Offered load as a multiple of the capacity.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_FACTOR
+#define CONFIG_BENCH_OVERLOAD_FACTOR 2
+#endif
+
+/*!
+ * @brief Client connections sharing the offered load, each sending without waiting for replies.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_CLIENTS
+#define CONFIG_BENCH_OVERLOAD_CLIENTS 4
+#endif
+
+/*!
+ * @brief Length of the overload run, in milliseconds.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_MS
+#define CONFIG_BENCH_OVERLOAD_MS 2000
+#endif
+
+/*!
+ * @brief p99 latency of the served calls that still counts as bounded, in microseconds.
+ *
+ * Without admission control the queue grows for the whole run and the p99
+ * approaches half of CONFIG_BENCH_OVERLOAD_MS.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_P99_US
+#define CONFIG_BENCH_OVERLOAD_P99_US 50000
+#endif
+
+#ifndef CONFIG_BENCH_OVERLOAD_PORT
+#define CONFIG_BENCH_OVERLOAD_PORT 50590
+#endif
+
+#define OVERLOAD_RATE \
+    (CONFIG_BENCH_OVERLOAD_FACTOR * CONFIG_BENCH_OVERLOAD_WORKERS * 1000000 / CONFIG_BENCH_OVERLOAD_WORK_US)
+#define OVERLOAD_CALLS (OVERLOAD_RATE / CONFIG_BENCH_OVERLOAD_CLIENTS * CONFIG_BENCH_OVERLOAD_MS / 1000)
+
+/*!
+ * @brief Pause between the calls of the probe connection, in microseconds.
+ */
+#ifndef CONFIG_BENCH_OVERLOAD_PROBE_US
+#define CONFIG_BENCH_OVERLOAD_PROBE_US 2000
+#endif
+
+#define OVERLOAD_PROBES (CONFIG_BENCH_OVERLOAD_MS * 1000 / CONFIG_BENCH_OVERLOAD_PROBE_US)
+
+struct LoadRun
+{
+    MessageBufferFactory *messageFactory;
+    LatencyLog *served;
+    LatencyLog *rejected;
+    NativeSocketTransport transport;
+    Crc16 crc;
+    uint32_t sent[OVERLOAD_CALLS];
+    unsigned failures;
+};
+
+static erpc_status_t sendCall(LoadRun *run, uint32_t sequence)
+{
+    uint32_t headerSize = run->transport.reserveHeaderSize();
+    MessageBuffer message = run->messageFactory->create();
+    BasicCodec codec;
+
+    message.setUsed(headerSize);
+    codec.setBuffer(message, headerSize);
+    codec.startWriteMessage(message_type_t::kInvocationMessage, BenchMulService::kServiceId, BenchMulService::kMulId,
+                            sequence);
+    codec.write(static_cast<int32_t>(sequence));
+    codec.write(static_cast<int32_t>(3));
+    erpc_status_t err = codec.getStatus();
+    if (err == kErpcStatus_Success)
+    {
+        err = run->transport.send(&codec.getBufferRef());
+    }
+    run->messageFactory->dispose(&codec.getBufferRef());
+    return err;
+}
+
+// One reply: the product, or kErpcStatus_ServerBusy; false for anything else.
+static bool receiveReply(LoadRun *run, uint32_t &sequence, bool &busy)
+{
+    uint32_t headerSize = run->transport.reserveHeaderSize();
+    MessageBuffer message = run->messageFactory->create();
+    erpc_status_t status = kErpcStatus_Success;
+    BasicCodec codec;
+    message_type_t type;
+    uint32_t service, method;
+    int32_t result = 0;
+    bool ok = false;
+
+    sequence = 0;
+    busy = false;
+    if (run->transport.receive(&message) == kErpcStatus_Success)
+    {
+        busy = readStatusReply(message, headerSize, status);
+        codec.setBuffer(message, headerSize);
+        codec.startReadMessage(type, service, method, sequence);
+        if (!busy)
+        {
+            codec.read(result);
+        }
+        ok = (codec.getStatus() == kErpcStatus_Success) &&
+             (busy ? (status == kErpcStatus_ServerBusy) : (result == static_cast<int32_t>(sequence) * 3));
+    }
+    run->messageFactory->dispose(&message);
+    return ok;
+}
+
+static void *receiveThread(void *arg)
+{
+    LoadRun *run = static_cast<LoadRun *>(arg);
+
+    for (uint32_t i = 0; i < OVERLOAD_CALLS; ++i)
+    {
+        uint32_t sequence;
+        bool busy;
+        if (!receiveReply(run, sequence, busy) || (sequence >= OVERLOAD_CALLS))
+        {
+            // A broken stream fails every call still outstanding.
+            run->failures += OVERLOAD_CALLS - i;
+            break;
+        }
+        (busy ? run->rejected : run->served)->add(erpc_native_now_us() - run->sent[sequence]);
+    }
+    return NULL;
+}
+
+// Sends this connection's share of the offered load at a fixed rate, whatever the replies do.
+static void *sendThread(void *arg)
+{
+    LoadRun *run = static_cast<LoadRun *>(arg);
+    uint32_t periodUs = 1000000U / (OVERLOAD_RATE / CONFIG_BENCH_OVERLOAD_CLIENTS);
+    uint32_t start = erpc_native_now_us();
+
+    for (uint32_t i = 0; i < OVERLOAD_CALLS; ++i)
+    {
+        int32_t wait = static_cast<int32_t>(start + i * periodUs - erpc_native_now_us());
+        if (wait > 0)
+        {
+            usleep(static_cast<useconds_t>(wait));
+        }
+        run->sent[i] = erpc_native_now_us();
+        if (sendCall(run, i) != kErpcStatus_Success)
+        {
+            ++run->failures;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * One call at a time on a connection of its own while the load runs.
+ *
+ * Replies of a connection leave in request order, so a busy reply on a load
+ * connection waits for the served calls ahead of it. The probe has none
+ * ahead: its busy replies time the rejection path itself.
+ */
+static void *probeThread(void *arg)
+{
+    LoadRun *run = static_cast<LoadRun *>(arg);
+
+    for (uint32_t i = 0; i < OVERLOAD_PROBES; ++i)
+    {
+        uint32_t sequence;
+        bool busy;
+        uint32_t start = erpc_native_now_us();
+        if ((sendCall(run, i) != kErpcStatus_Success) || !receiveReply(run, sequence, busy) || (sequence != i))
+        {
+            ++run->failures;
+            break;
+        }
+        (busy ? run->rejected : run->served)->add(erpc_native_now_us() - start);
+        usleep(CONFIG_BENCH_OVERLOAD_PROBE_US);
+    }
+    return NULL;
+}
+
+// Latency of a call into an idle server: what a rejection has to undercut.
+static unsigned timeIdleCalls(MessageBufferFactory *messageFactory, LatencyLog &log)
+{
+    TcpBenchClient client(messageFactory);
+    unsigned failures = 0;
+
+    if (!client.connect(CONFIG_BENCH_OVERLOAD_PORT))
+    {
+        return 1;
+    }
+    for (int32_t i = 0; i < 200; ++i)
+    {
+        int32_t result = 0;
+        uint32_t start = erpc_native_now_us();
+        if ((client.mul(i, 3, result) != kErpcStatus_Success) || (result != i * 3))
+        {
+            ++failures;
+        }
+        log.add(erpc_native_now_us() - start);
+    }
+    return failures;
+}
+
+static bool startRun(LoadRun *run, pthread_t &thread, void *(*entry)(void *))
+{
+    run->transport.setCrc16(&run->crc);
+    run->transport.setSocket(bench_tcp_connect(CONFIG_BENCH_OVERLOAD_PORT));
+    thread = 0;
+    return (run->transport.getSocket() >= 0) && (pthread_create(&thread, NULL, entry, run) == 0);
+}
+
+static void closeRun(LoadRun *run)
+{
+    if (run->transport.getSocket() >= 0)
+    {
+        ::close(run->transport.getSocket());
+    }
+    delete run;
+}
+
+int bench_overload(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    MessageBufferFactory *messageFactory = reinterpret_cast<MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    TcpBenchServer server;
+    LatencyLog idle(200);
+    LatencyLog served(CONFIG_BENCH_OVERLOAD_CLIENTS * OVERLOAD_CALLS);
+    LatencyLog rejected(CONFIG_BENCH_OVERLOAD_CLIENTS * OVERLOAD_CALLS);
+    LatencyLog probeServed(OVERLOAD_PROBES);
+    LatencyLog probeRejected(OVERLOAD_PROBES);
+    LoadRun *runs[CONFIG_BENCH_OVERLOAD_CLIENTS];
+    pthread_t senders[CONFIG_BENCH_OVERLOAD_CLIENTS];
+    pthread_t receivers[CONFIG_BENCH_OVERLOAD_CLIENTS];
+    LoadRun *probe = new LoadRun;
+    pthread_t prober;
+    unsigned failures = 0;
+
+    if (server.start(CONFIG_BENCH_OVERLOAD_PORT, CONFIG_BENCH_OVERLOAD_WORKERS) != kErpcStatus_Success)
+    {
+        puts("  server did not start");
+        delete probe;
+        return bench_result("overload", 1);
+    }
+    server.service().setWorkUs(CONFIG_BENCH_OVERLOAD_WORK_US);
+    failures += timeIdleCalls(messageFactory, idle);
+
+    printf("  %u workers x %u us per call, %u calls/s offered (%ux capacity) for %u ms\n",
+           static_cast<unsigned>(CONFIG_BENCH_OVERLOAD_WORKERS), static_cast<unsigned>(CONFIG_BENCH_OVERLOAD_WORK_US),
+           static_cast<unsigned>(OVERLOAD_RATE), static_cast<unsigned>(CONFIG_BENCH_OVERLOAD_FACTOR),
+           static_cast<unsigned>(CONFIG_BENCH_OVERLOAD_MS));
+
+    uint32_t start = erpc_native_now_us();
+    for (unsigned c = 0; c < CONFIG_BENCH_OVERLOAD_CLIENTS; ++c)
+    {
+        LoadRun *run = new LoadRun;
+        run->messageFactory = messageFactory;
+        run->served = &served;
+        run->rejected = &rejected;
+        run->failures = 0;
+        runs[c] = run;
+        senders[c] = 0;
+        if (!startRun(run, receivers[c], receiveThread) || (pthread_create(&senders[c], NULL, sendThread, run) != 0))
+        {
+            run->failures = OVERLOAD_CALLS;
+            senders[c] = 0;
+        }
+    }
+    probe->messageFactory = messageFactory;
+    probe->served = &probeServed;
+    probe->rejected = &probeRejected;
+    probe->failures = 0;
+    if (!startRun(probe, prober, probeThread))
+    {
+        probe->failures = 1;
+    }
+
+    for (unsigned c = 0; c < CONFIG_BENCH_OVERLOAD_CLIENTS; ++c)
+    {
+        if (senders[c] != 0)
+        {
+            pthread_join(senders[c], NULL);
+        }
+        else if (runs[c]->transport.getSocket() >= 0)
+        {
+            // Releases a receiver left waiting for replies that never come.
+            shutdown(runs[c]->transport.getSocket(), SHUT_RDWR);
+        }
+        if (receivers[c] != 0)
+        {
+            pthread_join(receivers[c], NULL);
+        }
+    }
+    uint32_t elapsed = erpc_native_now_us() - start;
+    if (prober != 0)
+    {
+        pthread_join(prober, NULL);
+    }
+
+    for (unsigned c = 0; c < CONFIG_BENCH_OVERLOAD_CLIENTS; ++c)
+    {
+        failures += runs[c]->failures;
+        closeRun(runs[c]);
+    }
+    failures += probe->failures;
+    closeRun(probe);
+
+    uint32_t rejectedCount = rejected.count() + probeRejected.count();
+    uint32_t servedP99 = served.percentile(99);
+    uint32_t idleP50 = idle.percentile(50);
+    uint32_t rejectP50 = probeRejected.percentile(50);
+    printf("  idle call            p50 %6lu us\n", static_cast<unsigned long>(idleP50));
+    printf("  served %6lu calls    p50 %6lu us   p99 %6lu us   %6.0f calls/s\n",
+           static_cast<unsigned long>(served.count()), static_cast<unsigned long>(served.percentile(50)),
+           static_cast<unsigned long>(servedP99), (elapsed != 0U) ? (1e6 * served.count() / elapsed) : 0.0);
+    printf("  busy   %6lu calls    p50 %6lu us   p99 %6lu us   (behind served replies)\n",
+           static_cast<unsigned long>(rejected.count()), static_cast<unsigned long>(rejected.percentile(50)),
+           static_cast<unsigned long>(rejected.percentile(99)));
+    printf("  probe  %3lu busy %3lu served    busy p50 %6lu us   served p50 %6lu us\n",
+           static_cast<unsigned long>(probeRejected.count()), static_cast<unsigned long>(probeServed.count()),
+           static_cast<unsigned long>(rejectP50), static_cast<unsigned long>(probeServed.percentile(50)));
+
+    if (servedP99 > CONFIG_BENCH_OVERLOAD_P99_US)
+    {
+        printf("  p99 above %u us\n", static_cast<unsigned>(CONFIG_BENCH_OVERLOAD_P99_US));
+        ++failures;
+    }
+    if ((rejected.count() == 0U) || (rejectedCount != server.server()->getRejectedCount()))
+    {
+        printf("  %lu busy replies, server rejected %lu\n", static_cast<unsigned long>(rejectedCount),
+               static_cast<unsigned long>(server.server()->getRejectedCount()));
+        ++failures;
+    }
+    // A rejection skips the queue and the handler: well within one idle call.
+    if ((probeRejected.count() == 0U) || (rejectP50 * 4U > idleP50))
+    {
+        puts("  rejection not cheaper than a call");
+        ++failures;
+    }
+
+    server.stop();
+    return bench_result("overload", failures);
+}
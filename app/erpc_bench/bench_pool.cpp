@@ -0,0 +1,387 @@
+// bench_pool.cpp — RiotPoolServer: fast calls next to a slow handler or a stalled peer, reply order of pipelined requests
+#include "bench.h"
+#include "queue_transport.hpp"
+#include "riot_pool_server.hpp"
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_client_manager.h"
+#include "erpc_crc16.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+#include "thread.h"
+}
+
+using namespace erpc;
+
+/*!
+ * @brief Time the slow method spends in its handler, in microseconds.
+ */
+#ifndef CONFIG_BENCH_POOL_SLOW_US
+#define CONFIG_BENCH_POOL_SLOW_US 20000
+#endif
+
+/*!
+ * @brief Fast calls timed per run.
+ */
+#ifndef CONFIG_BENCH_POOL_CALLS
+#define CONFIG_BENCH_POOL_CALLS 500
+#endif
+
+static const uint8_t kServiceId = 12;
+static const uint8_t kAddId = 1;  // add(int32 a, int32 b) -> int32, answers at once
+static const uint8_t kSlowId = 2; // slow(uint32 us) -> uint32, sleeps us in its handler
+
+class PoolBenchService : public Service
+{
+public:
+    PoolBenchService(void)
+    : Service(kServiceId)
+    {
+    }
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, Codec *codec,
+                                           MessageBufferFactory *messageFactory, Transport *transport) override
+    {
+        int32_t a = 0, b = 0;
+        uint32_t us = 0;
+
+        if (methodId == kAddId)
+        {
+            codec->read(a);
+            codec->read(b);
+        }
+        else if (methodId == kSlowId)
+        {
+            codec->read(us);
+            xtimer_usleep(us);
+        }
+        else
+        {
+            return kErpcStatus_InvalidArgument;
+        }
+
+        erpc_status_t err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(), transport->reserveHeaderSize());
+        }
+        if (err == kErpcStatus_Success)
+        {
+            codec->reset(transport->reserveHeaderSize());
+            codec->startWriteMessage(message_type_t::kReplyMessage, kServiceId, methodId, sequence);
+            if (methodId == kAddId)
+            {
+                codec->write(a + b);
+            }
+            else
+            {
+                codec->write(us);
+            }
+            err = codec->getStatus();
+        }
+        return err;
+    }
+};
+
+// One call of either method, as a generated client shim does it.
+static erpc_status_t call(ClientManager &manager, uint8_t methodId, uint32_t a, uint32_t b, uint32_t &result)
+{
+    erpc_status_t err;
+
+    RequestContext request = manager.createRequest(false);
+    Codec *codec = request.getCodec();
+
+    if (codec == NULL)
+    {
+        err = kErpcStatus_MemoryError;
+    }
+    else
+    {
+        codec->startWriteMessage(message_type_t::kInvocationMessage, kServiceId, methodId, request.getSequence());
+        codec->write(a);
+        if (methodId == kAddId)
+        {
+            codec->write(b);
+        }
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            manager.performRequest(request);
+            codec->read(result);
+            err = codec->getStatus();
+        }
+    }
+
+    manager.releaseRequest(request);
+    return err;
+}
+
+// Server, links and the thread keeping the slow method busy live as long as the shell.
+static RiotPoolServer s_server;
+static PoolBenchService s_service;
+static BasicCodecFactory s_codecFactory;
+static QueueLink s_fastLink; // timed add() calls
+static QueueLink s_slowLink; // slow() calls while s_loadOn
+static QueueLink s_pipeLink; // raw pipelined requests
+static ByteQueue s_stallStaged;  // frames s_stallClient sent, delivered to s_stallIn by hand
+static ByteQueue s_stallIn;
+static ByteQueue s_stallReplies;
+static ByteTransport s_stallServer(&s_stallIn, &s_stallReplies);
+static ByteTransport s_stallClient(&s_stallReplies, &s_stallStaged);
+static Crc16 s_stallCrc;
+static MessageBufferFactory *s_messageFactory;
+static char s_runStack[THREAD_STACKSIZE_MAIN];
+static char s_loadStack[THREAD_STACKSIZE_MAIN];
+static mutex_t s_loadLock;
+static cond_t s_loadChanged;
+static bool s_loadOn;
+static unsigned s_loadFailures;
+
+static void *runThread(void *arg)
+{
+    (void)arg;
+    erpc_status_t err = s_server.run();
+    printf("  pool server stopped: %d\n", static_cast<int>(err));
+    return NULL;
+}
+
+static void *loadThread(void *arg)
+{
+    (void)arg;
+    ClientManager manager;
+    manager.setTransport(&s_slowLink.client);
+    manager.setCodecFactory(&s_codecFactory);
+    manager.setMessageBufferFactory(s_messageFactory);
+
+    for (;;)
+    {
+        uint32_t result = 0;
+
+        mutex_lock(&s_loadLock);
+        while (!s_loadOn)
+        {
+            cond_wait(&s_loadChanged, &s_loadLock);
+        }
+        mutex_unlock(&s_loadLock);
+
+        if ((call(manager, kSlowId, CONFIG_BENCH_POOL_SLOW_US, 0, result) != kErpcStatus_Success) ||
+            (result != CONFIG_BENCH_POOL_SLOW_US))
+        {
+            ++s_loadFailures;
+        }
+    }
+    return NULL;
+}
+
+static bool startServer(void)
+{
+    static bool s_started;
+
+    if (s_started)
+    {
+        return true;
+    }
+    s_messageFactory = reinterpret_cast<MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    if (s_messageFactory == NULL)
+    {
+        return false;
+    }
+    mutex_init(&s_loadLock);
+    cond_init(&s_loadChanged);
+
+    s_server.setTransport(&s_fastLink.server);
+    s_server.setRxEvents(&s_fastLink.server);
+    s_server.setCodecFactory(&s_codecFactory);
+    s_server.setMessageBufferFactory(s_messageFactory);
+    s_server.addService(&s_service);
+    s_stallServer.setCrc16(&s_stallCrc);
+    s_stallClient.setCrc16(&s_stallCrc);
+    if ((s_server.addTransport(&s_slowLink.server) != kErpcStatus_Success) ||
+        (s_server.addTransport(&s_pipeLink.server) != kErpcStatus_Success) ||
+        (s_server.addTransport(&s_stallServer) != kErpcStatus_Success) ||
+        (s_server.start(THREAD_PRIORITY_MAIN - 1) != kErpcStatus_Success))
+    {
+        return false;
+    }
+    thread_create(s_runStack, sizeof(s_runStack), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST, runThread, NULL,
+                  "pool_run");
+    thread_create(s_loadStack, sizeof(s_loadStack), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST, loadThread,
+                  NULL, "pool_load");
+    s_started = true;
+    return true;
+}
+
+static void setLoad(bool on)
+{
+    mutex_lock(&s_loadLock);
+    s_loadOn = on;
+    cond_broadcast(&s_loadChanged);
+    mutex_unlock(&s_loadLock);
+}
+
+// CONFIG_BENCH_POOL_CALLS add() calls; returns the longest one.
+static uint32_t timeFastCalls(ClientManager &manager, const char *name, unsigned &failures)
+{
+    uint32_t longest = 0;
+    uint32_t start = xtimer_now_usec();
+
+    for (uint32_t i = 0; i < CONFIG_BENCH_POOL_CALLS; ++i)
+    {
+        uint32_t result = 0;
+        uint32_t callStart = xtimer_now_usec();
+        if ((call(manager, kAddId, i, 1000, result) != kErpcStatus_Success) || (result != i + 1000U))
+        {
+            ++failures;
+        }
+        uint32_t took = xtimer_now_usec() - callStart;
+        longest = (took > longest) ? took : longest;
+    }
+
+    bench_report(name, CONFIG_BENCH_POOL_CALLS, xtimer_now_usec() - start);
+    printf("  %-28s %10lu us\n", "  longest call", static_cast<unsigned long>(longest));
+    return longest;
+}
+
+// Slow and fast requests sent back to back on one connection: replies must keep request order.
+static unsigned checkReplyOrder(void)
+{
+    static const uint8_t s_methods[] = { kSlowId, kAddId, kAddId, kSlowId, kAddId, kAddId };
+    const uint32_t count = sizeof(s_methods);
+    uint8_t data[32];
+    BasicCodec codec;
+    unsigned failures = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        MessageBuffer request(data, sizeof(data));
+        codec.setBuffer(request);
+        codec.startWriteMessage(message_type_t::kInvocationMessage, kServiceId, s_methods[i], i);
+        codec.write((s_methods[i] == kSlowId) ? static_cast<uint32_t>(CONFIG_BENCH_POOL_SLOW_US) : i);
+        if (s_methods[i] == kAddId)
+        {
+            codec.write(static_cast<uint32_t>(1));
+        }
+        MessageBuffer sent = codec.getBuffer();
+        if (s_pipeLink.client.send(&sent) != kErpcStatus_Success)
+        {
+            return 1;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        MessageBuffer reply(data, sizeof(data));
+        message_type_t type;
+        uint32_t serviceId, methodId, sequence, result = 0;
+        if (s_pipeLink.client.receive(&reply) != kErpcStatus_Success)
+        {
+            return failures + 1U;
+        }
+        codec.setBuffer(reply);
+        codec.startReadMessage(type, serviceId, methodId, sequence);
+        codec.read(result);
+        if (!codec.isStatusOk() || (sequence != i) ||
+            (result != ((s_methods[i] == kSlowId) ? static_cast<uint32_t>(CONFIG_BENCH_POOL_SLOW_US) : i + 1U)))
+        {
+            printf("  reply %u: sequence %lu, result %lu\n", static_cast<unsigned>(i),
+                   static_cast<unsigned long>(sequence), static_cast<unsigned long>(result));
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+// A peer that stops in the middle of a frame must not hold up the other transports.
+static unsigned checkStalledPeer(ClientManager &manager)
+{
+    const uint8_t hdrSize = s_stallClient.reserveHeaderSize();
+    uint8_t data[32];
+    uint8_t frame[32];
+    BasicCodec codec;
+    unsigned failures = 0;
+
+    MessageBuffer request(data, sizeof(data));
+    request.setUsed(hdrSize);
+    codec.setBuffer(request, hdrSize);
+    codec.startWriteMessage(message_type_t::kInvocationMessage, kServiceId, kAddId, 0);
+    codec.write(static_cast<uint32_t>(20));
+    codec.write(static_cast<uint32_t>(22));
+    MessageBuffer sent = codec.getBuffer();
+    uint32_t size = sent.getUsed();
+    if ((s_stallClient.send(&sent) != kErpcStatus_Success) || (size > sizeof(frame)))
+    {
+        return 1;
+    }
+    s_stallStaged.read(frame, size);
+
+    // Header and part of the body, then nothing while the other links are used.
+    (void)s_stallIn.write(frame, size / 2U);
+    s_stallServer.notifyRx();
+    (void)timeFastCalls(manager, "add(), a peer stalled", failures);
+
+    (void)s_stallIn.write(frame + size / 2U, size - size / 2U);
+    s_stallServer.notifyRx();
+
+    MessageBuffer reply(data, sizeof(data));
+    message_type_t type;
+    uint32_t serviceId, methodId, sequence, result = 0;
+    if (s_stallClient.receive(&reply) != kErpcStatus_Success)
+    {
+        return failures + 1U;
+    }
+    codec.setBuffer(reply, hdrSize);
+    codec.startReadMessage(type, serviceId, methodId, sequence);
+    codec.read(result);
+    if (!codec.isStatusOk() || (sequence != 0U) || (result != 42U))
+    {
+        printf("  stalled peer: sequence %lu, result %lu\n", static_cast<unsigned long>(sequence),
+               static_cast<unsigned long>(result));
+        ++failures;
+    }
+    return failures;
+}
+
+int bench_pool(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    unsigned failures = 0;
+
+    if (!startServer())
+    {
+        puts("  pool server did not start");
+        return bench_result("pool", 1U);
+    }
+
+    ClientManager manager;
+    manager.setTransport(&s_fastLink.client);
+    manager.setCodecFactory(&s_codecFactory);
+    manager.setMessageBufferFactory(s_messageFactory);
+
+    printf("  %u workers, slow() takes %u us\n", static_cast<unsigned>(CONFIG_ERPC_POOL_WORKERS),
+           static_cast<unsigned>(CONFIG_BENCH_POOL_SLOW_US));
+    (void)timeFastCalls(manager, "add(), server idle", failures);
+
+    s_loadFailures = 0;
+    setLoad(true);
+    uint32_t longest = timeFastCalls(manager, "add(), slow() running", failures);
+    setLoad(false);
+    failures += s_loadFailures;
+
+#if CONFIG_ERPC_POOL_WORKERS > 1
+    // A single-threaded server would make some of them wait for a whole slow() call.
+    if (longest >= CONFIG_BENCH_POOL_SLOW_US)
+    {
+        puts("  add() waited for slow()");
+        ++failures;
+    }
+#else
+    (void)longest;
+#endif
+
+    failures += checkReplyOrder();
+    failures += checkStalledPeer(manager);
+    return bench_result("pool", failures);
+}
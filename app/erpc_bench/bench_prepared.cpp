@@ -0,0 +1,174 @@
+// bench_prepared.cpp — encode cost of a request with PreparedCall against startWriteMessage()
+#include "bench.h"
+#include "erpc_compact_codec.hpp"
+#include "prepared_call.hpp"
+#include "queue_transport.hpp"
+#include "reusable_client.hpp"
+
+#include "erpc_basic_codec.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <string.h>
+
+using namespace erpc;
+
+// Requests are only encoded, never sent: the link just gives the client a transport.
+static QueueLink s_link;
+
+// Encode one add(a, b) request the way a generated shim does, and release it.
+static __attribute__((noinline)) bool encodeShim(ClientManager &client, uint32_t serviceId, uint32_t methodId,
+                                                 int32_t a, int32_t b)
+{
+    RequestContext request = client.createRequest(false);
+    Codec *codec = request.getCodec();
+    bool ok = false;
+
+    if (codec != NULL)
+    {
+        codec->startWriteMessage(message_type_t::kInvocationMessage, serviceId, methodId, request.getSequence());
+        codec->write(a);
+        codec->write(b);
+        ok = codec->isStatusOk();
+    }
+    client.releaseRequest(request);
+    return ok;
+}
+
+// The same request through @p call.
+static __attribute__((noinline)) bool encodePrepared(PreparedCall &call, int32_t a, int32_t b)
+{
+    RequestContext request = call.begin();
+    Codec *codec = request.getCodec();
+    bool ok = false;
+
+    if (codec != NULL)
+    {
+        codec->write(a);
+        codec->write(b);
+        ok = codec->isStatusOk();
+    }
+    call.end(request);
+    return ok;
+}
+
+// One request each way with the same sequence number; their bytes must match.
+static bool sameBytes(ClientManager &shimClient, PreparedCall &call, uint32_t serviceId, uint32_t methodId)
+{
+    uint8_t shimData[64];
+    uint32_t shimUsed = 0;
+    bool same = false;
+
+    RequestContext shim = shimClient.createRequest(false);
+    if (shim.getCodec() != NULL)
+    {
+        Codec *codec = shim.getCodec();
+        codec->startWriteMessage(message_type_t::kInvocationMessage, serviceId, methodId, shim.getSequence());
+        codec->write(static_cast<int32_t>(-5));
+        codec->write(static_cast<int32_t>(70000));
+        shimUsed = codec->getBufferRef().getUsed();
+        if (codec->isStatusOk() && (shimUsed <= sizeof(shimData)))
+        {
+            memcpy(shimData, codec->getBufferRef().get(), shimUsed);
+        }
+        else
+        {
+            shimUsed = 0;
+        }
+    }
+    shimClient.releaseRequest(shim);
+
+    RequestContext prepared = call.begin();
+    if ((prepared.getCodec() != NULL) && (prepared.getSequence() == shim.getSequence()) && (shimUsed != 0U))
+    {
+        Codec *codec = prepared.getCodec();
+        codec->write(static_cast<int32_t>(-5));
+        codec->write(static_cast<int32_t>(70000));
+        same = codec->isStatusOk() && (codec->getBufferRef().getUsed() == shimUsed) &&
+               (memcmp(codec->getBufferRef().get(), shimData, shimUsed) == 0);
+    }
+    call.end(prepared);
+    return same;
+}
+
+static void setUp(ReusableClientManager &client, CodecFactory *codecFactory, MessageBufferFactory *messageFactory)
+{
+    client.setTransport(&s_link.client);
+    client.setCodecFactory(codecFactory);
+    client.setMessageBufferFactory(messageFactory);
+    (void)client.preallocate();
+}
+
+// Time both ways for one codec and pair of ids; two clients keep their sequence numbers in step.
+static void compare(const char *name, CodecFactory *codecFactory, MessageBufferFactory *messageFactory,
+                    uint32_t serviceId, uint32_t methodId, unsigned &failures)
+{
+    ReusableClientManager shimClient;
+    ReusableClientManager preparedClient;
+    PreparedCall call;
+
+    setUp(shimClient, codecFactory, messageFactory);
+    setUp(preparedClient, codecFactory, messageFactory);
+    // prepare() takes a sequence number of its client; the shim client skips one too.
+    RequestContext skipped = shimClient.createRequest(false);
+    shimClient.releaseRequest(skipped);
+    if ((call.prepare(&preparedClient, serviceId, methodId) != kErpcStatus_Success) ||
+        !sameBytes(shimClient, call, serviceId, methodId))
+    {
+        printf("  %s: prepared request differs from startWriteMessage()\n", name);
+        ++failures;
+        return;
+    }
+    printf("  %s, ids %lu/%lu\n", name, static_cast<unsigned long>(serviceId), static_cast<unsigned long>(methodId));
+
+    uint32_t calls = 0;
+    uint32_t start = xtimer_now_usec();
+    uint32_t elapsed;
+    do
+    {
+        if (!encodeShim(shimClient, serviceId, methodId, static_cast<int32_t>(calls), 3))
+        {
+            ++failures;
+        }
+        ++calls;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    bench_report("  startWriteMessage()", calls, elapsed);
+
+    calls = 0;
+    start = xtimer_now_usec();
+    do
+    {
+        if (!encodePrepared(call, static_cast<int32_t>(calls), 3))
+        {
+            ++failures;
+        }
+        ++calls;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    bench_report("  PreparedCall", calls, elapsed);
+}
+
+int bench_prepared(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    MessageBufferFactory *messageFactory = reinterpret_cast<MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    BasicCodecFactory basic;
+    CompactCodecFactory compact;
+    unsigned failures = 0;
+
+    if (messageFactory == NULL)
+    {
+        return bench_result("prepared", 1);
+    }
+    // Create, header, two int32 arguments, release; one preallocated buffer, so no allocation is timed.
+    compare("BasicCodec", &basic, messageFactory, 1, 3, failures);
+    compare("CompactCodec", &compact, messageFactory, 1, 3, failures);
+    compare("CompactCodec", &compact, messageFactory, 300, 70000, failures);
+
+    return bench_result("prepared", failures);
+}
@@ -0,0 +1,103 @@
+// bench_stall.cpp — native only: clients stalled in the middle of a frame against NativeTcpServer
+#include "bench.h"
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+/*!
+ * @brief Calls of the healthy client while the others stall.
+ */
+#ifndef CONFIG_BENCH_STALL_CALLS
+#define CONFIG_BENCH_STALL_CALLS 2000
+#endif
+
+/*!
+ * @brief Longest wait for a reply before the call counts as blocked, in milliseconds.
+ */
+#ifndef CONFIG_BENCH_STALL_TIMEOUT_MS
+#define CONFIG_BENCH_STALL_TIMEOUT_MS 1000
+#endif
+
+#ifndef CONFIG_BENCH_STALL_PORT
+#define CONFIG_BENCH_STALL_PORT 50620
+#endif
+
+// Connect and send the first @p size bytes of a frame announcing a 100 byte message, then go quiet.
+static int stallAfter(uint32_t size)
+{
+    // Size 100, then header and body CRC that are never checked: the frame never completes.
+    static const uint8_t kFrame[] = { 100, 0, 0x12, 0x34, 0x56, 0x78, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+    int fd = bench_tcp_connect(CONFIG_BENCH_STALL_PORT);
+
+    if ((fd >= 0) && (::send(fd, kFrame, size, MSG_NOSIGNAL) != static_cast<ssize_t>(size)))
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+int bench_stall(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    erpc::MessageBufferFactory *messageFactory =
+        reinterpret_cast<erpc::MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    TcpBenchServer server;
+    unsigned failures = 0;
+
+    if ((messageFactory == NULL) || (server.start(CONFIG_BENCH_STALL_PORT, 1) != kErpcStatus_Success))
+    {
+        return bench_result("stall", 1);
+    }
+
+    // One stalls inside the header, one inside the body.
+    int stalled[2] = { stallAfter(3), stallAfter(16) };
+    {
+        TcpBenchClient client(messageFactory);
+        struct timeval timeout = { CONFIG_BENCH_STALL_TIMEOUT_MS / 1000,
+                                   (CONFIG_BENCH_STALL_TIMEOUT_MS % 1000) * 1000 };
+        if ((stalled[0] < 0) || (stalled[1] < 0) || !client.connect(CONFIG_BENCH_STALL_PORT) ||
+            (setsockopt(client.transport().getSocket(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0))
+        {
+            ++failures;
+        }
+        else
+        {
+            LatencyLog log(CONFIG_BENCH_STALL_CALLS);
+            uint32_t start = erpc_native_now_us();
+            for (int32_t i = 0; (i < CONFIG_BENCH_STALL_CALLS) && (failures == 0U); ++i)
+            {
+                uint32_t callStart = erpc_native_now_us();
+                int32_t result = 0;
+                if ((client.mul(i, 3, result) != kErpcStatus_Success) || (result != i * 3))
+                {
+                    ++failures;
+                }
+                log.add(erpc_native_now_us() - callStart);
+            }
+            uint32_t elapsed = erpc_native_now_us() - start;
+            printf("  2 connections stalled mid-frame, %u calls on a third: %s\n", log.count(),
+                   (failures == 0U) ? "answered" : "blocked");
+            bench_report("  call", log.count(), elapsed);
+            printf("  p50 %lu us, p99 %lu us\n", static_cast<unsigned long>(log.percentile(50)),
+                   static_cast<unsigned long>(log.percentile(99)));
+        }
+    }
+
+    for (unsigned i = 0; i < 2U; ++i)
+    {
+        if (stalled[i] >= 0)
+        {
+            ::close(stalled[i]);
+        }
+    }
+    server.stop();
+    return bench_result("stall", failures);
+}
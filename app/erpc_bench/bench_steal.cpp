@@ -0,0 +1,138 @@
+// bench_steal.cpp — native only: NativeTcpServer throughput and p99 latency from 1 to N workers
+#include "bench.h"
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <unistd.h>
+
+/*!
+ * @brief Client connections, each on a thread of its own.
+ */
+#ifndef CONFIG_BENCH_STEAL_CLIENTS
+#define CONFIG_BENCH_STEAL_CLIENTS 8
+#endif
+
+/*!
+ * @brief Calls per connection and run.
+ */
+#ifndef CONFIG_BENCH_STEAL_CALLS
+#define CONFIG_BENCH_STEAL_CALLS 1000
+#endif
+
+/*!
+ * @brief CPU time of each call in its handler, in microseconds.
+ */
+#ifndef CONFIG_BENCH_STEAL_WORK_US
+#define CONFIG_BENCH_STEAL_WORK_US 50
+#endif
+
+/*!
+ * @brief First port; the run with n workers listens on this plus n.
+ */
+#ifndef CONFIG_BENCH_STEAL_PORT
+#define CONFIG_BENCH_STEAL_PORT 50600
+#endif
+
+struct ClientRun
+{
+    uint16_t port;
+    int32_t id;
+    LatencyLog *log;
+    erpc::MessageBufferFactory *messageFactory;
+    unsigned failures;
+};
+
+static void *clientThread(void *arg)
+{
+    ClientRun *run = static_cast<ClientRun *>(arg);
+    TcpBenchClient client(run->messageFactory);
+
+    if (!client.connect(run->port))
+    {
+        run->failures = CONFIG_BENCH_STEAL_CALLS;
+        return NULL;
+    }
+    for (int32_t i = 0; i < CONFIG_BENCH_STEAL_CALLS; ++i)
+    {
+        int32_t result = 0;
+        uint32_t start = erpc_native_now_us();
+        if ((client.mul(i, run->id, result) != kErpcStatus_Success) || (result != i * run->id))
+        {
+            ++run->failures;
+        }
+        run->log->add(erpc_native_now_us() - start);
+    }
+    return NULL;
+}
+
+// All clients against a fresh server with @p workers workers.
+static unsigned runWorkers(unsigned workers, erpc::MessageBufferFactory *messageFactory, LatencyLog &log)
+{
+    TcpBenchServer server;
+    ClientRun runs[CONFIG_BENCH_STEAL_CLIENTS];
+    pthread_t threads[CONFIG_BENCH_STEAL_CLIENTS];
+    uint16_t port = static_cast<uint16_t>(CONFIG_BENCH_STEAL_PORT + workers);
+    unsigned failures = 0;
+
+    if (server.start(port, workers) != kErpcStatus_Success)
+    {
+        printf("  server with %u workers did not start\n", workers);
+        return 1;
+    }
+    server.service().setWorkUs(CONFIG_BENCH_STEAL_WORK_US);
+
+    log.clear();
+    uint32_t start = erpc_native_now_us();
+    for (unsigned c = 0; c < CONFIG_BENCH_STEAL_CLIENTS; ++c)
+    {
+        runs[c] = { port, static_cast<int32_t>(c + 1U), &log, messageFactory, 0 };
+        if (pthread_create(&threads[c], NULL, clientThread, &runs[c]) != 0)
+        {
+            runs[c].failures = CONFIG_BENCH_STEAL_CALLS;
+            threads[c] = 0;
+        }
+    }
+    for (unsigned c = 0; c < CONFIG_BENCH_STEAL_CLIENTS; ++c)
+    {
+        if (threads[c] != 0)
+        {
+            pthread_join(threads[c], NULL);
+        }
+        failures += runs[c].failures;
+    }
+    uint32_t elapsed = erpc_native_now_us() - start;
+
+    printf("  %2u workers %10.0f calls/s   p50 %6lu us   p99 %6lu us\n", workers,
+           (elapsed != 0U) ? (1e6 * log.count() / elapsed) : 0.0, static_cast<unsigned long>(log.percentile(50)),
+           static_cast<unsigned long>(log.percentile(99)));
+    return failures;
+}
+
+int bench_steal(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned maxWorkers = (cores > 0) ? static_cast<unsigned>(cores) : 1U;
+    erpc::MessageBufferFactory *messageFactory =
+        reinterpret_cast<erpc::MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    LatencyLog log(CONFIG_BENCH_STEAL_CLIENTS * CONFIG_BENCH_STEAL_CALLS);
+    unsigned failures = 0;
+
+    printf("  %u connections x %u calls, %u us per call, %u cores\n", static_cast<unsigned>(CONFIG_BENCH_STEAL_CLIENTS),
+           static_cast<unsigned>(CONFIG_BENCH_STEAL_CALLS), static_cast<unsigned>(CONFIG_BENCH_STEAL_WORK_US),
+           maxWorkers);
+
+    // 1, 2, 4, ... workers, and every core.
+    for (unsigned workers = 1; workers < maxWorkers; workers *= 2U)
+    {
+        failures += runWorkers(workers, messageFactory, log);
+    }
+    failures += runWorkers(maxWorkers, messageFactory, log);
+
+    return bench_result("steal", failures);
+}
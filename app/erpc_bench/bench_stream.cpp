@@ -0,0 +1,424 @@
+// bench_stream.cpp — chunk upload through RiotStreamWriter into a small-buffer sink, failed parts and their retry
+#include "bench.h"
+#include "queue_transport.hpp"
+#include "riot_stream.hpp"
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_client_manager.h"
+#include "erpc_crc16.hpp"
+#include "erpc_simple_server.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+#include "thread.h"
+}
+
+using namespace erpc;
+
+/*!
+ * @brief Bytes of one uploaded part.
+ */
+#ifndef CONFIG_BENCH_STREAM_SIZE
+#define CONFIG_BENCH_STREAM_SIZE (128U * 1024U)
+#endif
+
+/*!
+ * @brief Buffer of the receiving sink; every full buffer is folded into its digest, like a flash page written.
+ */
+#ifndef CONFIG_BENCH_STREAM_SINK_BUFFER
+#define CONFIG_BENCH_STREAM_SINK_BUFFER 32
+#endif
+
+/*!
+ * @brief Link level receive window of both ends, in bytes; the ByteQueues hold twice ERPC_DEFAULT_BUFFER_SIZE.
+ */
+#ifndef CONFIG_BENCH_STREAM_LINK_WINDOW
+#define CONFIG_BENCH_STREAM_LINK_WINDOW 256
+#endif
+
+/*!
+ * @brief Byte of a failing part at which the sink reports a write error.
+ *
+ * In the first sub-frame of a window, so the rest of the window is on its way when the sink fails.
+ */
+#ifndef CONFIG_BENCH_STREAM_FAIL_AT
+#define CONFIG_BENCH_STREAM_FAIL_AT (10U * CONFIG_ERPC_STREAM_WINDOW * CONFIG_ERPC_STREAM_CHUNK + 1U)
+#endif
+
+static const uint8_t kServiceId = 14;
+static const uint8_t kBeginId = 1;  // begin(uint16 streamId, uint32 failAt) -> int32, attaches the sink
+static const uint8_t kDigestId = 2; // digest() -> uint32 bytes, uint32 hash, int32 status of the last part
+
+static const uint16_t kUploadStream = 7;
+static const uint16_t kUnknownStream = 9; // never attached
+
+static const uint32_t kFnvBasis = 2166136261U;
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+    return hash;
+}
+
+// Byte @p offset of every uploaded part.
+static uint8_t partByte(uint32_t offset)
+{
+    return static_cast<uint8_t>((offset * 131U) ^ (offset >> 9));
+}
+
+/*!
+ * @brief Receives one part into a buffer much smaller than the part itself.
+ */
+class UploadSink : public RiotStreamSink
+{
+public:
+    UploadSink(void) { reset(0xFFFFFFFFU); }
+
+    void reset(uint32_t failAt)
+    {
+        m_failAt = failAt;
+        m_fill = 0;
+        m_bytes = 0;
+        m_hash = kFnvBasis;
+        m_status = kErpcStatus_Timeout; // no end seen yet
+    }
+
+    virtual erpc_status_t onData(const uint8_t *data, uint32_t size) override
+    {
+        if (m_bytes + size > m_failAt)
+        {
+            return kErpcStatus_Fail;
+        }
+        m_bytes += size;
+        while (size > 0U)
+        {
+            uint32_t n = CONFIG_BENCH_STREAM_SINK_BUFFER - m_fill;
+            n = (n < size) ? n : size;
+            memcpy(m_buffer + m_fill, data, n);
+            m_fill += n;
+            data += n;
+            size -= n;
+            if (m_fill == CONFIG_BENCH_STREAM_SINK_BUFFER)
+            {
+                m_hash = fnv1a(m_hash, m_buffer, m_fill);
+                m_fill = 0;
+            }
+        }
+        return kErpcStatus_Success;
+    }
+
+    virtual void onEnd(erpc_status_t status) override
+    {
+        m_hash = fnv1a(m_hash, m_buffer, m_fill);
+        m_fill = 0;
+        m_status = status;
+    }
+
+    uint32_t m_bytes;
+    uint32_t m_hash;
+    erpc_status_t m_status;
+
+private:
+    uint32_t m_failAt;
+    uint32_t m_fill;
+    uint8_t m_buffer[CONFIG_BENCH_STREAM_SINK_BUFFER];
+};
+
+/*!
+ * @brief Upload service: begin() announces a part on a stream id, its bytes then arrive as a stream.
+ */
+class UploadService : public Service
+{
+public:
+    UploadService(RiotFramedTransport *link)
+    : Service(kServiceId)
+    , m_link(link)
+    {
+    }
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, Codec *codec,
+                                           MessageBufferFactory *messageFactory, Transport *transport) override
+    {
+        uint16_t streamId = 0;
+        uint32_t failAt = 0;
+        int32_t attached = 0;
+
+        if (methodId == kBeginId)
+        {
+            codec->read(streamId);
+            codec->read(failAt);
+            if (codec->isStatusOk())
+            {
+                m_sink.reset(failAt);
+                attached = static_cast<int32_t>(m_link->attachStreamSink(streamId, &m_sink));
+            }
+        }
+        else if (methodId != kDigestId)
+        {
+            return kErpcStatus_InvalidArgument;
+        }
+
+        erpc_status_t err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(), transport->reserveHeaderSize());
+        }
+        if (err == kErpcStatus_Success)
+        {
+            codec->reset(transport->reserveHeaderSize());
+            codec->startWriteMessage(message_type_t::kReplyMessage, kServiceId, methodId, sequence);
+            if (methodId == kBeginId)
+            {
+                codec->write(attached);
+            }
+            else
+            {
+                codec->write(m_sink.m_bytes);
+                codec->write(m_sink.m_hash);
+                codec->write(static_cast<int32_t>(m_sink.m_status));
+            }
+            err = codec->getStatus();
+        }
+        return err;
+    }
+
+private:
+    RiotFramedTransport *m_link;
+    UploadSink m_sink;
+};
+
+// Server, link and thread live as long as the shell.
+static ByteQueue s_toServer;
+static ByteQueue s_toClient;
+static ByteTransport s_serverLink(&s_toServer, &s_toClient);
+static ByteTransport s_clientLink(&s_toClient, &s_toServer);
+static Crc16 s_crc;
+static SimpleServer s_server;
+static UploadService s_service(&s_serverLink);
+static BasicCodecFactory s_codecFactory;
+static MessageBufferFactory *s_messageFactory;
+static char s_serverStack[THREAD_STACKSIZE_MAIN];
+
+static void *serverThread(void *arg)
+{
+    (void)arg;
+    erpc_status_t err = s_serverLink.enableFlowControl(CONFIG_BENCH_STREAM_LINK_WINDOW);
+    if (err == kErpcStatus_Success)
+    {
+        err = s_server.run();
+    }
+    printf("  upload server stopped: %d\n", static_cast<int>(err));
+    return NULL;
+}
+
+static bool startServer(void)
+{
+    static bool s_started;
+
+    if (s_started)
+    {
+        return true;
+    }
+    s_messageFactory = reinterpret_cast<MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    if (s_messageFactory == NULL)
+    {
+        return false;
+    }
+    s_serverLink.setCrc16(&s_crc);
+    s_clientLink.setCrc16(&s_crc);
+    s_server.setTransport(&s_serverLink);
+    s_server.setCodecFactory(&s_codecFactory);
+    s_server.setMessageBufferFactory(s_messageFactory);
+    s_server.addService(&s_service);
+    thread_create(s_serverStack, sizeof(s_serverStack), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  serverThread, NULL, "upload");
+    // Sub-frames come in windows of CONFIG_ERPC_STREAM_WINDOW; the ByteQueues only hold two frames.
+    s_started = (s_clientLink.enableFlowControl(CONFIG_BENCH_STREAM_LINK_WINDOW) == kErpcStatus_Success);
+    return s_started;
+}
+
+// begin(streamId, failAt) or digest(), as a generated client shim does it.
+static erpc_status_t call(ClientManager &manager, uint8_t methodId, uint16_t streamId, uint32_t failAt,
+                          int32_t &attached, uint32_t &bytes, uint32_t &hash)
+{
+    erpc_status_t err;
+
+    RequestContext request = manager.createRequest(false);
+    Codec *codec = request.getCodec();
+
+    if (codec == NULL)
+    {
+        err = kErpcStatus_MemoryError;
+    }
+    else
+    {
+        codec->startWriteMessage(message_type_t::kInvocationMessage, kServiceId, methodId, request.getSequence());
+        if (methodId == kBeginId)
+        {
+            codec->write(streamId);
+            codec->write(failAt);
+        }
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            manager.performRequest(request);
+            if (methodId == kDigestId)
+            {
+                codec->read(bytes);
+                codec->read(hash);
+            }
+            codec->read(attached);
+            err = codec->getStatus();
+        }
+    }
+
+    manager.releaseRequest(request);
+    return err;
+}
+
+// Stream one part to @p streamId in pieces of uneven size; the status of close(), or the first failed write().
+static erpc_status_t upload(uint16_t streamId, uint32_t size, uint32_t &hash)
+{
+    uint8_t piece[1000];
+    uint32_t offset = 0;
+    uint32_t step = 1;
+    erpc_status_t err = kErpcStatus_Success;
+    RiotStreamWriter writer(&s_clientLink, streamId);
+
+    hash = kFnvBasis;
+    while ((err == kErpcStatus_Success) && (offset < size))
+    {
+        uint32_t n = (step < size - offset) ? step : size - offset;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            piece[i] = partByte(offset + i);
+        }
+        hash = fnv1a(hash, piece, n);
+        err = writer.write(piece, n);
+        offset += n;
+        step = (step * 7U) % sizeof(piece) + 1U;
+    }
+    erpc_status_t closed = writer.close();
+    return (err != kErpcStatus_Success) ? err : closed;
+}
+
+// Credits of @p streamId the server has sent and nobody has read; after close() there must be none.
+static unsigned strayCredits(uint16_t streamId)
+{
+    const uint32_t hdrSize = s_clientLink.reserveHeaderSize();
+    uint8_t data[2 * ERPC_DEFAULT_BUFFER_SIZE];
+    unsigned count = 0;
+
+    // The server has handled everything once its input is empty; give it time to answer the last frame.
+    while (s_toServer.peek(data, 0) != 0U)
+    {
+        xtimer_usleep(1000);
+    }
+    xtimer_usleep(20000);
+
+    uint32_t queued = s_toClient.peek(data, sizeof(data));
+    uint32_t at = 0;
+    while (at + hdrSize + sizeof(riot_stream_header_t) <= queued)
+    {
+        // Frame header: CRC of the header, then the body size.
+        uint32_t size = static_cast<uint32_t>(data[at + 2]) | (static_cast<uint32_t>(data[at + 3]) << 8);
+        riot_stream_header_t sh;
+        memcpy(&sh, data + at + hdrSize, sizeof(sh));
+        if ((sh.m_tag == RiotFramedTransport::kStreamTag) && (sh.m_kind == kRiotStream_Credit) &&
+            (sh.m_streamId == streamId))
+        {
+            ++count;
+        }
+        at += hdrSize + size;
+    }
+    return count;
+}
+
+// Announce a part, upload it and compare the server's digest; @p failAt makes the sink fail on the way.
+static unsigned uploadPart(ClientManager &manager, const char *name, uint32_t failAt, erpc_status_t expected)
+{
+    int32_t attached = -1;
+    int32_t ended = -1;
+    uint32_t bytes = 0, hash = 0, serverHash = 0;
+    unsigned failures = 0;
+
+    if ((call(manager, kBeginId, kUploadStream, failAt, attached, bytes, hash) != kErpcStatus_Success) ||
+        (attached != kErpcStatus_Success))
+    {
+        printf("  %s: begin() failed, %d\n", name, static_cast<int>(attached));
+        return 1;
+    }
+
+    uint32_t start = xtimer_now_usec();
+    erpc_status_t err = upload(kUploadStream, CONFIG_BENCH_STREAM_SIZE, hash);
+    uint32_t elapsed = xtimer_now_usec() - start;
+    unsigned stray = strayCredits(kUploadStream);
+
+    if (call(manager, kDigestId, 0, 0, ended, bytes, serverHash) != kErpcStatus_Success)
+    {
+        ++failures;
+    }
+    if (expected == kErpcStatus_Success)
+    {
+        failures += ((err != kErpcStatus_Success) || (ended != kErpcStatus_Success) ||
+                     (bytes != CONFIG_BENCH_STREAM_SIZE) || (serverHash != hash)) ?
+                        1U :
+                        0U;
+        printf("  %-28s %10lu bytes %8lu us %8lu KB/s, digest %s\n", name, static_cast<unsigned long>(bytes),
+               static_cast<unsigned long>(elapsed),
+               static_cast<unsigned long>((elapsed != 0U) ? (1000000ULL * bytes / 1024U / elapsed) : 0U),
+               (serverHash == hash) ? "matches" : "differs");
+    }
+    else
+    {
+        failures += ((err != expected) || (ended != expected)) ? 1U : 0U;
+        printf("  %-28s writer %d, sink %d after %lu bytes\n", name, static_cast<int>(err), static_cast<int>(ended),
+               static_cast<unsigned long>(bytes));
+    }
+    if (stray != 0U)
+    {
+        printf("  %s: %u credits left over for stream %u\n", name, stray, static_cast<unsigned>(kUploadStream));
+        failures += stray;
+    }
+    return failures;
+}
+
+int bench_stream(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    unsigned failures = 0;
+
+    if (!startServer())
+    {
+        puts("  upload server did not start");
+        return bench_result("stream", 1U);
+    }
+
+    ClientManager manager;
+    manager.setTransport(&s_clientLink);
+    manager.setCodecFactory(&s_codecFactory);
+    manager.setMessageBufferFactory(s_messageFactory);
+
+    printf("  %u byte parts, %u byte sink buffer, chunk %u, window %u sub-frames, link window %u\n",
+           static_cast<unsigned>(CONFIG_BENCH_STREAM_SIZE), static_cast<unsigned>(CONFIG_BENCH_STREAM_SINK_BUFFER),
+           static_cast<unsigned>(CONFIG_ERPC_STREAM_CHUNK), static_cast<unsigned>(CONFIG_ERPC_STREAM_WINDOW),
+           static_cast<unsigned>(CONFIG_BENCH_STREAM_LINK_WINDOW));
+    failures += uploadPart(manager, "upload", 0xFFFFFFFFU, kErpcStatus_Success);
+    // A write error in the sink ends the part, and must not leave credits that fail its retry.
+    failures += uploadPart(manager, "sink fails", CONFIG_BENCH_STREAM_FAIL_AT, kErpcStatus_Fail);
+    failures += uploadPart(manager, "retry, same stream id", 0xFFFFFFFFU, kErpcStatus_Success);
+
+    // A part nobody announced is refused once.
+    uint32_t hash;
+    erpc_status_t err = upload(kUnknownStream, 4U * CONFIG_ERPC_STREAM_WINDOW * CONFIG_ERPC_STREAM_CHUNK, hash);
+    unsigned stray = strayCredits(kUnknownStream);
+    printf("  %-28s writer %d, %u credits left over\n", "stream not announced", static_cast<int>(err), stray);
+    failures += ((err != kErpcStatus_InvalidArgument) || (stray != 0U)) ? 1U : 0U;
+
+    return bench_result("stream", failures);
+}
@@ -0,0 +1,136 @@
+// bench_tcpcrc.cpp — native only: CPU time per TCP call with the frame CRC kept and negotiated away
+#include "bench.h"
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <time.h>
+
+/*!
+ * @brief Timed rounds per mode; the modes alternate so drift hits both alike.
+ */
+#ifndef CONFIG_BENCH_TCPCRC_ROUNDS
+#define CONFIG_BENCH_TCPCRC_ROUNDS 3
+#endif
+
+#ifndef CONFIG_BENCH_TCPCRC_PORT
+#define CONFIG_BENCH_TCPCRC_PORT 50610
+#endif
+
+// CPU time of the whole process: client, poll thread and workers.
+static uint64_t cpuNs(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000U + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+struct CrcTotals
+{
+    uint64_t cpuNs;
+    uint64_t wallUs;
+    uint32_t calls;
+};
+
+// One timed round of mul() (@p size 0) or echo(@p size bytes) on @p client.
+static void timeRound(TcpBenchClient &client, const uint8_t *data, uint32_t size, CrcTotals &totals,
+                      unsigned &failures)
+{
+    uint32_t calls = 0;
+    uint64_t cpuStart = cpuNs();
+    uint32_t start = erpc_native_now_us();
+    uint32_t elapsed;
+    int32_t result = 0;
+
+    do
+    {
+        erpc_status_t err = (size == 0U) ? client.mul(static_cast<int32_t>(calls), 3, result) : client.echo(data, size);
+        if ((err != kErpcStatus_Success) || ((size == 0U) && (result != static_cast<int32_t>(calls) * 3)))
+        {
+            ++failures;
+        }
+        ++calls;
+        elapsed = erpc_native_now_us() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    totals.cpuNs += cpuNs() - cpuStart;
+    totals.wallUs += elapsed;
+    totals.calls += calls;
+}
+
+static void printTotals(const char *name, const CrcTotals &totals)
+{
+    printf("  %-28s %10.2f us cpu/call %8.2f us/call\n", name,
+           (totals.calls != 0U) ? (totals.cpuNs / 1000.0 / totals.calls) : 0.0,
+           (totals.calls != 0U) ? (static_cast<double>(totals.wallUs) / totals.calls) : 0.0);
+}
+
+int bench_tcpcrc(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    erpc::MessageBufferFactory *messageFactory =
+        reinterpret_cast<erpc::MessageBufferFactory *>(erpc_mbf_dynamic_init());
+    TcpBenchServer server;
+    unsigned failures = 0;
+
+    if ((messageFactory == NULL) || (server.start(CONFIG_BENCH_TCPCRC_PORT, 1) != kErpcStatus_Success))
+    {
+        return bench_result("tcpcrc", 1);
+    }
+
+    {
+        uint8_t data[BenchMulService::kEchoMax];
+        for (uint32_t i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = static_cast<uint8_t>(i * 7U + 1U);
+        }
+
+        // Same server, one connection per mode; only the forced one keeps the CRC.
+        TcpBenchClient crc(messageFactory);
+        TcpBenchClient noCrc(messageFactory);
+        crc.transport().setCrcEnabled(true);
+        int32_t result = 0;
+        if (!crc.connect(CONFIG_BENCH_TCPCRC_PORT) || !noCrc.connect(CONFIG_BENCH_TCPCRC_PORT) ||
+            (crc.mul(2, 3, result) != kErpcStatus_Success) || (noCrc.mul(2, 3, result) != kErpcStatus_Success))
+        {
+            server.stop();
+            return bench_result("tcpcrc", 1);
+        }
+        printf("  CRC kept: %s, negotiated: %s\n", crc.transport().isCrcEnabled() ? "on" : "off",
+               noCrc.transport().isCrcEnabled() ? "on" : "off");
+        if (!crc.transport().isCrcEnabled() || noCrc.transport().isCrcEnabled())
+        {
+            ++failures;
+        }
+
+        static const uint32_t kSizes[] = { 0, BenchMulService::kEchoMax };
+        for (unsigned s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s)
+        {
+            CrcTotals withCrc = {};
+            CrcTotals withoutCrc = {};
+            for (unsigned round = 0; round < CONFIG_BENCH_TCPCRC_ROUNDS; ++round)
+            {
+                timeRound(crc, data, kSizes[s], withCrc, failures);
+                timeRound(noCrc, data, kSizes[s], withoutCrc, failures);
+            }
+            if (kSizes[s] == 0U)
+            {
+                printf("  mul(), 8 argument bytes\n");
+            }
+            else
+            {
+                printf("  echo(), %lu argument bytes\n", static_cast<unsigned long>(kSizes[s]));
+            }
+            printTotals("  CRC", withCrc);
+            printTotals("  no CRC", withoutCrc);
+            printf("  %-28s %10.2f us cpu/call\n", "  saved",
+                   withCrc.cpuNs / 1000.0 / withCrc.calls - withoutCrc.cpuNs / 1000.0 / withoutCrc.calls);
+        }
+    }
+
+    server.stop();
+    return bench_result("tcpcrc", failures);
+}
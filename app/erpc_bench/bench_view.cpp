@@ -0,0 +1,274 @@
+// bench_view.cpp — zero-copy views: SensorSamples view shims, bounds of truncated and oversized lengths, view vs copy
+#include "bench.h"
+#include "direct_transport.hpp"
+#include "sensor_samples.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace erpc;
+using namespace erpcShim;
+
+//! Largest chunk the checks send; request header, length word and chunk fit into one buffer.
+static const uint32_t kMaxChunk = 200U;
+
+// Counts handler calls, so the bounds checks can tell that a bad request never reached it.
+class CountingHandler : public SensorSamples_interface
+{
+public:
+    CountingHandler(void)
+    : calls(0)
+    {
+    }
+
+    int64_t sum(const int32_t *samples, uint32_t count) override
+    {
+        ++calls;
+        return get_sensor_samples_impl()->sum(samples, count);
+    }
+
+    void scale(const float *samples, uint32_t count, float factor, float *scaled) override
+    {
+        ++calls;
+        get_sensor_samples_impl()->scale(samples, count, factor, scaled);
+    }
+
+    int16_t peak(const ListView<int16_t> &samples) override
+    {
+        ++calls;
+        return get_sensor_samples_impl()->peak(samples);
+    }
+
+    uint32_t checksum(const BinaryView &chunk) override
+    {
+        ++calls;
+        return get_sensor_samples_impl()->checksum(chunk);
+    }
+
+    unsigned calls;
+};
+
+// Calls through the typed client and server shims.
+static unsigned checkShims(SensorSamples_typed_client<FinalBasicCodec> &client)
+{
+    int16_t samples[kMaxChunk / 2U];
+    uint8_t chunk[kMaxChunk];
+    unsigned failures = 0;
+
+    for (uint32_t i = 0; i < kMaxChunk; ++i) {
+        chunk[i] = static_cast<uint8_t>(i * 7U + 3U);
+    }
+
+    for (uint32_t count = 1; count <= kMaxChunk / 2U; ++count) {
+        int16_t expected = INT16_MIN;
+        int16_t result = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            samples[i] = static_cast<int16_t>((i * 7919U) % 2001U) - 1000;
+            if (samples[i] > expected) {
+                expected = samples[i];
+            }
+        }
+        if ((client.peak(samples, count, result) != kErpcStatus_Success) || (result != expected)) {
+            printf("  peak() of %u samples failed\n", static_cast<unsigned>(count));
+            ++failures;
+        }
+    }
+
+    for (uint32_t length = 0; length <= kMaxChunk; ++length) {
+        BinaryView view = { (length != 0U) ? chunk : NULL, length };
+        uint32_t expected = get_sensor_samples_impl()->checksum(view);
+        uint32_t result = 0;
+        if ((client.checksum(chunk, length, result) != kErpcStatus_Success) || (result != expected)) {
+            printf("  checksum() of %u bytes failed\n", static_cast<unsigned>(length));
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+// A request of @p method whose length word says @p length but that carries only @p present bytes after it.
+static void writeRequest(FinalBasicCodec &codec, MessageBuffer &buffer, uint8_t method, uint32_t length,
+                         uint32_t present)
+{
+    codec.setBuffer(buffer);
+    codec.startWriteMessage(message_type_t::kInvocationMessage, SensorSamples_interface::m_serviceId, method, 1);
+    codec.write(length);
+    for (uint32_t i = 0; i < present; ++i) {
+        codec.write(static_cast<uint8_t>(i));
+    }
+}
+
+// Truncated and oversized lengths: the view stays empty, the codec fails, the handler is not called.
+static unsigned checkBounds(MessageBufferFactory *messageFactory)
+{
+    static const struct {
+        uint32_t length;        /*!< int16 elements (peak) or bytes (checksum) the length word claims. */
+        uint32_t listPresent;   /*!< Bytes actually following it, peak request. */
+        uint32_t binaryPresent; /*!< Bytes actually following it, checksum request. */
+    } s_bad[] = {
+        { 10, 19, 9 },           // one byte short
+        { 10, 0, 0 },            // nothing at all
+        { 0x8000U, 16, 16 },     // larger than a MessageBuffer
+        { 0x80000000U, 16, 16 }, // wraps to 0 when multiplied by the element size
+        { 0xFFFFFFFFU, 16, 16 },
+    };
+    uint8_t data[64];
+    unsigned failures = 0;
+
+    for (unsigned i = 0; i < sizeof(s_bad) / sizeof(s_bad[0]); ++i) {
+        MessageBuffer buffer(data, sizeof(data));
+        FinalBasicCodec codec;
+        message_type_t type;
+        uint32_t serviceId, methodId, sequence;
+
+        // The codec on its own.
+        ListView<int16_t> list = { data, 1 };
+        writeRequest(codec, buffer, SensorSamples_interface::m_peakId, s_bad[i].length, s_bad[i].listPresent);
+        MessageBuffer received = codec.getBuffer();
+        codec.setBuffer(received);
+        codec.startReadMessage(type, serviceId, methodId, sequence);
+        codec.readListView(list);
+        if (codec.isStatusOk() || (list.data != NULL) || (list.length != 0U)) {
+            printf("  readListView() accepted length %lu with %u bytes\n", static_cast<unsigned long>(s_bad[i].length),
+                   static_cast<unsigned>(s_bad[i].listPresent));
+            ++failures;
+        }
+
+        BinaryView binary = { data, 1 };
+        writeRequest(codec, buffer, SensorSamples_interface::m_checksumId, s_bad[i].length, s_bad[i].binaryPresent);
+        received = codec.getBuffer();
+        codec.setBuffer(received);
+        codec.startReadMessage(type, serviceId, methodId, sequence);
+        readBinaryView(&codec, binary);
+        if (codec.isStatusOk() || (binary.data != NULL) || (binary.length != 0U)) {
+            printf("  readBinaryView() accepted length %lu with %u bytes\n",
+                   static_cast<unsigned long>(s_bad[i].length), static_cast<unsigned>(s_bad[i].binaryPresent));
+            ++failures;
+        }
+
+        // The server shims.
+        CountingHandler handler;
+        SensorSamples_typed_service<FinalBasicCodec> service(&handler);
+        DirectTransport<FinalBasicCodec> transport(&service, messageFactory);
+        MessageBuffer reply(data, sizeof(data));
+        for (unsigned m = 0; m < 2U; ++m) {
+            uint8_t methodId = (m == 0U) ? SensorSamples_interface::m_peakId : SensorSamples_interface::m_checksumId;
+            writeRequest(codec, buffer, methodId, s_bad[i].length,
+                         (m == 0U) ? s_bad[i].listPresent : s_bad[i].binaryPresent);
+            MessageBuffer request = codec.getBuffer();
+            (void)transport.send(&request);
+            if (transport.receive(&reply) == kErpcStatus_Success) {
+                printf("  method %u answered length %lu\n", methodId, static_cast<unsigned long>(s_bad[i].length));
+                ++failures;
+            }
+        }
+        if (handler.calls != 0U) {
+            printf("  handler called for length %lu\n", static_cast<unsigned long>(s_bad[i].length));
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+// Decoding the chunk of a checksum() request: into a heap copy as the generated shims do, or as a view.
+// Both touch the first and last byte, standing in for the handler.
+static __attribute__((noinline)) uint32_t decodeCopy(FinalBasicCodec &codec, MessageBuffer &request)
+{
+    message_type_t type;
+    uint32_t serviceId, methodId, sequence;
+    uint32_t length = 0;
+    uint8_t *data = NULL;
+    uint32_t result = 0;
+
+    codec.setBuffer(request);
+    codec.startReadMessage(type, serviceId, methodId, sequence);
+    codec.readBinary(length, &data);
+    uint8_t *copy = static_cast<uint8_t *>(malloc((length != 0U) ? length : 1U));
+    if ((copy != NULL) && (length != 0U)) {
+        memcpy(copy, data, length);
+        result = copy[0] + copy[length - 1U];
+    }
+    free(copy);
+    return result;
+}
+
+static __attribute__((noinline)) uint32_t decodeView(FinalBasicCodec &codec, MessageBuffer &request)
+{
+    message_type_t type;
+    uint32_t serviceId, methodId, sequence;
+    BinaryView view;
+
+    codec.setBuffer(request);
+    codec.startReadMessage(type, serviceId, methodId, sequence);
+    readBinaryView(&codec, view);
+    return (view.length != 0U) ? (view.data[0] + view.data[view.length - 1U]) : 0U;
+}
+
+static void timeDecode(void)
+{
+    uint8_t data[8U + 4U + kMaxChunk];
+    uint8_t chunk[kMaxChunk];
+    MessageBuffer buffer(data, sizeof(data));
+    FinalBasicCodec codec;
+    volatile uint32_t sink = 0;
+    uint32_t rounds;
+    uint32_t start;
+    uint32_t elapsed;
+
+    memset(chunk, 0x5A, sizeof(chunk));
+    codec.setBuffer(buffer);
+    codec.startWriteMessage(message_type_t::kInvocationMessage, SensorSamples_interface::m_serviceId,
+                            SensorSamples_interface::m_checksumId, 1);
+    codec.writeBinary(sizeof(chunk), chunk);
+    MessageBuffer request = codec.getBuffer();
+
+    rounds = 0;
+    start = xtimer_now_usec();
+    do {
+        sink = decodeCopy(codec, request);
+        ++rounds;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    bench_report("binary(200 B) decode, copy", rounds, elapsed);
+
+    rounds = 0;
+    start = xtimer_now_usec();
+    do {
+        sink = decodeView(codec, request);
+        ++rounds;
+        elapsed = xtimer_now_usec() - start;
+    } while (elapsed < CONFIG_BENCH_MIN_US);
+    bench_report("binary(200 B) decode, view", rounds, elapsed);
+    (void)sink;
+}
+
+int bench_view(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    erpc_mbf_t mbf = erpc_mbf_dynamic_init();
+    if (mbf == NULL) {
+        puts("  no message buffer factory");
+        return bench_result("view", 1U);
+    }
+    MessageBufferFactory *messageFactory = reinterpret_cast<MessageBufferFactory *>(mbf);
+
+    SensorSamples_typed_service<FinalBasicCodec> service(get_sensor_samples_impl());
+    DirectTransport<FinalBasicCodec> transport(&service, messageFactory);
+    ClientManager manager;
+    manager.setTransport(&transport);
+    manager.setMessageBufferFactory(messageFactory);
+    SensorSamples_typed_client<FinalBasicCodec> client(&manager);
+
+    unsigned failures = checkShims(client);
+    failures += checkBounds(messageFactory);
+    timeDecode();
+
+    erpc_mbf_dynamic_deinit(mbf);
+    return bench_result("view", failures);
+}
@@ -0,0 +1,87 @@
+// direct_transport.hpp — in-process transport that hands each request straight to one service
+#ifndef _DIRECT_TRANSPORT_HPP_
+#define _DIRECT_TRANSPORT_HPP_
+
+#include "erpc_config_internal.h"
+#include "erpc_message_buffer.hpp"
+#include "erpc_server.hpp"
+#include "erpc_transport.hpp"
+
+#include <string.h>
+
+/*!
+ * @brief Client transport that runs the server side of a call inside send().
+ *
+ * send() decodes the request header with a @p CodecT codec, as a server
+ * would, and calls the service's handleInvocation(); receive() returns the
+ * reply it produced. This runs the client and server shims of a call without
+ * threads or a link, so the checks of the bench commands see real shim code.
+ */
+template <class CodecT>
+class DirectTransport : public erpc::Transport
+{
+public:
+    DirectTransport(erpc::Service *service, erpc::MessageBufferFactory *messageFactory)
+    : m_service(service)
+    , m_messageFactory(messageFactory)
+    , m_status(kErpcStatus_Fail)
+    , m_replySize(0)
+    {
+    }
+
+    virtual erpc_status_t send(erpc::MessageBuffer *message) override
+    {
+        erpc::message_type_t type;
+        uint32_t serviceId, methodId, sequence;
+        CodecT codec;
+
+        if (message->getUsed() > sizeof(m_data))
+        {
+            return kErpcStatus_SendFailed;
+        }
+        memcpy(m_data, message->get(), message->getUsed());
+        erpc::MessageBuffer buffer(m_data, sizeof(m_data));
+        buffer.setUsed(message->getUsed());
+
+        codec.setBuffer(buffer);
+        codec.startReadMessage(type, serviceId, methodId, sequence);
+        m_status = codec.getStatus();
+        if ((m_status == kErpcStatus_Success) && (serviceId != m_service->getServiceId()))
+        {
+            m_status = kErpcStatus_InvalidArgument;
+        }
+        if (m_status == kErpcStatus_Success)
+        {
+            m_status = m_service->handleInvocation(methodId, sequence, &codec, m_messageFactory, this);
+        }
+        m_replySize = codec.getBufferRef().getUsed();
+        return kErpcStatus_Success;
+    }
+
+    /*!
+     * @brief Hand out the reply, or the status of a server shim that failed.
+     */
+    virtual erpc_status_t receive(erpc::MessageBuffer *message) override
+    {
+        if (m_status != kErpcStatus_Success)
+        {
+            return m_status;
+        }
+        if (m_replySize > message->getLength())
+        {
+            return kErpcStatus_ReceiveFailed;
+        }
+        memcpy(message->get(), m_data, m_replySize);
+        message->setUsed(m_replySize);
+        return kErpcStatus_Success;
+    }
+
+private:
+    erpc::Service *m_service;
+    erpc::MessageBufferFactory *m_messageFactory;
+    erpc_status_t m_status;
+    uint16_t m_replySize;
+    uint8_t m_data[ERPC_DEFAULT_BUFFER_SIZE];
+};
+
+#endif // _DIRECT_TRANSPORT_HPP_
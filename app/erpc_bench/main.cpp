@@ -0,0 +1,40 @@
+// main.cpp — shell running the checks and benchmarks of the eRPC extension modules
+//
+// On native: make -C app/erpc_bench all term, then type a command (help lists
+// them). Every command prints "<name>: OK" or "<name>: FAILED" last.
+#include "bench.h"
+
+extern "C" {
+#include "shell.h"
+}
+
+static const shell_command_t s_commands[] = {
+    { "crc", "check every CRC16 engine against the bitwise one and time them", bench_crc },
+    { "codec", "compare BasicCodec and CompactCodec frame sizes and UART round trip time", bench_codec },
+    { "final", "time one multiply call through erpc::Codec * and through the final codecs", bench_final },
+    { "bulk", "check the byte swap kernels and the POD list shims, time bulk against per element lists", bench_bulk },
+    { "view", "check the view shims against truncated and oversized lengths, time view against copy", bench_view },
+    { "dense", "check the service table of DenseServer and time it against the list walk, 64 services", bench_dense },
+    { "pool", "time fast calls to the pool server while a slow handler runs or a peer stalls, check reply order", bench_pool },
+    { "prepared", "check PreparedCall requests against startWriteMessage() and time their encoding", bench_prepared },
+    { "lanes", "time an urgent method in its own pool server lane against lane 0 while bulk calls fill it", bench_lanes },
+    { "stream", "upload 128 KB parts through a 32 byte sink, check a failed part and its retry on the same stream id", bench_stream },
+    { "flow", "peak RX fill of a slow receiver and stream throughput per link window at high latency", bench_flow },
+#ifdef CPU_NATIVE
+    { "steal", "calls/s and p99 latency of the stealing TCP server from 1 to N workers", bench_steal },
+    { "overload", "p99 latency and busy replies of the TCP server at twice its capacity, rejection against call cost", bench_overload },
+    { "cache", "hit ratio, calls/s and p99 latency of the TCP server with and without the reply cache", bench_cache },
+    { "lb", "spread of calls over three TCP servers by the client pool, ejection and readmission of a slow one", bench_lb },
+    { "hedge", "p50 and p99 of client pool calls with one stalling TCP server, hedged and not", bench_hedge },
+    { "stall", "check that TCP clients stalled in the middle of a frame do not hold up the other connections", bench_stall },
+    { "tcpcrc", "check CRC negotiation on TCP connections and compare CPU time per call with and without CRC", bench_tcpcrc },
+#endif
+    { NULL, NULL, NULL },
+};
+
+int main(void)
+{
+    char line[SHELL_DEFAULT_BUFSIZE];
+    shell_run(s_commands, line, sizeof(line));
+    return 0;
+}
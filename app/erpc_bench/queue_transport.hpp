@@ -0,0 +1,466 @@
+// queue_transport.hpp — in-process links of message or byte queues, for servers and clients on RIOT threads
+#ifndef _QUEUE_TRANSPORT_HPP_
+#define _QUEUE_TRANSPORT_HPP_
+
+#include "erpc_config_internal.h"
+#include "erpc_message_buffer.hpp"
+#include "erpc_transport.hpp"
+#include "riot_framed_transport.hpp"
+
+extern "C" {
+#include "cond.h"
+#include "mutex.h"
+#include "xtimer.h"
+}
+
+#include <string.h>
+
+/*!
+ * @brief Messages one direction of a QueueLink holds before send() blocks.
+ */
+#ifndef CONFIG_BENCH_QUEUE_DEPTH
+#define CONFIG_BENCH_QUEUE_DEPTH 8
+#endif
+
+/*!
+ * @brief One direction of a QueueLink: whole messages, oldest first.
+ *
+ * put() blocks while the queue is full and take() while it is empty; both
+ * wait on a condition variable, so a waiting thread costs no CPU time.
+ * Every put() notifies the reader's RiotRxEvents.
+ */
+class MessageQueue
+{
+public:
+    MessageQueue(void)
+    : m_reader(NULL)
+    , m_head(0)
+    , m_count(0)
+    {
+        mutex_init(&m_lock);
+        cond_init(&m_changed);
+    }
+
+    void setReader(RiotRxEvents *reader) { m_reader = reader; }
+
+    erpc_status_t put(const erpc::MessageBuffer *message)
+    {
+        if (message->getUsed() > ERPC_DEFAULT_BUFFER_SIZE)
+        {
+            return kErpcStatus_SendFailed;
+        }
+        mutex_lock(&m_lock);
+        while (m_count == CONFIG_BENCH_QUEUE_DEPTH)
+        {
+            cond_wait(&m_changed, &m_lock);
+        }
+        uint8_t tail = static_cast<uint8_t>((m_head + m_count) % CONFIG_BENCH_QUEUE_DEPTH);
+        memcpy(m_data[tail], message->get(), message->getUsed());
+        m_size[tail] = message->getUsed();
+        ++m_count;
+        cond_broadcast(&m_changed);
+        mutex_unlock(&m_lock);
+        if (m_reader != NULL) {
+            m_reader->notifyRx();
+        }
+        return kErpcStatus_Success;
+    }
+
+    erpc_status_t take(erpc::MessageBuffer *message)
+    {
+        erpc_status_t err = kErpcStatus_Success;
+
+        mutex_lock(&m_lock);
+        while (m_count == 0U)
+        {
+            cond_wait(&m_changed, &m_lock);
+        }
+        if (m_size[m_head] > message->getLength())
+        {
+            err = kErpcStatus_ReceiveFailed;
+        }
+        else
+        {
+            memcpy(message->get(), m_data[m_head], m_size[m_head]);
+            message->setUsed(m_size[m_head]);
+        }
+        m_head = static_cast<uint8_t>((m_head + 1U) % CONFIG_BENCH_QUEUE_DEPTH);
+        --m_count;
+        cond_broadcast(&m_changed);
+        mutex_unlock(&m_lock);
+        return err;
+    }
+
+    bool isEmpty(void)
+    {
+        mutex_lock(&m_lock);
+        bool empty = (m_count == 0U);
+        mutex_unlock(&m_lock);
+        return empty;
+    }
+
+private:
+    RiotRxEvents *m_reader;
+    mutex_t m_lock;
+    cond_t m_changed; /*!< Signalled on every put() and take(). */
+    uint8_t m_data[CONFIG_BENCH_QUEUE_DEPTH][ERPC_DEFAULT_BUFFER_SIZE];
+    uint16_t m_size[CONFIG_BENCH_QUEUE_DEPTH];
+    uint8_t m_head;
+    uint8_t m_count;
+};
+
+/*!
+ * @brief One end of a QueueLink: sends into one queue, receives from the other.
+ */
+class QueueTransport : public erpc::Transport, public RiotRxEvents
+{
+public:
+    QueueTransport(MessageQueue *in, MessageQueue *out)
+    : m_in(in)
+    , m_out(out)
+    {
+        m_in->setReader(this);
+    }
+
+    virtual erpc_status_t send(erpc::MessageBuffer *message) override { return m_out->put(message); }
+
+    virtual erpc_status_t receive(erpc::MessageBuffer *message) override { return m_in->take(message); }
+
+    virtual bool hasMessage(void) override { return !m_in->isEmpty(); }
+
+private:
+    MessageQueue *m_in;
+    MessageQueue *m_out;
+};
+
+/*!
+ * @brief In-process connection between a client and a server.
+ *
+ * Unlike DirectTransport both ends run on threads of their own, so server
+ * implementations that receive and execute concurrently see a real peer.
+ */
+struct QueueLink
+{
+    QueueLink(void)
+    : client(&toClient, &toServer)
+    , server(&toServer, &toClient)
+    {
+    }
+
+    MessageQueue toServer;
+    MessageQueue toClient;
+    QueueTransport client;
+    QueueTransport server;
+};
+
+/*!
+ * @brief Bytes of one direction of a ByteLink, in arrival order.
+ */
+class ByteQueue
+{
+public:
+    ByteQueue(void)
+    : m_head(0)
+    , m_count(0)
+    {
+        mutex_init(&m_lock);
+        cond_init(&m_changed);
+    }
+
+    /*!
+     * @brief Append @p size bytes; false if they do not fit.
+     */
+    bool write(const uint8_t *data, uint32_t size)
+    {
+        mutex_lock(&m_lock);
+        bool fits = (m_count + size <= sizeof(m_data));
+        for (uint32_t i = 0; fits && (i < size); ++i)
+        {
+            m_data[(m_head + m_count + i) % sizeof(m_data)] = data[i];
+        }
+        if (fits)
+        {
+            m_count += size;
+            cond_broadcast(&m_changed);
+        }
+        mutex_unlock(&m_lock);
+        return fits;
+    }
+
+    /*!
+     * @brief Take @p size bytes, waiting until they have arrived.
+     */
+    void read(uint8_t *data, uint32_t size)
+    {
+        mutex_lock(&m_lock);
+        while (m_count < size)
+        {
+            cond_wait(&m_changed, &m_lock);
+        }
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            data[i] = m_data[(m_head + i) % sizeof(m_data)];
+        }
+        m_head = (m_head + size) % sizeof(m_data);
+        m_count -= size;
+        mutex_unlock(&m_lock);
+    }
+
+    /*!
+     * @brief Copy up to @p size bytes without taking them; the number of bytes queued.
+     */
+    uint32_t peek(uint8_t *data, uint32_t size)
+    {
+        mutex_lock(&m_lock);
+        for (uint32_t i = 0; (i < size) && (i < m_count); ++i)
+        {
+            data[i] = m_data[(m_head + i) % sizeof(m_data)];
+        }
+        uint32_t count = m_count;
+        mutex_unlock(&m_lock);
+        return count;
+    }
+
+private:
+    mutex_t m_lock;
+    cond_t m_changed; /*!< Signalled on every write(). */
+    uint8_t m_data[2 * ERPC_DEFAULT_BUFFER_SIZE];
+    uint32_t m_head;
+    uint32_t m_count;
+};
+
+/*!
+ * @brief Framed transport over two ByteQueues, for tests that deliver frames in pieces.
+ *
+ * send() only writes to its output queue; whoever moves the bytes on to the
+ * peer's input calls the peer's notifyRx().
+ */
+class ByteTransport : public RiotFramedTransport
+{
+public:
+    ByteTransport(ByteQueue *in, ByteQueue *out)
+    : m_in(in)
+    , m_out(out)
+    {
+    }
+
+protected:
+    virtual erpc_status_t underlyingSend(const uint8_t *data, uint32_t size) override
+    {
+        return m_out->write(data, size) ? kErpcStatus_Success : kErpcStatus_SendFailed;
+    }
+
+    virtual erpc_status_t underlyingReceive(uint8_t *data, uint32_t size) override
+    {
+        m_in->read(data, size);
+        return kErpcStatus_Success;
+    }
+
+    virtual int32_t underlyingPeek(uint8_t *data, uint32_t size) override
+    {
+        return static_cast<int32_t>(m_in->peek(data, size));
+    }
+
+private:
+    ByteQueue *m_in;
+    ByteQueue *m_out;
+};
+
+/*!
+ * @brief Bytes one direction of a DelayLine holds, on the wire and received together.
+ */
+#ifndef CONFIG_BENCH_DELAY_LINE_SIZE
+#define CONFIG_BENCH_DELAY_LINE_SIZE 8192
+#endif
+
+/*!
+ * @brief Writes one direction of a DelayLine can have on the wire.
+ */
+#ifndef CONFIG_BENCH_DELAY_LINE_WRITES
+#define CONFIG_BENCH_DELAY_LINE_WRITES 256
+#endif
+
+/*!
+ * @brief One direction of a link with latency, like a UART with a long way to go.
+ *
+ * Written bytes arrive a fixed time later; until they are read they occupy
+ * the receiver's RX buffer, whose highest fill is kept. Arrival is worked out
+ * when either side calls, so no thread moves the bytes: the fill only grows
+ * while the reader is away, and the reader reports its peak when it comes back.
+ */
+class DelayLine
+{
+public:
+    DelayLine(void)
+    {
+        mutex_init(&m_lock);
+        cond_init(&m_changed);
+        reset(0);
+    }
+
+    /*!
+     * @brief Forget every byte and the peak, and delay later writes by @p latencyUs.
+     */
+    void reset(uint32_t latencyUs)
+    {
+        mutex_lock(&m_lock);
+        m_latencyUs = latencyUs;
+        m_written = 0;
+        m_arrived = 0;
+        m_read = 0;
+        m_peak = 0;
+        m_writeHead = 0;
+        m_writeCount = 0;
+        mutex_unlock(&m_lock);
+    }
+
+    /*!
+     * @brief Put @p size bytes on the wire; false if the line cannot hold them.
+     */
+    bool write(const uint8_t *data, uint32_t size)
+    {
+        mutex_lock(&m_lock);
+        arrive(xtimer_now_usec());
+        bool fits = (m_written - m_read + size <= sizeof(m_data)) && (m_writeCount < CONFIG_BENCH_DELAY_LINE_WRITES);
+        if (fits)
+        {
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                m_data[(m_written + i) % sizeof(m_data)] = data[i];
+            }
+            m_written += size;
+            uint32_t tail = (m_writeHead + m_writeCount) % CONFIG_BENCH_DELAY_LINE_WRITES;
+            m_due[tail] = xtimer_now_usec() + m_latencyUs;
+            m_end[tail] = m_written;
+            ++m_writeCount;
+            cond_broadcast(&m_changed);
+        }
+        mutex_unlock(&m_lock);
+        return fits;
+    }
+
+    /*!
+     * @brief Take @p size bytes, waiting until they have arrived.
+     */
+    void read(uint8_t *data, uint32_t size)
+    {
+        mutex_lock(&m_lock);
+        for (;;)
+        {
+            uint32_t now = xtimer_now_usec();
+            arrive(now);
+            if (m_arrived - m_read >= size)
+            {
+                break;
+            }
+            if (m_writeCount == 0U)
+            {
+                cond_wait(&m_changed, &m_lock);
+            }
+            else
+            {
+                // The next write is on its way; sleep until it arrives.
+                uint32_t wait = m_due[m_writeHead] - now;
+                mutex_unlock(&m_lock);
+                xtimer_usleep(wait);
+                mutex_lock(&m_lock);
+            }
+        }
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            data[i] = m_data[(m_read + i) % sizeof(m_data)];
+        }
+        m_read += size;
+        mutex_unlock(&m_lock);
+    }
+
+    /*!
+     * @brief Copy up to @p size arrived bytes without taking them; the number of bytes arrived.
+     */
+    uint32_t peek(uint8_t *data, uint32_t size)
+    {
+        mutex_lock(&m_lock);
+        arrive(xtimer_now_usec());
+        uint32_t count = m_arrived - m_read;
+        for (uint32_t i = 0; (i < size) && (i < count); ++i)
+        {
+            data[i] = m_data[(m_read + i) % sizeof(m_data)];
+        }
+        mutex_unlock(&m_lock);
+        return count;
+    }
+
+    /*!
+     * @brief Most bytes that had arrived and were not read yet, since reset().
+     */
+    uint32_t getPeak(void)
+    {
+        mutex_lock(&m_lock);
+        arrive(xtimer_now_usec());
+        uint32_t peak = m_peak;
+        mutex_unlock(&m_lock);
+        return peak;
+    }
+
+private:
+    // Move the writes due by @p now into the RX buffer.
+    void arrive(uint32_t now)
+    {
+        while ((m_writeCount != 0U) && (static_cast<int32_t>(now - m_due[m_writeHead]) >= 0))
+        {
+            m_arrived = m_end[m_writeHead];
+            m_writeHead = (m_writeHead + 1U) % CONFIG_BENCH_DELAY_LINE_WRITES;
+            --m_writeCount;
+        }
+        m_peak = (m_arrived - m_read > m_peak) ? (m_arrived - m_read) : m_peak;
+    }
+
+    mutex_t m_lock;
+    cond_t m_changed; /*!< Signalled on every write(). */
+    uint32_t m_latencyUs;
+    uint32_t m_written; /*!< Running totals of bytes written, arrived and read. */
+    uint32_t m_arrived;
+    uint32_t m_read;
+    uint32_t m_peak;
+    uint32_t m_due[CONFIG_BENCH_DELAY_LINE_WRITES]; /*!< Arrival time of each write on the wire. */
+    uint32_t m_end[CONFIG_BENCH_DELAY_LINE_WRITES]; /*!< m_written after each write on the wire. */
+    uint32_t m_writeHead;
+    uint32_t m_writeCount;
+    uint8_t m_data[CONFIG_BENCH_DELAY_LINE_SIZE];
+};
+
+/*!
+ * @brief Framed transport over two DelayLines.
+ */
+class DelayTransport : public RiotFramedTransport
+{
+public:
+    DelayTransport(DelayLine *in, DelayLine *out)
+    : m_in(in)
+    , m_out(out)
+    {
+    }
+
+protected:
+    virtual erpc_status_t underlyingSend(const uint8_t *data, uint32_t size) override
+    {
+        return m_out->write(data, size) ? kErpcStatus_Success : kErpcStatus_SendFailed;
+    }
+
+    virtual erpc_status_t underlyingReceive(uint8_t *data, uint32_t size) override
+    {
+        m_in->read(data, size);
+        return kErpcStatus_Success;
+    }
+
+    virtual int32_t underlyingPeek(uint8_t *data, uint32_t size) override
+    {
+        return static_cast<int32_t>(m_in->peek(data, size));
+    }
+
+private:
+    DelayLine *m_in;
+    DelayLine *m_out;
+};
+
+#endif // _QUEUE_TRANSPORT_HPP_
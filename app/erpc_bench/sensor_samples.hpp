@@ -0,0 +1,353 @@
+// sensor_samples.hpp — bulk sensor sample service, typed shims on the POD list and view paths of the final codecs
+//
+// Hand-written in the shape of the generated shims, for an IDL that eRPC
+// would describe as:
+//
+//   interface SensorSamples {
+//       sum(in list<int32> samples) -> int64
+//       scale(in list<float> samples, in float factor, out list<float> scaled)
+//       peak(in list<int16> samples) -> int16
+//       checksum(in binary chunk) -> uint32
+//   }
+//
+// Lists are encoded with FinalBasicCodec::writeList() and decoded with
+// readList(): one bounds check and one copy per list instead of one virtual
+// call per element. peak() and checksum() hand the handler a view into the
+// receive buffer instead, with no copy at all and no length limit beyond the
+// buffer. The wire format is that of BasicCodec.
+#ifndef _SENSOR_SAMPLES_HPP_
+#define _SENSOR_SAMPLES_HPP_
+
+#include "erpc_client_manager.h"
+#include "erpc_final_codec.hpp"
+#include "erpc_server.hpp"
+
+/* Largest list the sum() and scale() server shims decode; longer lists fail with kErpcStatus_BufferOverrun */
+#ifndef CONFIG_SENSOR_SAMPLES_MAX
+#define CONFIG_SENSOR_SAMPLES_MAX 32
+#endif
+
+class SensorSamples_interface
+{
+public:
+    static const uint8_t m_serviceId = 10;
+    static const uint8_t m_sumId = 1;
+    static const uint8_t m_scaleId = 2;
+    static const uint8_t m_peakId = 3;
+    static const uint8_t m_checksumId = 4;
+
+    virtual ~SensorSamples_interface(void) {}
+
+    virtual int64_t sum(const int32_t *samples, uint32_t count) = 0;
+    virtual void scale(const float *samples, uint32_t count, float factor, float *scaled) = 0;
+
+    // Views are valid until the handler returns.
+    virtual int16_t peak(const erpc::ListView<int16_t> &samples) = 0;
+    virtual uint32_t checksum(const erpc::BinaryView &chunk) = 0;
+};
+
+/* Handler used by the bench commands, see sensor_samples_impl.cpp */
+SensorSamples_interface *get_sensor_samples_impl(void);
+
+namespace erpcShim
+{
+
+template <class CodecT>
+class SensorSamples_typed_client
+{
+public:
+    // Installs the matching codec factory; the shim relies on it for its downcast.
+    SensorSamples_typed_client(erpc::ClientManager *manager)
+    : m_clientManager(manager)
+    {
+        erpc::FinalCodecFactory<CodecT>::install(manager);
+    }
+
+    erpc_status_t sum(const int32_t *samples, uint32_t count, int64_t &result)
+    {
+        erpc_status_t err;
+
+        erpc::RequestContext request = m_clientManager->createRequest(false);
+        CodecT *codec = static_cast<CodecT *>(request.getCodec());
+
+        if (codec == NULL)
+        {
+            err = kErpcStatus_MemoryError;
+        }
+        else
+        {
+            codec->startWriteMessage(erpc::message_type_t::kInvocationMessage, SensorSamples_interface::m_serviceId,
+                                     SensorSamples_interface::m_sumId, request.getSequence());
+            codec->writeList(samples, count);
+
+            err = codec->getStatus();
+            if (err == kErpcStatus_Success)
+            {
+                m_clientManager->performRequest(request);
+                codec->read(result);
+                err = codec->getStatus();
+            }
+        }
+
+        m_clientManager->releaseRequest(request);
+        m_clientManager->callErrorHandler(err, SensorSamples_interface::m_sumId);
+        return err;
+    }
+
+    erpc_status_t scale(const float *samples, uint32_t count, float factor, float *scaled, uint32_t maxCount,
+                        uint32_t &scaledCount)
+    {
+        erpc_status_t err;
+
+        scaledCount = 0;
+        erpc::RequestContext request = m_clientManager->createRequest(false);
+        CodecT *codec = static_cast<CodecT *>(request.getCodec());
+
+        if (codec == NULL)
+        {
+            err = kErpcStatus_MemoryError;
+        }
+        else
+        {
+            codec->startWriteMessage(erpc::message_type_t::kInvocationMessage, SensorSamples_interface::m_serviceId,
+                                     SensorSamples_interface::m_scaleId, request.getSequence());
+            codec->writeList(samples, count);
+            codec->write(factor);
+
+            err = codec->getStatus();
+            if (err == kErpcStatus_Success)
+            {
+                m_clientManager->performRequest(request);
+                codec->readList(scaled, maxCount, scaledCount);
+                err = codec->getStatus();
+            }
+        }
+
+        m_clientManager->releaseRequest(request);
+        m_clientManager->callErrorHandler(err, SensorSamples_interface::m_scaleId);
+        return err;
+    }
+
+    erpc_status_t peak(const int16_t *samples, uint32_t count, int16_t &result)
+    {
+        erpc_status_t err;
+
+        erpc::RequestContext request = m_clientManager->createRequest(false);
+        CodecT *codec = static_cast<CodecT *>(request.getCodec());
+
+        if (codec == NULL)
+        {
+            err = kErpcStatus_MemoryError;
+        }
+        else
+        {
+            codec->startWriteMessage(erpc::message_type_t::kInvocationMessage, SensorSamples_interface::m_serviceId,
+                                     SensorSamples_interface::m_peakId, request.getSequence());
+            codec->writeList(samples, count);
+
+            err = codec->getStatus();
+            if (err == kErpcStatus_Success)
+            {
+                m_clientManager->performRequest(request);
+                codec->read(result);
+                err = codec->getStatus();
+            }
+        }
+
+        m_clientManager->releaseRequest(request);
+        m_clientManager->callErrorHandler(err, SensorSamples_interface::m_peakId);
+        return err;
+    }
+
+    erpc_status_t checksum(const uint8_t *chunk, uint32_t length, uint32_t &result)
+    {
+        erpc_status_t err;
+
+        erpc::RequestContext request = m_clientManager->createRequest(false);
+        CodecT *codec = static_cast<CodecT *>(request.getCodec());
+
+        if (codec == NULL)
+        {
+            err = kErpcStatus_MemoryError;
+        }
+        else
+        {
+            codec->startWriteMessage(erpc::message_type_t::kInvocationMessage, SensorSamples_interface::m_serviceId,
+                                     SensorSamples_interface::m_checksumId, request.getSequence());
+            codec->writeBinary(length, chunk);
+
+            err = codec->getStatus();
+            if (err == kErpcStatus_Success)
+            {
+                m_clientManager->performRequest(request);
+                codec->read(result);
+                err = codec->getStatus();
+            }
+        }
+
+        m_clientManager->releaseRequest(request);
+        m_clientManager->callErrorHandler(err, SensorSamples_interface::m_checksumId);
+        return err;
+    }
+
+protected:
+    erpc::ClientManager *m_clientManager;
+};
+
+template <class CodecT>
+class SensorSamples_typed_service : public erpc::Service
+{
+public:
+    // The server must create CodecT codecs: call erpc::FinalCodecFactory<CodecT>::install() on it.
+    SensorSamples_typed_service(SensorSamples_interface *handler)
+    : erpc::Service(SensorSamples_interface::m_serviceId)
+    , m_handler(handler)
+    {
+    }
+
+    virtual ~SensorSamples_typed_service() {}
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, erpc::Codec *codec,
+                                           erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport)
+    {
+        switch (methodId)
+        {
+            case SensorSamples_interface::m_sumId:
+                return sum_shim(static_cast<CodecT *>(codec), messageFactory, transport, sequence);
+            case SensorSamples_interface::m_scaleId:
+                return scale_shim(static_cast<CodecT *>(codec), messageFactory, transport, sequence);
+            case SensorSamples_interface::m_peakId:
+                return peak_shim(static_cast<CodecT *>(codec), messageFactory, transport, sequence);
+            case SensorSamples_interface::m_checksumId:
+                return checksum_shim(static_cast<CodecT *>(codec), messageFactory, transport, sequence);
+            default:
+                return kErpcStatus_InvalidArgument;
+        }
+    }
+
+private:
+    SensorSamples_interface *m_handler;
+
+    erpc_status_t startReply(CodecT *codec, erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport,
+                             uint32_t methodId, uint32_t sequence)
+    {
+        erpc_status_t err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(),
+                                                                      transport->reserveHeaderSize());
+        if (err == kErpcStatus_Success)
+        {
+            codec->reset(transport->reserveHeaderSize());
+            codec->startWriteMessage(erpc::message_type_t::kReplyMessage, SensorSamples_interface::m_serviceId,
+                                     methodId, sequence);
+        }
+        return err;
+    }
+
+    erpc_status_t sum_shim(CodecT *codec, erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport,
+                           uint32_t sequence)
+    {
+        erpc_status_t err;
+        int32_t samples[CONFIG_SENSOR_SAMPLES_MAX];
+        uint32_t count = 0;
+        int64_t result = 0;
+
+        codec->readList(samples, CONFIG_SENSOR_SAMPLES_MAX, count);
+
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            result = m_handler->sum(samples, count);
+            err = startReply(codec, messageFactory, transport, SensorSamples_interface::m_sumId, sequence);
+        }
+
+        if (err == kErpcStatus_Success)
+        {
+            codec->write(result);
+            err = codec->getStatus();
+        }
+
+        return err;
+    }
+
+    erpc_status_t scale_shim(CodecT *codec, erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport,
+                             uint32_t sequence)
+    {
+        erpc_status_t err;
+        float samples[CONFIG_SENSOR_SAMPLES_MAX];
+        float scaled[CONFIG_SENSOR_SAMPLES_MAX];
+        uint32_t count = 0;
+        float factor = 0.0f;
+
+        codec->readList(samples, CONFIG_SENSOR_SAMPLES_MAX, count);
+        codec->read(factor);
+
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            m_handler->scale(samples, count, factor, scaled);
+            err = startReply(codec, messageFactory, transport, SensorSamples_interface::m_scaleId, sequence);
+        }
+
+        if (err == kErpcStatus_Success)
+        {
+            codec->writeList(scaled, count);
+            err = codec->getStatus();
+        }
+
+        return err;
+    }
+
+    erpc_status_t peak_shim(CodecT *codec, erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport,
+                            uint32_t sequence)
+    {
+        erpc_status_t err;
+        erpc::ListView<int16_t> samples;
+        int16_t result = 0;
+
+        codec->readListView(samples);
+
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            // The reply overwrites the buffer the view points into: call the handler first.
+            result = m_handler->peak(samples);
+            err = startReply(codec, messageFactory, transport, SensorSamples_interface::m_peakId, sequence);
+        }
+
+        if (err == kErpcStatus_Success)
+        {
+            codec->write(result);
+            err = codec->getStatus();
+        }
+
+        return err;
+    }
+
+    erpc_status_t checksum_shim(CodecT *codec, erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport,
+                                uint32_t sequence)
+    {
+        erpc_status_t err;
+        erpc::BinaryView chunk;
+        uint32_t result = 0;
+
+        erpc::readBinaryView(codec, chunk);
+
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            result = m_handler->checksum(chunk);
+            err = startReply(codec, messageFactory, transport, SensorSamples_interface::m_checksumId, sequence);
+        }
+
+        if (err == kErpcStatus_Success)
+        {
+            codec->write(result);
+            err = codec->getStatus();
+        }
+
+        return err;
+    }
+};
+
+} // erpcShim
+
+#endif // _SENSOR_SAMPLES_HPP_
@@ -0,0 +1,52 @@
+// sensor_samples_impl.cpp — SensorSamples handler used by the bench commands
+#include "sensor_samples.hpp"
+
+class SensorSamples_impl : public SensorSamples_interface
+{
+public:
+    int64_t sum(const int32_t *samples, uint32_t count) override
+    {
+        int64_t total = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            total += samples[i];
+        }
+        return total;
+    }
+
+    void scale(const float *samples, uint32_t count, float factor, float *scaled) override
+    {
+        for (uint32_t i = 0; i < count; ++i) {
+            scaled[i] = samples[i] * factor;
+        }
+    }
+
+    int16_t peak(const erpc::ListView<int16_t> &samples) override
+    {
+        int16_t peak = INT16_MIN;
+        for (uint32_t i = 0; i < samples.length; ++i) {
+            int16_t v = samples.at(i);
+            if (v > peak) {
+                peak = v;
+            }
+        }
+        return peak;
+    }
+
+    // Fletcher-32 style sum, enough to tell chunks apart.
+    uint32_t checksum(const erpc::BinaryView &chunk) override
+    {
+        uint32_t a = 1;
+        uint32_t b = 0;
+        for (uint32_t i = 0; i < chunk.length; ++i) {
+            a = (a + chunk.data[i]) % 65521U;
+            b = (b + a) % 65521U;
+        }
+        return (b << 16) | a;
+    }
+};
+
+SensorSamples_interface *get_sensor_samples_impl(void)
+{
+    static SensorSamples_impl impl;
+    return &impl;
+}
@@ -0,0 +1,352 @@
+// tcp_bench.cpp — native only, see tcp_bench.hpp
+#include "tcp_bench.hpp"
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+}
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace erpc;
+
+BenchMulService::BenchMulService(void)
+: Service(kServiceId)
+, m_workUs(0)
+, m_stallPercent(0)
+, m_stallUs(0)
+, m_calls(0)
+{
+}
+
+erpc_status_t BenchMulService::handleInvocation(uint32_t methodId, uint32_t sequence, Codec *codec,
+                                                MessageBufferFactory *messageFactory, Transport *transport)
+{
+    int32_t a = 0, b = 0;
+
+    if (methodId == kEchoId)
+    {
+        return handleEcho(sequence, codec, messageFactory, transport);
+    }
+    if (methodId != kMulId)
+    {
+        return kErpcStatus_InvalidArgument;
+    }
+    codec->read(a);
+    codec->read(b);
+    uint32_t call = __atomic_add_fetch(&m_calls, 1U, __ATOMIC_RELAXED);
+
+    uint32_t workUs = __atomic_load_n(&m_workUs, __ATOMIC_RELAXED);
+    uint32_t start = erpc_native_now_us();
+    while ((erpc_native_now_us() - start) < workUs)
+    {
+    }
+    // 37 is prime to 100: the stalled calls do not come in a row.
+    if ((call * 37U) % 100U < __atomic_load_n(&m_stallPercent, __ATOMIC_RELAXED))
+    {
+        usleep(__atomic_load_n(&m_stallUs, __ATOMIC_RELAXED));
+    }
+
+    erpc_status_t err = codec->getStatus();
+    if (err == kErpcStatus_Success)
+    {
+        err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(), transport->reserveHeaderSize());
+    }
+    if (err == kErpcStatus_Success)
+    {
+        codec->reset(transport->reserveHeaderSize());
+        codec->startWriteMessage(message_type_t::kReplyMessage, kServiceId, kMulId, sequence);
+        codec->write(a * b);
+        err = codec->getStatus();
+    }
+    return err;
+}
+
+erpc_status_t BenchMulService::handleEcho(uint32_t sequence, Codec *codec, MessageBufferFactory *messageFactory,
+                                          Transport *transport)
+{
+    // The reply is written over the request: keep the argument aside.
+    uint8_t copy[kEchoMax];
+    uint8_t *data = NULL;
+    uint32_t size = 0;
+
+    codec->readBinary(size, &data);
+    erpc_status_t err = codec->getStatus();
+    if ((err == kErpcStatus_Success) && (size > kEchoMax))
+    {
+        err = kErpcStatus_InvalidArgument;
+    }
+    if (err == kErpcStatus_Success)
+    {
+        memcpy(copy, data, size);
+        (void)__atomic_add_fetch(&m_calls, 1U, __ATOMIC_RELAXED);
+        err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(), transport->reserveHeaderSize());
+    }
+    if (err == kErpcStatus_Success)
+    {
+        codec->reset(transport->reserveHeaderSize());
+        codec->startWriteMessage(message_type_t::kReplyMessage, kServiceId, kEchoId, sequence);
+        codec->writeBinary(size, copy);
+        err = codec->getStatus();
+    }
+    return err;
+}
+
+TcpBenchServer::TcpBenchServer(void)
+: m_server(NULL)
+, m_replyCache(NULL)
+{
+}
+
+TcpBenchServer::~TcpBenchServer(void)
+{
+    stop();
+}
+
+erpc_status_t TcpBenchServer::start(uint16_t port, unsigned workers)
+{
+    static BasicCodecFactory s_codecFactory;
+    erpc_status_t err;
+
+    stop();
+    m_server = new NativeTcpServer();
+    m_server->setCodecFactory(&s_codecFactory);
+    m_server->setMessageBufferFactory(reinterpret_cast<MessageBufferFactory *>(erpc_mbf_dynamic_init()));
+    m_server->addService(&m_service);
+    m_server->setReplyCache(m_replyCache);
+
+    err = m_server->open(port);
+    if (err == kErpcStatus_Success)
+    {
+        err = m_server->start(workers, true);
+    }
+    if ((err == kErpcStatus_Success) && (pthread_create(&m_thread, NULL, runEntry, m_server) != 0))
+    {
+        err = kErpcStatus_InitFailed;
+    }
+    if (err != kErpcStatus_Success)
+    {
+        delete m_server;
+        m_server = NULL;
+    }
+    return err;
+}
+
+void TcpBenchServer::stop(void)
+{
+    if (m_server != NULL)
+    {
+        m_server->stop();
+        pthread_join(m_thread, NULL);
+        delete m_server;
+        m_server = NULL;
+    }
+}
+
+void *TcpBenchServer::runEntry(void *arg)
+{
+    (void)static_cast<NativeTcpServer *>(arg)->run();
+    return NULL;
+}
+
+TcpBenchClient::TcpBenchClient(MessageBufferFactory *messageFactory)
+{
+    m_transport.setCrc16(&m_crc);
+    m_manager.setTransport(&m_transport);
+    m_manager.setCodecFactory(&m_codecFactory);
+    m_manager.setMessageBufferFactory(messageFactory);
+}
+
+TcpBenchClient::~TcpBenchClient(void)
+{
+    if (m_transport.getSocket() >= 0)
+    {
+        ::close(m_transport.getSocket());
+    }
+}
+
+bool TcpBenchClient::connect(uint16_t port)
+{
+    int fd = bench_tcp_connect(port);
+    m_transport.setSocket(fd);
+    return fd >= 0;
+}
+
+erpc_status_t TcpBenchClient::mul(int32_t a, int32_t b, int32_t &result)
+{
+    return bench_mul(m_manager, a, b, result);
+}
+
+erpc_status_t TcpBenchClient::echo(const uint8_t *data, uint32_t size)
+{
+    erpc_status_t err;
+
+    RequestContext request = m_manager.createRequest(false);
+    Codec *codec = request.getCodec();
+
+    if (codec == NULL)
+    {
+        err = kErpcStatus_MemoryError;
+    }
+    else
+    {
+        codec->startWriteMessage(message_type_t::kInvocationMessage, BenchMulService::kServiceId,
+                                 BenchMulService::kEchoId, request.getSequence());
+        codec->writeBinary(size, data);
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            m_manager.performRequest(request);
+            uint8_t *reply = NULL;
+            uint32_t replySize = 0;
+            codec->readBinary(replySize, &reply);
+            err = codec->getStatus();
+            if ((err == kErpcStatus_Success) && ((replySize != size) || (memcmp(reply, data, size) != 0)))
+            {
+                err = kErpcStatus_Fail;
+            }
+        }
+    }
+
+    m_manager.releaseRequest(request);
+    return err;
+}
+
+erpc_status_t bench_mul(ClientManager &manager, int32_t a, int32_t b, int32_t &result)
+{
+    erpc_status_t err;
+
+    RequestContext request = manager.createRequest(false);
+    Codec *codec = request.getCodec();
+
+    if (codec == NULL)
+    {
+        err = kErpcStatus_MemoryError;
+    }
+    else
+    {
+        codec->startWriteMessage(message_type_t::kInvocationMessage, BenchMulService::kServiceId,
+                                 BenchMulService::kMulId, request.getSequence());
+        codec->write(a);
+        codec->write(b);
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            manager.performRequest(request);
+            codec->read(result);
+            err = codec->getStatus();
+        }
+    }
+
+    manager.releaseRequest(request);
+    return err;
+}
+
+TcpBenchPool::TcpBenchPool(MessageBufferFactory *messageFactory)
+{
+    m_pool.setCodecFactory(&m_codecFactory);
+    m_pool.setMessageBufferFactory(messageFactory);
+}
+
+TcpBenchPool::~TcpBenchPool(void)
+{
+    for (unsigned i = 0; i < kMaxConnections; ++i)
+    {
+        if (m_transports[i].getSocket() >= 0)
+        {
+            ::close(m_transports[i].getSocket());
+        }
+    }
+}
+
+bool TcpBenchPool::connect(uint16_t firstPort, unsigned endpoints, unsigned perEndpoint)
+{
+    unsigned count = 0;
+
+    for (unsigned e = 0; e < endpoints; ++e)
+    {
+        for (unsigned i = 0; i < perEndpoint; ++i, ++count)
+        {
+            if (count == kMaxConnections)
+            {
+                return false;
+            }
+            m_transports[count].setCrc16(&m_crc);
+            m_transports[count].setSocket(bench_tcp_connect(static_cast<uint16_t>(firstPort + e)));
+            if ((m_transports[count].getSocket() < 0) ||
+                (m_pool.addConnection(&m_transports[count], static_cast<uint8_t>(e)) != kErpcStatus_Success))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+LatencyLog::LatencyLog(uint32_t capacity)
+: m_samples(static_cast<uint32_t *>(malloc(capacity * sizeof(uint32_t))))
+, m_capacity((m_samples != NULL) ? capacity : 0U)
+, m_count(0)
+{
+    pthread_mutex_init(&m_lock, NULL);
+}
+
+LatencyLog::~LatencyLog(void)
+{
+    pthread_mutex_destroy(&m_lock);
+    free(m_samples);
+}
+
+void LatencyLog::add(uint32_t us)
+{
+    pthread_mutex_lock(&m_lock);
+    if (m_count < m_capacity)
+    {
+        m_samples[m_count++] = us;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+static int compareSamples(const void *a, const void *b)
+{
+    uint32_t x = *static_cast<const uint32_t *>(a);
+    uint32_t y = *static_cast<const uint32_t *>(b);
+    return (x > y) - (x < y);
+}
+
+uint32_t LatencyLog::percentile(unsigned percent)
+{
+    if (m_count == 0U)
+    {
+        return 0;
+    }
+    qsort(m_samples, m_count, sizeof(m_samples[0]), compareSamples);
+    uint32_t index = static_cast<uint32_t>((static_cast<uint64_t>(m_count) * percent + 99U) / 100U);
+    return m_samples[(index != 0U) ? (index - 1U) : 0U];
+}
+
+int bench_tcp_connect(uint16_t port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    sockaddr_in addr = {};
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
@@ -0,0 +1,192 @@
+// tcp_bench.hpp — native only: a multiply service on NativeTcpServer, blocking TCP clients and pools, latency percentiles
+#ifndef _TCP_BENCH_HPP_
+#define _TCP_BENCH_HPP_
+
+#include "client_pool.hpp"
+#include "native_clock.h"
+#include "native_tcp_server.hpp"
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_client_manager.h"
+
+#include <pthread.h>
+
+/*!
+ * @brief Service 13: mul(int32 a, int32 b) -> int32, after @p workUs of CPU time in the handler.
+ *
+ * Method 2, echo(binary) -> binary, answers with its argument and no work.
+ */
+class BenchMulService : public erpc::Service
+{
+public:
+    static const uint8_t kServiceId = 13;
+    static const uint8_t kMulId = 1;
+    static const uint8_t kEchoId = 2;
+
+    //! @brief Largest echo() argument, in bytes.
+    static const uint32_t kEchoMax = 192;
+
+    BenchMulService(void);
+
+    /*!
+     * @brief Busy time of each call from now on, in microseconds; 0 answers at once.
+     */
+    void setWorkUs(uint32_t workUs) { __atomic_store_n(&m_workUs, workUs, __ATOMIC_RELAXED); }
+
+    /*!
+     * @brief Sleep @p us microseconds more in @p percent of the calls from now on, spread evenly; 0 for none.
+     */
+    void setStall(uint32_t percent, uint32_t us)
+    {
+        __atomic_store_n(&m_stallUs, us, __ATOMIC_RELAXED);
+        __atomic_store_n(&m_stallPercent, percent, __ATOMIC_RELAXED);
+    }
+
+    /*!
+     * @brief Calls that reached the handler so far.
+     */
+    uint32_t getCalls(void) const { return __atomic_load_n(&m_calls, __ATOMIC_RELAXED); }
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, erpc::Codec *codec,
+                                           erpc::MessageBufferFactory *messageFactory,
+                                           erpc::Transport *transport) override;
+
+private:
+    erpc_status_t handleEcho(uint32_t sequence, erpc::Codec *codec, erpc::MessageBufferFactory *messageFactory,
+                             erpc::Transport *transport);
+
+    uint32_t m_workUs;
+    uint32_t m_stallPercent;
+    uint32_t m_stallUs;
+    uint32_t m_calls;
+};
+
+/*!
+ * @brief NativeTcpServer serving a BenchMulService on a port of the loopback, run() on a thread of its own.
+ */
+class TcpBenchServer
+{
+public:
+    TcpBenchServer(void);
+    ~TcpBenchServer(void);
+
+    /*!
+     * @brief Answer cached calls from @p cache from the next start() on; NULL for none.
+     */
+    void setReplyCache(ReplyCache *cache) { m_replyCache = cache; }
+
+    /*!
+     * @brief Listen on @p port, start @p workers pinned workers (0: one per core) and run.
+     */
+    erpc_status_t start(uint16_t port, unsigned workers);
+
+    /*!
+     * @brief Stop run() and the workers; the server can be started again.
+     */
+    void stop(void);
+
+    BenchMulService &service(void) { return m_service; }
+    NativeTcpServer *server(void) { return m_server; }
+
+private:
+    static void *runEntry(void *arg);
+
+    NativeTcpServer *m_server; /*!< Allocated per start(): the executor starts only once. */
+    BenchMulService m_service;
+    ReplyCache *m_replyCache;
+    pthread_t m_thread;
+};
+
+/*!
+ * @brief Call BenchMulService::mul through @p manager, as a generated client shim does.
+ */
+erpc_status_t bench_mul(erpc::ClientManager &manager, int32_t a, int32_t b, int32_t &result);
+
+/*!
+ * @brief One blocking client connection to a TcpBenchServer.
+ */
+class TcpBenchClient
+{
+public:
+    TcpBenchClient(erpc::MessageBufferFactory *messageFactory);
+    ~TcpBenchClient(void);
+
+    bool connect(uint16_t port);
+
+    erpc_status_t mul(int32_t a, int32_t b, int32_t &result);
+
+    /*!
+     * @brief Send @p size bytes of @p data to echo() and check that the same bytes come back.
+     */
+    erpc_status_t echo(const uint8_t *data, uint32_t size);
+
+    NativeSocketTransport &transport(void) { return m_transport; }
+
+private:
+    NativeSocketTransport m_transport;
+    erpc::Crc16 m_crc;
+    erpc::BasicCodecFactory m_codecFactory;
+    erpc::ClientManager m_manager;
+};
+
+/*!
+ * @brief ClientPool with connections to several TcpBenchServers, one endpoint per server.
+ */
+class TcpBenchPool
+{
+public:
+    static const unsigned kMaxConnections = CONFIG_ERPC_CLIENT_POOL_SIZE;
+
+    TcpBenchPool(erpc::MessageBufferFactory *messageFactory);
+    ~TcpBenchPool(void);
+
+    /*!
+     * @brief Open @p perEndpoint connections to each of the servers on @p firstPort .. @p firstPort + @p endpoints - 1.
+     */
+    bool connect(uint16_t firstPort, unsigned endpoints, unsigned perEndpoint);
+
+    ClientPool &pool(void) { return m_pool; }
+
+private:
+    ClientPool m_pool;
+    NativeSocketTransport m_transports[kMaxConnections];
+    erpc::Crc16 m_crc;
+    erpc::BasicCodecFactory m_codecFactory;
+};
+
+/*!
+ * @brief Call latencies of one run, in microseconds.
+ */
+class LatencyLog
+{
+public:
+    LatencyLog(uint32_t capacity);
+    ~LatencyLog(void);
+
+    /*!
+     * @brief Record one latency; thread safe, samples beyond the capacity are dropped.
+     */
+    void add(uint32_t us);
+
+    uint32_t count(void) const { return m_count; }
+
+    /*!
+     * @brief Latency that @p percent of the samples do not exceed; sorts the samples.
+     */
+    uint32_t percentile(unsigned percent);
+
+    void clear(void) { m_count = 0; }
+
+private:
+    uint32_t *m_samples;
+    uint32_t m_capacity;
+    uint32_t m_count;
+    pthread_mutex_t m_lock;
+};
+
+/*!
+ * @brief Connect to 127.0.0.1:@p port; the socket, or -1.
+ */
+int bench_tcp_connect(uint16_t port);
+
+#endif // _TCP_BENCH_HPP_
@@ -6,7 +6,10 @@
 #define ERPC_THREADS_THREADX  4
 #define ERPC_THREADS_MBED     5
 
+/* ERPC_THREADS_RIOT when built with the erpc_threading_riot module, which sets it */
+#ifndef ERPC_THREADS
 #define ERPC_THREADS         ERPC_THREADS_NONE
+#endif
 #define ERPC_HAS_MBED        0
 #define ERPC_NESTED_CALLS    0
 #define ERPC_MESSAGE_LOGGING 0
@@ -6,7 +6,7 @@ extern "C" {
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
-#include "erpc_framed_transport.hpp"
+#include "riot_framed_transport.hpp"
 
 using namespace erpc;
 
@@ -30,6 +30,13 @@ struct Ring {
 
     size_t avail() const { return (head + CAP - tail) % CAP; }            // bytes in buffer
     size_t space() const { return CAP - 1 - avail(); }                     // free space
+    size_t peek(uint8_t *dst, size_t n) const {
+        size_t got = 0;
+        for (size_t at = tail; got < n && at != head; at = (at + 1) % CAP) {
+            dst[got++] = buf[at];
+        }
+        return got;
+    }
     size_t read(uint8_t *dst, size_t n) {
         size_t got = 0;
         while (got < n && tail != head) {
@@ -52,18 +59,31 @@ struct Shared {
     mutex_t lock;
     Ring a2b; // bytes from endpoint A -> B
     Ring b2a; // bytes from endpoint B -> A
+    RiotFramedTransport *ends[2] = { nullptr, nullptr }; // A, B: told when the other end writes
     Shared() { mutex_init(&lock); }
 };
 
-class LoopbackEndpoint : public FramedTransport {
+class LoopbackEndpoint : public RiotFramedTransport {
 public:
     // dir=false => this is A (receives from b2a, sends to a2b)
     // dir=true  => this is B (receives from a2b, sends to b2a)
-    LoopbackEndpoint(Shared *sh, bool dirB) : _sh(sh), _dirB(dirB) {}
+    LoopbackEndpoint(Shared *sh, bool dirB) : _sh(sh), _dirB(dirB) { _sh->ends[_dirB] = this; }
     erpc_status_t init() { return kErpcStatus_Success; }
 
-
 protected:
+    // Bytes never leave RAM, so both endpoints negotiate CRC-less frames.
+    bool isReliable(void) const override { return true; }
+
+    // Lets a multi-transport server see whole frames without blocking.
+    int32_t underlyingPeek(uint8_t *data, uint32_t size) override {
+        mutex_lock(&_sh->lock);
+        Ring &in = _dirB ? _sh->a2b : _sh->b2a;
+        in.peek(data, size);
+        int32_t avail = static_cast<int32_t>(in.avail());
+        mutex_unlock(&_sh->lock);
+        return avail;
+    }
+
     erpc_status_t underlyingSend(const uint8_t *data, uint32_t size) override {
         uint32_t left = size;
         while (left) {
@@ -72,6 +92,8 @@ protected:
             size_t wrote = out.write(data + (size - left), left);
             mutex_unlock(&_sh->lock);
             left -= static_cast<uint32_t>(wrote);
+            RiotFramedTransport *peer = _sh->ends[!_dirB];
+            if (wrote && peer) peer->notifyRx();
             if (left) xtimer_usleep(1000); // 1ms backoff until peer drains
         }
         #if ERPC_LOOPBACK_LOG
@@ -3,6 +3,7 @@
 /* ---- RIOT C headers ---- */
 extern "C" {
 #include "thread.h"
+#include "periph/uart.h"
 
 /* eRPC setup C API */
 #include "erpc_client_setup.h"
@@ -18,16 +19,47 @@ extern "C" {
 extern "C" {
     void    initMultiplyService_client(erpc_client_t client);
     int32_t multiply_rpc(int32_t a, int32_t b);
+
+    /* per-thread clients (riot_client_shimp.cpp) */
+    typedef struct multiply_client *multiply_client_t;
+    multiply_client_t multiply_client_create(erpc_client_t client);
+    void    multiply_client_destroy(multiply_client_t handle);
+    int32_t multiply_client_call(multiply_client_t handle, int32_t a, int32_t b);
 }
 
 
 /* ---- Generated C++ server-side wrappers ---- */
 #include "multiply_demo_server.hpp"
 #include "multiply_demo_interface.hpp"
+#include "multiply_demo_typed.hpp"
+#include "erpc_simple_server.hpp"
+
+/* ---- Frame CRC engine selection (erpc_framing module) ---- */
+#include "erpc_crc16_fast.h"
+
+/* ---- Wire codec selection (erpc_codec_ext module) ---- */
+#include "erpc_codec_setup.h"
+
+/* ---- Pool server (erpc_server_ext module) ---- */
+#include "erpc_server_ext_setup.h"
+
+/* 1: run handlers on CONFIG_ERPC_POOL_WORKERS threads instead of the erpc_server thread */
+#ifndef CONFIG_MULTIPLY_POOL_SERVER
+#define CONFIG_MULTIPLY_POOL_SERVER 0
+#endif
+
+/* 1: the pool server also serves a peer on UART_DEV(CONFIG_MULTIPLY_UART_PEER_DEV); it must use the same codec */
+#ifndef CONFIG_MULTIPLY_UART_PEER
+#define CONFIG_MULTIPLY_UART_PEER 0
+#endif
+#ifndef CONFIG_MULTIPLY_UART_PEER_DEV
+#define CONFIG_MULTIPLY_UART_PEER_DEV 1
+#endif
 
 /* ---- Loopback transport factories (we wrote these) ---- */
 extern "C" void *erpc_loopback_create_A(void);
 extern "C" void *erpc_loopback_create_B(void);
+extern "C" void *riot_uart_transport_create(uart_t dev, uint32_t baud);
 
 /* ---- Your service implementation (from test_server_app.cpp) ---- */
 extern "C" erpcShim::MultiplyService_interface *get_multiply_impl(void);
@@ -52,13 +84,33 @@ static void *server_thread(void *arg)
     erpc_mbf_t mbf = g_mbf;
     if (!mbf) { puts("[server] ERROR: mbf not initialized"); return nullptr; }
 
+#if CONFIG_MULTIPLY_POOL_SERVER
+    erpc_server_t srv = erpc_server_pool_init((erpc_transport_t)t, mbf, THREAD_PRIORITY_MAIN - 1);
+#else
     erpc_server_t srv = erpc_server_init((erpc_transport_t)t, mbf);
+#endif
     if (!srv) { puts("[server] ERROR: server init failed"); return nullptr; }
+#if CONFIG_MULTIPLY_POOL_SERVER && CONFIG_MULTIPLY_UART_PEER
+    /* same services, replies go back over the UART */
+    void *uart = riot_uart_transport_create(UART_DEV(CONFIG_MULTIPLY_UART_PEER_DEV), 115200);
+    if (!uart || erpc_server_pool_add_transport(srv, (erpc_transport_t)uart) != kErpcStatus_Success) {
+        puts("[server] WARNING: UART peer not served");
+    }
+#endif
+#if CONFIG_MULTIPLY_TYPED_SHIMS
+    erpc::FinalCodecFactory<MultiplyTypedCodec>::install(reinterpret_cast<erpc::SimpleServer *>(srv));
+#else
+    erpc_server_set_codec(srv, CONFIG_MULTIPLY_CODEC);
+#endif
 
     /* Bind your C++ implementation to the generated C++ service wrapper */
     MultiplyService_interface *impl = get_multiply_impl();
     if (!impl) { puts("[server] ERROR: service impl null"); return nullptr; }
+#if CONFIG_MULTIPLY_TYPED_SHIMS
+    static MultiplyService_typed_service<MultiplyTypedCodec> service(impl);
+#else
     static MultiplyService_service service(impl);
+#endif
 
     /* Register the service with the C API */
     erpc_add_service_to_server(srv, reinterpret_cast<erpc_service_t>(&service));
@@ -90,12 +142,18 @@ static void *client_thread(void *arg)
 
     erpc_client_t cl = erpc_client_init((erpc_transport_t)t, mbf);
     if (!cl) { puts("[client] ERROR: client init failed"); return nullptr; }
-
-    /* Use your real client (provided via riot_client_shim.cpp or generated code) */
-    initMultiplyService_client(cl);
+#if !CONFIG_MULTIPLY_TYPED_SHIMS
+    /* the typed client installs its own codec factory */
+    erpc_client_set_codec(cl, CONFIG_MULTIPLY_CODEC);
+#endif
+
+    /* This thread's own client; another thread would create one on its own transport */
+    multiply_client_t mc = multiply_client_create(cl);
+    if (!mc) { puts("[client] ERROR: multiply client create failed"); return nullptr; }
     puts("[client] calling multiply...");
-    int32_t r = multiply_rpc(5, 28);
+    int32_t r = multiply_client_call(mc, 5, 28);
     std::printf("multiply(5, 28) = %ld\n", (long)r);
+    multiply_client_destroy(mc);
     return nullptr;
 }
 
@@ -103,6 +161,11 @@ int main(void)
 {
     puts("RIOT eRPC multiply (one-process loopback)");
 
+    /* pick the fastest frame CRC engine before any transport runs */
+    if (erpc_crc16_select(ERPC_CRC16_IMPL_HW) != kErpcStatus_Success) {
+        erpc_crc16_select(ERPC_CRC16_IMPL_SLICE);
+    }
+
     /* init single MBF for both threads */
     g_mbf = erpc_mbf_dynamic_init();
     if (!g_mbf) {
@@ -0,0 +1,152 @@
+// multiply_demo_typed.hpp — MultiplyService shims templated on the codec type
+//
+// Same wire behaviour as the generated multiply_demo_client/server shims, but
+// the codec is held as CodecT * instead of erpc::Codec *. With a final codec
+// (erpc::FinalBasicCodec, erpc::FinalCompactCodec) every field encode/decode
+// is inline. Keep in sync with multiply.erpc.
+#ifndef _MULTIPLY_DEMO_TYPED_HPP_
+#define _MULTIPLY_DEMO_TYPED_HPP_
+
+#include "erpc_client_manager.h"
+#include "erpc_codec_setup.h"
+#include "erpc_final_codec.hpp"
+#include "erpc_server.hpp"
+#include "multiply_demo_interface.hpp"
+
+#include <type_traits>
+
+/* 1: main.cpp and riot_client_shimp.cpp use the typed shims below instead of the generated ones */
+#ifndef CONFIG_MULTIPLY_TYPED_SHIMS
+#define CONFIG_MULTIPLY_TYPED_SHIMS 1
+#endif
+
+/* Both loopback ends run in this process, so they always agree on the codec */
+#ifndef CONFIG_MULTIPLY_CODEC
+#define CONFIG_MULTIPLY_CODEC ERPC_CODEC_COMPACT
+#endif
+
+namespace erpcShim
+{
+
+/* Codec of the typed shims: the final class of CONFIG_MULTIPLY_CODEC, so a UART peer sees the same wire format */
+typedef std::conditional<CONFIG_MULTIPLY_CODEC == ERPC_CODEC_BASIC, erpc::FinalBasicCodec,
+                         erpc::FinalCompactCodec>::type MultiplyTypedCodec;
+
+template <class CodecT>
+class MultiplyService_typed_client : public MultiplyService_interface
+{
+public:
+    // Installs the matching codec factory; the shim relies on it for its downcast.
+    MultiplyService_typed_client(erpc::ClientManager *manager)
+    : m_clientManager(manager)
+    {
+        erpc::FinalCodecFactory<CodecT>::install(manager);
+    }
+
+    virtual ~MultiplyService_typed_client() {}
+
+    virtual int32_t multiply(int32_t a, int32_t b)
+    {
+        erpc_status_t err;
+        int32_t result = 0;
+
+        erpc::RequestContext request = m_clientManager->createRequest(false);
+        CodecT *codec = static_cast<CodecT *>(request.getCodec());
+
+        if (codec == NULL)
+        {
+            err = kErpcStatus_MemoryError;
+        }
+        else
+        {
+            codec->startWriteMessage(erpc::message_type_t::kInvocationMessage, m_serviceId, m_multiplyId,
+                                     request.getSequence());
+            codec->write(a);
+            codec->write(b);
+
+            m_clientManager->performRequest(request);
+
+            codec->read(result);
+            err = codec->getStatus();
+        }
+
+        m_clientManager->releaseRequest(request);
+        m_clientManager->callErrorHandler(err, m_multiplyId);
+
+        if (err != kErpcStatus_Success)
+        {
+            result = -1;
+        }
+
+        return result;
+    }
+
+protected:
+    erpc::ClientManager *m_clientManager;
+};
+
+template <class CodecT>
+class MultiplyService_typed_service : public erpc::Service
+{
+public:
+    // The server must create CodecT codecs: call erpc::FinalCodecFactory<CodecT>::install() on it.
+    MultiplyService_typed_service(MultiplyService_interface *handler)
+    : erpc::Service(MultiplyService_interface::m_serviceId)
+    , m_handler(handler)
+    {
+    }
+
+    virtual ~MultiplyService_typed_service() {}
+
+    MultiplyService_interface *getHandler(void) { return m_handler; }
+
+    virtual erpc_status_t handleInvocation(uint32_t methodId, uint32_t sequence, erpc::Codec *codec,
+                                           erpc::MessageBufferFactory *messageFactory, erpc::Transport *transport)
+    {
+        switch (methodId)
+        {
+            case MultiplyService_interface::m_multiplyId:
+                return multiply_shim(static_cast<CodecT *>(codec), messageFactory, transport, sequence);
+            default:
+                return kErpcStatus_InvalidArgument;
+        }
+    }
+
+private:
+    MultiplyService_interface *m_handler;
+
+    erpc_status_t multiply_shim(CodecT *codec, erpc::MessageBufferFactory *messageFactory,
+                                erpc::Transport *transport, uint32_t sequence)
+    {
+        erpc_status_t err;
+        int32_t a;
+        int32_t b;
+        int32_t result = 0;
+
+        // startReadMessage() was already called before this shim was invoked.
+        codec->read(a);
+        codec->read(b);
+
+        err = codec->getStatus();
+        if (err == kErpcStatus_Success)
+        {
+            result = m_handler->multiply(a, b);
+            err = messageFactory->prepareServerBufferForSend(codec->getBufferRef(), transport->reserveHeaderSize());
+        }
+
+        if (err == kErpcStatus_Success)
+        {
+            codec->reset(transport->reserveHeaderSize());
+            codec->startWriteMessage(erpc::message_type_t::kReplyMessage, MultiplyService_interface::m_serviceId,
+                                     MultiplyService_interface::m_multiplyId, sequence);
+            codec->write(result);
+            err = codec->getStatus();
+        }
+
+        return err;
+    }
+};
+
+} // erpcShim
+
+#endif // _MULTIPLY_DEMO_TYPED_HPP_
@@ -3,11 +3,16 @@
 
 #include "erpc_manually_constructed.hpp"   // ERPC_MANUALLY_CONSTRUCTED_STATIC
 #include "multiply_demo_client.hpp"        // erpcShim::MultiplyService_client
+#include "multiply_demo_typed.hpp"         // erpcShim::MultiplyService_typed_client
 #include "erpc_client_manager.h"           // erpc::ClientManager (C++)
 #include "erpc_client_setup.h"             // erpc_client_t (C)
 #include "c_multiply_demo_client.h"        // C prototypes we must satisfy
 
+#if CONFIG_MULTIPLY_TYPED_SHIMS
+typedef erpcShim::MultiplyService_typed_client<erpcShim::MultiplyTypedCodec> MultiplyService_client;
+#else
 using erpcShim::MultiplyService_client;
+#endif
 using erpc::ClientManager;
 
 #if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
@@ -16,6 +21,19 @@ static MultiplyService_client *s_MultiplyService_client = nullptr;
 ERPC_MANUALLY_CONSTRUCTED_STATIC(MultiplyService_client, s_MultiplyService_client);
 #endif
 
+/* Clients of multiply_client_create() with the static allocation policy */
+#ifndef CONFIG_MULTIPLY_CLIENT_INSTANCES
+#define CONFIG_MULTIPLY_CLIENT_INSTANCES 4
+#endif
+
+#if ERPC_ALLOCATION_POLICY != ERPC_ALLOCATION_POLICY_DYNAMIC
+extern "C" {
+#include "mutex.h"
+}
+static erpc::ManuallyConstructed<MultiplyService_client> s_multiplyClients[CONFIG_MULTIPLY_CLIENT_INSTANCES];
+static mutex_t s_multiplyClientsLock = MUTEX_INIT;
+#endif
+
 extern "C" {
 
 // C API expected by your main.cpp
@@ -59,4 +77,58 @@ void deinitMultiplyService_client(void)
 #endif
 }
 
+/* Handle API: one client per thread, each on its own erpc_client_t, sharing nothing */
+
+typedef struct multiply_client *multiply_client_t;
+
+multiply_client_t multiply_client_create(erpc_client_t client)
+{
+    if (!client) return nullptr;
+    auto *mgr = reinterpret_cast<ClientManager *>(client);
+
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    return reinterpret_cast<multiply_client_t>(new MultiplyService_client(mgr));
+#else
+    MultiplyService_client *shim = nullptr;
+    mutex_lock(&s_multiplyClientsLock);
+    for (auto &slot : s_multiplyClients) {
+        if (!slot.isUsed()) {
+            slot.construct(mgr);
+            shim = slot.get();
+            break;
+        }
+    }
+    mutex_unlock(&s_multiplyClientsLock);
+    return reinterpret_cast<multiply_client_t>(shim);
+#endif
+}
+
+void multiply_client_destroy(multiply_client_t handle)
+{
+    auto *shim = reinterpret_cast<MultiplyService_client *>(handle);
+    if (!shim) return;
+
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    delete shim;
+#else
+    mutex_lock(&s_multiplyClientsLock);
+    for (auto &slot : s_multiplyClients) {
+        if (slot.isUsed() && slot.get() == shim) {
+            slot.destroy();
+            break;
+        }
+    }
+    mutex_unlock(&s_multiplyClientsLock);
+#endif
+}
+
+/* -1 on failure, as the shim returns after calling the client's error handler;
+ * a NULL handle (failed create) has no client, hence no handler to call. */
+int32_t multiply_client_call(multiply_client_t handle, int32_t a, int32_t b)
+{
+    auto *shim = reinterpret_cast<MultiplyService_client *>(handle);
+    if (!shim) return -1;
+    return shim->multiply(a, b);
+}
+
 } // extern "C"
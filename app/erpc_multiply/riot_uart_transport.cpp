@@ -1,20 +1,41 @@
 // riot_uart_transport.cpp — minimal, blocking transport for RIOT
 extern "C" {
+#include "mutex.h"
 #include "periph/uart.h"
+#include "thread.h"
+#include "tsrb.h"
 }
-#include "erpc_framed_transport.hpp"
+#include "riot_framed_transport.hpp"
 #include <cstdint>
 #include <cstdio>
 
 using namespace erpc;
 
-class RiotUartTransport : public FramedTransport {
+// RX ring size; must be a power of two and hold at least one whole frame burst
+#ifndef CONFIG_MULTIPLY_UART_RX_BUF
+#define CONFIG_MULTIPLY_UART_RX_BUF 256
+#endif
+
+class RiotUartTransport : public RiotFramedTransport {
 public:
-    RiotUartTransport(uart_t dev, uint32_t baud) : _dev(dev), _baud(baud) {}
+    RiotUartTransport(uart_t dev, uint32_t baud) : _dev(dev), _baud(baud) {
+        tsrb_init(&_rx, _rxBuf, sizeof(_rxBuf));
+        mutex_init(&_rxReady);
+        mutex_lock(&_rxReady); // released whenever a byte is buffered
+    }
 
     erpc_status_t init() {
-        // No RX callback: we do simple blocking reads via getchar() on native
+#ifdef CPU_NATIVE
+        // On BOARD=native, UART0 maps to stdio: a thread feeds getchar() into the ring
         int rc = uart_init(_dev, _baud, nullptr, nullptr);
+        if (rc == 0 && thread_create(_readerStack, sizeof(_readerStack), THREAD_PRIORITY_MAIN - 1,
+                                     THREAD_CREATE_STACKTEST, stdio_reader, this, "uart_stdio") < 0) {
+            rc = -1;
+        }
+#else
+        // Buffer RX bytes from the interrupt, so hasMessage() can peek without blocking
+        int rc = uart_init(_dev, _baud, rx_cb, this);
+#endif
         return (rc == 0) ? kErpcStatus_Success : kErpcStatus_Fail;
     }
 
@@ -29,18 +50,51 @@ protected:
     }
 
     erpc_status_t underlyingReceive(uint8_t *data, uint32_t size) override {
-        // On BOARD=native, UART0 maps to stdio → use getchar() blocking
+        // Block until enough bytes have been buffered
         for (uint32_t i = 0; i < size; ++i) {
             int c;
-            do { c = std::getchar(); } while (c == EOF);
+            while ((c = tsrb_get_one(&_rx)) < 0) {
+                mutex_lock(&_rxReady);
+            }
             data[i] = static_cast<uint8_t>(c);
         }
         return kErpcStatus_Success;
     }
 
+    // Lets a multi-transport server see whole frames without blocking.
+    int32_t underlyingPeek(uint8_t *data, uint32_t size) override {
+        tsrb_peek(&_rx, data, size);
+        return static_cast<int32_t>(tsrb_avail(&_rx));
+    }
+
 private:
+    void add_byte(uint8_t data) {
+        tsrb_add_one(&_rx, data); // dropped when full; the frame CRC catches it
+        mutex_unlock(&_rxReady);
+        notifyRx();
+    }
+
+    static void rx_cb(void *arg, uint8_t data) {
+        static_cast<RiotUartTransport *>(arg)->add_byte(data);
+    }
+
+#ifdef CPU_NATIVE
+    static void *stdio_reader(void *arg) {
+        RiotUartTransport *self = static_cast<RiotUartTransport *>(arg);
+        int c;
+        while ((c = std::getchar()) != EOF) {
+            self->add_byte(static_cast<uint8_t>(c));
+        }
+        return nullptr; // stdin closed: nothing will arrive any more
+    }
+
+    char     _readerStack[THREAD_STACKSIZE_DEFAULT];
+#endif
     uart_t   _dev;
     uint32_t _baud;
+    tsrb_t   _rx;
+    uint8_t  _rxBuf[CONFIG_MULTIPLY_UART_RX_BUF];
+    mutex_t  _rxReady;
 };
 
 // C factory used by main.cpp
@@ -0,0 +1,141 @@
+// Calculator calls as C++20 coroutines: many co_await calc.add() on one thread through AsyncClientManager::run().
+//
+// The Calculator server runs in the same process on NativeTcpServer, so the
+// app checks itself: every result must be right and every coroutine must
+// finish. It ends with "async: OK" or "async: FAILED".
+#include <cstdio>
+#include <pthread.h>
+
+extern "C" {
+#include "erpc_mbf_setup.h"
+#include "erpc_server_setup.h"
+}
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_server_ext_setup.h"
+
+#include "calc_async.hpp"
+#include "calculator_server.hpp"
+
+#if !ERPC_ASYNC_HAVE_COROUTINES
+#error "erpc_calculator_async needs a compiler with C++20 coroutines"
+#endif
+
+/* coroutines started at once, each awaiting one add() after another */
+#ifndef CONFIG_CALC_ASYNC_TASKS
+#define CONFIG_CALC_ASYNC_TASKS 2000
+#endif
+
+/* add() calls each coroutine awaits */
+#ifndef CONFIG_CALC_ASYNC_ADDS
+#define CONFIG_CALC_ASYNC_ADDS 5
+#endif
+
+/* TCP connections the calls are spread over */
+#ifndef CONFIG_CALC_ASYNC_CONNECTIONS
+#define CONFIG_CALC_ASYNC_CONNECTIONS 4
+#endif
+
+#ifndef CONFIG_CALC_ASYNC_PORT
+#define CONFIG_CALC_ASYNC_PORT 50052
+#endif
+
+#if CONFIG_CALC_ASYNC_CONNECTIONS > CONFIG_ERPC_ASYNC_CONNECTIONS
+#error "CONFIG_CALC_ASYNC_CONNECTIONS exceeds CONFIG_ERPC_ASYNC_CONNECTIONS"
+#endif
+
+using namespace erpcShim;
+
+// Quiet implementation: thousands of calls would flood the console
+class Calculator_impl : public Calculator_interface {
+public:
+    int32_t add(int32_t a, int32_t b) override { return a + b; }
+    int32_t subtract(int32_t a, int32_t b) override { return a - b; }
+    int32_t multiply(int32_t a, int32_t b) override { return a * b; }
+    float divide(int32_t a, int32_t b) override { return b != 0 ? (float)a / b : 0.0f; }
+};
+
+static unsigned s_finished;
+static unsigned s_wrong;
+
+// Running sum of @p task + 1, ..., @p task + CONFIG_CALC_ASYNC_ADDS, one awaited add() per step.
+static AsyncTask sumTask(CalculatorAsync &calc, int32_t task)
+{
+    int32_t sum = 0;
+    int32_t expected = 0;
+
+    for (int32_t i = 1; i <= CONFIG_CALC_ASYNC_ADDS; ++i) {
+        sum = co_await calc.add(sum, task + i);
+        expected += task + i;
+    }
+    if (sum != expected) {
+        ++s_wrong;
+    }
+    ++s_finished;
+}
+
+static void *serverThread(void *arg)
+{
+    (void)erpc_server_run(static_cast<erpc_server_t>(arg));
+    return NULL;
+}
+
+int main(void)
+{
+    std::puts("eRPC Calculator async client (native, C++20)");
+
+    erpc_mbf_t mbf = erpc_mbf_dynamic_init();
+    if (!mbf) {
+        std::puts("[async] ERROR: mbf init failed");
+        return 1;
+    }
+
+    /* server: listening once created, serving from its own thread */
+    erpc_server_t srv = erpc_server_native_tcp_init(CONFIG_CALC_ASYNC_PORT, mbf, 2, false);
+    if (!srv) {
+        std::puts("[async] ERROR: server init failed");
+        return 1;
+    }
+    static Calculator_impl impl;
+    static Calculator_service service(&impl);
+    erpc_add_service_to_server(srv, reinterpret_cast<void *>(&service));
+    pthread_t server;
+    if (pthread_create(&server, NULL, serverThread, srv) != 0) {
+        std::puts("[async] ERROR: server thread failed");
+        return 1;
+    }
+
+    /* client: one thread, many connections */
+    static erpc::BasicCodecFactory codecFactory;
+    static AsyncClientManager client;
+    client.setCodecFactory(&codecFactory);
+    client.setMessageBufferFactory(reinterpret_cast<erpc::MessageBufferFactory *>(mbf));
+    unsigned failures = 0;
+    for (unsigned c = 0; c < CONFIG_CALC_ASYNC_CONNECTIONS; ++c) {
+        if (client.connect("127.0.0.1", CONFIG_CALC_ASYNC_PORT) != kErpcStatus_Success) {
+            std::printf("[async] ERROR: connection %u failed\n", c);
+            ++failures;
+        }
+    }
+
+    if (failures == 0) {
+        CalculatorAsync calc(client);
+
+        /* each runs up to its first co_await and leaves its call queued */
+        for (int32_t t = 0; t < CONFIG_CALC_ASYNC_TASKS; ++t) {
+            sumTask(calc, t);
+        }
+        std::printf("[async] %u coroutines, %u calls outstanding\n", (unsigned)CONFIG_CALC_ASYNC_TASKS,
+                    client.getOutstandingCount());
+        client.run();
+        std::printf("[async] %u of %u coroutines finished, %u wrong sums\n", s_finished,
+                    (unsigned)CONFIG_CALC_ASYNC_TASKS, s_wrong);
+        failures += (CONFIG_CALC_ASYNC_TASKS - s_finished) + s_wrong;
+    }
+
+    erpc_server_stop(srv);
+    pthread_join(server, NULL);
+
+    std::printf("async: %s\n", (failures == 0) ? "OK" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#ifndef _CALC_ASYNC_HPP_
+#define _CALC_ASYNC_HPP_
+
+#include "async_coro.hpp"
+#include "calculator_interface.hpp"
+
+#if ERPC_ASYNC_HAVE_COROUTINES
+
+/*!
+ * @brief Calculator calls to co_await on an AsyncClientManager (native, C++20).
+ *
+ * Same service and method ids, encoding and error reporting as the generated
+ * Calculator_client, but each call suspends the calling coroutine instead of
+ * blocking the thread:
+ *
+ * @code
+ * AsyncTask work(CalculatorAsync &calc)
+ * {
+ *     int32_t sum = co_await calc.add(42, 7);
+ *     float quotient = co_await calc.divide(sum, 7);
+ * }
+ * @endcode
+ */
+class CalculatorAsync {
+public:
+    explicit CalculatorAsync(AsyncClientManager &client) : m_client(client) {}
+
+    auto add(int32_t a, int32_t b) { return asyncCall<int32_t>(m_client, Ids::m_serviceId, Ids::m_addId, a, b); }
+
+    auto subtract(int32_t a, int32_t b)
+    {
+        return asyncCall<int32_t>(m_client, Ids::m_serviceId, Ids::m_subtractId, a, b);
+    }
+
+    auto multiply(int32_t a, int32_t b)
+    {
+        return asyncCall<int32_t>(m_client, Ids::m_serviceId, Ids::m_multiplyId, a, b);
+    }
+
+    auto divide(int32_t a, int32_t b) { return asyncCall<float>(m_client, Ids::m_serviceId, Ids::m_divideId, a, b); }
+
+private:
+    typedef erpcShim::Calculator_interface Ids;
+
+    AsyncClientManager &m_client;
+};
+
+#endif /* ERPC_ASYNC_HAVE_COROUTINES */
+
+#endif /* _CALC_ASYNC_HPP_ */
@@ -0,0 +1,91 @@
+// calc_client.cpp — handle-based C API with prepared, typed Calculator calls
+#include "calc_client.h"
+#include "calculator_typed.hpp"
+#include "erpc_manually_constructed.hpp"
+
+#if ERPC_ALLOCATION_POLICY != ERPC_ALLOCATION_POLICY_DYNAMIC
+extern "C" {
+#include "mutex.h"
+}
+#endif
+
+using namespace erpc;
+using namespace erpcShim;
+
+#if CONFIG_CALC_TYPED_SHIMS
+typedef Calculator_typed_client<CalculatorTypedCodec> CalculatorPrepared;
+#else
+typedef Calculator_typed_client<Codec> CalculatorPrepared;
+#endif
+
+#if ERPC_ALLOCATION_POLICY != ERPC_ALLOCATION_POLICY_DYNAMIC
+static ManuallyConstructed<CalculatorPrepared> s_calcClients[CONFIG_CALC_CLIENT_INSTANCES];
+static mutex_t s_calcClientsLock = MUTEX_INIT; /* Guards taking and returning slots only; calls never lock. */
+#endif
+
+static inline CalculatorPrepared *calc_shim(calc_client_t calc)
+{
+    return reinterpret_cast<CalculatorPrepared *>(calc);
+}
+
+calc_client_t calc_client_create(erpc_client_t client)
+{
+    if (client == NULL) {
+        return NULL;
+    }
+    ClientManager *manager = reinterpret_cast<ClientManager *>(client);
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    return reinterpret_cast<calc_client_t>(new CalculatorPrepared(manager));
+#else
+    CalculatorPrepared *shim = NULL;
+    mutex_lock(&s_calcClientsLock);
+    for (unsigned i = 0; i < CONFIG_CALC_CLIENT_INSTANCES; ++i) {
+        if (!s_calcClients[i].isUsed()) {
+            s_calcClients[i].construct(manager);
+            shim = s_calcClients[i].get();
+            break;
+        }
+    }
+    mutex_unlock(&s_calcClientsLock);
+    return reinterpret_cast<calc_client_t>(shim);
+#endif
+}
+
+void calc_client_destroy(calc_client_t calc)
+{
+    if (calc == NULL) {
+        return;
+    }
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    delete calc_shim(calc);
+#else
+    mutex_lock(&s_calcClientsLock);
+    for (unsigned i = 0; i < CONFIG_CALC_CLIENT_INSTANCES; ++i) {
+        if (s_calcClients[i].isUsed() && (s_calcClients[i].get() == calc_shim(calc))) {
+            s_calcClients[i].destroy();
+            break;
+        }
+    }
+    mutex_unlock(&s_calcClientsLock);
+#endif
+}
+
+int32_t calc_add(calc_client_t calc, int32_t a, int32_t b)
+{
+    return calc_shim(calc)->add(a, b);
+}
+
+int32_t calc_subtract(calc_client_t calc, int32_t a, int32_t b)
+{
+    return calc_shim(calc)->subtract(a, b);
+}
+
+int32_t calc_multiply(calc_client_t calc, int32_t a, int32_t b)
+{
+    return calc_shim(calc)->multiply(a, b);
+}
+
+float calc_divide(calc_client_t calc, int32_t a, int32_t b)
+{
+    return calc_shim(calc)->divide(a, b);
+}
@@ -0,0 +1,70 @@
+#ifndef _CALC_CLIENT_H_
+#define _CALC_CLIENT_H_
+
+#include <stdint.h>
+#include "erpc_client_setup.h"
+
+/*!
+ * @brief Calculator clients that can exist at once with ERPC_ALLOCATION_POLICY_STATIC.
+ *
+ * With the dynamic policy they are allocated and there is no limit.
+ */
+#ifndef CONFIG_CALC_CLIENT_INSTANCES
+#define CONFIG_CALC_CLIENT_INSTANCES 4
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Handle of one Calculator client.
+ *
+ * Unlike the generated C functions (add(), subtract(), ...), which share the
+ * one client set up by initCalculator_client(), every handle has its own
+ * client shim on the eRPC client it was created with. That shim encodes the
+ * message header of each method once, when the handle is created, and per
+ * call only the sequence number and arguments (see PreparedCall). With
+ * CONFIG_CALC_TYPED_SHIMS (the default) it holds its codec as
+ * erpc::FinalBasicCodec, so arguments and results are encoded without virtual
+ * calls (calculator_typed.hpp). Give each thread its own handle on its own erpc_client_t (e.g. from erpc_client_init() on its
+ * own transport, or erpc_client_pool_checkout()) and the threads share no
+ * state when calling.
+ */
+typedef struct calc_client *calc_client_t;
+
+/*!
+ * @brief Create a Calculator client calling through @p client.
+ *
+ * @return Handle, or NULL if @p client is NULL or, with the static allocation
+ *         policy, CONFIG_CALC_CLIENT_INSTANCES handles exist.
+ */
+calc_client_t calc_client_create(erpc_client_t client);
+
+/*!
+ * @brief Destroy a handle from calc_client_create(); @p client is left as it is.
+ */
+void calc_client_destroy(calc_client_t calc);
+
+/*!
+ * @name Calculator calls on one handle
+ *
+ * Same results, error reporting and bytes on the wire as the generated
+ * functions of the same names: the client's error handler is called, and -1
+ * returned, on failure.
+ */
+//@{
+int32_t calc_add(calc_client_t calc, int32_t a, int32_t b);
+
+int32_t calc_subtract(calc_client_t calc, int32_t a, int32_t b);
+
+int32_t calc_multiply(calc_client_t calc, int32_t a, int32_t b);
+
+float calc_divide(calc_client_t calc, int32_t a, int32_t b);
+//@}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _CALC_CLIENT_H_ */
@@ -0,0 +1,123 @@
+// calculator_typed.hpp — Calculator client shim templated on the codec type
+//
+// Same wire behaviour as the generated Calculator_client, except that each
+// method's header is encoded once in the constructor (PreparedCall) and the
+// codec is held as CodecT * instead of erpc::Codec *. With a final codec
+// (erpc::FinalBasicCodec) every argument and result is encoded and decoded
+// inline. Keep in sync with calculator.erpc.
+#ifndef _CALCULATOR_TYPED_HPP_
+#define _CALCULATOR_TYPED_HPP_
+
+#include "calculator_interface.hpp"
+#include "erpc_final_codec.hpp"
+#include "prepared_call.hpp"
+
+/* 1: calc_client_create() hands out Calculator_typed_client<CalculatorTypedCodec>, else the same shim via erpc::Codec * */
+#ifndef CONFIG_CALC_TYPED_SHIMS
+#define CONFIG_CALC_TYPED_SHIMS 1
+#endif
+
+namespace erpcShim
+{
+
+/* Codec of the typed shim; wire compatible with the BasicCodec of the stock Calculator server */
+typedef erpc::FinalBasicCodec CalculatorTypedCodec;
+
+template <class CodecT>
+class Calculator_typed_client : public Calculator_interface
+{
+public:
+    // A final CodecT gets its codec factory installed first: the shim relies on it for its downcast.
+    Calculator_typed_client(erpc::ClientManager *manager)
+    {
+        installCodec(manager, static_cast<CodecT *>(NULL));
+        // Failing leaves a call encoding its header every time.
+        (void)m_add.prepare(manager, m_serviceId, m_addId);
+        (void)m_subtract.prepare(manager, m_serviceId, m_subtractId);
+        (void)m_multiply.prepare(manager, m_serviceId, m_multiplyId);
+        (void)m_divide.prepare(manager, m_serviceId, m_divideId);
+    }
+
+    virtual ~Calculator_typed_client() {}
+
+    virtual int32_t add(int32_t a, int32_t b) { return invoke<int32_t>(m_add, a, b); }
+
+    virtual int32_t subtract(int32_t a, int32_t b) { return invoke<int32_t>(m_subtract, a, b); }
+
+    virtual int32_t multiply(int32_t a, int32_t b) { return invoke<int32_t>(m_multiply, a, b); }
+
+    virtual float divide(int32_t a, int32_t b) { return invoke<float>(m_divide, a, b); }
+
+private:
+    // erpc::Codec: keep whatever codec the client was set up with.
+    static void installCodec(erpc::ClientManager *manager, erpc::Codec *) { (void)manager; }
+
+    template <class FinalT>
+    static void installCodec(erpc::ClientManager *manager, FinalT *)
+    {
+        erpc::FinalCodecFactory<FinalT>::install(manager);
+    }
+
+    template <typename R>
+    static R invoke(PreparedCall &call, int32_t a, int32_t b)
+    {
+        erpc_status_t err;
+        erpc::ClientManager *manager = call.getClient();
+
+        R result = R();
+
+#if ERPC_PRE_POST_ACTION
+        pre_post_action_cb preCB = manager->getPreCB();
+        if (preCB)
+        {
+            preCB();
+        }
+#endif
+
+        erpc::RequestContext request = call.begin();
+        CodecT *codec = static_cast<CodecT *>(request.getCodec());
+
+        if (codec == NULL)
+        {
+            err = kErpcStatus_MemoryError;
+        }
+        else
+        {
+            codec->write(a);
+            codec->write(b);
+
+            // Codec status is checked inside this function.
+            call.perform(request);
+
+            codec->read(result);
+            err = codec->getStatus();
+        }
+
+        call.end(request);
+        manager->callErrorHandler(err, call.getMethodId());
+
+#if ERPC_PRE_POST_ACTION
+        pre_post_action_cb postCB = manager->getPostCB();
+        if (postCB)
+        {
+            postCB();
+        }
+#endif
+
+        if (err != kErpcStatus_Success)
+        {
+            result = -1;
+        }
+
+        return result;
+    }
+
+    PreparedCall m_add;
+    PreparedCall m_subtract;
+    PreparedCall m_multiply;
+    PreparedCall m_divide;
+};
+
+} // erpcShim
+
+#endif // _CALCULATOR_TYPED_HPP_
@@ -1,6 +1,6 @@
-// Simple C-style eRPC client using generated C client wrappers.
+// Simple C-style eRPC client using the handle-based Calculator C API (calc_client.h).
 #include <stdio.h>
-#include "c_calculator_client.h"
+#include "calc_client.h"
 #include "riot_uart_transport.hpp"
 #include "erpc_client_setup.h"
 #include "erpc_mbf_setup.h"
@@ -33,8 +33,14 @@ int main(void)
         return 1;
     }
 
-    // Initialize generated C client wrapper
-    initCalculator_client(client);
+    // Calculator client of this thread; further threads create their own on their own clients
+    calc_client_t calc = calc_client_create(client);
+    if (!calc) {
+        printf("Failed to create Calculator client\n");
+        erpc_client_deinit(client);
+        erpc_mbf_dynamic_deinit(mbf);
+        return 1;
+    }
 
     printf("eRPC Calculator Client starting...\n");
 
@@ -43,21 +49,21 @@ int main(void)
 
     printf("Testing remote calculations with a=%d, b=%d\n", a, b);
 
-    // Use generated C client functions. They return results directly.
-    int32_t sum = add(a, b);
+    // Calls on the handle return results directly, as the generated C functions do.
+    int32_t sum = calc_add(calc, a, b);
     printf("Remote add result: %d\n", sum);
 
-    int32_t diff = subtract(a, b);
+    int32_t diff = calc_subtract(calc, a, b);
     printf("Remote subtract result: %d\n", diff);
 
-    int32_t product = multiply(a, b);
+    int32_t product = calc_multiply(calc, a, b);
     printf("Remote multiply result: %d\n", product);
 
-    float quotient = divide(a, b);
+    float quotient = calc_divide(calc, a, b);
     printf("Remote divide result: %f\n", quotient);
 
     // Cleanup
-    deinitCalculator_client();
+    calc_client_destroy(calc);
     erpc_client_deinit(client);
     erpc_mbf_dynamic_deinit(mbf);
 
@@ -3,7 +3,7 @@
 #include <cstdio>
 
 RiotUartTransport::RiotUartTransport(uart_t uart_dev)
-    : FramedTransport(), m_uart_dev(uart_dev)
+    : RiotFramedTransport(), m_uart_dev(uart_dev)
 {
 }
 
@@ -13,7 +13,11 @@ RiotUartTransport::~RiotUartTransport()
 
 erpc_status_t RiotUartTransport::init(void)
 {
+#if CONFIG_RIOT_UART_FLOW_WINDOW
+    return enableFlowControl(CONFIG_RIOT_UART_FLOW_WINDOW);
+#else
     return kErpcStatus_Success;
+#endif
 }
 
 erpc_status_t RiotUartTransport::underlyingReceive(uint8_t *data, uint32_t size)
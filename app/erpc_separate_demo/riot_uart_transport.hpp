@@ -1,14 +1,25 @@
 #ifndef _RIOT_UART_TRANSPORT_HPP_
 #define _RIOT_UART_TRANSPORT_HPP_
 
-#include "erpc_framed_transport.hpp"
+#include "riot_framed_transport.hpp"
 #include "erpc_message_buffer.hpp"
 #include "periph/uart.h"
 
+/*!
+ * @brief Receive window advertised to the peer, in bytes; 0 disables flow control.
+ *
+ * Set it to the free space of the UART RX buffer (minus a few 14 byte control
+ * frames). Both ends must use flow control, and init() blocks until the peer
+ * has advertised its window.
+ */
+#ifndef CONFIG_RIOT_UART_FLOW_WINDOW
+#define CONFIG_RIOT_UART_FLOW_WINDOW 0
+#endif
+
 /*!
  * @brief RIOT UART transport that uses UART peripheral driver.
  */
-class RiotUartTransport : public erpc::FramedTransport {
+class RiotUartTransport : public RiotFramedTransport {
 public:
     RiotUartTransport(uart_t uart_dev);
     virtual ~RiotUartTransport();
@@ -6,6 +6,23 @@ extern "C" {
 #include "periph/uart.h"
 }
 
+/* Multi-connection TCP server on a work-stealing pool (erpc_server_ext module) */
+#include "erpc_server_ext_setup.h"
+
+/* 1: serve many TCP clients on CONFIG_CALCULATOR_WORKERS threads (native only), 0: stock single-connection server */
+#ifndef CONFIG_CALCULATOR_STEAL_SERVER
+#define CONFIG_CALCULATOR_STEAL_SERVER 0
+#endif
+
+#if CONFIG_CALCULATOR_STEAL_SERVER && !defined(CPU_NATIVE)
+#error "CONFIG_CALCULATOR_STEAL_SERVER needs BOARD=native or native64"
+#endif
+
+/* worker threads of the stealing server, 0 for one per core */
+#ifndef CONFIG_CALCULATOR_WORKERS
+#define CONFIG_CALCULATOR_WORKERS 0
+#endif
+
 /* Generated C++ service wrapper */
 #include "calculator_server.hpp"
 #include "calculator_interface.hpp"
@@ -40,13 +57,6 @@ int main(void)
 {
     std::puts("eRPC Calculator server (native)");
 
-    /* create TCP transport for host-to-host RPC */
-    erpc_transport_t transport = erpc_transport_tcp_init("0.0.0.0", 50051, true);
-    if (!transport) {
-        std::puts("[server] ERROR: TCP transport create failed");
-        return 1;
-    }
-
     /* init MBF */
     erpc_mbf_t mbf = erpc_mbf_dynamic_init();
     if (!mbf) {
@@ -54,8 +64,20 @@ int main(void)
         return 1;
     }
 
+#if CONFIG_CALCULATOR_STEAL_SERVER
+    /* listen on the same port, workers pinned to cores */
+    erpc_server_t srv = erpc_server_native_tcp_init(50051, mbf, CONFIG_CALCULATOR_WORKERS, true);
+#else
+    /* create TCP transport for host-to-host RPC */
+    erpc_transport_t transport = erpc_transport_tcp_init("0.0.0.0", 50051, true);
+    if (!transport) {
+        std::puts("[server] ERROR: TCP transport create failed");
+        return 1;
+    }
+
     /* init server (cast transport to erpc_transport_t as examples do) */
     erpc_server_t srv = erpc_server_init((erpc_transport_t)transport, mbf);
+#endif
     if (!srv) {
         std::puts("[server] ERROR: server init failed");
         return 1;
@@ -0,0 +1,391 @@
+// async_client.cpp — event-loop ClientManager with many outstanding calls over TCP (native only)
+#include "async_client.hpp"
+#include "erpc_status_reply.hpp"
+#include "native_clock.h"
+
+#include <arpa/inet.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace erpc;
+
+AsyncClientManager::AsyncClientManager(void)
+: ClientManager()
+, m_count(0)
+, m_queued(0)
+, m_sent(0)
+, m_timeoutUs(1000000)
+, m_stop(false)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_ASYNC_CONNECTIONS; ++i) {
+        m_connections[i].m_inflight = 0;
+        m_connections[i].m_open = false;
+    }
+    memset(m_calls, 0, sizeof(m_calls));
+    m_queue.m_head = m_queue.m_tail = NULL;
+    m_wire.m_head = m_wire.m_tail = NULL;
+}
+
+AsyncClientManager::~AsyncClientManager(void)
+{
+    for (unsigned i = 0; i < m_count; ++i) {
+        if (m_connections[i].m_transport.getSocket() >= 0) {
+            ::close(m_connections[i].m_transport.getSocket());
+        }
+    }
+    if (m_spare.get() != NULL) {
+        m_messageFactory->dispose(&m_spare);
+    }
+}
+
+erpc_status_t AsyncClientManager::addConnection(int fd)
+{
+    if ((fd < 0) || (m_codecFactory == NULL) || (m_messageFactory == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    if (m_count == CONFIG_ERPC_ASYNC_CONNECTIONS) {
+        return kErpcStatus_MemoryError;
+    }
+    int yes = 1;
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    Connection &conn = m_connections[m_count];
+    conn.m_transport.setCrc16(&m_crc);
+    conn.m_transport.setSocket(fd);
+    conn.m_inflight = 0;
+    conn.m_open = true;
+    if (m_count == 0U) {
+        // createRequest() and verifyReply() take the header size from here.
+        setTransport(&conn.m_transport);
+    }
+    ++m_count;
+    return kErpcStatus_Success;
+}
+
+erpc_status_t AsyncClientManager::connect(const char *host, uint16_t port)
+{
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if ((host == NULL) || (inet_pton(AF_INET, host, &addr.sin_addr) != 1)) {
+        return kErpcStatus_ConnectionFailure;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return kErpcStatus_ConnectionFailure;
+    }
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return kErpcStatus_ConnectionFailure;
+    }
+    erpc_status_t err = addConnection(fd);
+    if (err != kErpcStatus_Success) {
+        ::close(fd);
+    }
+    return err;
+}
+
+erpc_status_t AsyncClientManager::start(AsyncCall &call, RequestContext &request)
+{
+    Codec *codec = request.getCodec();
+    if ((codec == NULL) || !codec->isStatusOk()) {
+        return kErpcStatus_InvalidArgument;
+    }
+    bool open = false;
+    for (unsigned i = 0; (i < m_count) && !open; ++i) {
+        open = m_connections[i].m_open;
+    }
+    if (!open) {
+        return kErpcStatus_ConnectionClosed;
+    }
+
+    // Only queued here: completions, and so coroutine resumptions, happen in poll() alone.
+    call.m_codec = codec;
+    call.m_sequence = request.getSequence();
+    call.m_isOneway = request.isOneway();
+    call.m_startedAt = erpc_native_now_us();
+    call.m_conn = NULL;
+    append(m_queue, call);
+    ++m_queued;
+    return kErpcStatus_Success;
+}
+
+unsigned AsyncClientManager::poll(uint32_t timeoutUs)
+{
+    struct pollfd fds[CONFIG_ERPC_ASYNC_CONNECTIONS];
+    Connection *polled[CONFIG_ERPC_ASYNC_CONNECTIONS];
+
+    dispatch();
+
+    nfds_t n = 0;
+    for (unsigned i = 0; i < m_count; ++i) {
+        Connection &conn = m_connections[i];
+        if (conn.m_open) {
+            polled[n] = &conn;
+            fds[n].fd = conn.m_transport.getSocket();
+            fds[n].events = POLLIN;
+            fds[n].revents = 0;
+            ++n;
+        }
+    }
+
+    uint32_t waitFor = waitUs(erpc_native_now_us(), timeoutUs);
+    int timeoutMs = (waitFor == UINT32_MAX) ? -1 : static_cast<int>((waitFor + 999U) / 1000U);
+    if (::poll(fds, n, timeoutMs) > 0) {
+        for (nfds_t i = 0; i < n; ++i) {
+            if (fds[i].revents != 0) {
+                receiveReplies(*polled[i]);
+            }
+        }
+    }
+
+    expire(erpc_native_now_us());
+    dispatch();
+    return getOutstandingCount();
+}
+
+void AsyncClientManager::run(void)
+{
+    m_stop = false;
+    while (!m_stop && (getOutstandingCount() > 0U)) {
+        (void)poll(UINT32_MAX);
+    }
+}
+
+void AsyncClientManager::performRequest(RequestContext &request)
+{
+    class BlockingCall : public AsyncCall {
+    public:
+        BlockingCall(void) : m_done(false) {}
+        bool m_done;
+
+    protected:
+        virtual void onComplete(void) override { m_done = true; }
+    };
+
+    BlockingCall call;
+    erpc_status_t err = start(call, request);
+    if (err != kErpcStatus_Success) {
+        if (request.getCodec() != NULL) {
+            request.getCodec()->updateStatus(err);
+        }
+        return;
+    }
+    while (!call.m_done) {
+        (void)poll(UINT32_MAX);
+    }
+}
+
+void AsyncClientManager::append(CallList &list, AsyncCall &call)
+{
+    call.m_prev = list.m_tail;
+    call.m_next = NULL;
+    if (list.m_tail != NULL) {
+        list.m_tail->m_next = &call;
+    } else {
+        list.m_head = &call;
+    }
+    list.m_tail = &call;
+}
+
+void AsyncClientManager::unlink(CallList &list, AsyncCall &call)
+{
+    if (call.m_prev != NULL) {
+        call.m_prev->m_next = call.m_next;
+    } else {
+        list.m_head = call.m_next;
+    }
+    if (call.m_next != NULL) {
+        call.m_next->m_prev = call.m_prev;
+    } else {
+        list.m_tail = call.m_prev;
+    }
+    call.m_prev = call.m_next = NULL;
+}
+
+AsyncClientManager::Connection *AsyncClientManager::chooseConnection(void)
+{
+    Connection *best = NULL;
+    for (unsigned i = 0; i < m_count; ++i) {
+        Connection &conn = m_connections[i];
+        if (conn.m_open && (conn.m_inflight < CONFIG_ERPC_ASYNC_WINDOW) &&
+            ((best == NULL) || (conn.m_inflight < best->m_inflight))) {
+            best = &conn;
+        }
+    }
+    return best;
+}
+
+void AsyncClientManager::dispatch(void)
+{
+    Connection *conn;
+    while ((m_queue.m_head != NULL) && ((conn = chooseConnection()) != NULL)) {
+        AsyncCall &call = *m_queue.m_head;
+        unlink(m_queue, call);
+        --m_queued;
+
+        AsyncCall *&slot = m_calls[call.m_sequence & (CONFIG_ERPC_ASYNC_CALLS - 1U)];
+        if (!call.m_isOneway) {
+            if (slot != NULL) {
+                // A call CONFIG_ERPC_ASYNC_CALLS sequence numbers older is still unanswered.
+                complete(call, kErpcStatus_MemoryError);
+                continue;
+            }
+            slot = &call;
+            call.m_conn = conn;
+            append(m_wire, call);
+            ++m_sent;
+            ++conn->m_inflight;
+        }
+
+        erpc_status_t err = conn->m_transport.send(&call.m_codec->getBufferRef());
+        if (call.m_isOneway) {
+            complete(call, err);
+        }
+        if (err != kErpcStatus_Success) {
+            closeConnection(*conn, err);
+        }
+    }
+
+    if (m_queue.m_head != NULL) {
+        bool open = false;
+        for (unsigned i = 0; (i < m_count) && !open; ++i) {
+            open = m_connections[i].m_open;
+        }
+        while (!open && (m_queue.m_head != NULL)) {
+            AsyncCall &call = *m_queue.m_head;
+            unlink(m_queue, call);
+            --m_queued;
+            complete(call, kErpcStatus_ConnectionClosed);
+        }
+    }
+}
+
+void AsyncClientManager::receiveReplies(Connection &conn)
+{
+    // Drain the whole frames that have arrived; a server stalled mid-frame blocks nobody.
+    erpc_status_t err = conn.m_transport.fill();
+
+    while (conn.m_open && conn.m_transport.hasMessage()) {
+        receiveReply(conn);
+    }
+    if (conn.m_open && (err != kErpcStatus_Success)) {
+        closeConnection(conn, err);
+    }
+}
+
+void AsyncClientManager::receiveReply(Connection &conn)
+{
+    if (m_spare.get() == NULL) {
+        m_spare = m_messageFactory->create();
+        if (m_spare.get() == NULL) {
+            closeConnection(conn, kErpcStatus_MemoryError);
+            return;
+        }
+    }
+    erpc_status_t err = conn.m_transport.receive(&m_spare);
+    if (err != kErpcStatus_Success) {
+        closeConnection(conn, err);
+        return;
+    }
+
+    uint32_t headerOffset = conn.m_transport.reserveHeaderSize();
+    message_type_t type;
+    uint32_t service;
+    uint32_t method;
+    uint32_t sequence;
+    if (!readMessageHeader(m_spare, headerOffset, type, service, method, sequence)) {
+        return;
+    }
+    AsyncCall *call = m_calls[sequence & (CONFIG_ERPC_ASYNC_CALLS - 1U)];
+    if ((call == NULL) || (call->m_sequence != sequence) || (call->m_conn != &conn)) {
+        return; // reply to a call that timed out
+    }
+
+    // The reply becomes the call's buffer, the call's request buffer the next spare.
+    MessageBuffer reply = m_spare;
+    m_spare = call->m_codec->getBufferRef();
+    call->m_codec->setBuffer(reply, static_cast<uint8_t>(headerOffset));
+    erpc_status_t replyStatus;
+    if (readStatusReply(reply, headerOffset, replyStatus)) {
+        // Rejected by the server (e.g. kErpcStatus_ServerBusy) before running the call.
+        call->m_codec->updateStatus((replyStatus != kErpcStatus_Success) ? replyStatus : kErpcStatus_Fail);
+    } else {
+        RequestContext request(sequence, call->m_codec, false);
+        verifyReply(request);
+    }
+    complete(*call, kErpcStatus_Success);
+}
+
+void AsyncClientManager::expire(uint32_t now)
+{
+    if (m_timeoutUs == 0U) {
+        return;
+    }
+    // Both lists are in start order, so the oldest calls are at their heads.
+    while ((m_wire.m_head != NULL) && (now - m_wire.m_head->m_startedAt >= m_timeoutUs)) {
+        complete(*m_wire.m_head, kErpcStatus_Timeout);
+    }
+    while ((m_queue.m_head != NULL) && (now - m_queue.m_head->m_startedAt >= m_timeoutUs)) {
+        AsyncCall &call = *m_queue.m_head;
+        unlink(m_queue, call);
+        --m_queued;
+        complete(call, kErpcStatus_Timeout);
+    }
+}
+
+uint32_t AsyncClientManager::waitUs(uint32_t now, uint32_t timeoutUs)
+{
+    if ((m_queue.m_head != NULL) && (chooseConnection() != NULL)) {
+        return 0;
+    }
+    if (m_timeoutUs != 0U) {
+        AsyncCall *heads[2] = { m_wire.m_head, m_queue.m_head };
+        for (unsigned i = 0; i < 2U; ++i) {
+            if (heads[i] != NULL) {
+                uint32_t age = now - heads[i]->m_startedAt;
+                uint32_t left = (age < m_timeoutUs) ? (m_timeoutUs - age) : 0U;
+                if (left < timeoutUs) {
+                    timeoutUs = left;
+                }
+            }
+        }
+    }
+    return timeoutUs;
+}
+
+void AsyncClientManager::closeConnection(Connection &conn, erpc_status_t status)
+{
+    conn.m_open = false;
+    AsyncCall *call = m_wire.m_head;
+    while (call != NULL) {
+        AsyncCall *next = call->m_next;
+        if (call->m_conn == &conn) {
+            complete(*call, status);
+        }
+        call = next;
+    }
+    ::close(conn.m_transport.getSocket());
+    conn.m_transport.setSocket(-1);
+}
+
+void AsyncClientManager::complete(AsyncCall &call, erpc_status_t status)
+{
+    if (call.m_conn != NULL) {
+        Connection &conn = *static_cast<Connection *>(call.m_conn);
+        m_calls[call.m_sequence & (CONFIG_ERPC_ASYNC_CALLS - 1U)] = NULL;
+        unlink(m_wire, call);
+        --m_sent;
+        --conn.m_inflight;
+        call.m_conn = NULL;
+    }
+    if (status != kErpcStatus_Success) {
+        call.m_codec->updateStatus(status);
+    }
+    call.onComplete();
+}
@@ -0,0 +1,567 @@
+// client_pool.cpp — ClientManager over several connections and endpoints for concurrent callers
+#include "client_pool.hpp"
+#include "erpc_status_reply.hpp"
+
+#include <string.h>
+
+extern "C" {
+#include "ztimer.h"
+}
+
+using namespace erpc;
+
+ClientPool::ClientPool(void)
+: ClientManager()
+, m_count(0)
+, m_random(ztimer_now(ZTIMER_USEC) | 1U)
+, m_hedgeRuleCount(0)
+, m_hedged(0)
+, m_hedgeWins(0)
+#if !ERPC_THREADS_IS(NONE)
+, m_waitHead(NULL)
+, m_waitTail(NULL)
+#endif
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_CLIENT_POOL_SIZE; ++i) {
+        m_connections[i].m_codec = NULL;
+        m_connections[i].m_endpoint = 0;
+        m_connections[i].m_busy = false;
+        m_connections[i].m_late = false;
+    }
+    for (unsigned i = 0; i < CONFIG_ERPC_CLIENT_POOL_ENDPOINTS; ++i) {
+        Endpoint &ep = m_endpoints[i];
+        ep.m_latencyUs = 0;
+        ep.m_ejectedUntil = 0;
+        ep.m_connectionCount = 0;
+        ep.m_outstanding = 0;
+        ep.m_ejections = 0;
+        ep.m_ejected = false;
+        ep.m_p95Us = 0;
+        ep.m_sampleCount = 0;
+        ep.m_sampleNext = 0;
+    }
+}
+
+erpc_status_t ClientPool::addConnection(Transport *transport, uint8_t endpoint)
+{
+    if ((transport == NULL) || (endpoint >= CONFIG_ERPC_CLIENT_POOL_ENDPOINTS) || (m_codecFactory == NULL) ||
+        (m_messageFactory == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    if (m_count == CONFIG_ERPC_CLIENT_POOL_SIZE) {
+        return kErpcStatus_MemoryError;
+    }
+    Connection &conn = m_connections[m_count];
+    conn.m_client.setTransport(transport);
+    conn.m_client.setCodecFactory(m_codecFactory);
+    conn.m_client.setMessageBufferFactory(m_messageFactory);
+    (void)conn.m_client.preallocate(); // Without, its calls allocate as usual.
+    conn.m_endpoint = endpoint;
+    ++m_endpoints[endpoint].m_connectionCount;
+    ++m_count;
+    return kErpcStatus_Success;
+}
+
+void ClientPool::setDeadline(uint32_t budgetUs)
+{
+    for (unsigned i = 0; i < m_count; ++i) {
+        m_connections[i].m_client.setDeadline(budgetUs);
+    }
+}
+
+uint32_t ClientPool::getEndpointLatency(uint8_t endpoint) const
+{
+    return (endpoint < CONFIG_ERPC_CLIENT_POOL_ENDPOINTS) ? m_endpoints[endpoint].m_latencyUs : 0U;
+}
+
+bool ClientPool::isEjected(uint8_t endpoint) const
+{
+    return (endpoint < CONFIG_ERPC_CLIENT_POOL_ENDPOINTS) && m_endpoints[endpoint].m_ejected;
+}
+
+uint32_t ClientPool::getEndpointP95(uint8_t endpoint) const
+{
+    return (endpoint < CONFIG_ERPC_CLIENT_POOL_ENDPOINTS) ? m_endpoints[endpoint].m_p95Us : 0U;
+}
+
+erpc_status_t ClientPool::hedgeMethod(uint32_t serviceId, uint32_t methodId)
+{
+    if (m_hedgeRuleCount == CONFIG_ERPC_CLIENT_HEDGE_METHODS) {
+        return kErpcStatus_MemoryError;
+    }
+    m_hedgeRules[m_hedgeRuleCount].m_serviceId = serviceId;
+    m_hedgeRules[m_hedgeRuleCount].m_methodId = methodId;
+    ++m_hedgeRuleCount;
+    return kErpcStatus_Success;
+}
+
+uint32_t ClientPool::random(void)
+{
+    // xorshift32; only spreads the choices, no need for more.
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+}
+
+bool ClientPool::isLate(Connection &conn)
+{
+    // Once the late reply is there, the next call on the connection discards it right away.
+    return conn.m_late && !conn.m_client.getTransport()->hasMessage();
+}
+
+ClientPool::Connection *ClientPool::chooseAny(uint32_t now)
+{
+    Connection *conn = choose(now, CONFIG_ERPC_CLIENT_POOL_ENDPOINTS, true);
+    return (conn != NULL) ? conn : choose(now, CONFIG_ERPC_CLIENT_POOL_ENDPOINTS, false);
+}
+
+ClientPool::Connection *ClientPool::choose(uint32_t now, unsigned exclude, bool skipLate)
+{
+    // Called with m_lock held. @p exclude is an endpoint not to choose, or
+    // CONFIG_ERPC_CLIENT_POOL_ENDPOINTS for none.
+    bool usable[CONFIG_ERPC_CLIENT_POOL_SIZE];
+    bool hasFree[CONFIG_ERPC_CLIENT_POOL_ENDPOINTS] = {};
+    for (unsigned i = 0; i < m_count; ++i) {
+        usable[i] = !m_connections[i].m_busy && !(skipLate && isLate(m_connections[i]));
+        if (usable[i]) {
+            hasFree[m_connections[i].m_endpoint] = true;
+        }
+    }
+
+    uint8_t candidates[CONFIG_ERPC_CLIENT_POOL_ENDPOINTS];
+    unsigned n = 0;
+    for (unsigned e = 0; e < CONFIG_ERPC_CLIENT_POOL_ENDPOINTS; ++e) {
+        Endpoint &ep = m_endpoints[e];
+        if (ep.m_ejected && (static_cast<int32_t>(now - ep.m_ejectedUntil) >= 0)) {
+            ep.m_ejected = false;
+            ep.m_latencyUs = 0;
+            ep.m_p95Us = 0;
+            ep.m_sampleCount = 0;
+        }
+        if (hasFree[e] && !ep.m_ejected && (e != exclude)) {
+            candidates[n++] = static_cast<uint8_t>(e);
+        }
+    }
+    if (n == 0U) {
+        return NULL;
+    }
+
+    // Power of two choices.
+    uint8_t endpoint = candidates[0];
+    if (n > 1U) {
+        unsigned i = random() % n;
+        unsigned j = random() % (n - 1U);
+        if (j >= i) {
+            ++j;
+        }
+        const Endpoint &a = m_endpoints[candidates[i]];
+        const Endpoint &b = m_endpoints[candidates[j]];
+        bool second = (b.m_outstanding < a.m_outstanding) ||
+                      ((b.m_outstanding == a.m_outstanding) && (b.m_latencyUs < a.m_latencyUs));
+        endpoint = candidates[second ? j : i];
+    }
+
+    // The lowest free connection of the endpoint, so a lightly loaded pool keeps using the same ones.
+    for (unsigned i = 0; i < m_count; ++i) {
+        Connection &conn = m_connections[i];
+        if (usable[i] && (conn.m_endpoint == endpoint)) {
+            conn.m_busy = true;
+            conn.m_late = false;
+            ++m_endpoints[endpoint].m_outstanding;
+            return &conn;
+        }
+    }
+    return NULL;
+}
+
+bool ClientPool::otherAdmitted(uint8_t endpoint, uint32_t &bestLatencyUs) const
+{
+    bool found = false;
+    bestLatencyUs = 0;
+    for (unsigned e = 0; e < CONFIG_ERPC_CLIENT_POOL_ENDPOINTS; ++e) {
+        const Endpoint &ep = m_endpoints[e];
+        if ((e == endpoint) || (ep.m_connectionCount == 0U) || ep.m_ejected) {
+            continue;
+        }
+        found = true;
+        if ((ep.m_latencyUs != 0U) && ((bestLatencyUs == 0U) || (ep.m_latencyUs < bestLatencyUs))) {
+            bestLatencyUs = ep.m_latencyUs;
+        }
+    }
+    return found;
+}
+
+void ClientPool::recordCall(Connection &conn, uint32_t latencyUs, bool failed, uint32_t now, bool abandoned)
+{
+    // Called with m_lock held. An abandoned call (the loser of a hedge) took
+    // longer than @p latencyUs; that counts towards the average, but would
+    // only hold up the p95 it was hedged at.
+    Endpoint &ep = m_endpoints[conn.m_endpoint];
+    if (!failed) {
+        ep.m_latencyUs = (ep.m_latencyUs == 0U) ? latencyUs : (ep.m_latencyUs - ep.m_latencyUs / 8U + latencyUs / 8U);
+        if ((m_hedgeRuleCount != 0U) && !abandoned) {
+            recordSample(ep, latencyUs);
+        }
+    }
+    uint32_t best;
+    if (ep.m_ejected || !otherAdmitted(conn.m_endpoint, best)) {
+        return;
+    }
+    bool slow = (best != 0U) && (ep.m_latencyUs > CONFIG_ERPC_CLIENT_LB_EJECT_MIN_US) &&
+                (ep.m_latencyUs / CONFIG_ERPC_CLIENT_LB_EJECT_FACTOR > best);
+    if (!failed && !slow) {
+        ep.m_ejections = 0;
+        return;
+    }
+    ep.m_ejected = true;
+    ep.m_ejectedUntil = now + (static_cast<uint32_t>(CONFIG_ERPC_CLIENT_LB_EJECT_US) << ep.m_ejections);
+    if (ep.m_ejections < 3U) {
+        ++ep.m_ejections;
+    }
+}
+
+void ClientPool::recordSample(Endpoint &ep, uint32_t latencyUs)
+{
+    // Called with m_lock held.
+    ep.m_samples[ep.m_sampleNext] = latencyUs;
+    ep.m_sampleNext = static_cast<uint8_t>((ep.m_sampleNext + 1U) % CONFIG_ERPC_CLIENT_HEDGE_SAMPLES);
+    if (ep.m_sampleCount < CONFIG_ERPC_CLIENT_HEDGE_SAMPLES) {
+        ++ep.m_sampleCount;
+    }
+    if (ep.m_sampleCount < CONFIG_ERPC_CLIENT_HEDGE_SAMPLES) {
+        return;
+    }
+
+    // Insertion sort of a copy; the window is small and calls take far longer.
+    uint32_t sorted[CONFIG_ERPC_CLIENT_HEDGE_SAMPLES];
+    for (unsigned i = 0; i < CONFIG_ERPC_CLIENT_HEDGE_SAMPLES; ++i) {
+        uint32_t value = ep.m_samples[i];
+        unsigned j = i;
+        for (; (j > 0U) && (sorted[j - 1U] > value); --j) {
+            sorted[j] = sorted[j - 1U];
+        }
+        sorted[j] = value;
+    }
+    ep.m_p95Us = sorted[(CONFIG_ERPC_CLIENT_HEDGE_SAMPLES * 95U + 99U) / 100U - 1U];
+}
+
+ClientPool::Connection *ClientPool::take(void)
+{
+    if (m_count == 0U) {
+        return NULL;
+    }
+#if ERPC_THREADS_IS(NONE)
+    return chooseAny(ztimer_now(ZTIMER_USEC));
+#else
+    Waiter self;
+    {
+        Mutex::Guard lock(m_lock);
+        // Queue behind earlier callers, so one that returns a connection and
+        // calls again right away cannot starve them.
+        Connection *conn = (m_waitHead == NULL) ? chooseAny(ztimer_now(ZTIMER_USEC)) : NULL;
+        if (conn != NULL) {
+            return conn;
+        }
+        self.m_conn = NULL;
+        self.m_next = NULL;
+        if (m_waitTail != NULL) {
+            m_waitTail->m_next = &self;
+        } else {
+            m_waitHead = &self;
+        }
+        m_waitTail = &self;
+    }
+    (void)self.m_ready.get();
+    return self.m_conn;
+#endif
+}
+
+void ClientPool::give(Connection *conn)
+{
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_lock);
+#endif
+    conn->m_codec = NULL;
+    conn->m_busy = false;
+    --m_endpoints[conn->m_endpoint].m_outstanding;
+#if !ERPC_THREADS_IS(NONE)
+    // Hand connections to waiters while admitted endpoints have some free;
+    // that may also be one readmitted just now.
+    while (m_waitHead != NULL) {
+        Connection *next = chooseAny(ztimer_now(ZTIMER_USEC));
+        if (next == NULL) {
+            break;
+        }
+        Waiter *waiter = m_waitHead;
+        m_waitHead = waiter->m_next;
+        if (m_waitHead == NULL) {
+            m_waitTail = NULL;
+        }
+        waiter->m_conn = next;
+        waiter->m_ready.put();
+    }
+#endif
+}
+
+ClientPool::Connection *ClientPool::takeHedge(uint8_t endpoint)
+{
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_lock);
+    // Connections go to waiting callers first.
+    if (m_waitHead != NULL) {
+        return NULL;
+    }
+#endif
+    // Behind a late reply the hedge would wait as long as the call it hedges.
+    Connection *conn = choose(ztimer_now(ZTIMER_USEC), endpoint, true);
+    if (conn != NULL) {
+        ++m_hedged;
+    }
+    return conn;
+}
+
+ClientPool::Connection *ClientPool::findRequest(RequestContext &request)
+{
+    // Only the owner of a request touches its connection's m_codec, so no lock.
+    for (unsigned i = 0; i < m_count; ++i) {
+        if (m_connections[i].m_busy && (m_connections[i].m_codec == request.getCodec())) {
+            return &m_connections[i];
+        }
+    }
+    return NULL;
+}
+
+ClientManager *ClientPool::checkout(void)
+{
+    Connection *conn = take();
+    return (conn != NULL) ? &conn->m_client : NULL;
+}
+
+void ClientPool::checkin(ClientManager *client)
+{
+    for (unsigned i = 0; i < m_count; ++i) {
+        if (&m_connections[i].m_client == client) {
+            give(&m_connections[i]);
+            return;
+        }
+    }
+}
+
+RequestContext ClientPool::createRequest(bool isOneway)
+{
+    Connection *conn = take();
+    if (conn == NULL) {
+        // The generated shims report a missing codec as kErpcStatus_MemoryError.
+        return RequestContext(0, NULL, isOneway);
+    }
+    RequestContext request = conn->m_client.createRequest(isOneway);
+    if (request.getCodec() == NULL) {
+        give(conn);
+    } else {
+        conn->m_codec = request.getCodec();
+    }
+    return request;
+}
+
+void ClientPool::performRequest(RequestContext &request)
+{
+    Connection *conn = findRequest(request);
+    if (conn == NULL) {
+        if (request.getCodec() != NULL) {
+            request.getCodec()->updateStatus(kErpcStatus_InvalidArgument);
+        }
+        return;
+    }
+
+    uint32_t start = ztimer_now(ZTIMER_USEC);
+    uint32_t hedgeAfterUs;
+    if (isHedged(*conn, request, hedgeAfterUs)) {
+        performHedged(*conn, request, start, hedgeAfterUs);
+        return;
+    }
+    conn->m_client.performRequest(request);
+    if (!request.isOneway()) {
+        uint32_t now = ztimer_now(ZTIMER_USEC);
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_lock);
+#endif
+        recordCall(*conn, now - start, !request.getCodec()->isStatusOk(), now);
+        conn->m_late = (request.getCodec()->getStatus() == kErpcStatus_Timeout);
+    }
+}
+
+bool ClientPool::isHedged(Connection &conn, RequestContext &request, uint32_t &hedgeAfterUs)
+{
+    if ((m_hedgeRuleCount == 0U) || request.isOneway() || !request.getCodec()->isStatusOk()) {
+        return false;
+    }
+    message_type_t type;
+    uint32_t service;
+    uint32_t method;
+    uint32_t sequence;
+    if (!readMessageHeader(request.getCodec()->getBufferRef(), conn.m_client.getTransport()->reserveHeaderSize(),
+                           type, service, method, sequence)) {
+        return false;
+    }
+    bool marked = false;
+    for (unsigned i = 0; (i < m_hedgeRuleCount) && !marked; ++i) {
+        marked = (m_hedgeRules[i].m_serviceId == service) &&
+                 ((m_hedgeRules[i].m_methodId == kAnyMethod) || (m_hedgeRules[i].m_methodId == method));
+    }
+    if (!marked) {
+        return false;
+    }
+
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_lock);
+#endif
+    uint32_t best;
+    hedgeAfterUs = m_endpoints[conn.m_endpoint].m_p95Us;
+    return (hedgeAfterUs != 0U) && otherAdmitted(conn.m_endpoint, best);
+}
+
+ClientPool::Connection *ClientPool::sendHedge(Connection &conn, MessageBuffer &copy, RequestContext &hedgeRequest,
+                                              uint32_t budgetUs)
+{
+    Connection *hedge = takeHedge(conn.m_endpoint);
+    if (hedge == NULL) {
+        return NULL;
+    }
+    hedgeRequest = hedge->m_client.createRequest(false);
+    Codec *codec = hedgeRequest.getCodec();
+    if (codec == NULL) {
+        give(hedge);
+        return NULL;
+    }
+
+    // The same request under the hedge connection's sequence number, so its
+    // reply, if it loses, is discarded there like a late one.
+    uint32_t headerOffset = conn.m_client.getTransport()->reserveHeaderSize();
+    uint32_t headerSize = messageHeaderSize(copy, headerOffset);
+    message_type_t type;
+    uint32_t service;
+    uint32_t method;
+    uint32_t sequence;
+    MessageBuffer &buffer = codec->getBufferRef();
+    if ((headerSize == 0U) || !readMessageHeader(copy, headerOffset, type, service, method, sequence) ||
+        (buffer.getLength() < copy.getUsed())) {
+        codec->updateStatus(kErpcStatus_InvalidArgument);
+        return hedge;
+    }
+    memcpy(buffer.get(), copy.get(), copy.getUsed());
+    buffer.setUsed(copy.getUsed());
+    codec->updateStatus(writeMessage(buffer, headerOffset, type, service, method, hedgeRequest.getSequence(),
+                                     copy.get() + headerOffset + headerSize,
+                                     copy.getUsed() - headerOffset - headerSize));
+    hedge->m_client.sendRequest(hedgeRequest, budgetUs);
+    return hedge;
+}
+
+void ClientPool::performHedged(Connection &conn, RequestContext &request, uint32_t start, uint32_t hedgeAfterUs)
+{
+    Codec *codec = request.getCodec();
+    MessageBuffer &buffer = codec->getBufferRef();
+    uint32_t headerOffset = conn.m_client.getTransport()->reserveHeaderSize();
+    uint32_t budgetUs = conn.m_client.getDeadline();
+
+    // The request's buffer receives whatever comes on its connection, late
+    // replies to earlier calls included, so the hedge is made from a copy.
+    MessageBuffer copy = m_messageFactory->create();
+    if ((copy.get() == NULL) || (copy.getLength() < buffer.getUsed())) {
+        hedgeAfterUs = 0;
+    } else {
+        memcpy(copy.get(), buffer.get(), buffer.getUsed());
+        copy.setUsed(buffer.getUsed());
+    }
+
+    conn.m_client.sendRequest(request, budgetUs);
+    Connection *hedge = NULL;
+    RequestContext hedgeRequest(0, NULL, false);
+    uint32_t hedgeStart = 0;
+    bool primaryLive = codec->isStatusOk();
+    bool hedgeLive = false;
+    bool hedgeWon = false;
+    bool hedgeFailed = false;
+    while (primaryLive || hedgeLive) {
+        if (primaryLive && conn.m_client.pollReply(request)) {
+            primaryLive = false;
+            if (codec->isStatusOk()) {
+                break;
+            }
+        }
+        if (hedgeLive && hedge->m_client.pollReply(hedgeRequest)) {
+            hedgeLive = false;
+            if (hedgeRequest.getCodec()->isStatusOk()) {
+                hedgeWon = true;
+                break;
+            }
+            hedgeFailed = true;
+        }
+        uint32_t elapsed = ztimer_now(ZTIMER_USEC) - start;
+        if ((budgetUs != 0U) && (elapsed >= budgetUs)) {
+            codec->updateStatus(kErpcStatus_Timeout);
+            break;
+        }
+        if (primaryLive && (hedge == NULL) && (hedgeAfterUs != 0U) && (elapsed >= hedgeAfterUs)) {
+            // One try: when no connection is free, the call is not hedged.
+            hedgeAfterUs = 0;
+            hedge = sendHedge(conn, copy, hedgeRequest, (budgetUs != 0U) ? (budgetUs - elapsed) : 0U);
+            if (hedge != NULL) {
+                hedgeStart = start + elapsed;
+                hedgeLive = hedgeRequest.getCodec()->isStatusOk();
+            }
+        }
+        if (primaryLive || hedgeLive) {
+            ztimer_sleep(ZTIMER_USEC, CONFIG_ERPC_CLIENT_POLL_US);
+        }
+    }
+
+    uint32_t now = ztimer_now(ZTIMER_USEC);
+    {
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_lock);
+#endif
+        recordCall(conn, now - start, !codec->isStatusOk(), now, hedgeWon);
+        conn.m_late = primaryLive;
+        if (hedgeWon) {
+            ++m_hedgeWins;
+            recordCall(*hedge, now - hedgeStart, false, now);
+        } else if (hedgeFailed) {
+            recordCall(*hedge, now - hedgeStart, true, now);
+        }
+        if (hedge != NULL) {
+            hedge->m_late = hedgeLive;
+        }
+    }
+
+    if (hedgeWon) {
+        // Hand the winning reply to the caller as verifyReply() leaves it:
+        // the codec positioned at the results.
+        MessageBuffer &reply = hedgeRequest.getCodec()->getBufferRef();
+        message_type_t type;
+        uint32_t service;
+        uint32_t method;
+        uint32_t sequence;
+        memcpy(buffer.get(), reply.get(), reply.getUsed());
+        buffer.setUsed(reply.getUsed());
+        codec->reset(static_cast<uint8_t>(headerOffset));
+        codec->startReadMessage(type, service, method, sequence);
+    }
+    if (hedge != NULL) {
+        hedge->m_client.releaseRequest(hedgeRequest);
+        give(hedge);
+    }
+    if (copy.get() != NULL) {
+        m_messageFactory->dispose(&copy);
+    }
+}
+
+void ClientPool::releaseRequest(RequestContext &request)
+{
+    Connection *conn = findRequest(request);
+    if (conn != NULL) {
+        conn->m_client.releaseRequest(request);
+        give(conn);
+    }
+}
@@ -0,0 +1,97 @@
+// deadline_client.cpp — ClientManager with per-request deadlines
+#include "deadline_client.hpp"
+#include "erpc_compact_codec.hpp"
+#include "erpc_status_reply.hpp"
+
+extern "C" {
+#include "ztimer.h"
+}
+
+using namespace erpc;
+
+void DeadlineClientManager::performClientRequest(RequestContext &request)
+{
+    uint32_t startUs = ztimer_now(ZTIMER_USEC);
+    sendRequest(request, m_budgetUs);
+    if (!request.isOneway() && request.getCodec()->isStatusOk()) {
+        receiveReply(request, startUs, m_budgetUs);
+    }
+}
+
+void DeadlineClientManager::sendRequest(RequestContext &request, uint32_t budgetUs)
+{
+    Codec *codec = request.getCodec();
+    if (codec->isStatusOk() && (budgetUs != 0U)) {
+        codec->updateStatus(
+            CompactCodec::insertDeadline(codec->getBufferRef(), m_transport->reserveHeaderSize(), budgetUs));
+    }
+    if (codec->isStatusOk()) {
+        codec->updateStatus(m_transport->send(&codec->getBufferRef()));
+    }
+}
+
+bool DeadlineClientManager::pollReply(RequestContext &request)
+{
+    if (!m_transport->hasMessage()) {
+        return false;
+    }
+    Codec *codec = request.getCodec();
+    codec->updateStatus(m_transport->receive(&codec->getBufferRef()));
+    return !codec->isStatusOk() || acceptReply(request);
+}
+
+bool DeadlineClientManager::waitForMessage(uint32_t startUs, uint32_t budgetUs)
+{
+    while (!m_transport->hasMessage()) {
+        if ((ztimer_now(ZTIMER_USEC) - startUs) >= budgetUs) {
+            return false;
+        }
+        ztimer_sleep(ZTIMER_USEC, CONFIG_ERPC_CLIENT_POLL_US);
+    }
+    return true;
+}
+
+void DeadlineClientManager::receiveReply(RequestContext &request, uint32_t startUs, uint32_t budgetUs)
+{
+    Codec *codec = request.getCodec();
+    for (;;) {
+        if ((budgetUs != 0U) && !waitForMessage(startUs, budgetUs)) {
+            codec->updateStatus(kErpcStatus_Timeout);
+            return;
+        }
+        // Whole frames only: a timeout never leaves half a reply behind.
+        codec->updateStatus(m_transport->receive(&codec->getBufferRef()));
+        if (!codec->isStatusOk() || acceptReply(request)) {
+            return;
+        }
+    }
+}
+
+bool DeadlineClientManager::acceptReply(RequestContext &request)
+{
+    // verifyReply(), but a reply to an earlier, timed out call is skipped.
+    Codec *codec = request.getCodec();
+    message_type_t msgType;
+    uint32_t service;
+    uint32_t requestNumber;
+    uint32_t sequence;
+    erpc_status_t replyStatus;
+    bool statusOnly = readStatusReply(codec->getBufferRef(), m_transport->reserveHeaderSize(), replyStatus);
+    codec->reset(m_transport->reserveHeaderSize());
+    codec->startReadMessage(msgType, service, requestNumber, sequence);
+    if (!codec->isStatusOk()) {
+        return true;
+    }
+    if (statusOnly) {
+        msgType = message_type_t::kReplyMessage;
+    }
+    if ((msgType == message_type_t::kReplyMessage) && (static_cast<int32_t>(sequence - request.getSequence()) < 0)) {
+        return false;
+    }
+    if ((msgType != message_type_t::kReplyMessage) || (sequence != request.getSequence())) {
+        codec->updateStatus(kErpcStatus_ExpectedReply);
+    } else if (statusOnly) {
+        codec->updateStatus((replyStatus != kErpcStatus_Success) ? replyStatus : kErpcStatus_Fail);
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+// erpc_client_ext_setup.cpp — C API for the erpc_client_ext client variants
+#include "erpc_client_ext_setup.h"
+#include "erpc_basic_codec.hpp"
+#include "erpc_compact_codec.hpp"
+#include "erpc_crc16.hpp"
+#include "erpc_manually_constructed.hpp"
+#include "client_pool.hpp"
+#include "reusable_client.hpp"
+
+using namespace erpc;
+
+// As erpc_client_init(), but with CompactCodec: only its header carries a deadline.
+ERPC_MANUALLY_CONSTRUCTED_STATIC(ReusableClientManager, s_deadlineClient);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(CompactCodecFactory, s_deadlineCodecFactory);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(Crc16, s_deadlineCrc16);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(ClientPool, s_clientPool);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(BasicCodecFactory, s_poolCodecFactory);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(Crc16, s_poolCrc16);
+
+////////////////////////////////////////////////////////////////////////////////
+// External C Interface
+////////////////////////////////////////////////////////////////////////////////
+
+erpc_client_t erpc_client_deadline_init(erpc_transport_t transport, erpc_mbf_t message_buffer_factory)
+{
+    if ((transport == NULL) || (message_buffer_factory == NULL) || s_deadlineClient.isUsed()) {
+        return NULL;
+    }
+    Transport *t = reinterpret_cast<Transport *>(transport);
+
+    s_deadlineCrc16.construct();
+    t->setCrc16(s_deadlineCrc16.get());
+    s_deadlineCodecFactory.construct();
+    s_deadlineClient.construct();
+
+    ReusableClientManager *client = s_deadlineClient.get();
+    client->setTransport(t);
+    client->setCodecFactory(s_deadlineCodecFactory.get());
+    client->setMessageBufferFactory(reinterpret_cast<MessageBufferFactory *>(message_buffer_factory));
+    (void)client->preallocate(); // Without, its calls allocate as usual.
+    return reinterpret_cast<erpc_client_t>(client);
+}
+
+erpc_status_t erpc_client_set_deadline(erpc_client_t client, uint32_t budget_us)
+{
+    if (client == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    reinterpret_cast<DeadlineClientManager *>(client)->setDeadline(budget_us);
+    return kErpcStatus_Success;
+}
+
+erpc_client_t erpc_client_pool_init(erpc_mbf_t message_buffer_factory)
+{
+    if ((message_buffer_factory == NULL) || s_clientPool.isUsed()) {
+        return NULL;
+    }
+
+    s_poolCrc16.construct();
+    s_poolCodecFactory.construct();
+    s_clientPool.construct();
+
+    ClientPool *client = s_clientPool.get();
+    client->setCodecFactory(s_poolCodecFactory.get());
+    client->setMessageBufferFactory(reinterpret_cast<MessageBufferFactory *>(message_buffer_factory));
+    return reinterpret_cast<erpc_client_t>(client);
+}
+
+erpc_status_t erpc_client_pool_add_connection(erpc_client_t client, erpc_transport_t transport, uint8_t endpoint)
+{
+    if ((client == NULL) || (transport == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    Transport *t = reinterpret_cast<Transport *>(transport);
+    t->setCrc16(s_poolCrc16.get());
+    return reinterpret_cast<ClientPool *>(client)->addConnection(t, endpoint);
+}
+
+erpc_client_t erpc_client_pool_checkout(erpc_client_t client)
+{
+    if (client == NULL) {
+        return NULL;
+    }
+    return reinterpret_cast<erpc_client_t>(reinterpret_cast<ClientPool *>(client)->checkout());
+}
+
+void erpc_client_pool_checkin(erpc_client_t client, erpc_client_t connection)
+{
+    if ((client != NULL) && (connection != NULL)) {
+        reinterpret_cast<ClientPool *>(client)->checkin(reinterpret_cast<ClientManager *>(connection));
+    }
+}
+
+erpc_status_t erpc_client_pool_hedge_method(erpc_client_t client, uint32_t service_id, uint32_t method_id)
+{
+    if (client == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    return reinterpret_cast<ClientPool *>(client)->hedgeMethod(service_id, method_id);
+}
@@ -0,0 +1,214 @@
+#ifndef _ASYNC_CLIENT_HPP_
+#define _ASYNC_CLIENT_HPP_
+
+#include "erpc_client_manager.h"
+#include "native_socket_transport.hpp"
+
+/*!
+ * @brief TCP connections one AsyncClientManager spreads its calls over.
+ */
+#ifndef CONFIG_ERPC_ASYNC_CONNECTIONS
+#define CONFIG_ERPC_ASYNC_CONNECTIONS 16
+#endif
+
+/*!
+ * @brief Calls one connection of an AsyncClientManager has on the wire at once.
+ *
+ * Further calls wait in the manager until a reply frees a place. The requests
+ * of a full window must fit into the socket's send buffer: sending blocks,
+ * and a blocked loop would stop reading the replies the server is waiting to
+ * send. Keep the windows of all connections to one NativeTcpServer below its
+ * CONFIG_ERPC_TCP_ADMIT, or the calls beyond it fail with
+ * kErpcStatus_ServerBusy.
+ */
+#ifndef CONFIG_ERPC_ASYNC_WINDOW
+#define CONFIG_ERPC_ASYNC_WINDOW 8
+#endif
+
+/*!
+ * @brief Calls an AsyncClientManager has on the wire at once, over all connections; a power of two.
+ *
+ * Calls are found by sequence number in a table of this size.
+ */
+#ifndef CONFIG_ERPC_ASYNC_CALLS
+#define CONFIG_ERPC_ASYNC_CALLS 1024
+#endif
+
+#if (CONFIG_ERPC_ASYNC_CALLS & (CONFIG_ERPC_ASYNC_CALLS - 1)) != 0
+#error "CONFIG_ERPC_ASYNC_CALLS must be a power of two"
+#endif
+
+#if CONFIG_ERPC_ASYNC_CONNECTIONS * CONFIG_ERPC_ASYNC_WINDOW > CONFIG_ERPC_ASYNC_CALLS
+#error "CONFIG_ERPC_ASYNC_CONNECTIONS * CONFIG_ERPC_ASYNC_WINDOW must not exceed CONFIG_ERPC_ASYNC_CALLS"
+#endif
+
+class AsyncClientManager;
+
+/*!
+ * @brief One call started with AsyncClientManager::start().
+ *
+ * The caller owns the object, keeps it alive until onComplete() and derives
+ * from it to learn of the completion.
+ */
+class AsyncCall {
+public:
+    AsyncCall(void)
+    : m_codec(NULL)
+    , m_sequence(0)
+    , m_startedAt(0)
+    , m_conn(NULL)
+    , m_prev(NULL)
+    , m_next(NULL)
+    , m_isOneway(false)
+    {
+    }
+
+    virtual ~AsyncCall(void) {}
+
+protected:
+    /*!
+     * @brief The call is over, on the loop thread.
+     *
+     * The codec of the request holds the reply, positioned at the results, or
+     * its status tells the error: kErpcStatus_Timeout, the status of a
+     * server's status-only reply (e.g. kErpcStatus_ServerBusy), or the
+     * transport's if the connection failed. A one-way call completes once sent. The call
+     * may start further calls from here, but must not wait for one.
+     */
+    virtual void onComplete(void) = 0;
+
+private:
+    friend class AsyncClientManager;
+
+    erpc::Codec *m_codec;
+    uint32_t m_sequence;
+    uint32_t m_startedAt; /*!< erpc_native_now_us() of start(). */
+    void *m_conn;         /*!< Connection it was sent on; NULL while queued. */
+    AsyncCall *m_prev;
+    AsyncCall *m_next;
+    bool m_isOneway;
+};
+
+/*!
+ * @brief ClientManager whose calls run asynchronously on a single-threaded event loop (native only).
+ *
+ * start() hands over an encoded request and returns at once; poll() or run()
+ * send the requests, wait for the sockets and complete each call when its
+ * reply arrives, calling AsyncCall::onComplete(). Replies are matched by
+ * sequence number, so their order does not matter and thousands of calls can
+ * be outstanding: up to CONFIG_ERPC_ASYNC_WINDOW on each connection, the
+ * rest waiting in start order. A call that is not answered within the
+ * timeout (setTimeout()) fails with kErpcStatus_Timeout and its late reply is
+ * dropped.
+ *
+ * Nothing locks: create requests, start calls and poll on one thread only.
+ * Generated client shims work too: their blocking performRequest() starts
+ * the call and polls until it completes, so they must not be called from an
+ * onComplete().
+ *
+ * async_coro.hpp adds C++20 coroutines on top: co_await of a call.
+ */
+class AsyncClientManager : public erpc::ClientManager {
+public:
+    AsyncClientManager(void);
+    virtual ~AsyncClientManager(void);
+
+    /*!
+     * @brief Make calls on the connected stream socket @p fd as well; it is closed by the manager.
+     *
+     * The codec and message buffer factories must be set first.
+     *
+     * @retval kErpcStatus_Success Connection added.
+     * @retval kErpcStatus_InvalidArgument Negative @p fd, or a factory not set.
+     * @retval kErpcStatus_MemoryError CONFIG_ERPC_ASYNC_CONNECTIONS reached.
+     */
+    erpc_status_t addConnection(int fd);
+
+    /*!
+     * @brief Connect to @p host (IPv4 address) on @p port and add the connection.
+     *
+     * @retval kErpcStatus_ConnectionFailure Invalid address, or connecting failed.
+     * @return Otherwise as addConnection().
+     */
+    erpc_status_t connect(const char *host, uint16_t port);
+
+    /*!
+     * @brief Fail calls unanswered @p timeoutUs microseconds after start(); 0 for no timeout.
+     */
+    void setTimeout(uint32_t timeoutUs) { m_timeoutUs = timeoutUs; }
+
+    /*!
+     * @brief Start @p request, created with createRequest() and encoded, as @p call.
+     *
+     * The caller reads the reply from the request's codec in
+     * AsyncCall::onComplete() or later, then calls releaseRequest().
+     *
+     * @retval kErpcStatus_Success Started; @p call will complete.
+     * @retval kErpcStatus_InvalidArgument No codec, or its status is an error.
+     * @retval kErpcStatus_ConnectionClosed No connection is open.
+     */
+    erpc_status_t start(AsyncCall &call, erpc::RequestContext &request);
+
+    /*!
+     * @brief Send waiting requests, then complete the calls answered or timed out within @p timeoutUs.
+     *
+     * Returns as soon as something completed, or after @p timeoutUs.
+     *
+     * @return Calls still outstanding.
+     */
+    unsigned poll(uint32_t timeoutUs);
+
+    /*!
+     * @brief Poll until no call is outstanding, or until stop().
+     */
+    void run(void);
+
+    /*!
+     * @brief Make run() return after the current poll().
+     */
+    void stop(void) { m_stop = true; }
+
+    /*!
+     * @brief Calls started and not completed yet.
+     */
+    unsigned getOutstandingCount(void) const { return m_queued + m_sent; }
+
+    virtual void performRequest(erpc::RequestContext &request) override;
+
+private:
+    struct Connection {
+        NativeSocketTransport m_transport;
+        unsigned m_inflight;
+        bool m_open;
+    };
+
+    struct CallList {
+        AsyncCall *m_head;
+        AsyncCall *m_tail;
+    };
+
+    static void append(CallList &list, AsyncCall &call);
+    static void unlink(CallList &list, AsyncCall &call);
+    Connection *chooseConnection(void);
+    void dispatch(void);
+    void receiveReplies(Connection &conn);
+    void receiveReply(Connection &conn);
+    void expire(uint32_t now);
+    uint32_t waitUs(uint32_t now, uint32_t timeoutUs);
+    void closeConnection(Connection &conn, erpc_status_t status);
+    void complete(AsyncCall &call, erpc_status_t status);
+
+    Connection m_connections[CONFIG_ERPC_ASYNC_CONNECTIONS];
+    unsigned m_count;
+    AsyncCall *m_calls[CONFIG_ERPC_ASYNC_CALLS]; /*!< Calls on the wire, by sequence number. */
+    CallList m_queue;                           /*!< Started, waiting for a connection, in start order. */
+    CallList m_wire;                            /*!< On the wire, in start order. */
+    unsigned m_queued;
+    unsigned m_sent;
+    erpc::MessageBuffer m_spare; /*!< Receives the next reply, then swapped with its call's buffer. */
+    erpc::Crc16 m_crc;
+    uint32_t m_timeoutUs;
+    bool m_stop;
+};
+
+#endif /* _ASYNC_CLIENT_HPP_ */
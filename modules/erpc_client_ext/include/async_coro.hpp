@@ -0,0 +1,148 @@
+#ifndef _ASYNC_CORO_HPP_
+#define _ASYNC_CORO_HPP_
+
+#include "async_client.hpp"
+
+/*!
+ * @brief 1 when the compiler offers C++20 coroutines, and this header its coroutine client layer.
+ *
+ * The apps build with -std=c++11 and see an empty header; a native gateway
+ * built with -std=c++20 gets AsyncTask and asyncCall().
+ */
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define ERPC_ASYNC_HAVE_COROUTINES 1
+#endif
+#endif
+#ifndef ERPC_ASYNC_HAVE_COROUTINES
+#define ERPC_ASYNC_HAVE_COROUTINES 0
+#endif
+
+#if ERPC_ASYNC_HAVE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <tuple>
+
+/*!
+ * @brief Return type of a coroutine that runs on its own, started by calling it.
+ *
+ * It runs until its first co_await of a call that has not completed, and is
+ * resumed by AsyncClientManager::poll() when the call completes. The frame is
+ * freed when the coroutine returns. Nothing waits for it: spawn thousands,
+ * then AsyncClientManager::run() until all their calls are done.
+ *
+ * @code
+ * AsyncTask sum(CalculatorAsync &calc, int32_t a, int32_t b)
+ * {
+ *     int32_t r = co_await calc.add(a, b);
+ *     printf("%d\n", r);
+ * }
+ * @endcode
+ */
+class AsyncTask {
+public:
+    struct promise_type {
+        AsyncTask get_return_object(void) noexcept { return AsyncTask(); }
+        std::suspend_never initial_suspend(void) noexcept { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void) noexcept {}
+        void unhandled_exception(void) noexcept { std::terminate(); }
+    };
+};
+
+/*!
+ * @brief co_await-able call of one method, from asyncCall().
+ *
+ * The request is encoded and started when awaited; the awaiting coroutine is
+ * resumed from AsyncClientManager::poll() with the result. Errors are
+ * reported as by the generated shims: the client's error handler is called
+ * with the method id and the result is -1.
+ */
+template <typename R, typename... Args>
+class AsyncMethodCall : public AsyncCall {
+public:
+    AsyncMethodCall(AsyncClientManager &client, uint32_t serviceId, uint32_t methodId, Args... args)
+    : m_client(client)
+    , m_serviceId(serviceId)
+    , m_methodId(methodId)
+    , m_args(args...)
+    , m_request(0, NULL, false)
+    , m_status(kErpcStatus_Success)
+    {
+    }
+
+    bool await_ready(void) const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+        m_request = m_client.createRequest(false);
+        erpc::Codec *codec = m_request.getCodec();
+        if (codec == NULL) {
+            m_status = kErpcStatus_MemoryError;
+            return false;
+        }
+        codec->startWriteMessage(erpc::message_type_t::kInvocationMessage, m_serviceId, m_methodId,
+                                 m_request.getSequence());
+        std::apply([codec](const Args &...a) { (codec->write(a), ...); }, m_args);
+        m_status = m_client.start(*this, m_request);
+        return m_status == kErpcStatus_Success; // resume right away if it did not start
+    }
+
+    R await_resume(void)
+    {
+        R result {};
+        erpc::Codec *codec = m_request.getCodec();
+        if ((codec != NULL) && (m_status == kErpcStatus_Success)) {
+            codec->read(result);
+            m_status = codec->getStatus();
+        } else if ((codec != NULL) && codec->isStatusOk()) {
+            codec->updateStatus(m_status);
+        }
+        m_client.releaseRequest(m_request);
+        m_client.callErrorHandler(m_status, m_methodId);
+        if (m_status != kErpcStatus_Success) {
+            result = static_cast<R>(-1);
+        }
+        return result;
+    }
+
+    /*!
+     * @brief Status of the call once resumed.
+     */
+    erpc_status_t getStatus(void) const { return m_status; }
+
+protected:
+    virtual void onComplete(void) override { m_handle.resume(); }
+
+private:
+    AsyncClientManager &m_client;
+    uint32_t m_serviceId;
+    uint32_t m_methodId;
+    std::tuple<Args...> m_args;
+    erpc::RequestContext m_request;
+    erpc_status_t m_status;
+    std::coroutine_handle<> m_handle;
+};
+
+/*!
+ * @brief Call @p methodId of service @p serviceId with @p args on @p client; co_await the result.
+ *
+ * For methods whose arguments and result are scalars written and read with
+ * the codec, as the generated shims do for them. Wrap it per service:
+ *
+ * @code
+ * auto add(int32_t a, int32_t b) { return asyncCall<int32_t>(m_client, m_serviceId, m_addId, a, b); }
+ * @endcode
+ */
+template <typename R, typename... Args>
+AsyncMethodCall<R, Args...> asyncCall(AsyncClientManager &client, uint32_t serviceId, uint32_t methodId,
+                                      Args... args)
+{
+    return AsyncMethodCall<R, Args...>(client, serviceId, methodId, args...);
+}
+
+#endif /* ERPC_ASYNC_HAVE_COROUTINES */
+
+#endif /* _ASYNC_CORO_HPP_ */
@@ -0,0 +1,262 @@
+#ifndef _CLIENT_POOL_HPP_
+#define _CLIENT_POOL_HPP_
+
+#include "reusable_client.hpp"
+#include "erpc_threading.h"
+
+/*!
+ * @brief Connections one ClientPool holds.
+ */
+#ifndef CONFIG_ERPC_CLIENT_POOL_SIZE
+#define CONFIG_ERPC_CLIENT_POOL_SIZE 4
+#endif
+
+/*!
+ * @brief Servers (endpoints) the connections of one ClientPool can lead to.
+ */
+#ifndef CONFIG_ERPC_CLIENT_POOL_ENDPOINTS
+#define CONFIG_ERPC_CLIENT_POOL_ENDPOINTS 4
+#endif
+
+/*!
+ * @brief An endpoint whose average latency exceeds this many times the best one's is ejected.
+ */
+#ifndef CONFIG_ERPC_CLIENT_LB_EJECT_FACTOR
+#define CONFIG_ERPC_CLIENT_LB_EJECT_FACTOR 4
+#endif
+
+/*!
+ * @brief Average latency below which an endpoint is never ejected, in microseconds.
+ */
+#ifndef CONFIG_ERPC_CLIENT_LB_EJECT_MIN_US
+#define CONFIG_ERPC_CLIENT_LB_EJECT_MIN_US 2000
+#endif
+
+/*!
+ * @brief Time an endpoint stays ejected the first time, in microseconds.
+ *
+ * Doubled on each repeated ejection, up to eight times as long, until the
+ * endpoint answers in time again.
+ */
+#ifndef CONFIG_ERPC_CLIENT_LB_EJECT_US
+#define CONFIG_ERPC_CLIENT_LB_EJECT_US 1000000
+#endif
+
+/*!
+ * @brief Methods ClientPool::hedgeMethod() can mark.
+ */
+#ifndef CONFIG_ERPC_CLIENT_HEDGE_METHODS
+#define CONFIG_ERPC_CLIENT_HEDGE_METHODS 8
+#endif
+
+/*!
+ * @brief Latest call latencies an endpoint keeps for its p95, the time after which a call is hedged.
+ *
+ * Calls to an endpoint are hedged only once it has answered this many.
+ */
+#ifndef CONFIG_ERPC_CLIENT_HEDGE_SAMPLES
+#define CONFIG_ERPC_CLIENT_HEDGE_SAMPLES 32
+#endif
+
+#if CONFIG_ERPC_CLIENT_POOL_ENDPOINTS > 255
+#error "CONFIG_ERPC_CLIENT_POOL_ENDPOINTS must not exceed 255"
+#endif
+
+#if (CONFIG_ERPC_CLIENT_HEDGE_SAMPLES < 1) || (CONFIG_ERPC_CLIENT_HEDGE_SAMPLES > 255)
+#error "CONFIG_ERPC_CLIENT_HEDGE_SAMPLES must be 1 .. 255"
+#endif
+
+/*!
+ * @brief ClientManager spreading concurrent calls over several connections.
+ *
+ * Each connection is a transport with its own ReusableClientManager, so one
+ * call at a time runs on it. createRequest() checks out a free connection,
+ * waiting while all are busy, and releaseRequest() returns it. Hand the pool
+ * to a generated client (e.g. initCalculator_client()) and its functions can
+ * be called from as many threads at once as there are connections.
+ *
+ * A caller that wants several calls on the same connection, e.g. to keep a
+ * server-side session, takes one with checkout() and gives it back with
+ * checkin().
+ *
+ * Connections can lead to different servers offering the same services
+ * (endpoints, numbered by the caller in addConnection()). A call then goes
+ * to the better of two endpoints drawn at random among those with a free
+ * connection (power of two choices): fewer calls outstanding, or on a tie
+ * the lower average latency. An endpoint whose average latency grows beyond
+ * CONFIG_ERPC_CLIENT_LB_EJECT_FACTOR times the best one's, or whose call
+ * fails, is ejected for CONFIG_ERPC_CLIENT_LB_EJECT_US or longer, and
+ * readmitted afterwards with its average forgotten. Calls wait for a
+ * connection to an admitted endpoint rather than going to an ejected one.
+ * The last admitted endpoint is never ejected.
+ *
+ * Calls of idempotent methods marked with hedgeMethod() are hedged: when no
+ * reply has come after the p95 latency of the endpoint called, the request
+ * is sent once more on a free connection to another admitted endpoint, and
+ * the first reply wins. The loser's reply is discarded by sequence number
+ * with the next call on its connection. A hedge is only sent while no caller
+ * waits for a connection, so hedging cannot add load to a saturated pool.
+ * Servers answer each connection in order, so until the late reply arrives
+ * the losing connection, like one whose call timed out, is only used when no
+ * other one is free.
+ * Hedged calls poll their transports every CONFIG_ERPC_CLIENT_POLL_US, which
+ * therefore must report pending data in hasMessage().
+ *
+ * The codec and message buffer factories of the pool, set before
+ * addConnection(), are shared by all connections and must be thread safe.
+ * Each connection keeps one buffer and codec from them for its calls (see
+ * ReusableClientManager); a factory with fewer left serves the remaining
+ * connections per call.
+ * With ERPC_THREADS_NONE nothing waits: when every connection is checked out,
+ * a call fails with kErpcStatus_MemoryError.
+ */
+class ClientPool : public erpc::ClientManager {
+public:
+    static const uint32_t kAnyMethod = 0xFFFFFFFFU; /*!< hedgeMethod(): every method of the service. */
+
+    ClientPool(void);
+    virtual ~ClientPool(void) {}
+
+    /*!
+     * @brief Make calls on @p transport as well.
+     *
+     * Call this before the first call.
+     *
+     * @param[in] transport Connected transport.
+     * @param[in] endpoint Server it leads to, 0 .. CONFIG_ERPC_CLIENT_POOL_ENDPOINTS - 1.
+     *
+     * @retval kErpcStatus_Success Connection added.
+     * @retval kErpcStatus_InvalidArgument NULL @p transport, no such endpoint, or no codec or message buffer factory set.
+     * @retval kErpcStatus_MemoryError CONFIG_ERPC_CLIENT_POOL_SIZE reached.
+     */
+    erpc_status_t addConnection(erpc::Transport *transport, uint8_t endpoint = 0);
+
+    unsigned getConnectionCount(void) const { return m_count; }
+
+    /*!
+     * @brief Average latency of the calls to @p endpoint, in microseconds; 0 before the first one.
+     */
+    uint32_t getEndpointLatency(uint8_t endpoint) const;
+
+    /*!
+     * @brief Return true while @p endpoint is ejected.
+     */
+    bool isEjected(uint8_t endpoint) const;
+
+    /*!
+     * @brief p95 latency of the latest calls to @p endpoint, in microseconds; 0 until it has answered enough.
+     */
+    uint32_t getEndpointP95(uint8_t endpoint) const;
+
+    /*!
+     * @brief Hedge calls of @p methodId of service @p serviceId.
+     *
+     * Only for idempotent methods: a hedged call may run on two servers.
+     * Call this before the first call.
+     *
+     * @param[in] serviceId Service id.
+     * @param[in] methodId Method id, or kAnyMethod.
+     *
+     * @retval kErpcStatus_Success Method marked.
+     * @retval kErpcStatus_MemoryError CONFIG_ERPC_CLIENT_HEDGE_METHODS reached.
+     */
+    erpc_status_t hedgeMethod(uint32_t serviceId, uint32_t methodId);
+
+    /*!
+     * @brief Hedges sent so far.
+     */
+    uint32_t getHedgedCount(void) const { return m_hedged; }
+
+    /*!
+     * @brief Hedges whose reply came first so far.
+     */
+    uint32_t getHedgeWinCount(void) const { return m_hedgeWins; }
+
+    /*!
+     * @brief Allow each following call @p budgetUs microseconds, on every connection; see DeadlineClientManager.
+     */
+    void setDeadline(uint32_t budgetUs);
+
+    /*!
+     * @brief Take a free connection for the caller alone, waiting while all are busy.
+     *
+     * @return Client of the connection, or NULL if the pool has none (or, without threads, none is free).
+     */
+    erpc::ClientManager *checkout(void);
+
+    /*!
+     * @brief Return a connection taken with checkout().
+     */
+    void checkin(erpc::ClientManager *client);
+
+    virtual erpc::RequestContext createRequest(bool isOneway) override;
+    virtual void performRequest(erpc::RequestContext &request) override;
+    virtual void releaseRequest(erpc::RequestContext &request) override;
+
+private:
+    struct Connection {
+        ReusableClientManager m_client;
+        erpc::Codec *m_codec; /*!< Codec of the request running on it, if m_busy. */
+        uint8_t m_endpoint;
+        bool m_busy;
+        bool m_late; /*!< Its last call timed out or lost a hedge race; the reply is still to come. */
+    };
+
+    struct Endpoint {
+        uint32_t m_latencyUs;    /*!< Moving average over calls, 1/8 weight for the newest; 0 if unknown. */
+        uint32_t m_ejectedUntil; /*!< ztimer_now(ZTIMER_USEC) of readmission, if m_ejected. */
+        uint8_t m_connectionCount;
+        uint8_t m_outstanding;   /*!< Connections to it that are checked out. */
+        uint8_t m_ejections;     /*!< Ejections since it last answered in time. */
+        bool m_ejected;
+        uint32_t m_p95Us;        /*!< p95 of m_samples once full, else 0. */
+        uint32_t m_samples[CONFIG_ERPC_CLIENT_HEDGE_SAMPLES]; /*!< Latest latencies, a ring. */
+        uint8_t m_sampleCount;
+        uint8_t m_sampleNext;
+    };
+
+    struct HedgeRule {
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+    };
+
+#if !ERPC_THREADS_IS(NONE)
+    struct Waiter {
+        erpc::Semaphore m_ready; /*!< Put once m_conn is set. */
+        Connection *m_conn;
+        Waiter *m_next;
+    };
+#endif
+
+    Connection *take(void);
+    void give(Connection *conn);
+    Connection *findRequest(erpc::RequestContext &request);
+    Connection *choose(uint32_t now, unsigned exclude, bool skipLate);
+    Connection *chooseAny(uint32_t now);
+    static bool isLate(Connection &conn);
+    Connection *takeHedge(uint8_t endpoint);
+    void performHedged(Connection &conn, erpc::RequestContext &request, uint32_t start, uint32_t hedgeAfterUs);
+    Connection *sendHedge(Connection &conn, erpc::MessageBuffer &copy, erpc::RequestContext &hedgeRequest,
+                          uint32_t budgetUs);
+    bool isHedged(Connection &conn, erpc::RequestContext &request, uint32_t &hedgeAfterUs);
+    void recordCall(Connection &conn, uint32_t latencyUs, bool failed, uint32_t now, bool abandoned = false);
+    void recordSample(Endpoint &ep, uint32_t latencyUs);
+    bool otherAdmitted(uint8_t endpoint, uint32_t &bestLatencyUs) const;
+    uint32_t random(void);
+
+    Connection m_connections[CONFIG_ERPC_CLIENT_POOL_SIZE];
+    Endpoint m_endpoints[CONFIG_ERPC_CLIENT_POOL_ENDPOINTS];
+    unsigned m_count;
+    uint32_t m_random; /*!< xorshift32 state for the two choices. */
+    HedgeRule m_hedgeRules[CONFIG_ERPC_CLIENT_HEDGE_METHODS];
+    uint8_t m_hedgeRuleCount;
+    uint32_t m_hedged;
+    uint32_t m_hedgeWins;
+#if !ERPC_THREADS_IS(NONE)
+    erpc::Mutex m_lock;
+    Waiter *m_waitHead; /*!< Callers waiting in take(), served first come first served. */
+    Waiter *m_waitTail;
+#endif
+};
+
+#endif /* _CLIENT_POOL_HPP_ */
@@ -0,0 +1,99 @@
+#ifndef _DEADLINE_CLIENT_HPP_
+#define _DEADLINE_CLIENT_HPP_
+
+#include "erpc_client_manager.h"
+#include "erpc_status_ext.h"
+
+/*!
+ * @brief Time between two checks for a reply while a deadline runs, in microseconds.
+ */
+#ifndef CONFIG_ERPC_CLIENT_POLL_US
+#define CONFIG_ERPC_CLIENT_POLL_US 100
+#endif
+
+/*!
+ * @brief ClientManager that gives every request a deadline.
+ *
+ * The deadline is written into the request header (see
+ * erpc::CompactCodec::insertDeadline()), so the codec factory must create
+ * erpc::CompactCodec instances. Servers of erpc_server_ext drop requests
+ * that are still waiting when it passes.
+ *
+ * While waiting for the reply the client polls
+ * erpc::Transport::hasMessage(); once the deadline passes the call fails
+ * with kErpcStatus_Timeout, reported through the error handler like any
+ * other error. The reply may still arrive later: the next call discards
+ * replies with an older sequence number, so the transport stays in step.
+ * A transport whose hasMessage() always returns true (the eRPC default)
+ * blocks in receive() as without a deadline.
+ *
+ * Without a deadline (setDeadline(0), the default) requests go out exactly as
+ * with erpc::ClientManager.
+ *
+ * Either way, a status-only reply (erpc::writeStatusReply(), such as
+ * kErpcStatus_ServerBusy from a server shedding load) fails the call with
+ * that status, in both codecs.
+ */
+class DeadlineClientManager : public erpc::ClientManager {
+public:
+    DeadlineClientManager(void)
+    : ClientManager()
+    , m_budgetUs(0)
+    {
+    }
+
+    virtual ~DeadlineClientManager(void) {}
+
+    /*!
+     * @brief Allow each following call @p budgetUs microseconds from send to reply; 0 for no deadline.
+     */
+    void setDeadline(uint32_t budgetUs) { m_budgetUs = budgetUs; }
+
+    uint32_t getDeadline(void) const { return m_budgetUs; }
+
+    /*!
+     * @brief Send @p request with a deadline of @p budgetUs (0 for none) and return without waiting for the reply.
+     *
+     * For callers that wait on several connections at once; collect the
+     * reply with pollReply(). Errors are set on the request's codec.
+     */
+    void sendRequest(erpc::RequestContext &request, uint32_t budgetUs);
+
+    /*!
+     * @brief Receive one message if the transport has one, discarding replies to earlier calls.
+     *
+     * @retval true The reply to @p request arrived and was verified, or
+     *              receiving failed; the codec's status tells which.
+     * @retval false No reply yet.
+     */
+    bool pollReply(erpc::RequestContext &request);
+
+protected:
+    virtual void performClientRequest(erpc::RequestContext &request) override;
+
+    /*!
+     * @brief Wait until the transport has a message or @p budgetUs have passed since @p startUs.
+     *
+     * @retval true A message is waiting.
+     * @retval false Timed out.
+     */
+    bool waitForMessage(uint32_t startUs, uint32_t budgetUs);
+
+    /*!
+     * @brief Receive replies until the one for @p request arrives; older ones are discarded.
+     */
+    void receiveReply(erpc::RequestContext &request, uint32_t startUs, uint32_t budgetUs);
+
+    /*!
+     * @brief verifyReply() for the message just received for @p request.
+     *
+     * @retval true Verified; the codec's status tells the outcome.
+     * @retval false A reply to an earlier call, to be skipped.
+     */
+    bool acceptReply(erpc::RequestContext &request);
+
+private:
+    uint32_t m_budgetUs;
+};
+
+#endif /* _DEADLINE_CLIENT_HPP_ */
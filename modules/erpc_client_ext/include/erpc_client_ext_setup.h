@@ -0,0 +1,110 @@
+#ifndef _ERPC_CLIENT_EXT_SETUP_H_
+#define _ERPC_CLIENT_EXT_SETUP_H_
+
+#include <stdint.h>
+#include "erpc_client_setup.h"
+#include "erpc_status_ext.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Create a client whose calls can carry a deadline (DeadlineClientManager).
+ *
+ * Same as erpc_client_init(), except that the client uses erpc::CompactCodec,
+ * so the server must be set to ERPC_CODEC_COMPACT too, and that
+ * erpc_client_deinit() must not be called on it. There is one such client
+ * per firmware image. It keeps one buffer of @p message_buffer_factory for
+ * all its calls instead of taking one per call (ReusableClientManager).
+ *
+ * @return Client handle, or NULL if it already exists.
+ */
+erpc_client_t erpc_client_deadline_init(erpc_transport_t transport, erpc_mbf_t message_buffer_factory);
+
+/*!
+ * @brief Allow each following call of @p client @p budget_us microseconds; 0 for no deadline.
+ *
+ * A call whose reply does not arrive in time fails with kErpcStatus_Timeout;
+ * the server drops it if it has not started it yet.
+ *
+ * @retval kErpcStatus_Success Deadline set.
+ * @retval kErpcStatus_InvalidArgument NULL client.
+ */
+erpc_status_t erpc_client_set_deadline(erpc_client_t client, uint32_t budget_us);
+
+/*!
+ * @brief Create a client that spreads concurrent calls over several connections (ClientPool).
+ *
+ * Add connections with erpc_client_pool_add_connection(), then pass the
+ * handle to a generated client init function (e.g. initCalculator_client()):
+ * each generated call checks out a free connection, waiting while all are
+ * busy, so up to CONFIG_ERPC_CLIENT_POOL_SIZE threads call at once. The
+ * client uses erpc::BasicCodec, as erpc_client_init() does, and
+ * @p message_buffer_factory must be thread safe. erpc_client_deinit() must
+ * not be called on it. There is one pool per firmware image.
+ *
+ * @return Client handle, or NULL if it already exists.
+ */
+erpc_client_t erpc_client_pool_init(erpc_mbf_t message_buffer_factory);
+
+/*!
+ * @brief Let the pool make calls on @p transport as well, e.g. a further erpc_transport_tcp_init() connection.
+ *
+ * Connections to different servers offering the same services get different
+ * @p endpoint numbers; calls are then balanced over the servers and slow or
+ * failing ones are ejected for a while (see ClientPool). Call this before the
+ * first call.
+ *
+ * @param[in] client Pool from erpc_client_pool_init().
+ * @param[in] transport Connected transport.
+ * @param[in] endpoint Server @p transport leads to, 0 .. CONFIG_ERPC_CLIENT_POOL_ENDPOINTS - 1.
+ *
+ * @retval kErpcStatus_Success Connection added.
+ * @retval kErpcStatus_InvalidArgument NULL argument or no such endpoint.
+ * @retval kErpcStatus_MemoryError CONFIG_ERPC_CLIENT_POOL_SIZE reached.
+ */
+erpc_status_t erpc_client_pool_add_connection(erpc_client_t client, erpc_transport_t transport, uint8_t endpoint);
+
+/*!
+ * @brief Take a free connection of the pool for the calling thread alone, waiting while all are busy.
+ *
+ * The returned handle can be passed to a second generated client to make
+ * several calls on one connection. Return it with erpc_client_pool_checkin().
+ *
+ * @return Client handle of the connection, or NULL if the pool has none.
+ */
+erpc_client_t erpc_client_pool_checkout(erpc_client_t client);
+
+/*!
+ * @brief Return a connection taken with erpc_client_pool_checkout().
+ */
+void erpc_client_pool_checkin(erpc_client_t client, erpc_client_t connection);
+
+/*!
+ * @brief erpc_client_pool_hedge_method(): every method of the service.
+ */
+#define ERPC_HEDGE_ANY_METHOD (0xFFFFFFFFU)
+
+/*!
+ * @brief Hedge calls of @p method_id of service @p service_id over the pool's endpoints.
+ *
+ * A call that has no reply after the p95 latency of its endpoint is sent to
+ * a second endpoint as well, and the first reply is used (see ClientPool).
+ * Only for idempotent methods. Call this before the first call.
+ *
+ * @param[in] client Pool from erpc_client_pool_init().
+ * @param[in] service_id Service id as generated from the IDL.
+ * @param[in] method_id Method id, or ERPC_HEDGE_ANY_METHOD.
+ *
+ * @retval kErpcStatus_Success Method hedged.
+ * @retval kErpcStatus_InvalidArgument NULL client.
+ * @retval kErpcStatus_MemoryError CONFIG_ERPC_CLIENT_HEDGE_METHODS reached.
+ */
+erpc_status_t erpc_client_pool_hedge_method(erpc_client_t client, uint32_t service_id, uint32_t method_id);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _ERPC_CLIENT_EXT_SETUP_H_ */
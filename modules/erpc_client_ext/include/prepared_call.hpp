@@ -0,0 +1,98 @@
+#ifndef _PREPARED_CALL_HPP_
+#define _PREPARED_CALL_HPP_
+
+#include "erpc_client_manager.h"
+
+/*!
+ * @brief Longest message header, without its sequence number, a PreparedCall keeps.
+ *
+ * BasicCodec headers need 4 bytes, CompactCodec ones up to 11.
+ */
+#ifndef CONFIG_ERPC_PREPARED_HEADER_SIZE
+#define CONFIG_ERPC_PREPARED_HEADER_SIZE 12
+#endif
+
+#if (CONFIG_ERPC_PREPARED_HEADER_SIZE < 4) || (CONFIG_ERPC_PREPARED_HEADER_SIZE > 64)
+#error "CONFIG_ERPC_PREPARED_HEADER_SIZE must be 4 .. 64"
+#endif
+
+/*!
+ * @brief Request of one method whose constant header is encoded only once.
+ *
+ * A generated client shim encodes the whole message header with
+ * startWriteMessage() on every call, though only the sequence number in it
+ * changes. prepare() encodes the header once with the client's codec and
+ * keeps the bytes in front of the sequence number; begin() copies them into
+ * the new request and encodes only the sequence number. The caller then
+ * writes the arguments as the shim would:
+ *
+ * @code
+ * erpc::RequestContext request = m_add.begin();
+ * erpc::Codec *codec = request.getCodec();
+ * if (codec != NULL) {
+ *     codec->write(a);
+ *     codec->write(b);
+ *     m_add.perform(request);
+ *     codec->read(result);
+ * }
+ * m_add.end(request);
+ * @endcode
+ *
+ * The bytes sent are those startWriteMessage() would have produced, so
+ * servers and the clients of this module (deadlines, pools, reused buffers)
+ * see no difference. A codec whose header does not end with its encoding of
+ * the sequence number is not prepared; begin() then calls
+ * startWriteMessage() as usual.
+ */
+class PreparedCall {
+public:
+    PreparedCall(void);
+
+    /*!
+     * @brief Encode the header of method @p methodId of service @p serviceId, called through @p client.
+     *
+     * Call this once the client is set up; it makes and discards one request.
+     *
+     * @param[in] client Client the calls go through; its codec factory must not change afterwards.
+     * @param[in] serviceId Service id.
+     * @param[in] methodId Method id.
+     * @param[in] isOneway The method has no reply.
+     *
+     * @retval kErpcStatus_Success Header encoded.
+     * @retval kErpcStatus_InvalidArgument NULL @p client, or its codec's header cannot be prepared;
+     *         begin() then encodes it every time.
+     * @retval kErpcStatus_MemoryError The client could not create a request; begin() then encodes every time.
+     */
+    erpc_status_t prepare(erpc::ClientManager *client, uint32_t serviceId, uint32_t methodId, bool isOneway = false);
+
+    bool isPrepared(void) const { return m_headerSize != 0U; }
+
+    /*!
+     * @brief Create a request with the header written; its codec, if not NULL, takes the arguments next.
+     */
+    erpc::RequestContext begin(void);
+
+    /*!
+     * @brief Send @p request and, unless one-way, receive its reply.
+     */
+    void perform(erpc::RequestContext &request) { m_client->performRequest(request); }
+
+    /*!
+     * @brief Dispose of @p request.
+     */
+    void end(erpc::RequestContext &request) { m_client->releaseRequest(request); }
+
+    erpc::ClientManager *getClient(void) const { return m_client; }
+
+    uint32_t getMethodId(void) const { return m_methodId; }
+
+private:
+    erpc::ClientManager *m_client;
+    uint32_t m_serviceId;
+    uint32_t m_methodId;
+    bool m_isOneway;
+    uint8_t m_headerSize; /*!< Bytes in m_header; 0 if not prepared. */
+    uint8_t m_header[CONFIG_ERPC_PREPARED_HEADER_SIZE]; /*!< Header up to the sequence number. */
+};
+
+#endif /* _PREPARED_CALL_HPP_ */
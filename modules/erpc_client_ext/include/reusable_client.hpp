@@ -0,0 +1,68 @@
+#ifndef _REUSABLE_CLIENT_HPP_
+#define _REUSABLE_CLIENT_HPP_
+
+#include "deadline_client.hpp"
+
+/*!
+ * @brief DeadlineClientManager that reuses one preallocated request set.
+ *
+ * erpc::ClientManager::createRequest() takes a buffer from the message
+ * buffer factory and a codec from the codec factory for every call, and
+ * releaseRequest() gives both back. After preallocate() this client keeps
+ * one buffer and codec for its lifetime: createRequest() only resets them
+ * and numbers the request, releaseRequest() only marks them free. A calling
+ * loop then allocates nothing and keeps touching the same memory.
+ *
+ * Only one request uses the set at a time. A request created while it is
+ * taken, e.g. by a second thread or a nested call, gets its own buffer and
+ * codec as with erpc::ClientManager, so correctness never depends on it.
+ * Without preallocate(), or if it failed, every request does.
+ *
+ * The set goes back to the factories that created it. When the client's
+ * factories are replaced after preallocate(), e.g. by
+ * erpc::FinalCodecFactory::install() or erpc_client_set_codec(), the next
+ * request disposes of the old set and takes a new one from the current
+ * factories.
+ */
+class ReusableClientManager : public DeadlineClientManager {
+public:
+    ReusableClientManager(void)
+    : DeadlineClientManager()
+    , m_codec(NULL)
+    , m_setCodecFactory(NULL)
+    , m_setMessageFactory(NULL)
+    , m_inUse(false)
+    {
+    }
+
+    virtual ~ReusableClientManager(void);
+
+    /*!
+     * @brief Take the buffer and codec kept for all requests.
+     *
+     * Call this after the transport and both factories are set, before the
+     * first call. The buffer stays taken from the factory until destruction
+     * or until the factories are replaced.
+     *
+     * @retval kErpcStatus_Success Set preallocated, or already was.
+     * @retval kErpcStatus_InvalidArgument Transport or a factory not set.
+     * @retval kErpcStatus_MemoryError The factory had no buffer or codec; requests allocate as usual.
+     */
+    erpc_status_t preallocate(void);
+
+    bool isPreallocated(void) const { return m_codec != NULL; }
+
+    virtual erpc::RequestContext createRequest(bool isOneway) override;
+    virtual void releaseRequest(erpc::RequestContext &request) override;
+
+private:
+    void refreshSet(void);
+    void disposeSet(void);
+
+    erpc::Codec *m_codec; /*!< Codec of the preallocated set, holding its buffer; NULL if none. */
+    erpc::CodecFactory *m_setCodecFactory;           /*!< Factory the set was taken from; NULL before preallocate(). */
+    erpc::MessageBufferFactory *m_setMessageFactory; /*!< Factory the buffer of the set was taken from. */
+    bool m_inUse;         /*!< A request uses the set. */
+};
+
+#endif /* _REUSABLE_CLIENT_HPP_ */
@@ -0,0 +1,86 @@
+// prepared_call.cpp — requests whose constant header is encoded once per method
+#include "prepared_call.hpp"
+
+#include <cstring>
+
+using namespace erpc;
+
+PreparedCall::PreparedCall(void)
+: m_client(NULL)
+, m_serviceId(0)
+, m_methodId(0)
+, m_isOneway(false)
+, m_headerSize(0)
+{
+}
+
+erpc_status_t PreparedCall::prepare(ClientManager *client, uint32_t serviceId, uint32_t methodId, bool isOneway)
+{
+    if (client == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    m_client = client;
+    m_serviceId = serviceId;
+    m_methodId = methodId;
+    m_isOneway = isOneway;
+    m_headerSize = 0;
+
+    RequestContext request = m_client->createRequest(isOneway);
+    Codec *codec = request.getCodec();
+    if (codec == NULL) {
+        m_client->releaseRequest(request);
+        return kErpcStatus_MemoryError;
+    }
+
+    // The whole header, then the sequence number alone: the header can be
+    // prepared if it ends with the latter.
+    MessageBuffer &buffer = codec->getBufferRef();
+    uint32_t offset = buffer.getUsed();
+    codec->startWriteMessage(isOneway ? message_type_t::kOnewayMessage : message_type_t::kInvocationMessage,
+                             serviceId, methodId, request.getSequence());
+    uint32_t headerSize = buffer.getUsed() - offset;
+    uint8_t header[CONFIG_ERPC_PREPARED_HEADER_SIZE + 5U];
+    bool ok = codec->isStatusOk() && (headerSize <= sizeof(header));
+    if (ok) {
+        memcpy(header, buffer.get() + offset, headerSize);
+        buffer.setUsed(offset);
+        codec->reset(offset);
+        codec->write(request.getSequence());
+        uint32_t sequenceSize = buffer.getUsed() - offset;
+        ok = codec->isStatusOk() && (sequenceSize < headerSize) &&
+             (headerSize - sequenceSize <= CONFIG_ERPC_PREPARED_HEADER_SIZE) &&
+             (memcmp(header + headerSize - sequenceSize, buffer.get() + offset, sequenceSize) == 0);
+        if (ok) {
+            m_headerSize = static_cast<uint8_t>(headerSize - sequenceSize);
+            memcpy(m_header, header, m_headerSize);
+        }
+    }
+    m_client->releaseRequest(request);
+    return ok ? kErpcStatus_Success : kErpcStatus_InvalidArgument;
+}
+
+RequestContext PreparedCall::begin(void)
+{
+    RequestContext request = m_client->createRequest(m_isOneway);
+    Codec *codec = request.getCodec();
+    if (codec == NULL) {
+        return request;
+    }
+    if (m_headerSize == 0U) {
+        codec->startWriteMessage(m_isOneway ? message_type_t::kOnewayMessage : message_type_t::kInvocationMessage,
+                                 m_serviceId, m_methodId, request.getSequence());
+        return request;
+    }
+
+    MessageBuffer &buffer = codec->getBufferRef();
+    uint32_t offset = buffer.getUsed() + m_headerSize;
+    if (offset > buffer.getLength()) {
+        codec->updateStatus(kErpcStatus_BufferOverrun);
+        return request;
+    }
+    memcpy(buffer.get() + buffer.getUsed(), m_header, m_headerSize);
+    buffer.setUsed(offset);
+    codec->reset(offset);
+    codec->write(request.getSequence());
+    return request;
+}
@@ -0,0 +1,67 @@
+// reusable_client.cpp — ClientManager reusing one preallocated buffer and codec for its requests
+#include "reusable_client.hpp"
+
+using namespace erpc;
+
+ReusableClientManager::~ReusableClientManager(void)
+{
+    disposeSet();
+}
+
+erpc_status_t ReusableClientManager::preallocate(void)
+{
+    if ((m_transport == NULL) || (m_codecFactory == NULL) || (m_messageFactory == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    if ((m_setCodecFactory != m_codecFactory) || (m_setMessageFactory != m_messageFactory)) {
+        refreshSet();
+    }
+    return (m_codec != NULL) ? kErpcStatus_Success : kErpcStatus_MemoryError;
+}
+
+void ReusableClientManager::refreshSet(void)
+{
+    // Called while no request uses the set. Each set goes back where it came from.
+    disposeSet();
+    m_setCodecFactory = m_codecFactory;
+    m_setMessageFactory = m_messageFactory;
+    m_codec = createBufferAndCodec();
+}
+
+void ReusableClientManager::disposeSet(void)
+{
+    if (m_codec != NULL) {
+        m_setMessageFactory->dispose(&m_codec->getBufferRef());
+        m_setCodecFactory->dispose(m_codec);
+        m_codec = NULL;
+    }
+}
+
+RequestContext ReusableClientManager::createRequest(bool isOneway)
+{
+    if ((m_setCodecFactory == NULL) || __atomic_exchange_n(&m_inUse, true, __ATOMIC_ACQUIRE)) {
+        return ClientManager::createRequest(isOneway);
+    }
+    // Factories replaced since the set was taken: a set of theirs, once.
+    if ((m_setCodecFactory != m_codecFactory) || (m_setMessageFactory != m_messageFactory)) {
+        refreshSet();
+    }
+    if (m_codec == NULL) {
+        __atomic_store_n(&m_inUse, false, __ATOMIC_RELEASE);
+        return ClientManager::createRequest(isOneway);
+    }
+    // What createBufferAndCodec() would hand out, minus both factories.
+    uint8_t headerSize = m_transport->reserveHeaderSize();
+    m_codec->getBufferRef().setUsed(headerSize);
+    m_codec->reset(headerSize);
+    return RequestContext(++m_sequence, m_codec, isOneway);
+}
+
+void ReusableClientManager::releaseRequest(RequestContext &request)
+{
+    if ((request.getCodec() != NULL) && (request.getCodec() == m_codec)) {
+        __atomic_store_n(&m_inUse, false, __ATOMIC_RELEASE);
+    } else {
+        ClientManager::releaseRequest(request);
+    }
+}
@@ -0,0 +1,122 @@
+// erpc_bswap.cpp — bulk byte swap kernels for the POD array codec path
+#include "erpc_bswap.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ERPC_BSWAP_HAVE_SSSE3 1
+#include <immintrin.h>
+#else
+#define ERPC_BSWAP_HAVE_SSSE3 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels
+////////////////////////////////////////////////////////////////////////////////
+
+// Scalar loops; memcpy keeps unaligned buffers legal and compiles to plain loads.
+static void bswap16_scalar(uint8_t *dst, const uint8_t *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, dst += 2, src += 2) {
+        uint16_t v;
+        std::memcpy(&v, src, sizeof(v));
+        v = __builtin_bswap16(v);
+        std::memcpy(dst, &v, sizeof(v));
+    }
+}
+
+static void bswap32_scalar(uint8_t *dst, const uint8_t *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, dst += 4, src += 4) {
+        uint32_t v;
+        std::memcpy(&v, src, sizeof(v));
+        v = __builtin_bswap32(v);
+        std::memcpy(dst, &v, sizeof(v));
+    }
+}
+
+static void bswap64_scalar(uint8_t *dst, const uint8_t *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, dst += 8, src += 8) {
+        uint64_t v;
+        std::memcpy(&v, src, sizeof(v));
+        v = __builtin_bswap64(v);
+        std::memcpy(dst, &v, sizeof(v));
+    }
+}
+
+#if ERPC_BSWAP_HAVE_SSSE3
+// One PSHUFB per 16 bytes; the tail goes through the scalar loop.
+__attribute__((target("ssse3")))
+static uint32_t bswap_ssse3(uint8_t *dst, const uint8_t *src, uint32_t bytes, __m128i mask)
+{
+    uint32_t done = 0;
+    for (; done + 16U <= bytes; done += 16U) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + done), _mm_shuffle_epi8(v, mask));
+    }
+    return done;
+}
+
+static bool bswap_ssse3_supported(void)
+{
+    static int s_supported = -1;
+    if (s_supported < 0) {
+        __builtin_cpu_init();
+        s_supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+    return s_supported == 1;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// External C Interface
+////////////////////////////////////////////////////////////////////////////////
+
+void erpc_bswap16_copy(void *dst, const void *src, uint32_t count)
+{
+    uint8_t *d = static_cast<uint8_t *>(dst);
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+#if ERPC_BSWAP_HAVE_SSSE3
+    if (bswap_ssse3_supported()) {
+        const __m128i mask = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+        uint32_t done = bswap_ssse3(d, s, count * 2U, mask);
+        d += done;
+        s += done;
+        count -= done / 2U;
+    }
+#endif
+    bswap16_scalar(d, s, count);
+}
+
+void erpc_bswap32_copy(void *dst, const void *src, uint32_t count)
+{
+    uint8_t *d = static_cast<uint8_t *>(dst);
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+#if ERPC_BSWAP_HAVE_SSSE3
+    if (bswap_ssse3_supported()) {
+        const __m128i mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        uint32_t done = bswap_ssse3(d, s, count * 4U, mask);
+        d += done;
+        s += done;
+        count -= done / 4U;
+    }
+#endif
+    bswap32_scalar(d, s, count);
+}
+
+void erpc_bswap64_copy(void *dst, const void *src, uint32_t count)
+{
+    uint8_t *d = static_cast<uint8_t *>(dst);
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+#if ERPC_BSWAP_HAVE_SSSE3
+    if (bswap_ssse3_supported()) {
+        const __m128i mask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+        uint32_t done = bswap_ssse3(d, s, count * 8U, mask);
+        d += done;
+        s += done;
+        count -= done / 8U;
+    }
+#endif
+    bswap64_scalar(d, s, count);
+}
@@ -0,0 +1,44 @@
+// erpc_codec_setup.cpp — swap the codec factory of an eRPC client or server
+#include "erpc_codec_setup.h"
+#include "erpc_basic_codec.hpp"
+#include "erpc_client_manager.h"
+#include "erpc_compact_codec.hpp"
+#include "erpc_simple_server.hpp"
+
+using namespace erpc;
+
+// Factories are stateless, one instance each serves every client and server.
+static BasicCodecFactory s_basicCodecFactory;
+static CompactCodecFactory s_compactCodecFactory;
+
+static CodecFactory *codec_factory(erpc_codec_kind_t kind)
+{
+    switch (kind) {
+    case ERPC_CODEC_BASIC:
+        return &s_basicCodecFactory;
+    case ERPC_CODEC_COMPACT:
+        return &s_compactCodecFactory;
+    default:
+        return NULL;
+    }
+}
+
+erpc_status_t erpc_client_set_codec(erpc_client_t client, erpc_codec_kind_t kind)
+{
+    CodecFactory *factory = codec_factory(kind);
+    if ((client == NULL) || (factory == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    reinterpret_cast<ClientManager *>(client)->setCodecFactory(factory);
+    return kErpcStatus_Success;
+}
+
+erpc_status_t erpc_server_set_codec(erpc_server_t server, erpc_codec_kind_t kind)
+{
+    CodecFactory *factory = codec_factory(kind);
+    if ((server == NULL) || (factory == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    reinterpret_cast<SimpleServer *>(server)->setCodecFactory(factory);
+    return kErpcStatus_Success;
+}
@@ -0,0 +1,279 @@
+// erpc_compact_codec.cpp — varint codec with a compact message header
+#include "erpc_compact_codec.hpp"
+
+#include <string.h>
+
+using namespace erpc;
+
+const uint8_t CompactCodec::kCompactCodecVersion = 0xC;
+const uint8_t CompactCodec::kHeaderTypeMask = 0x07;
+const uint8_t CompactCodec::kHeaderDeadlineFlag = 0x08;
+const uint8_t CompactCodec::kHeaderStatusFlag = 0x08;
+
+static inline uint64_t zigzag_encode(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1U);
+}
+
+void CompactCodec::writeVarint(uint64_t value)
+{
+    uint8_t tmp[10];
+    uint32_t n = 0;
+
+    while (value >= 0x80U) {
+        tmp[n++] = static_cast<uint8_t>(value | 0x80U);
+        value >>= 7;
+    }
+    tmp[n++] = static_cast<uint8_t>(value);
+    writeData(n, tmp);
+}
+
+uint64_t CompactCodec::readVarint(uint8_t maxBits)
+{
+    uint64_t value = 0;
+    uint8_t shift = 0;
+
+    if (!isStatusOk()) {
+        return 0;
+    }
+
+    // Decode in place; the cursor only moves once the whole varint is valid.
+    const uint8_t *p = m_cursor.get();
+    uint16_t avail = m_cursor.getRemainingUsed();
+    uint16_t n = 0;
+
+    for (;;) {
+        if ((n == avail) || (shift >= maxBits)) {
+            updateStatus(kErpcStatus_Fail);
+            return 0;
+        }
+        uint8_t b = p[n++];
+        value |= static_cast<uint64_t>(b & 0x7FU) << shift;
+        shift += 7;
+        if ((b & 0x80U) == 0U) {
+            break;
+        }
+    }
+
+    if ((maxBits < 64U) && ((value >> maxBits) != 0U)) {
+        updateStatus(kErpcStatus_Fail);
+        return 0;
+    }
+
+    m_cursor += n;
+    return value;
+}
+
+void CompactCodec::startWriteMessage(message_type_t type, uint32_t service, uint32_t request, uint32_t sequence)
+{
+    uint8_t head = static_cast<uint8_t>((kCompactCodecVersion << 4) | (static_cast<uint8_t>(type) & 0x0FU));
+
+    BasicCodec::write(head);
+    writeVarint(service);
+    writeVarint(request);
+    writeVarint(sequence);
+}
+
+void CompactCodec::write(int16_t value)
+{
+    writeVarint(zigzag_encode(value));
+}
+
+void CompactCodec::write(int32_t value)
+{
+    writeVarint(zigzag_encode(value));
+}
+
+void CompactCodec::write(int64_t value)
+{
+    writeVarint(zigzag_encode(value));
+}
+
+void CompactCodec::write(uint16_t value)
+{
+    writeVarint(value);
+}
+
+void CompactCodec::write(uint32_t value)
+{
+    writeVarint(value);
+}
+
+void CompactCodec::write(uint64_t value)
+{
+    writeVarint(value);
+}
+
+void CompactCodec::startReadMessage(message_type_t &type, uint32_t &service, uint32_t &request, uint32_t &sequence)
+{
+    uint8_t head = 0;
+
+    BasicCodec::read(head);
+    if (isStatusOk() && ((head >> 4) != kCompactCodecVersion)) {
+        updateStatus(kErpcStatus_InvalidMessageVersion);
+    }
+
+    service = static_cast<uint32_t>(readVarint(32));
+    request = static_cast<uint32_t>(readVarint(32));
+    sequence = static_cast<uint32_t>(readVarint(32));
+    if ((head & kHeaderDeadlineFlag) != 0U) {
+        // Deadline or status; readers use readDeadline()/readStatus().
+        (void)readVarint(32);
+    }
+    type = static_cast<message_type_t>(head & kHeaderTypeMask);
+}
+
+// Length of the varint at @p p, or 0 if it does not end within @p size bytes.
+static uint32_t varint_length(const uint8_t *p, uint32_t size)
+{
+    for (uint32_t n = 0; (n < size) && (n < 5U); ++n) {
+        if ((p[n] & 0x80U) == 0U) {
+            return n + 1U;
+        }
+    }
+    return 0;
+}
+
+// Length of the header up to the deadline field, or 0 if @p data is not a compact header.
+static uint32_t header_length(const uint8_t *data, uint32_t size)
+{
+    if ((size == 0U) || ((data[0] >> 4) != CompactCodec::kCompactCodecVersion)) {
+        return 0;
+    }
+    uint32_t pos = 1;
+    for (unsigned i = 0; i < 3U; ++i) {
+        uint32_t n = varint_length(data + pos, size - pos);
+        if (n == 0U) {
+            return 0;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+uint32_t CompactCodec::headerSize(const uint8_t *data, uint32_t size)
+{
+    uint32_t pos = header_length(data, size);
+    if ((pos == 0U) || ((data[0] & kHeaderDeadlineFlag) == 0U)) {
+        return pos;
+    }
+    uint32_t n = varint_length(data + pos, size - pos);
+    return (n == 0U) ? 0U : (pos + n);
+}
+
+// Fourth header varint of a message of @p type, if the flag announces one. The
+// deadline and status flags are the same bit; the message type tells them apart.
+static bool read_extension(const uint8_t *data, uint32_t size, message_type_t type, uint32_t &value)
+{
+    uint32_t pos = header_length(data, size);
+    if ((pos == 0U) || ((data[0] & CompactCodec::kHeaderDeadlineFlag) == 0U) ||
+        ((data[0] & CompactCodec::kHeaderTypeMask) != static_cast<uint8_t>(type))) {
+        return false;
+    }
+    uint32_t n = varint_length(data + pos, size - pos);
+    if (n == 0U) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        v |= static_cast<uint64_t>(data[pos + i] & 0x7FU) << (7U * i);
+    }
+    value = (v > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(v);
+    return true;
+}
+
+bool CompactCodec::readDeadline(const uint8_t *data, uint32_t size, uint32_t &budgetUs)
+{
+    return read_extension(data, size, message_type_t::kInvocationMessage, budgetUs) ||
+           read_extension(data, size, message_type_t::kOnewayMessage, budgetUs);
+}
+
+bool CompactCodec::readStatus(const uint8_t *data, uint32_t size, erpc_status_t &status)
+{
+    uint32_t value;
+    if (!read_extension(data, size, message_type_t::kReplyMessage, value)) {
+        return false;
+    }
+    status = static_cast<erpc_status_t>(value);
+    return true;
+}
+
+void CompactCodec::startWriteStatusReply(uint32_t service, uint32_t request, uint32_t sequence, erpc_status_t status)
+{
+    uint8_t head = static_cast<uint8_t>((kCompactCodecVersion << 4) |
+                                        static_cast<uint8_t>(message_type_t::kReplyMessage) | kHeaderStatusFlag);
+
+    BasicCodec::write(head);
+    writeVarint(service);
+    writeVarint(request);
+    writeVarint(sequence);
+    writeVarint(static_cast<uint32_t>(status));
+}
+
+erpc_status_t CompactCodec::insertDeadline(MessageBuffer &message, uint32_t headerOffset, uint32_t budgetUs)
+{
+    if (message.getUsed() < headerOffset) {
+        return kErpcStatus_InvalidArgument;
+    }
+    uint8_t *data = message.get() + headerOffset;
+    uint32_t used = message.getUsed() - headerOffset;
+    uint32_t pos = header_length(data, used);
+    if (pos == 0U) {
+        return kErpcStatus_InvalidMessageVersion;
+    }
+    if ((data[0] & kHeaderDeadlineFlag) != 0U) {
+        return kErpcStatus_InvalidArgument;
+    }
+
+    uint8_t field[5];
+    uint32_t n = 0;
+    while (budgetUs >= 0x80U) {
+        field[n++] = static_cast<uint8_t>(budgetUs | 0x80U);
+        budgetUs >>= 7;
+    }
+    field[n++] = static_cast<uint8_t>(budgetUs);
+    if (message.getFree() < n) {
+        return kErpcStatus_BufferOverrun;
+    }
+
+    memmove(data + pos + n, data + pos, used - pos);
+    memcpy(data + pos, field, n);
+    data[0] |= kHeaderDeadlineFlag;
+    message.setUsed(static_cast<uint16_t>(message.getUsed() + n));
+    return kErpcStatus_Success;
+}
+
+void CompactCodec::read(int16_t &value)
+{
+    value = static_cast<int16_t>(zigzag_decode(readVarint(16)));
+}
+
+void CompactCodec::read(int32_t &value)
+{
+    value = static_cast<int32_t>(zigzag_decode(readVarint(32)));
+}
+
+void CompactCodec::read(int64_t &value)
+{
+    value = zigzag_decode(readVarint(64));
+}
+
+void CompactCodec::read(uint16_t &value)
+{
+    value = static_cast<uint16_t>(readVarint(16));
+}
+
+void CompactCodec::read(uint32_t &value)
+{
+    value = static_cast<uint32_t>(readVarint(32));
+}
+
+void CompactCodec::read(uint64_t &value)
+{
+    value = readVarint(64);
+}
@@ -0,0 +1,114 @@
+// erpc_status_reply.cpp — replies the server builds without a handler, for BasicCodec and CompactCodec
+#include "erpc_status_reply.hpp"
+#include "erpc_compact_codec.hpp"
+
+#include <string.h>
+
+using namespace erpc;
+
+const uint8_t erpc::kBasicStatusReplyType = static_cast<uint8_t>(message_type_t::kReplyMessage) | 0x80U;
+
+bool erpc::isCompactMessage(MessageBuffer &message, uint32_t headerOffset)
+{
+    // A BasicCodec header starts with the message type, never with the compact version nibble.
+    return (message.getUsed() > headerOffset) &&
+           ((message.get()[headerOffset] >> 4) == CompactCodec::kCompactCodecVersion);
+}
+
+uint32_t erpc::messageHeaderSize(MessageBuffer &message, uint32_t headerOffset)
+{
+    if (message.getUsed() <= headerOffset) {
+        return 0;
+    }
+    uint32_t size = message.getUsed() - headerOffset;
+    if (isCompactMessage(message, headerOffset)) {
+        return CompactCodec::headerSize(message.get() + headerOffset, size);
+    }
+    // BasicCodec: header word and sequence number.
+    return (size >= 8U) ? 8U : 0U;
+}
+
+erpc_status_t erpc::writeStatusReply(MessageBuffer &message, uint32_t headerOffset, uint32_t service,
+                                     uint32_t request, uint32_t sequence, erpc_status_t status)
+{
+    if (message.getUsed() <= headerOffset) {
+        return kErpcStatus_InvalidArgument;
+    }
+    bool compact = isCompactMessage(message, headerOffset);
+    erpc_status_t err;
+
+    // Drop the request; the reply is written from the header on.
+    message.setUsed(static_cast<uint16_t>(headerOffset));
+    if (compact) {
+        CompactCodec codec;
+        codec.setBuffer(message, static_cast<uint8_t>(headerOffset));
+        codec.startWriteStatusReply(service, request, sequence, status);
+        err = codec.getStatus();
+        message.setUsed(codec.getBuffer().getUsed());
+    } else {
+        BasicCodec codec;
+        codec.setBuffer(message, static_cast<uint8_t>(headerOffset));
+        codec.startWriteMessage(static_cast<message_type_t>(kBasicStatusReplyType), service, request, sequence);
+        codec.write(static_cast<uint32_t>(status));
+        err = codec.getStatus();
+        message.setUsed(codec.getBuffer().getUsed());
+    }
+    return err;
+}
+
+bool erpc::readMessageHeader(MessageBuffer &message, uint32_t headerOffset, message_type_t &type, uint32_t &service,
+                             uint32_t &request, uint32_t &sequence)
+{
+    if (message.getUsed() <= headerOffset) {
+        return false;
+    }
+    CompactCodec compactCodec;
+    BasicCodec basicCodec;
+    BasicCodec &codec = isCompactMessage(message, headerOffset) ? compactCodec : basicCodec;
+
+    codec.setBuffer(message, static_cast<uint8_t>(headerOffset));
+    codec.startReadMessage(type, service, request, sequence);
+    return codec.isStatusOk();
+}
+
+erpc_status_t erpc::writeMessage(MessageBuffer &message, uint32_t headerOffset, message_type_t type,
+                                 uint32_t service, uint32_t request, uint32_t sequence, const uint8_t *payload,
+                                 uint32_t size)
+{
+    if (message.getUsed() <= headerOffset) {
+        return kErpcStatus_InvalidArgument;
+    }
+    CompactCodec compactCodec;
+    BasicCodec basicCodec;
+    BasicCodec &codec = isCompactMessage(message, headerOffset) ? compactCodec : basicCodec;
+
+    message.setUsed(static_cast<uint16_t>(headerOffset));
+    codec.setBuffer(message, static_cast<uint8_t>(headerOffset));
+    codec.startWriteMessage(type, service, request, sequence);
+    if (size > 0U) {
+        codec.writeData(size, payload);
+    }
+    message.setUsed(codec.getBuffer().getUsed());
+    return codec.getStatus();
+}
+
+bool erpc::readStatusReply(MessageBuffer &message, uint32_t headerOffset, erpc_status_t &status)
+{
+    if (message.getUsed() <= headerOffset) {
+        return false;
+    }
+    const uint8_t *data = message.get() + headerOffset;
+    uint32_t size = message.getUsed() - headerOffset;
+
+    if (CompactCodec::readStatus(data, size, status)) {
+        return true;
+    }
+    // BasicCodec: type byte, method, service, version; then sequence and status.
+    if ((size >= 12U) && (data[0] == kBasicStatusReplyType) && (data[3] == BasicCodec::kBasicCodecVersion)) {
+        uint32_t value;
+        memcpy(&value, data + 8, sizeof(value));
+        status = static_cast<erpc_status_t>(value);
+        return true;
+    }
+    return false;
+}
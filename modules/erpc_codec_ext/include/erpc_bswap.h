@@ -0,0 +1,42 @@
+#ifndef _ERPC_BSWAP_H_
+#define _ERPC_BSWAP_H_
+
+#include <stdint.h>
+
+/*!
+ * @brief 1 when the wire byte order of BasicCodec differs from the host.
+ *
+ * eRPC's default endianness header leaves values in host order, so this stays
+ * 0 unless the build also selects a swapping ENDIANNESS_HEADER for eRPC.
+ */
+#ifndef CONFIG_ERPC_WIRE_SWAP
+#define CONFIG_ERPC_WIRE_SWAP 0
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Copy @p count 16 bit words from @p src to @p dst, reversing the bytes of each.
+ *
+ * @p dst may equal @p src; other overlaps are not allowed. Uses SSSE3 on x86
+ * hosts that support it, byte reverse instructions (REV16/REV) elsewhere.
+ */
+void erpc_bswap16_copy(void *dst, const void *src, uint32_t count);
+
+/*!
+ * @brief Same as erpc_bswap16_copy() for 32 bit words.
+ */
+void erpc_bswap32_copy(void *dst, const void *src, uint32_t count);
+
+/*!
+ * @brief Same as erpc_bswap16_copy() for 64 bit words.
+ */
+void erpc_bswap64_copy(void *dst, const void *src, uint32_t count);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _ERPC_BSWAP_H_ */
@@ -0,0 +1,45 @@
+#ifndef _ERPC_CODEC_SETUP_H_
+#define _ERPC_CODEC_SETUP_H_
+
+#include "erpc_client_setup.h"
+#include "erpc_server_setup.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Wire codecs selectable with erpc_client_set_codec()/erpc_server_set_codec().
+ */
+typedef enum {
+    ERPC_CODEC_BASIC = 0, /*!< erpc::BasicCodec, the eRPC default */
+    ERPC_CODEC_COMPACT,   /*!< erpc::CompactCodec, varint integers and compact header */
+    ERPC_CODEC_NUMOF,
+} erpc_codec_kind_t;
+
+/*!
+ * @brief Select the codec used by a client created with erpc_client_init().
+ *
+ * Call this before the first request. The server on the other end must use
+ * the same codec.
+ *
+ * @retval kErpcStatus_Success Codec selected.
+ * @retval kErpcStatus_InvalidArgument Unknown codec or NULL client.
+ */
+erpc_status_t erpc_client_set_codec(erpc_client_t client, erpc_codec_kind_t kind);
+
+/*!
+ * @brief Select the codec used by a server created with erpc_server_init().
+ *
+ * Call this before erpc_server_run()/erpc_server_poll().
+ *
+ * @retval kErpcStatus_Success Codec selected.
+ * @retval kErpcStatus_InvalidArgument Unknown codec or NULL server.
+ */
+erpc_status_t erpc_server_set_codec(erpc_server_t server, erpc_codec_kind_t kind);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _ERPC_CODEC_SETUP_H_ */
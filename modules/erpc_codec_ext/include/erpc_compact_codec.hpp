@@ -0,0 +1,152 @@
+#ifndef _ERPC_COMPACT_CODEC_HPP_
+#define _ERPC_COMPACT_CODEC_HPP_
+
+#include "erpc_basic_codec.hpp"
+
+namespace erpc {
+
+/*!
+ * @brief Codec for bandwidth constrained links such as UART.
+ *
+ * Differences to BasicCodec:
+ * - 16/32/64 bit unsigned integers, list lengths and binary/string lengths
+ *   are LEB128 varints (7 bits per byte, MSB set on all but the last byte).
+ * - Signed integers and union discriminators are zigzag mapped first, so
+ *   small negative values stay short too.
+ * - The message header is one byte (version nibble | message type) followed by
+ *   service id, method id and sequence number as varints; 4 bytes for the
+ *   usual small ids instead of 8.
+ * - A client may add a deadline to a request header with insertDeadline();
+ *   see readDeadline() for the layout. A server may answer with a reply
+ *   that carries only a status, see startWriteStatusReply().
+ *
+ * 8 bit values, floats, doubles and pointers are written as by BasicCodec.
+ * Both ends of a connection must use this codec; a BasicCodec message is
+ * rejected with kErpcStatus_InvalidMessageVersion.
+ */
+class CompactCodec : public BasicCodec
+{
+public:
+    static const uint8_t kCompactCodecVersion; /*!< Upper nibble of the first header byte. */
+    static const uint8_t kHeaderTypeMask;      /*!< Message type bits of the first header byte. */
+    static const uint8_t kHeaderDeadlineFlag;  /*!< Set in the first byte of a request when a deadline follows. */
+    static const uint8_t kHeaderStatusFlag;    /*!< Set in the first byte of a reply that carries only a status. */
+
+    CompactCodec(void)
+    : BasicCodec()
+    {
+    }
+
+    virtual ~CompactCodec(void) {}
+
+    using BasicCodec::read;
+    using BasicCodec::write;
+
+    virtual void startWriteMessage(message_type_t type, uint32_t service, uint32_t request,
+                                   uint32_t sequence) override;
+    virtual void write(int16_t value) override;
+    virtual void write(int32_t value) override;
+    virtual void write(int64_t value) override;
+    virtual void write(uint16_t value) override;
+    virtual void write(uint32_t value) override;
+    virtual void write(uint64_t value) override;
+
+    virtual void startReadMessage(message_type_t &type, uint32_t &service, uint32_t &request,
+                                  uint32_t &sequence) override;
+    virtual void read(int16_t &value) override;
+    virtual void read(int32_t &value) override;
+    virtual void read(int64_t &value) override;
+    virtual void read(uint16_t &value) override;
+    virtual void read(uint32_t &value) override;
+    virtual void read(uint64_t &value) override;
+
+    /*!
+     * @brief Read the deadline of the compact request header at @p data.
+     *
+     * With kHeaderDeadlineFlag set, the header carries a fourth varint after
+     * the sequence number: the time the client still allowed for the call when
+     * it sent the request, in microseconds. It is relative so that the two
+     * ends need no common clock; the receiver counts it from arrival.
+     *
+     * @param[in] data First header byte.
+     * @param[in] size Bytes available at @p data.
+     * @param[out] budgetUs Remaining time the client allowed, in microseconds.
+     *
+     * @retval true The header carries a deadline.
+     * @retval false No deadline, or @p data is not a compact header.
+     */
+    static bool readDeadline(const uint8_t *data, uint32_t size, uint32_t &budgetUs);
+
+    /*!
+     * @brief Add a deadline to the header of an encoded request.
+     *
+     * Used after the shim has written the message, so the generated code
+     * stays unchanged; the payload moves up by the size of the varint.
+     *
+     * @param[in,out] message Encoded message.
+     * @param[in] headerOffset Offset of the header in @p message (the transport's reserved header size).
+     * @param[in] budgetUs Time the call may still take, in microseconds.
+     *
+     * @retval kErpcStatus_Success Deadline added.
+     * @retval kErpcStatus_InvalidMessageVersion @p message is not a compact message.
+     * @retval kErpcStatus_InvalidArgument @p message already carries a deadline.
+     * @retval kErpcStatus_BufferOverrun No room for the field.
+     */
+    static erpc_status_t insertDeadline(MessageBuffer &message, uint32_t headerOffset, uint32_t budgetUs);
+
+    /*!
+     * @brief Write the header of a reply that reports @p status instead of results.
+     *
+     * The status is a fourth header varint, announced by kHeaderStatusFlag;
+     * no payload follows. startReadMessage() skips it, so a client that does
+     * not check readStatus() fails while reading the missing results.
+     */
+    void startWriteStatusReply(uint32_t service, uint32_t request, uint32_t sequence, erpc_status_t status);
+
+    /*!
+     * @brief Read the status of a reply written by startWriteStatusReply().
+     *
+     * @param[in] data First header byte.
+     * @param[in] size Bytes available at @p data.
+     * @param[out] status Status reported by the server.
+     *
+     * @retval true @p data is a status-only reply.
+     * @retval false Any other message.
+     */
+    static bool readStatus(const uint8_t *data, uint32_t size, erpc_status_t &status);
+
+    /*!
+     * @brief Size of the compact message header at @p data, including a deadline or status field.
+     *
+     * @return Header size in bytes, or 0 if @p data is not a complete compact header.
+     */
+    static uint32_t headerSize(const uint8_t *data, uint32_t size);
+
+protected:
+    /*!
+     * @brief Append @p value as a varint.
+     */
+    void writeVarint(uint64_t value);
+
+    /*!
+     * @brief Read a varint that must fit into @p maxBits bits.
+     *
+     * Sets kErpcStatus_Fail when the buffer ends early or the value is too large.
+     */
+    uint64_t readVarint(uint8_t maxBits);
+};
+
+/*!
+ * @brief Factory handing out CompactCodec instances.
+ */
+class CompactCodecFactory : public CodecFactory
+{
+public:
+    virtual Codec *create(void) override { return new CompactCodec(); }
+
+    virtual void dispose(Codec *codec) override { delete codec; }
+};
+
+} // namespace erpc
+
+#endif /* _ERPC_COMPACT_CODEC_HPP_ */
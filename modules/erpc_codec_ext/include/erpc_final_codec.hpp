@@ -0,0 +1,391 @@
+#ifndef _ERPC_FINAL_CODEC_HPP_
+#define _ERPC_FINAL_CODEC_HPP_
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_bswap.h"
+#include "erpc_client_server_common.hpp"
+#include "erpc_compact_codec.hpp"
+#include "erpc_view.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace erpc {
+
+/*!
+ * @brief BasicCodec with inline fixed-size scalar encode/decode.
+ *
+ * The wire format is identical to BasicCodec. The class is final, so shims
+ * that hold a FinalBasicCodec pointer (see the typed shims in the apps) bind
+ * every read()/write() statically and each field compiles to a bounds check
+ * plus a store. Calls through erpc::Codec * behave exactly like BasicCodec.
+ *
+ * writeList()/readList() move a whole array of arithmetic values with one
+ * bounds check and one memcpy, or one bulk byte swap when
+ * CONFIG_ERPC_WIRE_SWAP is set. The result is the same as startWriteList()
+ * followed by one write() per element.
+ */
+class FinalBasicCodec final : public BasicCodec
+{
+public:
+    FinalBasicCodec(void)
+    : BasicCodec()
+    {
+    }
+
+    virtual ~FinalBasicCodec(void) {}
+
+    using BasicCodec::read;
+    using BasicCodec::write;
+
+    virtual void write(bool value) override { putScalar(static_cast<uint8_t>(value ? 1U : 0U)); }
+    virtual void write(int8_t value) override { putScalar(value); }
+    virtual void write(int16_t value) override { putScalar(value); }
+    virtual void write(int32_t value) override { putScalar(value); }
+    virtual void write(int64_t value) override { putScalar(value); }
+    virtual void write(uint8_t value) override { putScalar(value); }
+    virtual void write(uint16_t value) override { putScalar(value); }
+    virtual void write(uint32_t value) override { putScalar(value); }
+    virtual void write(uint64_t value) override { putScalar(value); }
+    virtual void write(float value) override { putScalar(value); }
+    virtual void write(double value) override { putScalar(value); }
+
+    virtual void read(bool &value) override
+    {
+        uint8_t b = 0;
+        getScalar(b);
+        value = (b != 0U);
+    }
+    virtual void read(int8_t &value) override { getScalar(value); }
+    virtual void read(int16_t &value) override { getScalar(value); }
+    virtual void read(int32_t &value) override { getScalar(value); }
+    virtual void read(int64_t &value) override { getScalar(value); }
+    virtual void read(uint8_t &value) override { getScalar(value); }
+    virtual void read(uint16_t &value) override { getScalar(value); }
+    virtual void read(uint32_t &value) override { getScalar(value); }
+    virtual void read(uint64_t &value) override { getScalar(value); }
+    virtual void read(float &value) override { getScalar(value); }
+    virtual void read(double &value) override { getScalar(value); }
+
+    /*!
+     * @brief Encode a list of @p count values: length word, then the elements.
+     */
+    template <typename T>
+    void writeList(const T *values, uint32_t count)
+    {
+        write(count);
+        writeArray(values, count);
+    }
+
+    /*!
+     * @brief Encode @p count values without a length word.
+     */
+    template <typename T>
+    void writeArray(const T *values, uint32_t count)
+    {
+        static_assert(std::is_arithmetic<T>::value, "bulk path is for arithmetic element types");
+
+        if (!isStatusOk() || (count == 0U)) {
+            return;
+        }
+        if (values == NULL) {
+            m_status = kErpcStatus_MemoryError;
+            return;
+        }
+        if ((m_cursor.getRemaining() / sizeof(T)) < count) {
+            m_status = kErpcStatus_BufferOverrun;
+            return;
+        }
+        copyWire<T>(m_cursor.get(), values, count);
+        advance(static_cast<uint16_t>(count * sizeof(T)), true);
+    }
+
+    /*!
+     * @brief Decode a list written by writeList() or by per-element writes.
+     *
+     * @param[out] values Destination, room for @p maxCount elements.
+     * @param[in] maxCount Capacity of @p values.
+     * @param[out] count Number of elements in the message. Larger than
+     *                   @p maxCount sets kErpcStatus_BufferOverrun.
+     */
+    template <typename T>
+    void readList(T *values, uint32_t maxCount, uint32_t &count)
+    {
+        read(count);
+        if (!isStatusOk()) {
+            count = 0;
+            return;
+        }
+        if (count > maxCount) {
+            m_status = kErpcStatus_BufferOverrun;
+            return;
+        }
+        readArray(values, count);
+    }
+
+    /*!
+     * @brief Decode @p count values without a length word.
+     */
+    template <typename T>
+    void readArray(T *values, uint32_t count)
+    {
+        static_assert(std::is_arithmetic<T>::value, "bulk path is for arithmetic element types");
+
+        if (!isStatusOk() || (count == 0U)) {
+            return;
+        }
+        if (values == NULL) {
+            m_status = kErpcStatus_MemoryError;
+            return;
+        }
+        if ((m_cursor.getRemainingUsed() / sizeof(T)) < count) {
+            m_status = kErpcStatus_Fail;
+            return;
+        }
+        copyWire<T>(values, m_cursor.get(), count);
+        advance(static_cast<uint16_t>(count * sizeof(T)), false);
+    }
+
+    /*!
+     * @brief Decode a list as a view into the receive buffer instead of a copy.
+     *
+     * Only fixed-size element encodings can be viewed, hence only on this codec.
+     */
+    template <typename T>
+    void readListView(ListView<T> &view)
+    {
+        uint32_t count = 0;
+
+        view.data = NULL;
+        view.length = 0;
+
+        read(count);
+        if (!isStatusOk() || (count == 0U)) {
+            return;
+        }
+        if ((m_cursor.getRemainingUsed() / sizeof(T)) < count) {
+            m_status = kErpcStatus_Fail;
+            return;
+        }
+        view.data = m_cursor.get();
+        view.length = count;
+        advance(static_cast<uint16_t>(count * sizeof(T)), false);
+    }
+
+private:
+    // Host <-> wire copy; a plain memcpy unless the wire order differs.
+    template <typename T>
+    static void copyWire(void *dst, const void *src, uint32_t count)
+    {
+#if CONFIG_ERPC_WIRE_SWAP
+        switch (sizeof(T)) {
+        case 2:
+            erpc_bswap16_copy(dst, src, count);
+            return;
+        case 4:
+            erpc_bswap32_copy(dst, src, count);
+            return;
+        case 8:
+            erpc_bswap64_copy(dst, src, count);
+            return;
+        default:
+            break;
+        }
+#endif
+        std::memcpy(dst, src, count * sizeof(T));
+    }
+
+    void advance(uint16_t bytes, bool grow)
+    {
+        m_cursor += bytes;
+        if (grow) {
+            MessageBuffer &buf = m_cursor.getBufferRef();
+            buf.setUsed(static_cast<uint16_t>(buf.getUsed() + bytes));
+        }
+    }
+
+    template <typename T>
+    void putScalar(T value)
+    {
+        if (!isStatusOk()) {
+            return;
+        }
+        if (m_cursor.getRemaining() < sizeof(T)) {
+            m_status = kErpcStatus_BufferOverrun;
+            return;
+        }
+        copyWire<T>(m_cursor.get(), &value, 1U);
+        advance(static_cast<uint16_t>(sizeof(T)), true);
+    }
+
+    template <typename T>
+    void getScalar(T &value)
+    {
+        if (isStatusOk() && (m_cursor.getRemainingUsed() < sizeof(T))) {
+            m_status = kErpcStatus_Fail;
+        }
+        if (!isStatusOk()) {
+            value = T();
+            return;
+        }
+        copyWire<T>(&value, m_cursor.get(), 1U);
+        advance(static_cast<uint16_t>(sizeof(T)), false);
+    }
+};
+
+/*!
+ * @brief CompactCodec with inline varint encode/decode.
+ *
+ * The wire format is identical to CompactCodec. Through a FinalCompactCodec
+ * pointer the request header and every integer field compile to an inline
+ * varint loop on the buffer; CompactCodec keeps its out of line versions for
+ * calls through erpc::Codec *. Reading the header and the deadline and status
+ * extensions stay in CompactCodec.
+ */
+class FinalCompactCodec final : public CompactCodec
+{
+public:
+    FinalCompactCodec(void)
+    : CompactCodec()
+    {
+    }
+
+    virtual ~FinalCompactCodec(void) {}
+
+    using CompactCodec::read;
+    using CompactCodec::write;
+
+    virtual void startWriteMessage(message_type_t type, uint32_t service, uint32_t request,
+                                   uint32_t sequence) override
+    {
+        putByte(static_cast<uint8_t>((kCompactCodecVersion << 4) | (static_cast<uint8_t>(type) & 0x0FU)));
+        putVarint(service);
+        putVarint(request);
+        putVarint(sequence);
+    }
+
+    virtual void write(int16_t value) override { putVarint(zigzag(value)); }
+    virtual void write(int32_t value) override { putVarint(zigzag(value)); }
+    virtual void write(int64_t value) override { putVarint(zigzag(value)); }
+    virtual void write(uint16_t value) override { putVarint(value); }
+    virtual void write(uint32_t value) override { putVarint(value); }
+    virtual void write(uint64_t value) override { putVarint(value); }
+
+    virtual void read(int16_t &value) override { value = static_cast<int16_t>(unzigzag(getVarint(16))); }
+    virtual void read(int32_t &value) override { value = static_cast<int32_t>(unzigzag(getVarint(32))); }
+    virtual void read(int64_t &value) override { value = unzigzag(getVarint(64)); }
+    virtual void read(uint16_t &value) override { value = static_cast<uint16_t>(getVarint(16)); }
+    virtual void read(uint32_t &value) override { value = static_cast<uint32_t>(getVarint(32)); }
+    virtual void read(uint64_t &value) override { value = getVarint(64); }
+
+private:
+    static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1U); }
+
+    void advance(uint16_t bytes)
+    {
+        m_cursor += bytes;
+        MessageBuffer &buf = m_cursor.getBufferRef();
+        buf.setUsed(static_cast<uint16_t>(buf.getUsed() + bytes));
+    }
+
+    void putByte(uint8_t value)
+    {
+        if (!isStatusOk()) {
+            return;
+        }
+        if (m_cursor.getRemaining() < 1U) {
+            m_status = kErpcStatus_BufferOverrun;
+            return;
+        }
+        *m_cursor.get() = value;
+        advance(1);
+    }
+
+    // Same bytes as CompactCodec::writeVarint(); nothing is written unless all of them fit.
+    void putVarint(uint64_t value)
+    {
+        if (!isStatusOk()) {
+            return;
+        }
+        uint8_t *p = m_cursor.get();
+        uint16_t room = m_cursor.getRemaining();
+        uint16_t n = 0;
+        uint64_t rest = value;
+        do {
+            if (n == room) {
+                m_status = kErpcStatus_BufferOverrun;
+                return;
+            }
+            rest >>= 7;
+            ++n;
+        } while (rest != 0U);
+        for (uint16_t i = 0; i + 1U < n; ++i) {
+            p[i] = static_cast<uint8_t>(value | 0x80U);
+            value >>= 7;
+        }
+        p[n - 1U] = static_cast<uint8_t>(value);
+        advance(n);
+    }
+
+    // Same checks as CompactCodec::readVarint(); the cursor only moves past a valid varint.
+    uint64_t getVarint(uint8_t maxBits)
+    {
+        if (!isStatusOk()) {
+            return 0;
+        }
+        const uint8_t *p = m_cursor.get();
+        uint16_t avail = m_cursor.getRemainingUsed();
+        uint64_t value = 0;
+        uint8_t shift = 0;
+        uint16_t n = 0;
+        for (;;) {
+            if ((n == avail) || (shift >= maxBits)) {
+                m_status = kErpcStatus_Fail;
+                return 0;
+            }
+            uint8_t b = p[n++];
+            value |= static_cast<uint64_t>(b & 0x7FU) << shift;
+            shift = static_cast<uint8_t>(shift + 7U);
+            if ((b & 0x80U) == 0U) {
+                break;
+            }
+        }
+        if ((maxBits < 64U) && ((value >> maxBits) != 0U)) {
+            m_status = kErpcStatus_Fail;
+            return 0;
+        }
+        m_cursor += n;
+        return value;
+    }
+};
+
+/*!
+ * @brief Codec factory bound to one concrete codec type.
+ *
+ * Typed shims downcast the erpc::Codec * they receive to @p CodecT without a
+ * runtime check (RTTI is off on RIOT), so the client or server must get its
+ * codecs from this factory. install() takes care of that.
+ */
+template <class CodecT>
+class FinalCodecFactory : public CodecFactory
+{
+public:
+    virtual Codec *create(void) override { return new CodecT(); }
+
+    virtual void dispose(Codec *codec) override { delete static_cast<CodecT *>(codec); }
+
+    /*!
+     * @brief Make @p common (a ClientManager or server) create @p CodecT codecs.
+     */
+    static void install(ClientServerCommon *common)
+    {
+        static FinalCodecFactory<CodecT> s_factory;
+        common->setCodecFactory(&s_factory);
+    }
+};
+
+} // namespace erpc
+
+#endif /* _ERPC_FINAL_CODEC_HPP_ */
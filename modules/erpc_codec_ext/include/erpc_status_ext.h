@@ -0,0 +1,19 @@
+#ifndef _ERPC_STATUS_EXT_H_
+#define _ERPC_STATUS_EXT_H_
+
+#include "erpc_common.h"
+
+/*!
+ * @brief Status codes of the extension modules.
+ *
+ * eRPC uses 0..20 of erpc_status_t; these start at 24 so that new upstream
+ * codes do not collide with them. They stay within the range of the enum.
+ */
+
+/*! @brief The request's deadline passed before it was executed or answered. */
+#define kErpcStatus_DeadlineExceeded ((erpc_status_t)24)
+
+/*! @brief The server rejected the request because it is overloaded; it was not executed. */
+#define kErpcStatus_ServerBusy ((erpc_status_t)25)
+
+#endif /* _ERPC_STATUS_EXT_H_ */
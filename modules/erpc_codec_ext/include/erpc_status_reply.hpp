@@ -0,0 +1,104 @@
+#ifndef _ERPC_STATUS_REPLY_HPP_
+#define _ERPC_STATUS_REPLY_HPP_
+
+#include "erpc_codec.hpp"
+#include "erpc_message_buffer.hpp"
+
+namespace erpc {
+
+/*!
+ * @brief Type byte of a BasicCodec status-only reply: kReplyMessage with the top bit set.
+ *
+ * The header is followed by the sequence number and the status as uint32_t.
+ * Stock eRPC clients reject it with kErpcStatus_ExpectedReply.
+ */
+extern const uint8_t kBasicStatusReplyType;
+
+/*!
+ * @brief Overwrite the request in @p message with a reply that only reports @p status.
+ *
+ * The reply uses the request's codec: CompactCodec::startWriteStatusReply()
+ * for compact requests, kBasicStatusReplyType for BasicCodec ones. It is
+ * cheap enough to reject requests without dispatching them.
+ *
+ * @param[in,out] message Received request; holds the reply on return.
+ * @param[in] headerOffset Offset of the message header (the transport's reserved header size).
+ * @param[in] service Service id of the request.
+ * @param[in] request Method id of the request.
+ * @param[in] sequence Sequence number of the request.
+ * @param[in] status Status to report.
+ *
+ * @return Encoding status.
+ */
+erpc_status_t writeStatusReply(MessageBuffer &message, uint32_t headerOffset, uint32_t service, uint32_t request,
+                               uint32_t sequence, erpc_status_t status);
+
+/*!
+ * @brief Read the status of a reply written by writeStatusReply().
+ *
+ * @param[in] message Received reply.
+ * @param[in] headerOffset Offset of the message header.
+ * @param[out] status Status reported by the server.
+ *
+ * @retval true @p message is a status-only reply in either codec.
+ * @retval false Any other message.
+ */
+bool readStatusReply(MessageBuffer &message, uint32_t headerOffset, erpc_status_t &status);
+
+/*!
+ * @brief Return true if the message in @p message was written by CompactCodec, false for BasicCodec.
+ *
+ * The two encode the same values differently, so encoded payloads can only
+ * be reused between messages of the same codec.
+ */
+bool isCompactMessage(MessageBuffer &message, uint32_t headerOffset);
+
+/*!
+ * @brief Size of the header of the message in @p message, in whichever codec wrote it.
+ *
+ * The payload (encoded arguments or results) starts right after it.
+ *
+ * @return Header size in bytes, or 0 if the message is too short.
+ */
+uint32_t messageHeaderSize(MessageBuffer &message, uint32_t headerOffset);
+
+/*!
+ * @brief Read the header of the message in @p message, in whichever codec wrote it, without a codec of its own.
+ *
+ * @retval true Header read.
+ * @retval false @p message holds no valid header.
+ */
+bool readMessageHeader(MessageBuffer &message, uint32_t headerOffset, message_type_t &type, uint32_t &service,
+                       uint32_t &request, uint32_t &sequence);
+
+/*!
+ * @brief Overwrite the message in @p message with one of @p type carrying the already encoded @p payload.
+ *
+ * Only the header is written, in the codec of the message it replaces;
+ * @p payload is copied as is and must not lie within @p message. A deadline
+ * of the old header is dropped.
+ *
+ * @return Encoding status; kErpcStatus_BufferOverrun if @p payload does not fit.
+ */
+erpc_status_t writeMessage(MessageBuffer &message, uint32_t headerOffset, message_type_t type, uint32_t service,
+                           uint32_t request, uint32_t sequence, const uint8_t *payload, uint32_t size);
+
+/*!
+ * @brief Overwrite the request in @p message with a reply carrying the already encoded @p payload.
+ *
+ * Only the header is written; @p payload is copied as is, in the request's
+ * codec (see writeStatusReply()). Used to answer from a cache or with the
+ * results of an identical call.
+ *
+ * @return Encoding status; kErpcStatus_BufferOverrun if @p payload does not fit.
+ */
+inline erpc_status_t writeReply(MessageBuffer &message, uint32_t headerOffset, uint32_t service, uint32_t request,
+                                uint32_t sequence, const uint8_t *payload, uint32_t size)
+{
+    return writeMessage(message, headerOffset, message_type_t::kReplyMessage, service, request, sequence, payload,
+                        size);
+}
+
+} // namespace erpc
+
+#endif /* _ERPC_STATUS_REPLY_HPP_ */
@@ -0,0 +1,80 @@
+#ifndef _ERPC_VIEW_HPP_
+#define _ERPC_VIEW_HPP_
+
+#include "erpc_bswap.h"
+#include "erpc_codec.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace erpc {
+
+/*!
+ * @brief Read-only view of a binary/string parameter inside the receive buffer.
+ *
+ * The bytes belong to the MessageBuffer the codec decodes from. On the server
+ * that buffer is reused for the reply, so a view is valid only until the shim
+ * calls codec->reset(), i.e. for the duration of the handler call.
+ */
+struct BinaryView
+{
+    const uint8_t *data; /*!< First byte, NULL when empty. */
+    uint32_t length;     /*!< Number of bytes. */
+};
+
+/*!
+ * @brief Read-only view of a list of arithmetic values inside the receive buffer.
+ *
+ * Elements are not necessarily aligned for @p T, so they are accessed with
+ * at(), which copies one element out (and byte swaps it when
+ * CONFIG_ERPC_WIRE_SWAP is set). Same lifetime rules as BinaryView.
+ */
+template <typename T>
+struct ListView
+{
+    static_assert(std::is_arithmetic<T>::value, "list views are for arithmetic element types");
+
+    const uint8_t *data; /*!< Encoded elements, NULL when empty. */
+    uint32_t length;     /*!< Number of elements. */
+
+    T at(uint32_t index) const
+    {
+        T value;
+        std::memcpy(&value, data + (index * sizeof(T)), sizeof(T));
+#if CONFIG_ERPC_WIRE_SWAP
+        if (sizeof(T) == 2) {
+            erpc_bswap16_copy(&value, &value, 1U);
+        } else if (sizeof(T) == 4) {
+            erpc_bswap32_copy(&value, &value, 1U);
+        } else if (sizeof(T) == 8) {
+            erpc_bswap64_copy(&value, &value, 1U);
+        }
+#endif
+        return value;
+    }
+};
+
+/*!
+ * @brief Decode a binary/string parameter as a view instead of a copy.
+ *
+ * Works with every codec: erpc::Codec::readBinary() already returns a pointer
+ * into the buffer, this only skips the allocation and copy of the generated
+ * shims.
+ */
+inline void readBinaryView(Codec *codec, BinaryView &view)
+{
+    uint8_t *data = NULL;
+    uint32_t length = 0;
+
+    codec->readBinary(length, &data);
+    if (!codec->isStatusOk()) {
+        data = NULL;
+        length = 0;
+    }
+    view.data = data;
+    view.length = length;
+}
+
+} // namespace erpc
+
+#endif /* _ERPC_VIEW_HPP_ */
@@ -0,0 +1,248 @@
+// erpc_crc16_fast.cpp — faster drop-in engines for the eRPC frame CRC16
+#include "erpc_crc16_fast.h"
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ERPC_CRC16_HAVE_PCLMUL 1
+#include <immintrin.h>
+#else
+#define ERPC_CRC16_HAVE_PCLMUL 0
+#endif
+
+static const uint16_t kCrc16Poly = 0x1021;
+
+// CRC-16/CCITT table for poly 0x1021, MSB first: s_table[b] = crc16(0, {b}).
+static constexpr uint16_t s_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+// s_slices.rows[k].v[b] = crc16(0, {b, 0 x k}), computed by the compiler: the
+// tables are constant data (flash on MCUs) and ready before any thread runs.
+template <unsigned... I>
+struct Indices {
+};
+
+template <unsigned N, unsigned... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {
+};
+
+template <unsigned... I>
+struct MakeIndices<0, I...> {
+    typedef Indices<I...> type;
+};
+
+struct SliceRow {
+    uint16_t v[256];
+};
+
+struct SliceTables {
+    SliceRow rows[CONFIG_ERPC_CRC16_SLICES];
+};
+
+// One zero byte more: crc16(0, {b, 0 x k}) from crc16(0, {b, 0 x (k - 1)}).
+static constexpr uint16_t crc16_zero_step(uint16_t v)
+{
+    return static_cast<uint16_t>((v << 8) ^ s_table[v >> 8]);
+}
+
+static constexpr uint16_t crc16_slice_entry(unsigned k, unsigned b)
+{
+    return (k == 0U) ? s_table[b] : crc16_zero_step(crc16_slice_entry(k - 1U, b));
+}
+
+template <unsigned... B>
+static constexpr SliceRow crc16_slice_row(unsigned k, Indices<B...>)
+{
+    return SliceRow{ { crc16_slice_entry(k, B)... } };
+}
+
+template <unsigned... K>
+static constexpr SliceTables crc16_slice_tables(Indices<K...>)
+{
+    return SliceTables{ { crc16_slice_row(K, MakeIndices<256>::type())... } };
+}
+
+static constexpr SliceTables s_slices = crc16_slice_tables(MakeIndices<CONFIG_ERPC_CRC16_SLICES>::type());
+
+static erpc_crc16_fn_t s_hwHook = NULL;
+static erpc_crc16_impl_t s_selected = ERPC_CRC16_IMPL_TABLE;
+
+static uint16_t crc16_bitwise(uint16_t crc, const uint8_t *data, uint32_t size);
+static uint16_t crc16_table(uint16_t crc, const uint8_t *data, uint32_t size);
+static erpc_crc16_fn_t s_active = crc16_table;
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernels
+////////////////////////////////////////////////////////////////////////////////
+
+static uint16_t crc16_bitwise(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+    uint32_t c = crc;
+    for (uint32_t j = 0; j < size; ++j) {
+        c ^= static_cast<uint32_t>(data[j]) << 8;
+        for (uint32_t i = 0; i < 8U; ++i) {
+            c = (c & 0x8000U) ? ((c << 1) ^ kCrc16Poly) : (c << 1);
+        }
+    }
+    return static_cast<uint16_t>(c);
+}
+
+static uint16_t crc16_table(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ s_table[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+static uint16_t crc16_slice(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+    const unsigned n = CONFIG_ERPC_CRC16_SLICES;
+    while (size >= n) {
+        // The running CRC is folded into the first two bytes of the block.
+        uint16_t c = static_cast<uint16_t>(s_slices.rows[n - 1].v[(crc >> 8) ^ data[0]] ^
+                                           s_slices.rows[n - 2].v[(crc & 0xFFU) ^ data[1]]);
+        for (unsigned i = 2; i < n; ++i) {
+            c ^= s_slices.rows[n - 1 - i].v[data[i]];
+        }
+        crc = c;
+        data += n;
+        size -= n;
+    }
+    return crc16_table(crc, data, size);
+}
+
+#if ERPC_CRC16_HAVE_PCLMUL
+// x^128 mod P and x^192 mod P for P = x^16 + x^12 + x^5 + 1.
+static const uint32_t kFoldK128 = 0xAEFC;
+static const uint32_t kFoldK192 = 0x650B;
+
+// Carry-less multiply folding: the message is consumed in 16-byte blocks and
+// kept as a 128-bit remainder congruent to it modulo P. The remainder and the
+// trailing bytes are then finished with the byte table.
+__attribute__((target("pclmul,ssse3")))
+static uint16_t crc16_pclmul(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+    if (size < 32) {
+        return crc16_table(crc, data, size);
+    }
+
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i k = _mm_set_epi32(0, static_cast<int>(kFoldK192), 0, static_cast<int>(kFoldK128));
+
+    __m128i x = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), bswap);
+    x = _mm_xor_si128(x, _mm_set_epi32(static_cast<int>(static_cast<uint32_t>(crc) << 16), 0, 0, 0));
+    data += 16;
+    size -= 16;
+
+    while (size >= 16) {
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), bswap);
+        __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+        __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+        x = _mm_xor_si128(_mm_xor_si128(hi, lo), b);
+        data += 16;
+        size -= 16;
+    }
+
+    uint8_t rem[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(rem), _mm_shuffle_epi8(x, bswap));
+    crc = crc16_table(0, rem, sizeof(rem));
+    return crc16_table(crc, data, size);
+}
+
+static bool crc16_pclmul_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// External C Interface
+////////////////////////////////////////////////////////////////////////////////
+
+erpc_crc16_fn_t erpc_crc16_get(erpc_crc16_impl_t impl)
+{
+    switch (impl) {
+    case ERPC_CRC16_IMPL_BITWISE:
+        return crc16_bitwise;
+    case ERPC_CRC16_IMPL_TABLE:
+        return crc16_table;
+    case ERPC_CRC16_IMPL_SLICE:
+        return crc16_slice;
+    case ERPC_CRC16_IMPL_HW:
+        if (s_hwHook != NULL) {
+            return s_hwHook;
+        }
+#if ERPC_CRC16_HAVE_PCLMUL
+        if (crc16_pclmul_supported()) {
+            return crc16_pclmul;
+        }
+#endif
+        return NULL;
+    default:
+        return NULL;
+    }
+}
+
+erpc_status_t erpc_crc16_select(erpc_crc16_impl_t impl)
+{
+    erpc_crc16_fn_t fn = erpc_crc16_get(impl);
+    if (fn == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    s_active = fn;
+    s_selected = impl;
+    return kErpcStatus_Success;
+}
+
+erpc_crc16_impl_t erpc_crc16_selected(void)
+{
+    return s_selected;
+}
+
+void erpc_crc16_register_hw(erpc_crc16_fn_t fn)
+{
+    s_hwHook = fn;
+    if (s_selected == ERPC_CRC16_IMPL_HW && erpc_crc16_select(ERPC_CRC16_IMPL_HW) != kErpcStatus_Success) {
+        (void)erpc_crc16_select(ERPC_CRC16_IMPL_TABLE);
+    }
+}
+
+uint16_t erpc_crc16_update(uint16_t crc, const uint8_t *data, uint32_t size)
+{
+    return s_active(crc, data, size);
+}
@@ -0,0 +1,88 @@
+#ifndef _ERPC_CRC16_FAST_H_
+#define _ERPC_CRC16_FAST_H_
+
+#include <stdint.h>
+#include "erpc_common.h"
+
+/*!
+ * @brief Number of lookup tables used by the slice-by-N engine.
+ *
+ * Each slice is a 512 byte constant table. Supported values are 2, 4 and 8.
+ */
+#ifndef CONFIG_ERPC_CRC16_SLICES
+#define CONFIG_ERPC_CRC16_SLICES 8
+#endif
+
+#if (CONFIG_ERPC_CRC16_SLICES != 2) && (CONFIG_ERPC_CRC16_SLICES != 4) && (CONFIG_ERPC_CRC16_SLICES != 8)
+#error "CONFIG_ERPC_CRC16_SLICES must be 2, 4 or 8"
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief CRC16 engines available to RiotFramedTransport.
+ *
+ * All engines compute the same CRC-16/CCITT (poly 0x1021, MSB first, no final
+ * XOR) as erpc::Crc16, so the frame format on the wire does not change.
+ */
+typedef enum {
+    ERPC_CRC16_IMPL_BITWISE = 0, /*!< Reference bit-by-bit loop, same as erpc::Crc16 */
+    ERPC_CRC16_IMPL_TABLE,       /*!< One 256-entry lookup table, one byte per step */
+    ERPC_CRC16_IMPL_SLICE,       /*!< CONFIG_ERPC_CRC16_SLICES tables, N bytes per step */
+    ERPC_CRC16_IMPL_HW,          /*!< Registered hardware hook, or PCLMUL on x86 hosts */
+    ERPC_CRC16_IMPL_NUMOF,
+} erpc_crc16_impl_t;
+
+/*!
+ * @brief CRC16 kernel signature.
+ *
+ * @param[in] crc Running CRC value (the CRC start value for the first chunk).
+ * @param[in] data Bytes to process.
+ * @param[in] size Number of bytes.
+ *
+ * @return Updated CRC value.
+ */
+typedef uint16_t (*erpc_crc16_fn_t)(uint16_t crc, const uint8_t *data, uint32_t size);
+
+/*!
+ * @brief Select the engine used by erpc_crc16_update().
+ *
+ * Call this during setup, before transports start exchanging frames.
+ *
+ * @retval kErpcStatus_Success The engine is now active.
+ * @retval kErpcStatus_InvalidArgument The engine is unknown or not available on this target.
+ */
+erpc_status_t erpc_crc16_select(erpc_crc16_impl_t impl);
+
+/*!
+ * @brief Return the engine currently used by erpc_crc16_update().
+ */
+erpc_crc16_impl_t erpc_crc16_selected(void);
+
+/*!
+ * @brief Return the kernel of a specific engine, e.g. for benchmarking.
+ *
+ * @return Kernel pointer or NULL when the engine is not available.
+ */
+erpc_crc16_fn_t erpc_crc16_get(erpc_crc16_impl_t impl);
+
+/*!
+ * @brief Register a board specific CRC16 kernel as ERPC_CRC16_IMPL_HW.
+ *
+ * The kernel must produce the same result as ERPC_CRC16_IMPL_BITWISE. A
+ * registered hook takes precedence over the built-in PCLMUL kernel.
+ */
+void erpc_crc16_register_hw(erpc_crc16_fn_t fn);
+
+/*!
+ * @brief Feed @p size bytes into a running CRC using the selected engine.
+ */
+uint16_t erpc_crc16_update(uint16_t crc, const uint8_t *data, uint32_t size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _ERPC_CRC16_FAST_H_ */
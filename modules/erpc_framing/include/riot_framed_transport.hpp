@@ -0,0 +1,303 @@
+#ifndef _RIOT_FRAMED_TRANSPORT_HPP_
+#define _RIOT_FRAMED_TRANSPORT_HPP_
+
+#include "erpc_framed_transport.hpp"
+#include "erpc_message_buffer.hpp"
+#include "erpc_crc16_fast.h"
+#include "riot_rx_events.hpp"
+#include "riot_stream.hpp"
+
+/*!
+ * @brief Leading message bytes whose CRC is remembered, per direction; 0 disables it.
+ *
+ * Repeated calls of one method begin with the same bytes: the 4-byte
+ * BasicCodec header word (a PreparedCall keeps exactly these constant). When
+ * a message starts like the previous one in the same direction, the body CRC
+ * continues from the remembered value instead of covering these bytes again.
+ * Only used with the bytewise CRC engines (bitwise and table).
+ */
+#ifndef CONFIG_ERPC_CRC16_PREFIX_CACHE
+#define CONFIG_ERPC_CRC16_PREFIX_CACHE 4
+#endif
+
+#if CONFIG_ERPC_CRC16_PREFIX_CACHE > 16
+#error "CONFIG_ERPC_CRC16_PREFIX_CACHE must not exceed 16"
+#endif
+
+/*!
+ * @brief Bytes kept for RPC messages read while a sender waits for credit.
+ *
+ * enableFlowControl() accepts windows up to this size minus one
+ * ERPC_DEFAULT_BUFFER_SIZE.
+ */
+#ifndef CONFIG_ERPC_FRAMING_PENDING_SIZE
+#define CONFIG_ERPC_FRAMING_PENDING_SIZE (2 * ERPC_DEFAULT_BUFFER_SIZE)
+#endif
+
+/*!
+ * @brief FramedTransport that computes the frame CRC with the engine chosen by erpc_crc16_select().
+ *
+ * The header layout and CRC values are those of erpc::FramedTransport, and
+ * a peer using the stock eRPC transport interoperates as long as only RPC
+ * messages are exchanged: no stream, flow control or CRC negotiation frames.
+ * Transports in this repository derive from this class and only implement
+ * underlyingSend()/underlyingReceive().
+ *
+ * Transports that cannot corrupt bytes (in-process loopback, shared memory,
+ * stream sockets) may override isReliable() to negotiate CRC-less frames.
+ * The side that sends before it has received anything offers it with a
+ * kRiotStream_NoCrc control frame. A peer that is reliable too answers with
+ * a switch frame and from then on sends CRC-less frames; the offering side
+ * does the same once it reads the switch. Each direction changes mode exactly
+ * at its switch frame, so the receiver never has to guess whether a header
+ * carries a CRC. A peer that is not reliable ignores the offer and both sides
+ * keep the CRC. In a CRC-less frame m_crcHeader is kNoCrcMarker and
+ * m_crcBody the complement of the message size; both are checked to catch
+ * lost framing.
+ *
+ * The offer is a control frame like those below, so a reliable transport
+ * that speaks first needs a RiotFramedTransport peer.
+ *
+ * Besides RPC messages the transport carries stream sub-frames (see
+ * riot_stream.hpp). They use the same framing, start with kStreamTag and are
+ * consumed by receive() itself.
+ *
+ * Optional credit based flow control protects a slow receiver's RX buffer:
+ * after enableFlowControl() on both ends, each side advertises its receive
+ * window in bytes and a sender keeps at most that many bytes of RPC messages
+ * and stream data unacknowledged. The receiver returns credit once half the
+ * window has been consumed, or when the sender polls for it. Control frames
+ * (credits, window, poll) are not counted, so leave room for a few of them
+ * (14 bytes each) in the RX buffer.
+ *
+ * A sender out of credit sleeps until a thread in receive() signals the
+ * grant. If no thread is receiving, the sender reads frames itself; RPC
+ * messages among them are kept, in order, and receive() takes them even
+ * while the sender goes on reading. Their credit is only returned once
+ * receive() takes them, so the peer never has more than our window
+ * outstanding and CONFIG_ERPC_FRAMING_PENDING_SIZE always has room for the
+ * next frame. That bound needs flow control on both ends; without it a
+ * sender that finds no room fails with kErpcStatus_Fail.
+ *
+ * Transports that can look at received bytes without consuming them
+ * implement underlyingPeek(). hasMessage() then only reports a message once
+ * a whole RPC frame has arrived, and receive() returns it without blocking.
+ * Together with notifyRx() this lets one thread serve several transports.
+ */
+class RiotFramedTransport : public erpc::FramedTransport, public RiotRxEvents {
+public:
+    RiotFramedTransport(void);
+    virtual ~RiotFramedTransport(void);
+
+    /*!
+     * @brief Receive one RPC message and verify its header and body CRC.
+     *
+     * Stream sub-frames arriving in between are passed to their sink.
+     *
+     * @retval kErpcStatus_Success Frame received and verified.
+     * @retval kErpcStatus_CrcCheckFailed Header or body CRC mismatch.
+     * @retval kErpcStatus_ReceiveFailed Frame does not fit into @p message.
+     */
+    virtual erpc_status_t receive(erpc::MessageBuffer *message) override;
+
+    /*!
+     * @brief Return true if receive() would return without waiting for the link.
+     *
+     * Complete control and stream frames found on the way are handled here.
+     * Without underlyingPeek() this returns true, as erpc::Transport does.
+     */
+    virtual bool hasMessage(void) override;
+
+    /*!
+     * @brief Fill in the frame header of @p message and send it.
+     */
+    virtual erpc_status_t send(erpc::MessageBuffer *message) override;
+
+    /*!
+     * @brief Keep the CRC (true) or negotiate CRC-less frames (false), overriding isReliable().
+     *
+     * Call this before the first frame is sent or received.
+     */
+    void setCrcEnabled(bool enabled);
+
+    /*!
+     * @brief Return true while frames are sent with header and body CRC.
+     */
+    bool isCrcEnabled(void) const { return m_txCrc; }
+
+    /*!
+     * @brief Start over with a new peer on the same link object, e.g. a reused socket slot.
+     *
+     * The CRC is negotiated again; frames read ahead, stream sinks and flow
+     * control are dropped. Call it only while no thread sends or receives.
+     */
+    void resetLink(void);
+
+    /*!
+     * @brief Advertise a receive window of @p rxWindow bytes and wait for the peer's.
+     *
+     * Both ends must call this, before any RPC traffic; it blocks until the
+     * peer's advertisement arrives. A single frame larger than the peer's
+     * window is sent when nothing else is unacknowledged.
+     *
+     * @retval kErpcStatus_InvalidArgument @p rxWindow is 0, or larger than
+     *         CONFIG_ERPC_FRAMING_PENDING_SIZE - ERPC_DEFAULT_BUFFER_SIZE.
+     * @return Otherwise the status of the window exchange.
+     */
+    erpc_status_t enableFlowControl(uint32_t rxWindow);
+
+    /*!
+     * @brief Deliver the sub-frames of stream @p streamId to @p sink.
+     *
+     * @retval kErpcStatus_Success Sink attached.
+     * @retval kErpcStatus_InvalidArgument NULL sink, reserved or already attached @p streamId.
+     * @retval kErpcStatus_MemoryError All CONFIG_ERPC_STREAM_SINKS slots in use.
+     */
+    erpc_status_t attachStreamSink(uint16_t streamId, RiotStreamSink *sink);
+
+    /*!
+     * @brief Stop delivering stream @p streamId.
+     *
+     * A stream already under way fails with kErpcStatus_Fail and the rest of
+     * it is dropped; a stream that has not started yet is refused with
+     * kErpcStatus_InvalidArgument at its first sub-frame.
+     */
+    void detachStreamSink(uint16_t streamId);
+
+    /*!
+     * @brief Send one stream sub-frame: @p header followed by @p size payload bytes.
+     *
+     * The payload is sent straight from @p data, without an intermediate copy.
+     */
+    erpc_status_t sendStreamFrame(const riot_stream_header_t &header, const uint8_t *data, uint16_t size);
+
+    /*!
+     * @brief Wait for the next credit of stream @p streamId.
+     *
+     * Credits read by other callers on the way, e.g. a sender waiting for
+     * link credit, are kept until their writer asks.
+     *
+     * @return Transport error, or the status reported by the receiving sink.
+     */
+    erpc_status_t receiveStreamCredit(uint16_t streamId);
+
+    //! @brief m_crcHeader value of a CRC-less frame.
+    static const uint16_t kNoCrcMarker = 0xFFFFU;
+
+    //! @brief First body byte of a stream sub-frame.
+    static const uint8_t kStreamTag = 0x5AU;
+
+protected:
+    /*!
+     * @brief Capability flag: true if the underlying link never corrupts bytes.
+     *
+     * Evaluated once, on the first send() or receive(). CRC-less frames are
+     * only used when the peer's flag is set as well.
+     */
+    virtual bool isReliable(void) const { return false; }
+
+    /*!
+     * @brief Copy up to @p size received bytes to @p data without consuming them.
+     *
+     * Must not block.
+     *
+     * @return Bytes ready to be read, which may exceed @p size; -1 if the
+     *         link cannot tell (the default).
+     */
+    virtual int32_t underlyingPeek(uint8_t *data, uint32_t size)
+    {
+        (void)data;
+        (void)size;
+        return -1;
+    }
+
+    /*!
+     * @brief CRC of @p size bytes, seeded with the CRC start value of the attached erpc::Crc16.
+     */
+    uint16_t computeCrc16(const uint8_t *data, uint32_t size);
+
+private:
+    struct StreamSlot {
+        uint16_t m_streamId;
+        uint16_t m_received; /*!< Data sub-frames since the last credit. */
+        uint32_t m_offset;   /*!< Next expected stream offset. */
+        RiotStreamSink *m_sink;
+    };
+
+    struct StreamCredit {
+        uint16_t m_streamId;
+        bool m_valid;
+        erpc_status_t m_status; /*!< Verdict of the receiver. */
+    };
+
+#if CONFIG_ERPC_CRC16_PREFIX_CACHE > 0
+    struct CrcPrefix {
+        uint8_t m_bytes[CONFIG_ERPC_CRC16_PREFIX_CACHE];
+        uint16_t m_seed; /*!< CRC start value m_crc was computed with. */
+        uint16_t m_crc;  /*!< CRC of m_bytes. */
+        bool m_valid;
+    };
+#else
+    struct CrcPrefix {
+    };
+#endif
+
+    uint16_t computeBodyCrc16(CrcPrefix &prefix, const uint8_t *data, uint32_t size);
+    void resolveCrcMode(void);
+    void offerNoCrc(void);
+    void switchNoCrc(void);
+    void buildHeader(Header &h, uint16_t messageSize, uint16_t crcBody);
+    erpc_status_t sendFrame(const uint8_t *prefix, uint16_t prefixSize, const uint8_t *data, uint16_t size);
+    erpc_status_t sendControl(uint8_t kind, uint16_t streamId, uint32_t arg);
+    erpc_status_t receiveFrame(erpc::MessageBuffer *message);
+    erpc_status_t receiveLink(erpc::MessageBuffer *message);
+    bool takePending(erpc::MessageBuffer *message, erpc_status_t &status);
+    bool hasPending(void);
+    erpc_status_t readLinkFrame(riot_stream_header_t &header);
+#if !ERPC_THREADS_IS(NONE)
+    void beginWaitLink(void);
+    void endWaitLink(bool sleep);
+#endif
+    void signalLink(void);
+    bool isStreamFrame(erpc::MessageBuffer *message);
+    void handleStreamFrame(const riot_stream_header_t &header, const uint8_t *data, uint32_t size);
+    StreamSlot *findStream(uint16_t streamId);
+    void keepStreamCredit(uint16_t streamId, erpc_status_t status);
+    bool takeStreamCredit(uint16_t streamId, erpc_status_t &status);
+
+    bool hasTxCredit(uint32_t size) const;
+    bool takeTxCredit(uint32_t size);
+    erpc_status_t waitTxCredit(uint32_t size);
+    void rxConsumed(uint32_t size, bool polled = false);
+
+    bool m_crcResolved;       /*!< m_noCrcWanted has been fixed by isReliable() or setCrcEnabled(). */
+    bool m_noCrcWanted;       /*!< We offer, and accept, CRC-less frames. */
+    bool m_noCrcOffered;      /*!< Offer or switch sent, under m_sendLock. */
+    volatile bool m_rxSeen;   /*!< A frame has been received; the peer spoke first. */
+    bool m_txCrc;             /*!< Frames we send carry a CRC, under m_sendLock. */
+    bool m_rxCrc;             /*!< Frames we receive carry a CRC, under m_receiveLock. */
+    StreamSlot m_streams[CONFIG_ERPC_STREAM_SINKS];
+    StreamCredit m_credits[CONFIG_ERPC_STREAM_WRITERS]; /*!< Credits read but not yet taken, under m_linkLock. */
+    CrcPrefix m_txPrefix; /*!< Start of the last message sent, under m_sendLock. */
+    CrcPrefix m_rxPrefix; /*!< Start of the last message received, under m_receiveLock. */
+
+    uint32_t m_rxWindow;            /*!< Our advertised window, 0 when flow control is off. */
+    uint32_t m_rxConsumed;          /*!< Bytes consumed since the last grant, under m_linkLock. */
+    bool m_rxPolled;                /*!< Peer asked for a grant while m_rxConsumed was 0, under m_linkLock. */
+    volatile uint32_t m_txWindow;   /*!< Peer's window, 0 while flow control is off. */
+    volatile uint32_t m_txGranted;  /*!< Running total of bytes granted by the peer. */
+    volatile uint32_t m_txSent;     /*!< Running total of counted bytes sent. */
+
+    //! RPC frames read outside receive(), oldest at m_pendingHead; the rest is room for the next one.
+    uint8_t m_pendingData[CONFIG_ERPC_FRAMING_PENDING_SIZE];
+    uint16_t m_pendingHead; /*!< Start of the oldest frame not yet taken, under m_linkLock. */
+    uint16_t m_pendingUsed; /*!< End of the newest frame, under m_linkLock. */
+    erpc_status_t m_pendingError; /*!< Link error hasMessage() ran into, for receive(); under m_linkLock. */
+#if !ERPC_THREADS_IS(NONE)
+    erpc::Mutex m_linkLock;      /*!< Guards the pending frames, the waiters and the receive window. */
+    erpc::Semaphore m_linkEvent; /*!< Grant, pending frame, free link or room: wakes every waiter. */
+    uint16_t m_linkWaiters;      /*!< Threads that may sleep on m_linkEvent, under m_linkLock. */
+#endif
+};
+
+#endif /* _RIOT_FRAMED_TRANSPORT_HPP_ */
@@ -0,0 +1,49 @@
+#ifndef _RIOT_RX_EVENTS_HPP_
+#define _RIOT_RX_EVENTS_HPP_
+
+#include <stddef.h>
+
+/*!
+ * @brief Input notification of a transport, for a server that waits on several transports at once.
+ *
+ * Whoever delivers input to the transport (its RX interrupt, a reader
+ * thread, or the sending end of an in-process link) calls notifyRx(). A
+ * transport offering this must also answer erpc::Transport::hasMessage()
+ * without blocking, and only report true once receive() would not block
+ * either.
+ */
+class RiotRxEvents {
+public:
+    typedef void (*rx_handler_t)(void *arg);
+
+    RiotRxEvents(void) : m_rxHandler(NULL), m_rxArg(NULL) {}
+
+    /*!
+     * @brief Call @p handler with @p arg on every notifyRx(); NULL to stop.
+     *
+     * The handler may run in interrupt context and must not block.
+     */
+    void setRxHandler(rx_handler_t handler, void *arg)
+    {
+        m_rxHandler = NULL;
+        m_rxArg = arg;
+        m_rxHandler = handler;
+    }
+
+    /*!
+     * @brief Report new input; safe from interrupt context.
+     */
+    void notifyRx(void)
+    {
+        rx_handler_t handler = m_rxHandler;
+        if (handler != NULL) {
+            handler(m_rxArg);
+        }
+    }
+
+private:
+    rx_handler_t volatile m_rxHandler;
+    void *volatile m_rxArg;
+};
+
+#endif /* _RIOT_RX_EVENTS_HPP_ */
@@ -0,0 +1,157 @@
+#ifndef _RIOT_STREAM_HPP_
+#define _RIOT_STREAM_HPP_
+
+#include "erpc_common.h"
+
+#include <stdint.h>
+
+/*!
+ * @brief Payload bytes per stream sub-frame.
+ *
+ * A sub-frame is the 6 byte frame header, the 8 byte stream header and the
+ * payload; it must fit into the receiver's MessageBuffer
+ * (ERPC_DEFAULT_BUFFER_SIZE with the dynamic/static MBF).
+ */
+#ifndef CONFIG_ERPC_STREAM_CHUNK
+#define CONFIG_ERPC_STREAM_CHUNK 128
+#endif
+
+/*!
+ * @brief Sub-frames a writer may send before it waits for a credit from the receiver.
+ */
+#ifndef CONFIG_ERPC_STREAM_WINDOW
+#define CONFIG_ERPC_STREAM_WINDOW 4
+#endif
+
+/*!
+ * @brief Number of streams one transport can receive at the same time.
+ */
+#ifndef CONFIG_ERPC_STREAM_SINKS
+#define CONFIG_ERPC_STREAM_SINKS 2
+#endif
+
+/*!
+ * @brief Number of streams one transport can send at the same time.
+ *
+ * A credit that arrives while its writer is not reading (e.g. while another
+ * thread waits for link credit) is kept for it in one of as many slots.
+ */
+#ifndef CONFIG_ERPC_STREAM_WRITERS
+#define CONFIG_ERPC_STREAM_WRITERS 2
+#endif
+
+class RiotFramedTransport;
+
+/*!
+ * @brief Stream sub-frame kinds, second byte of the stream header.
+ */
+enum riot_stream_kind_t {
+    kRiotStream_Data = 1, /*!< arg: offset of the payload in the stream */
+    kRiotStream_End,      /*!< arg: total number of bytes */
+    kRiotStream_Credit,   /*!< arg: erpc_status_t of the receiver; link channel: bytes granted */
+    kRiotStream_Window,   /*!< Link channel only. arg: receive window in bytes */
+    kRiotStream_Poll,     /*!< Link channel only. Sender is out of credit, asks for a grant */
+    kRiotStream_NoCrc,    /*!< Link channel only. arg: riot_stream_nocrc_t */
+};
+
+/*!
+ * @brief Arguments of a kRiotStream_NoCrc frame.
+ */
+enum riot_stream_nocrc_t {
+    kRiotStream_NoCrcOffer = 0, /*!< Sender can drop the CRC and would like to. */
+    kRiotStream_NoCrcSwitch,    /*!< Every later frame of the sender is CRC-less. */
+};
+
+/*!
+ * @brief Stream id reserved for link level flow control frames.
+ */
+#define RIOT_STREAM_LINK_ID 0xFFFFU
+
+/*!
+ * @brief Header in front of the payload of every stream sub-frame.
+ *
+ * The tag byte cannot start a BasicCodec or CompactCodec message, which is how
+ * RiotFramedTransport::receive() tells stream sub-frames from RPC messages.
+ */
+typedef struct {
+    uint8_t m_tag;       /*!< kStreamTag */
+    uint8_t m_kind;      /*!< riot_stream_kind_t */
+    uint16_t m_streamId; /*!< Chosen by the application, e.g. passed as an RPC parameter. */
+    uint32_t m_arg;      /*!< Depends on m_kind. */
+} riot_stream_header_t;
+
+/*!
+ * @brief Consumer of an incoming stream.
+ *
+ * Register it with RiotFramedTransport::attachStreamSink(), typically from the
+ * server handler of the RPC that announces the stream. Sub-frames are then
+ * handed over from inside receive(), one chunk at a time, and never reach the
+ * eRPC server loop.
+ */
+class RiotStreamSink {
+public:
+    virtual ~RiotStreamSink(void) {}
+
+    /*!
+     * @brief Consume the next chunk. @p data is only valid during the call.
+     *
+     * @return Anything but kErpcStatus_Success aborts the stream; the writer
+     *         sees the status at its next credit and the receiver drops the
+     *         sub-frames still on their way.
+     */
+    virtual erpc_status_t onData(const uint8_t *data, uint32_t size) = 0;
+
+    /*!
+     * @brief Stream finished (kErpcStatus_Success) or was aborted. The sink is detached afterwards.
+     */
+    virtual void onEnd(erpc_status_t status) = 0;
+};
+
+/*!
+ * @brief Sends a payload of any size as a sequence of stream sub-frames.
+ *
+ * Only CONFIG_ERPC_STREAM_CHUNK bytes are on the wire per sub-frame and at
+ * most CONFIG_ERPC_STREAM_WINDOW sub-frames are unacknowledged, so the
+ * receiver needs neither the whole payload nor more than a window of buffer.
+ *
+ * Use it between RPCs (no request of the same client may be outstanding):
+ * announce the stream with an RPC carrying the stream id, write(), then
+ * close() and check its status.
+ */
+class RiotStreamWriter {
+public:
+    RiotStreamWriter(RiotFramedTransport *transport, uint16_t streamId);
+
+    /*!
+     * @brief Append @p size bytes to the stream.
+     *
+     * Blocks for credits as needed.
+     */
+    erpc_status_t write(const void *data, uint32_t size);
+
+    /*!
+     * @brief Send the buffered tail and the end marker, and wait for the receiver's verdict.
+     *
+     * After a failed write() the end marker only lets the receiver release
+     * its sink; close() then returns the earlier status without waiting.
+     */
+    erpc_status_t close(void);
+
+    /*!
+     * @brief Number of bytes passed to write() so far.
+     */
+    uint32_t getOffset(void) const { return m_offset + m_fill; }
+
+private:
+    erpc_status_t flush(void);
+
+    RiotFramedTransport *m_transport;
+    uint16_t m_streamId;
+    uint32_t m_offset;   /*!< Stream offset of m_chunk[0]. */
+    uint16_t m_fill;     /*!< Bytes waiting in m_chunk. */
+    uint16_t m_inFlight; /*!< Sub-frames sent since the last credit. */
+    erpc_status_t m_status;
+    uint8_t m_chunk[CONFIG_ERPC_STREAM_CHUNK];
+};
+
+#endif /* _RIOT_STREAM_HPP_ */
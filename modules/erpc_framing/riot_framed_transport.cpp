@@ -0,0 +1,841 @@
+#include "riot_framed_transport.hpp"
+#include <cstring>
+
+#if !ERPC_THREADS_IS(NONE)
+#include "erpc_threading.h"
+#endif
+
+using namespace erpc;
+
+#if defined(ERPC_DEFAULT_BUFFER_SIZE)
+static_assert(6U + sizeof(riot_stream_header_t) + CONFIG_ERPC_STREAM_CHUNK <= ERPC_DEFAULT_BUFFER_SIZE,
+              "CONFIG_ERPC_STREAM_CHUNK does not fit into an eRPC message buffer");
+#endif
+
+RiotFramedTransport::RiotFramedTransport(void)
+    : FramedTransport()
+    , m_crcResolved(false)
+    , m_noCrcWanted(false)
+    , m_noCrcOffered(false)
+    , m_rxSeen(false)
+    , m_txCrc(true)
+    , m_rxCrc(true)
+    , m_rxWindow(0)
+    , m_rxConsumed(0)
+    , m_rxPolled(false)
+    , m_txWindow(0)
+    , m_txGranted(0)
+    , m_txSent(0)
+    , m_pendingHead(0)
+    , m_pendingUsed(0)
+    , m_pendingError(kErpcStatus_Success)
+#if !ERPC_THREADS_IS(NONE)
+    , m_linkWaiters(0)
+#endif
+{
+    std::memset(m_streams, 0, sizeof(m_streams));
+    std::memset(m_credits, 0, sizeof(m_credits));
+    std::memset(&m_txPrefix, 0, sizeof(m_txPrefix));
+    std::memset(&m_rxPrefix, 0, sizeof(m_rxPrefix));
+}
+
+RiotFramedTransport::~RiotFramedTransport(void)
+{
+}
+
+uint16_t RiotFramedTransport::computeCrc16(const uint8_t *data, uint32_t size)
+{
+    // erpc::Crc16 keeps its start value private; an empty run returns it unchanged.
+    uint16_t seed = m_crcImpl->computeCRC16(NULL, 0);
+    return erpc_crc16_update(seed, data, size);
+}
+
+uint16_t RiotFramedTransport::computeBodyCrc16(CrcPrefix &prefix, const uint8_t *data, uint32_t size)
+{
+#if CONFIG_ERPC_CRC16_PREFIX_CACHE > 0
+    // The wide engines cover a few bytes faster than the comparison.
+    const uint32_t n = CONFIG_ERPC_CRC16_PREFIX_CACHE;
+    if ((size > n) && (erpc_crc16_selected() <= ERPC_CRC16_IMPL_TABLE)) {
+        uint16_t seed = m_crcImpl->computeCRC16(NULL, 0);
+        if (!prefix.m_valid || (prefix.m_seed != seed) || (std::memcmp(prefix.m_bytes, data, n) != 0)) {
+            std::memcpy(prefix.m_bytes, data, n);
+            prefix.m_seed = seed;
+            prefix.m_crc = erpc_crc16_update(seed, data, n);
+            prefix.m_valid = true;
+        }
+        return erpc_crc16_update(prefix.m_crc, data + n, size - n);
+    }
+#else
+    (void)prefix;
+#endif
+    return computeCrc16(data, size);
+}
+
+void RiotFramedTransport::setCrcEnabled(bool enabled)
+{
+    m_noCrcWanted = !enabled;
+    m_crcResolved = true;
+}
+
+void RiotFramedTransport::resetLink(void)
+{
+    m_noCrcOffered = false;
+    m_rxSeen = false;
+    m_txCrc = true;
+    m_rxCrc = true;
+    m_rxWindow = 0;
+    m_rxConsumed = 0;
+    m_rxPolled = false;
+    m_txWindow = 0;
+    m_txGranted = 0;
+    m_txSent = 0;
+    m_pendingHead = 0;
+    m_pendingUsed = 0;
+    m_pendingError = kErpcStatus_Success;
+    std::memset(m_streams, 0, sizeof(m_streams));
+    std::memset(m_credits, 0, sizeof(m_credits));
+}
+
+void RiotFramedTransport::resolveCrcMode(void)
+{
+    // isReliable() is virtual, so it cannot be asked from our constructor.
+    if (!m_crcResolved) {
+        m_noCrcWanted = isReliable();
+        m_crcResolved = true;
+    }
+}
+
+void RiotFramedTransport::offerNoCrc(void)
+{
+    // Only the side that speaks first offers: a stock eRPC client never
+    // receives a control frame from a reliable server.
+    if (!m_noCrcWanted || m_noCrcOffered || m_rxSeen) {
+        return;
+    }
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_sendLock);
+#endif
+    if (!m_noCrcOffered) {
+        m_noCrcOffered = true;
+        (void)sendControl(kRiotStream_NoCrc, RIOT_STREAM_LINK_ID, kRiotStream_NoCrcOffer);
+    }
+}
+
+void RiotFramedTransport::switchNoCrc(void)
+{
+    // The switch frame itself still carries a CRC; the peer changes mode after it.
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_sendLock);
+#endif
+    if (m_txCrc) {
+        m_noCrcOffered = true;
+        if (sendControl(kRiotStream_NoCrc, RIOT_STREAM_LINK_ID, kRiotStream_NoCrcSwitch) == kErpcStatus_Success) {
+            m_txCrc = false;
+        }
+    }
+}
+
+void RiotFramedTransport::buildHeader(Header &h, uint16_t messageSize, uint16_t crcBody)
+{
+    h.m_messageSize = messageSize;
+    if (m_txCrc) {
+        h.m_crcBody = crcBody;
+        h.m_crcHeader = static_cast<uint16_t>(
+            computeCrc16(reinterpret_cast<const uint8_t *>(&h.m_messageSize), sizeof(h.m_messageSize)) +
+            computeCrc16(reinterpret_cast<const uint8_t *>(&h.m_crcBody), sizeof(h.m_crcBody)));
+    } else {
+        h.m_crcBody = static_cast<uint16_t>(~messageSize);
+        h.m_crcHeader = kNoCrcMarker;
+    }
+}
+
+erpc_status_t RiotFramedTransport::send(MessageBuffer *message)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    const uint16_t size = static_cast<uint16_t>(message->getUsed() - hdrSize);
+    erpc_status_t retVal;
+    Header h;
+
+    resolveCrcMode();
+    offerNoCrc();
+
+    for (;;) {
+        // Wait without m_sendLock: our receive side may need it to send grants.
+        retVal = waitTxCredit(message->getUsed());
+        if (retVal != kErpcStatus_Success) {
+            return retVal;
+        }
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_sendLock);
+#endif
+        if (!takeTxCredit(message->getUsed())) {
+            continue; // another thread used the credit first
+        }
+
+        buildHeader(h, size, m_txCrc ? computeBodyCrc16(m_txPrefix, message->get() + hdrSize, size) : 0U);
+        std::memcpy(message->get(), &h, sizeof(h));
+
+        return underlyingSend(message, message->getUsed(), 0);
+    }
+}
+
+erpc_status_t RiotFramedTransport::sendFrame(const uint8_t *prefix, uint16_t prefixSize, const uint8_t *data,
+                                             uint16_t size)
+{
+    uint8_t head[sizeof(Header) + sizeof(riot_stream_header_t)];
+    uint16_t crcBody = 0;
+    Header h;
+    erpc_status_t retVal;
+
+    if (prefixSize != sizeof(riot_stream_header_t)) {
+        return kErpcStatus_InvalidArgument;
+    }
+
+    // Only stream data counts against the peer's window; control frames must
+    // always get through or both sides could wait for each other.
+    const uint8_t kind = prefix[1];
+    const uint32_t counted =
+        ((kind == kRiotStream_Data) || (kind == kRiotStream_End)) ? (sizeof(Header) + prefixSize + size) : 0U;
+
+    resolveCrcMode();
+    offerNoCrc();
+
+    for (;;) {
+        retVal = waitTxCredit(counted);
+        if (retVal != kErpcStatus_Success) {
+            return retVal;
+        }
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_sendLock);
+#endif
+        if (!takeTxCredit(counted)) {
+            continue; // another thread used the credit first
+        }
+
+        if (m_txCrc) {
+            crcBody = erpc_crc16_update(computeCrc16(prefix, prefixSize), data, size);
+        }
+        buildHeader(h, static_cast<uint16_t>(prefixSize + size), crcBody);
+
+        std::memcpy(head, &h, sizeof(h));
+        std::memcpy(head + sizeof(h), prefix, prefixSize);
+
+        // Gathered send through the raw hook, so the payload is never copied.
+        retVal = underlyingSend(head, sizeof(h) + prefixSize);
+        if ((retVal == kErpcStatus_Success) && (size > 0U)) {
+            retVal = underlyingSend(data, size);
+        }
+        return retVal;
+    }
+}
+
+erpc_status_t RiotFramedTransport::sendControl(uint8_t kind, uint16_t streamId, uint32_t arg)
+{
+    riot_stream_header_t sh = { kStreamTag, kind, streamId, arg };
+    return sendStreamFrame(sh, NULL, 0);
+}
+
+erpc_status_t RiotFramedTransport::receive(MessageBuffer *message)
+{
+    erpc_status_t retVal;
+
+    resolveCrcMode();
+
+#if ERPC_THREADS_IS(NONE)
+    if (!takePending(message, retVal)) {
+        retVal = receiveLink(message);
+    }
+#else
+    // Messages read by a sender waiting for credit come first. While such a
+    // sender holds the link, sleep until it hands over a message or the link.
+    for (;;) {
+        beginWaitLink();
+        if (takePending(message, retVal)) {
+            endWaitLink(false);
+            break;
+        }
+        if (m_receiveLock.tryLock()) {
+            endWaitLink(false);
+            if (!takePending(message, retVal)) {
+                retVal = receiveLink(message);
+            }
+            m_receiveLock.unlock();
+            signalLink();
+            break;
+        }
+        endWaitLink(true);
+    }
+#endif
+    return retVal;
+}
+
+erpc_status_t RiotFramedTransport::receiveLink(MessageBuffer *message)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    riot_stream_header_t sh;
+    erpc_status_t retVal;
+
+    for (;;) {
+        retVal = receiveFrame(message);
+        if (retVal != kErpcStatus_Success) {
+            return retVal;
+        }
+        if (!isStreamFrame(message)) {
+            rxConsumed(message->getUsed());
+            return kErpcStatus_Success;
+        }
+        std::memcpy(&sh, message->get() + hdrSize, sizeof(sh));
+        if ((sh.m_kind == kRiotStream_Data) || (sh.m_kind == kRiotStream_End)) {
+            rxConsumed(message->getUsed());
+        }
+        handleStreamFrame(sh, message->get() + hdrSize + sizeof(sh), message->getUsed() - hdrSize - sizeof(sh));
+    }
+}
+
+bool RiotFramedTransport::takePending(MessageBuffer *message, erpc_status_t &status)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    uint16_t used;
+    Header h;
+
+    {
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_linkLock);
+#endif
+        if (m_pendingError != kErpcStatus_Success) {
+            // Older than any frame still pending: hasMessage() only reads into an empty queue.
+            status = m_pendingError;
+            m_pendingError = kErpcStatus_Success;
+            return true;
+        }
+        if (m_pendingHead == m_pendingUsed) {
+            return false;
+        }
+
+        // Frames are stored whole, so the header gives the size of the oldest one.
+        std::memcpy(&h, m_pendingData + m_pendingHead, sizeof(h));
+        used = static_cast<uint16_t>(hdrSize + h.m_messageSize);
+
+        if (message->get() == NULL) {
+            status = kErpcStatus_MemoryError;
+        } else if (used > message->getLength()) {
+            status = kErpcStatus_ReceiveFailed;
+        } else {
+            std::memcpy(message->get(), m_pendingData + m_pendingHead, used);
+            message->setUsed(used);
+            status = kErpcStatus_Success;
+        }
+        // Gone either way; only readLinkFrame() moves the rest down.
+        m_pendingHead = static_cast<uint16_t>(m_pendingHead + used);
+    }
+
+    rxConsumed(used);
+    signalLink();
+    return true;
+}
+
+bool RiotFramedTransport::hasPending(void)
+{
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_linkLock);
+#endif
+    return (m_pendingHead != m_pendingUsed) || (m_pendingError != kErpcStatus_Success);
+}
+
+bool RiotFramedTransport::hasMessage(void)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    riot_stream_header_t sh;
+    bool ready = false;
+    Header h;
+
+    resolveCrcMode();
+
+#if !ERPC_THREADS_IS(NONE)
+    // A sender waiting for credit holds the link and keeps what it reads for receive().
+    if (!m_receiveLock.tryLock()) {
+        return hasPending();
+    }
+#endif
+    // Read whole frames only, until an RPC message is waiting for receive().
+    while (!ready) {
+        if (hasPending()) {
+            ready = true;
+            break;
+        }
+        int32_t avail = underlyingPeek(reinterpret_cast<uint8_t *>(&h), sizeof(h));
+        if (avail < 0) {
+            ready = true; // the link cannot tell; receive() may block
+            break;
+        }
+        if (avail < static_cast<int32_t>(hdrSize)) {
+            break;
+        }
+        // An oversized frame fails right after its header, so let receive() report it.
+        uint32_t frameSize = hdrSize + static_cast<uint32_t>(h.m_messageSize);
+        if ((static_cast<uint32_t>(avail) < frameSize) && (frameSize <= ERPC_DEFAULT_BUFFER_SIZE)) {
+            break;
+        }
+        erpc_status_t err = readLinkFrame(sh);
+        if (err != kErpcStatus_Success) {
+#if !ERPC_THREADS_IS(NONE)
+            Mutex::Guard lock(m_linkLock);
+#endif
+            m_pendingError = err;
+            ready = true;
+        }
+    }
+#if !ERPC_THREADS_IS(NONE)
+    m_receiveLock.unlock();
+#endif
+    return ready;
+}
+
+erpc_status_t RiotFramedTransport::receiveFrame(MessageBuffer *message)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    Header h;
+    erpc_status_t retVal;
+    bool checkCrc;
+
+    if ((message->get() != NULL) && (message->getLength() < hdrSize)) {
+        return kErpcStatus_MemoryError;
+    }
+
+    retVal = underlyingReceive(message, hdrSize, 0);
+    if (retVal != kErpcStatus_Success) {
+        return retVal;
+    }
+    if (message->getLength() < hdrSize) {
+        return kErpcStatus_MemoryError;
+    }
+
+    std::memcpy(&h, message->get(), sizeof(h));
+    m_rxSeen = true;
+
+    // The mode only changes at a switch frame, never by looking at the header.
+    checkCrc = m_rxCrc;
+    if (checkCrc) {
+        uint16_t crcHeader = static_cast<uint16_t>(
+            computeCrc16(reinterpret_cast<const uint8_t *>(&h.m_messageSize), sizeof(h.m_messageSize)) +
+            computeCrc16(reinterpret_cast<const uint8_t *>(&h.m_crcBody), sizeof(h.m_crcBody)));
+        if (crcHeader != h.m_crcHeader) {
+            return kErpcStatus_CrcCheckFailed;
+        }
+    } else if ((h.m_crcHeader != kNoCrcMarker) || (h.m_crcBody != static_cast<uint16_t>(~h.m_messageSize))) {
+        // Framing lost sync; the size field cannot be trusted.
+        return kErpcStatus_ReceiveFailed;
+    }
+
+    if (static_cast<uint32_t>(h.m_messageSize) + hdrSize > message->getLength()) {
+        return kErpcStatus_ReceiveFailed;
+    }
+
+    // Some transports deliver the whole frame at once; only pull what is missing.
+    if (message->getUsed() < static_cast<uint32_t>(h.m_messageSize) + hdrSize) {
+        retVal = underlyingReceive(message, h.m_messageSize, hdrSize);
+        if (retVal != kErpcStatus_Success) {
+            return retVal;
+        }
+    }
+
+    if (checkCrc && (computeBodyCrc16(m_rxPrefix, message->get() + hdrSize, h.m_messageSize) != h.m_crcBody)) {
+        return kErpcStatus_CrcCheckFailed;
+    }
+
+    return kErpcStatus_Success;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Streams
+////////////////////////////////////////////////////////////////////////////////
+
+bool RiotFramedTransport::isStreamFrame(MessageBuffer *message)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    return (message->getUsed() >= hdrSize + sizeof(riot_stream_header_t)) && (message->get()[hdrSize] == kStreamTag);
+}
+
+RiotFramedTransport::StreamSlot *RiotFramedTransport::findStream(uint16_t streamId)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_STREAM_SINKS; ++i) {
+        if ((m_streams[i].m_sink != NULL) && (m_streams[i].m_streamId == streamId)) {
+            return &m_streams[i];
+        }
+    }
+    return NULL;
+}
+
+erpc_status_t RiotFramedTransport::attachStreamSink(uint16_t streamId, RiotStreamSink *sink)
+{
+    if ((sink == NULL) || (streamId == RIOT_STREAM_LINK_ID) || (findStream(streamId) != NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    for (unsigned i = 0; i < CONFIG_ERPC_STREAM_SINKS; ++i) {
+        if (m_streams[i].m_sink == NULL) {
+            m_streams[i].m_streamId = streamId;
+            m_streams[i].m_received = 0;
+            m_streams[i].m_offset = 0;
+            m_streams[i].m_sink = sink;
+            return kErpcStatus_Success;
+        }
+    }
+    return kErpcStatus_MemoryError;
+}
+
+void RiotFramedTransport::detachStreamSink(uint16_t streamId)
+{
+    StreamSlot *slot = findStream(streamId);
+    if (slot != NULL) {
+        slot->m_sink = NULL;
+        // A stream under way gets the verdict of its current window now; its
+        // remaining sub-frames are dropped like those after an abort.
+        if (slot->m_offset != 0U) {
+            (void)sendControl(kRiotStream_Credit, streamId, kErpcStatus_Fail);
+        }
+    }
+}
+
+erpc_status_t RiotFramedTransport::sendStreamFrame(const riot_stream_header_t &header, const uint8_t *data,
+                                                   uint16_t size)
+{
+    return sendFrame(reinterpret_cast<const uint8_t *>(&header), sizeof(header), data, size);
+}
+
+void RiotFramedTransport::handleStreamFrame(const riot_stream_header_t &header, const uint8_t *data, uint32_t size)
+{
+    if (header.m_streamId == RIOT_STREAM_LINK_ID) {
+        if (header.m_kind == kRiotStream_Window) {
+            m_txWindow = header.m_arg;
+            m_txGranted = m_txSent + header.m_arg;
+            signalLink();
+        } else if (header.m_kind == kRiotStream_Credit) {
+            m_txGranted = m_txGranted + header.m_arg;
+            signalLink();
+        } else if (header.m_kind == kRiotStream_Poll) {
+            rxConsumed(0, true);
+        } else if (header.m_kind == kRiotStream_NoCrc) {
+            if (header.m_arg == kRiotStream_NoCrcSwitch) {
+                m_rxCrc = false;
+            }
+            // An offer, or a switch crossing our own offer: confirm with our switch.
+            if (m_noCrcWanted) {
+                switchNoCrc();
+            }
+        }
+        return;
+    }
+
+    StreamSlot *slot = findStream(header.m_streamId);
+    erpc_status_t status;
+
+    if (header.m_kind == kRiotStream_Credit) {
+        // Whoever read it, the writer of that stream takes it in receiveStreamCredit().
+        keepStreamCredit(header.m_streamId, static_cast<erpc_status_t>(header.m_arg));
+        return;
+    }
+    if (slot == NULL) {
+        // Refuse a stream nobody attached once, at its first sub-frame. The rest
+        // of it, and everything after an abort, is dropped: the writer takes one
+        // verdict per window and stops there, so a credit for each of them would
+        // be left over for the next stream with this id.
+        if ((header.m_arg == 0U) && ((header.m_kind == kRiotStream_Data) || (header.m_kind == kRiotStream_End))) {
+            (void)sendControl(kRiotStream_Credit, header.m_streamId, kErpcStatus_InvalidArgument);
+        }
+        return;
+    }
+
+    RiotStreamSink *sink = slot->m_sink;
+
+    if (header.m_kind == kRiotStream_Data) {
+        status = (header.m_arg == slot->m_offset) ? sink->onData(data, size) : kErpcStatus_Fail;
+        if (status == kErpcStatus_Success) {
+            slot->m_offset += size;
+            if (++slot->m_received == CONFIG_ERPC_STREAM_WINDOW) {
+                slot->m_received = 0;
+                (void)sendControl(kRiotStream_Credit, header.m_streamId, kErpcStatus_Success);
+            }
+            return;
+        }
+    } else if (header.m_kind == kRiotStream_End) {
+        status = (header.m_arg == slot->m_offset) ? kErpcStatus_Success : kErpcStatus_Fail;
+    } else {
+        status = kErpcStatus_InvalidArgument;
+    }
+
+    // End of stream, or abort: the sink is done either way.
+    slot->m_sink = NULL;
+    sink->onEnd(status);
+    (void)sendControl(kRiotStream_Credit, header.m_streamId, status);
+}
+
+erpc_status_t RiotFramedTransport::readLinkFrame(riot_stream_header_t &header)
+{
+    const uint8_t hdrSize = reserveHeaderSize();
+    uint8_t *frame;
+    uint16_t room;
+    erpc_status_t retVal;
+
+    std::memset(&header, 0, sizeof(header));
+    {
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_linkLock);
+#endif
+        if (m_pendingHead != 0U) {
+            m_pendingUsed = static_cast<uint16_t>(m_pendingUsed - m_pendingHead);
+            std::memmove(m_pendingData, m_pendingData + m_pendingHead, m_pendingUsed);
+            m_pendingHead = 0;
+        }
+        room = static_cast<uint16_t>(sizeof(m_pendingData) - m_pendingUsed);
+        if (room < ERPC_DEFAULT_BUFFER_SIZE) {
+            // Only without flow control on our side: then the peer is not bounded by our window.
+            return kErpcStatus_Fail;
+        }
+        // Takers only advance m_pendingHead, so the space behind m_pendingUsed stays ours.
+        frame = m_pendingData + m_pendingUsed;
+    }
+
+    MessageBuffer message(frame, room);
+    retVal = receiveFrame(&message);
+    if (retVal != kErpcStatus_Success) {
+        return retVal;
+    }
+    if (!isStreamFrame(&message)) {
+        // An RPC message for receive(); keep it behind the others.
+        {
+#if !ERPC_THREADS_IS(NONE)
+            Mutex::Guard lock(m_linkLock);
+#endif
+            m_pendingUsed = static_cast<uint16_t>(m_pendingUsed + message.getUsed());
+        }
+        signalLink();
+        notifyRx();
+        return kErpcStatus_Success;
+    }
+
+    std::memcpy(&header, frame + hdrSize, sizeof(header));
+    if ((header.m_kind == kRiotStream_Data) || (header.m_kind == kRiotStream_End)) {
+        rxConsumed(message.getUsed());
+    }
+    handleStreamFrame(header, frame + hdrSize + sizeof(header), message.getUsed() - hdrSize - sizeof(header));
+    return kErpcStatus_Success;
+}
+
+#if !ERPC_THREADS_IS(NONE)
+void RiotFramedTransport::beginWaitLink(void)
+{
+    Mutex::Guard lock(m_linkLock);
+    ++m_linkWaiters;
+}
+
+void RiotFramedTransport::endWaitLink(bool sleep)
+{
+    if (sleep) {
+        (void)m_linkEvent.get();
+    }
+    Mutex::Guard lock(m_linkLock);
+    --m_linkWaiters;
+}
+#endif
+
+void RiotFramedTransport::signalLink(void)
+{
+#if !ERPC_THREADS_IS(NONE)
+    // Wake every registered waiter; each one checks its own condition again.
+    Mutex::Guard lock(m_linkLock);
+    while (m_linkEvent.getCount() < static_cast<int>(m_linkWaiters)) {
+        m_linkEvent.put();
+    }
+#endif
+}
+
+erpc_status_t RiotFramedTransport::receiveStreamCredit(uint16_t streamId)
+{
+    riot_stream_header_t sh;
+    erpc_status_t retVal;
+    erpc_status_t status = kErpcStatus_Success;
+
+    resolveCrcMode();
+
+    {
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_receiveLock);
+#endif
+        // Another reader may have come across it while we waited for the lock.
+        while (!takeStreamCredit(streamId, status)) {
+            retVal = readLinkFrame(sh);
+            if (retVal != kErpcStatus_Success) {
+                status = retVal;
+                break;
+            }
+        }
+    }
+
+    // A receive() may be waiting for the link.
+    signalLink();
+    return status;
+}
+
+void RiotFramedTransport::keepStreamCredit(uint16_t streamId, erpc_status_t status)
+{
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_linkLock);
+#endif
+    StreamCredit *slot = NULL;
+
+    for (unsigned i = 0; i < CONFIG_ERPC_STREAM_WRITERS; ++i) {
+        if (m_credits[i].m_valid && (m_credits[i].m_streamId == streamId)) {
+            // A writer takes its credit before the receiver can send the next one; this one was left behind.
+            slot = &m_credits[i];
+            break;
+        }
+        if (!m_credits[i].m_valid && (slot == NULL)) {
+            slot = &m_credits[i];
+        }
+    }
+    // No room: more writers than CONFIG_ERPC_STREAM_WRITERS, the credit is lost.
+    if (slot != NULL) {
+        slot->m_streamId = streamId;
+        slot->m_status = status;
+        slot->m_valid = true;
+    }
+}
+
+bool RiotFramedTransport::takeStreamCredit(uint16_t streamId, erpc_status_t &status)
+{
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_linkLock);
+#endif
+    for (unsigned i = 0; i < CONFIG_ERPC_STREAM_WRITERS; ++i) {
+        if (m_credits[i].m_valid && (m_credits[i].m_streamId == streamId)) {
+            m_credits[i].m_valid = false;
+            status = m_credits[i].m_status;
+            return true;
+        }
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Flow control
+////////////////////////////////////////////////////////////////////////////////
+
+erpc_status_t RiotFramedTransport::enableFlowControl(uint32_t rxWindow)
+{
+    riot_stream_header_t sh;
+    erpc_status_t retVal;
+
+    // RPC messages the peer sends within our window must fit while a sender waits for credit.
+    if ((rxWindow == 0U) || (rxWindow > CONFIG_ERPC_FRAMING_PENDING_SIZE - ERPC_DEFAULT_BUFFER_SIZE)) {
+        return kErpcStatus_InvalidArgument;
+    }
+
+    resolveCrcMode();
+
+    m_rxWindow = rxWindow;
+    m_rxConsumed = 0;
+    m_rxPolled = false;
+    retVal = sendControl(kRiotStream_Window, RIOT_STREAM_LINK_ID, rxWindow);
+
+    // Handshake: a sender only learns the peer's window by reading, and it
+    // does not read while it has credit, so wait for the advertisement here.
+    {
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_receiveLock);
+#endif
+        while ((retVal == kErpcStatus_Success) && (m_txWindow == 0U)) {
+            retVal = readLinkFrame(sh);
+        }
+    }
+
+    signalLink();
+    return retVal;
+}
+
+void RiotFramedTransport::rxConsumed(uint32_t size, bool polled)
+{
+    uint32_t grant = 0;
+
+    {
+#if !ERPC_THREADS_IS(NONE)
+        Mutex::Guard lock(m_linkLock);
+#endif
+        if (m_rxWindow == 0U) {
+            return;
+        }
+        m_rxPolled = m_rxPolled || polled;
+        m_rxConsumed += size;
+        // Grant in batches of half a window; a poll means the sender is stuck, so answer it now.
+        if ((m_rxConsumed > 0U) && (m_rxPolled || (m_rxConsumed * 2U >= m_rxWindow))) {
+            grant = m_rxConsumed;
+            m_rxConsumed = 0;
+            m_rxPolled = false;
+        }
+    }
+
+    if (grant != 0U) {
+        (void)sendControl(kRiotStream_Credit, RIOT_STREAM_LINK_ID, grant);
+    }
+}
+
+bool RiotFramedTransport::hasTxCredit(uint32_t size) const
+{
+    if ((size == 0U) || (m_txWindow == 0U)) {
+        return true;
+    }
+    // Signed on purpose: an oversized frame may push the balance below zero.
+    int32_t avail = static_cast<int32_t>(m_txGranted - m_txSent);
+    return (avail >= static_cast<int32_t>(size)) || (avail >= static_cast<int32_t>(m_txWindow));
+}
+
+bool RiotFramedTransport::takeTxCredit(uint32_t size)
+{
+    if (!hasTxCredit(size)) {
+        return false;
+    }
+    if (m_txWindow != 0U) {
+        m_txSent = m_txSent + size;
+    }
+    return true;
+}
+
+erpc_status_t RiotFramedTransport::waitTxCredit(uint32_t size)
+{
+    riot_stream_header_t sh;
+    erpc_status_t retVal = kErpcStatus_Success;
+    bool polled = false;
+
+    while (!hasTxCredit(size)) {
+        if (!polled) {
+            retVal = sendControl(kRiotStream_Poll, RIOT_STREAM_LINK_ID, 0);
+            if (retVal != kErpcStatus_Success) {
+                break;
+            }
+            polled = true;
+        }
+#if !ERPC_THREADS_IS(NONE)
+        // A thread in receive() reads the grant and signals it. If nobody
+        // reads, read ourselves; RPC messages read on the way are kept for
+        // receive(), which may take them while we go on reading.
+        beginWaitLink();
+        if (hasTxCredit(size)) {
+            endWaitLink(false);
+            break;
+        }
+        if (m_receiveLock.tryLock()) {
+            endWaitLink(false);
+            retVal = readLinkFrame(sh);
+            m_receiveLock.unlock();
+            signalLink();
+        } else {
+            endWaitLink(true);
+        }
+#else
+        retVal = readLinkFrame(sh);
+#endif
+        if (retVal != kErpcStatus_Success) {
+            break;
+        }
+    }
+    return retVal;
+}
@@ -0,0 +1,88 @@
+#include "riot_stream.hpp"
+#include "riot_framed_transport.hpp"
+
+#include <cstring>
+
+RiotStreamWriter::RiotStreamWriter(RiotFramedTransport *transport, uint16_t streamId)
+    : m_transport(transport)
+    , m_streamId(streamId)
+    , m_offset(0)
+    , m_fill(0)
+    , m_inFlight(0)
+    , m_status(kErpcStatus_Success)
+{
+}
+
+erpc_status_t RiotStreamWriter::write(const void *data, uint32_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+
+    while ((m_status == kErpcStatus_Success) && (size > 0U)) {
+        if ((m_fill == 0U) && (size >= CONFIG_ERPC_STREAM_CHUNK)) {
+            // Whole chunks go out straight from the caller's buffer.
+            riot_stream_header_t sh = { RiotFramedTransport::kStreamTag, kRiotStream_Data, m_streamId, m_offset };
+            m_status = m_transport->sendStreamFrame(sh, p, CONFIG_ERPC_STREAM_CHUNK);
+            if ((m_status == kErpcStatus_Success) && (++m_inFlight == CONFIG_ERPC_STREAM_WINDOW)) {
+                m_inFlight = 0;
+                m_status = m_transport->receiveStreamCredit(m_streamId);
+            }
+            m_offset += CONFIG_ERPC_STREAM_CHUNK;
+            p += CONFIG_ERPC_STREAM_CHUNK;
+            size -= CONFIG_ERPC_STREAM_CHUNK;
+            continue;
+        }
+
+        uint32_t n = CONFIG_ERPC_STREAM_CHUNK - m_fill;
+        if (n > size) {
+            n = size;
+        }
+        std::memcpy(m_chunk + m_fill, p, n);
+        m_fill = static_cast<uint16_t>(m_fill + n);
+        p += n;
+        size -= n;
+        if (m_fill == CONFIG_ERPC_STREAM_CHUNK) {
+            m_status = flush();
+        }
+    }
+
+    return m_status;
+}
+
+erpc_status_t RiotStreamWriter::flush(void)
+{
+    erpc_status_t status;
+    riot_stream_header_t sh = { RiotFramedTransport::kStreamTag, kRiotStream_Data, m_streamId, m_offset };
+
+    if (m_fill == 0U) {
+        return kErpcStatus_Success;
+    }
+
+    status = m_transport->sendStreamFrame(sh, m_chunk, m_fill);
+    if ((status == kErpcStatus_Success) && (++m_inFlight == CONFIG_ERPC_STREAM_WINDOW)) {
+        m_inFlight = 0;
+        status = m_transport->receiveStreamCredit(m_streamId);
+    }
+    m_offset += m_fill;
+    m_fill = 0;
+    return status;
+}
+
+erpc_status_t RiotStreamWriter::close(void)
+{
+    if (m_status == kErpcStatus_Success) {
+        m_status = flush();
+    }
+
+    // The end marker is sent even after an error so the receiver releases its
+    // sink. A writer that already has a failure credit waits for no other: the
+    // receiver sends one per stream and drops the rest, the end marker included.
+    riot_stream_header_t sh = { RiotFramedTransport::kStreamTag, kRiotStream_End, m_streamId, m_offset };
+    erpc_status_t status = m_transport->sendStreamFrame(sh, NULL, 0);
+    if (m_status == kErpcStatus_Success) {
+        if (status == kErpcStatus_Success) {
+            status = m_transport->receiveStreamCredit(m_streamId);
+        }
+        m_status = status;
+    }
+    return m_status;
+}
@@ -0,0 +1,20 @@
+#ifndef _NATIVE_CLOCK_H_
+#define _NATIVE_CLOCK_H_
+
+#include <stdint.h>
+#include <time.h>
+
+/*!
+ * @brief Monotonic time in microseconds, wrapping at 2^32; usable from any pthread of a native build.
+ *
+ * xtimer only serves RIOT threads, so the native servers, clients and
+ * benchmarks time their pthreads with this instead.
+ */
+static inline uint32_t erpc_native_now_us(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000000U + (uint32_t)(ts.tv_nsec / 1000);
+}
+
+#endif /* _NATIVE_CLOCK_H_ */
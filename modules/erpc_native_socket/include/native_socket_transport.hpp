@@ -0,0 +1,74 @@
+#ifndef _NATIVE_SOCKET_TRANSPORT_HPP_
+#define _NATIVE_SOCKET_TRANSPORT_HPP_
+
+#include "riot_framed_transport.hpp"
+
+/*!
+ * @brief Bytes fill() reads ahead of the frames; one whole frame always fits.
+ */
+#ifndef CONFIG_ERPC_NATIVE_SOCKET_READ_AHEAD
+#define CONFIG_ERPC_NATIVE_SOCKET_READ_AHEAD ERPC_DEFAULT_BUFFER_SIZE
+#endif
+
+#if CONFIG_ERPC_NATIVE_SOCKET_READ_AHEAD < ERPC_DEFAULT_BUFFER_SIZE
+#error "CONFIG_ERPC_NATIVE_SOCKET_READ_AHEAD must hold a frame of ERPC_DEFAULT_BUFFER_SIZE"
+#endif
+
+/*!
+ * @brief Framed transport over a connected stream socket.
+ *
+ * TCP never corrupts bytes, so the transport is reliable and negotiates
+ * CRC-less frames (see RiotFramedTransport). Only the side that speaks first
+ * offers: a server on this transport keeps the CRC with a stock eRPC TCP
+ * client, which never offers. A client on it offers with its first call, so
+ * its server must be a RiotFramedTransport too, such as NativeTcpServer;
+ * call setCrcEnabled(true) first to talk to a stock eRPC server. There is
+ * no input notification: callers poll hasMessage().
+ *
+ * A caller that serves several sockets from one thread calls fill() when its
+ * socket is readable and receive() only while hasMessage() is true: a peer
+ * that stops in the middle of a frame then blocks nobody.
+ */
+class NativeSocketTransport : public RiotFramedTransport {
+public:
+    NativeSocketTransport(void) : m_fd(-1), m_aheadUsed(0) {}
+    virtual ~NativeSocketTransport(void) {}
+
+    /*!
+     * @brief Use connected socket @p fd, or none (-1); a new socket is a new peer (resetLink()).
+     */
+    void setSocket(int fd)
+    {
+        m_fd = fd;
+        m_aheadUsed = 0;
+        resetLink();
+    }
+    int getSocket(void) const { return m_fd; }
+
+    /*!
+     * @brief Read what the socket holds without blocking, for hasMessage() and receive() to take.
+     *
+     * @retval kErpcStatus_Success Read, or nothing was waiting.
+     * @retval kErpcStatus_ConnectionClosed The peer closed; frames read before stay available.
+     * @retval kErpcStatus_ReceiveFailed The socket failed.
+     */
+    erpc_status_t fill(void);
+
+protected:
+    virtual bool isReliable(void) const override { return true; }
+
+    /*!
+     * @brief Peek at unread socket data; -1 once the peer closed, so receive() reports it.
+     */
+    virtual int32_t underlyingPeek(uint8_t *data, uint32_t size) override;
+
+    virtual erpc_status_t underlyingSend(const uint8_t *data, uint32_t size) override;
+    virtual erpc_status_t underlyingReceive(uint8_t *data, uint32_t size) override;
+
+private:
+    int m_fd;
+    uint32_t m_aheadUsed;
+    uint8_t m_ahead[CONFIG_ERPC_NATIVE_SOCKET_READ_AHEAD]; /*!< Read by fill(), not yet received. */
+};
+
+#endif /* _NATIVE_SOCKET_TRANSPORT_HPP_ */
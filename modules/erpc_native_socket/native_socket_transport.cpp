@@ -0,0 +1,90 @@
+// native_socket_transport.cpp — framed eRPC transport over a connected host socket (native only)
+#include "native_socket_transport.hpp"
+
+#include <errno.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+erpc_status_t NativeSocketTransport::fill(void)
+{
+    while (m_aheadUsed < sizeof(m_ahead)) {
+        ssize_t n = ::recv(m_fd, m_ahead + m_aheadUsed, sizeof(m_ahead) - m_aheadUsed, MSG_DONTWAIT);
+        if (n == 0) {
+            return kErpcStatus_ConnectionClosed;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? kErpcStatus_Success : kErpcStatus_ReceiveFailed;
+        }
+        m_aheadUsed += static_cast<uint32_t>(n);
+    }
+    // Full means a whole frame is waiting; the rest stays in the socket until it is taken.
+    return kErpcStatus_Success;
+}
+
+int32_t NativeSocketTransport::underlyingPeek(uint8_t *data, uint32_t size)
+{
+    struct pollfd pfd = { m_fd, POLLIN, 0 };
+    uint32_t ahead = (size < m_aheadUsed) ? size : m_aheadUsed;
+    int avail = 0;
+
+    memcpy(data, m_ahead, ahead);
+    if (::poll(&pfd, 1, 0) <= 0) {
+        return static_cast<int32_t>(m_aheadUsed);
+    }
+    // Readable with nothing to read: closed or failed. Frames read ahead go first.
+    if ((::ioctl(m_fd, FIONREAD, &avail) != 0) || (avail <= 0)) {
+        return (m_aheadUsed > 0U) ? static_cast<int32_t>(m_aheadUsed) : -1;
+    }
+    if ((size > ahead) && (::recv(m_fd, data + ahead, size - ahead, MSG_PEEK | MSG_DONTWAIT) < 0)) {
+        return -1;
+    }
+    return static_cast<int32_t>(m_aheadUsed) + avail;
+}
+
+erpc_status_t NativeSocketTransport::underlyingSend(const uint8_t *data, uint32_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::send(m_fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return kErpcStatus_SendFailed;
+        }
+        data += n;
+        size -= static_cast<uint32_t>(n);
+    }
+    return kErpcStatus_Success;
+}
+
+erpc_status_t NativeSocketTransport::underlyingReceive(uint8_t *data, uint32_t size)
+{
+    if (m_aheadUsed > 0U) {
+        uint32_t ahead = (size < m_aheadUsed) ? size : m_aheadUsed;
+        memcpy(data, m_ahead, ahead);
+        m_aheadUsed -= ahead;
+        memmove(m_ahead, m_ahead + ahead, m_aheadUsed);
+        data += ahead;
+        size -= ahead;
+    }
+    while (size > 0) {
+        ssize_t n = ::recv(m_fd, data, size, 0);
+        if (n == 0) {
+            return kErpcStatus_ConnectionClosed;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return kErpcStatus_ReceiveFailed;
+        }
+        data += n;
+        size -= static_cast<uint32_t>(n);
+    }
+    return kErpcStatus_Success;
+}
@@ -0,0 +1,145 @@
+// dense_server.cpp — SimpleServer with O(1) service lookup
+#include "dense_server.hpp"
+#include "erpc_compact_codec.hpp"
+#include "erpc_status_reply.hpp"
+
+#include <string.h>
+
+using namespace erpc;
+
+DenseServer::DenseServer(void)
+: SimpleServer()
+, m_replyCache(NULL)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_SERVICE_TABLE_SIZE; ++i) {
+        m_serviceTable[i] = NULL;
+    }
+}
+
+void DenseServer::addService(Service *service)
+{
+    Server::addService(service);
+    rebuildServiceTable();
+}
+
+void DenseServer::removeService(Service *service)
+{
+    Server::removeService(service);
+    rebuildServiceTable();
+}
+
+void DenseServer::rebuildServiceTable(void)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_SERVICE_TABLE_SIZE; ++i) {
+        m_serviceTable[i] = NULL;
+    }
+    // The first registered service wins a duplicate id, as in the list walk.
+    for (Service *service = m_firstService; service != NULL; service = service->getNext()) {
+        uint32_t id = service->getServiceId();
+        if ((id < CONFIG_ERPC_SERVICE_TABLE_SIZE) && (m_serviceTable[id] == NULL)) {
+            m_serviceTable[id] = service;
+        }
+    }
+}
+
+Service *DenseServer::findServiceWithId(uint32_t serviceId)
+{
+    // Read only: the pool servers look up from several workers at once.
+    Service *service = (serviceId < CONFIG_ERPC_SERVICE_TABLE_SIZE) ? m_serviceTable[serviceId] : NULL;
+    if (service == NULL) {
+        // Large id, or registered through erpc::Server::addService() since the last rebuild.
+        service = Server::findServiceWithId(serviceId);
+    }
+    return service;
+}
+
+erpc_status_t DenseServer::run(void)
+{
+    erpc_status_t err = kErpcStatus_Success;
+
+    // The C API registers services through the erpc::Server methods.
+    rebuildServiceTable();
+    while ((err == kErpcStatus_Success) && m_isServerOn) {
+        err = runInternal();
+    }
+    return err;
+}
+
+erpc_status_t DenseServer::processMessage(Codec *codec, message_type_t msgType, uint32_t serviceId,
+                                          uint32_t methodId, uint32_t sequence)
+{
+    return dispatch(codec, m_transport, msgType, serviceId, methodId, sequence);
+}
+
+erpc_status_t DenseServer::dispatch(Codec *codec, Transport *transport, message_type_t msgType, uint32_t serviceId,
+                                    uint32_t methodId, uint32_t sequence)
+{
+    Service *service = NULL;
+    if ((msgType == message_type_t::kInvocationMessage) || (msgType == message_type_t::kOnewayMessage)) {
+        service = findServiceWithId(serviceId);
+    }
+    if (service == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    if ((m_replyCache != NULL) && (msgType == message_type_t::kInvocationMessage) &&
+        m_replyCache->isCacheable(serviceId, methodId)) {
+        return dispatchCached(service, codec, transport, serviceId, methodId, sequence);
+    }
+    return service->handleInvocation(methodId, sequence, codec, m_messageFactory, transport);
+}
+
+erpc_status_t DenseServer::dispatchCached(Service *service, Codec *codec, Transport *transport, uint32_t serviceId,
+                                          uint32_t methodId, uint32_t sequence)
+{
+    MessageBuffer &buff = codec->getBufferRef();
+    uint32_t offset = transport->reserveHeaderSize();
+    uint32_t header = messageHeaderSize(buff, offset);
+    uint32_t argSize = buff.getUsed() - offset - header;
+    if ((header == 0U) || (argSize >= CONFIG_ERPC_CACHE_ARGS_MAX)) {
+        return service->handleInvocation(methodId, sequence, codec, m_messageFactory, transport);
+    }
+
+    // The handler overwrites the request with its reply; keep the key. It
+    // starts with the codec, whose encoding the cached results share.
+    uint8_t args[CONFIG_ERPC_CACHE_ARGS_MAX];
+    uint8_t reply[CONFIG_ERPC_CACHE_REPLY_MAX];
+    uint32_t replySize = 0;
+    args[0] = isCompactMessage(buff, offset) ? 1U : 0U;
+    memcpy(args + 1, buff.get() + offset + header, argSize);
+    ++argSize;
+
+    lockReplyCache();
+    bool hit = m_replyCache->lookup(serviceId, methodId, args, argSize, reply, replySize);
+    unlockReplyCache();
+    if (hit) {
+        return writeReply(buff, offset, serviceId, methodId, sequence, reply, replySize);
+    }
+
+    erpc_status_t err = service->handleInvocation(methodId, sequence, codec, m_messageFactory, transport);
+    if (err == kErpcStatus_Success) {
+        MessageBuffer &out = codec->getBufferRef();
+        header = messageHeaderSize(out, offset);
+        if ((header != 0U) && (out.getUsed() - offset - header <= CONFIG_ERPC_CACHE_REPLY_MAX)) {
+            lockReplyCache();
+            m_replyCache->store(serviceId, methodId, args, argSize, out.get() + offset + header,
+                                out.getUsed() - offset - header);
+            unlockReplyCache();
+        }
+    }
+    return err;
+}
+
+bool DenseServer::readDeadline(Codec *codec, Transport *transport, uint32_t &budgetUs)
+{
+    MessageBuffer &buff = codec->getBufferRef();
+    uint32_t offset = transport->reserveHeaderSize();
+    if ((buff.getUsed() <= offset) ||
+        !CompactCodec::readDeadline(buff.get() + offset, buff.getUsed() - offset, budgetUs)) {
+        return false;
+    }
+    // Callers compare deadlines as signed differences.
+    if (budgetUs > static_cast<uint32_t>(INT32_MAX)) {
+        budgetUs = static_cast<uint32_t>(INT32_MAX);
+    }
+    return true;
+}
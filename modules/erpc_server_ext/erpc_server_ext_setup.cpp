@@ -0,0 +1,135 @@
+// erpc_server_ext_setup.cpp — C API for the erpc_server_ext server variants
+#include "erpc_server_ext_setup.h"
+#include "erpc_basic_codec.hpp"
+#include "erpc_crc16.hpp"
+#include "erpc_manually_constructed.hpp"
+#include "dense_server.hpp"
+#include "riot_framed_transport.hpp"
+#include "riot_pool_server.hpp"
+
+using namespace erpc;
+
+// Same setup as erpc_server_init(): BasicCodec and a default Crc16 on the transport.
+ERPC_MANUALLY_CONSTRUCTED_STATIC(DenseServer, s_denseServer);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(BasicCodecFactory, s_denseCodecFactory);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(Crc16, s_denseCrc16);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(RiotPoolServer, s_poolServer);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(BasicCodecFactory, s_poolCodecFactory);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(Crc16, s_poolCrc16);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(ReplyCache, s_replyCache);
+static erpc_transport_t s_poolTransport; // erpc_server_pool_add_transport() needs its events
+
+////////////////////////////////////////////////////////////////////////////////
+// External C Interface
+////////////////////////////////////////////////////////////////////////////////
+
+erpc_server_t erpc_server_dense_init(erpc_transport_t transport, erpc_mbf_t message_buffer_factory)
+{
+    if ((transport == NULL) || (message_buffer_factory == NULL) || s_denseServer.isUsed()) {
+        return NULL;
+    }
+    Transport *t = reinterpret_cast<Transport *>(transport);
+
+    s_denseCrc16.construct();
+    t->setCrc16(s_denseCrc16.get());
+    s_denseCodecFactory.construct();
+    s_denseServer.construct();
+
+    DenseServer *server = s_denseServer.get();
+    server->setTransport(t);
+    server->setCodecFactory(s_denseCodecFactory.get());
+    server->setMessageBufferFactory(reinterpret_cast<MessageBufferFactory *>(message_buffer_factory));
+    return reinterpret_cast<erpc_server_t>(server);
+}
+
+void erpc_server_rebuild_dispatch(erpc_server_t server)
+{
+    if (server != NULL) {
+        reinterpret_cast<DenseServer *>(server)->rebuildServiceTable();
+    }
+}
+
+erpc_server_t erpc_server_pool_init(erpc_transport_t transport, erpc_mbf_t message_buffer_factory, uint8_t priority)
+{
+    if ((transport == NULL) || (message_buffer_factory == NULL) || s_poolServer.isUsed()) {
+        return NULL;
+    }
+    Transport *t = reinterpret_cast<Transport *>(transport);
+
+    s_poolTransport = transport;
+    s_poolCrc16.construct();
+    t->setCrc16(s_poolCrc16.get());
+    s_poolCodecFactory.construct();
+    s_poolServer.construct();
+
+    RiotPoolServer *server = s_poolServer.get();
+    server->setTransport(t);
+    server->setCodecFactory(s_poolCodecFactory.get());
+    server->setMessageBufferFactory(reinterpret_cast<MessageBufferFactory *>(message_buffer_factory));
+    if (server->start(priority) != kErpcStatus_Success) {
+        // No worker is left running; a later call may try again.
+        s_poolServer.destroy();
+        s_poolCodecFactory.destroy();
+        s_poolCrc16.destroy();
+        s_poolTransport = NULL;
+        return NULL;
+    }
+    return reinterpret_cast<erpc_server_t>(server);
+}
+
+erpc_status_t erpc_server_pool_add_transport(erpc_server_t server, erpc_transport_t transport)
+{
+    if ((server == NULL) || (transport == NULL)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    RiotPoolServer *pool = reinterpret_cast<RiotPoolServer *>(server);
+
+    // Both transports are RiotFramedTransport objects, see the header.
+    pool->setRxEvents(reinterpret_cast<RiotFramedTransport *>(s_poolTransport));
+    return pool->addTransport(reinterpret_cast<RiotFramedTransport *>(transport));
+}
+
+erpc_status_t erpc_server_pool_set_priority_class(erpc_server_t server, uint32_t service_id, uint32_t method_id,
+                                                  uint8_t lane)
+{
+    if (server == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    return reinterpret_cast<RiotPoolServer *>(server)->setPriorityClass(service_id, method_id, lane);
+}
+
+erpc_status_t erpc_server_cache_method(erpc_server_t server, uint32_t service_id, uint32_t method_id)
+{
+    if (server == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    DenseServer *dense = reinterpret_cast<DenseServer *>(server);
+    if (!s_replyCache.isUsed()) {
+        s_replyCache.construct();
+    } else if (dense->getReplyCache() != s_replyCache.get()) {
+        return kErpcStatus_InvalidArgument;
+    }
+    if (!s_replyCache->addMethod(service_id, method_id)) {
+        return kErpcStatus_MemoryError;
+    }
+    dense->setReplyCache(s_replyCache.get());
+    return kErpcStatus_Success;
+}
+
+void erpc_server_cache_clear(erpc_server_t server)
+{
+    if ((server != NULL) && (reinterpret_cast<DenseServer *>(server)->getReplyCache() != NULL)) {
+        reinterpret_cast<DenseServer *>(server)->getReplyCache()->clear();
+    }
+}
+
+void erpc_server_cache_stats(erpc_server_t server, uint32_t *hits, uint32_t *misses)
+{
+    ReplyCache *cache = (server != NULL) ? reinterpret_cast<DenseServer *>(server)->getReplyCache() : NULL;
+    if (hits != NULL) {
+        *hits = (cache != NULL) ? cache->getHits() : 0U;
+    }
+    if (misses != NULL) {
+        *misses = (cache != NULL) ? cache->getMisses() : 0U;
+    }
+}
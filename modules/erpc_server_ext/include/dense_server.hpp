@@ -0,0 +1,126 @@
+#ifndef _DENSE_SERVER_HPP_
+#define _DENSE_SERVER_HPP_
+
+#include "erpc_simple_server.hpp"
+#include "erpc_status_ext.h"
+#include "reply_cache.hpp"
+
+/*!
+ * @brief Number of service ids (0 .. N-1) resolved through the dense table.
+ *
+ * Costs one pointer per entry. Services with larger ids still work but are
+ * found by walking the service list.
+ */
+#ifndef CONFIG_ERPC_SERVICE_TABLE_SIZE
+#define CONFIG_ERPC_SERVICE_TABLE_SIZE 64
+#endif
+
+/*!
+ * @brief SimpleServer that finds services through a table indexed by service id.
+ *
+ * erpc::Server walks its service list for every request. This server keeps
+ * a table filled in by addService(), so the lookup is a single array access.
+ * erpc_add_service_to_server() and erpc_remove_service_from_server() call
+ * the erpc::Server methods instead, so run() refills the table from the
+ * service list before it serves. The lookup itself never writes, which keeps
+ * it safe from the worker threads of the derived servers; a service missing
+ * from the table is still found by walking the list. Without run()
+ * (erpc_server_poll()), or after changing services while run() is active,
+ * call rebuildServiceTable() (C: erpc_server_rebuild_dispatch()) while the
+ * server is idle.
+ *
+ * Method dispatch needs no table: the generated handleInvocation() switches
+ * on consecutive method ids, which compilers turn into a jump table.
+ *
+ * Deadlines (erpc::CompactCodec::insertDeadline()) are not enforced here.
+ * The budget on the wire counts from the client's send, and a client never
+ * sends a zero budget, so a server that executes each request as soon as it
+ * arrives cannot tell one that ran out. Only the queueing servers
+ * (RiotPoolServer, NativeTcpServer) drop a request whose budget passed while
+ * it waited for a worker.
+ *
+ * With setReplyCache(), calls of the methods marked in the cache are
+ * answered from it when the same arguments were seen before: the cached
+ * results are copied behind a fresh reply header and the handler is not
+ * called.
+ */
+class DenseServer : public erpc::SimpleServer {
+public:
+    DenseServer(void);
+    virtual ~DenseServer(void) {}
+
+    /*!
+     * @brief Register @p service and enter it in the table.
+     */
+    void addService(erpc::Service *service);
+
+    /*!
+     * @brief Unregister @p service and drop it from the table.
+     */
+    void removeService(erpc::Service *service);
+
+    /*!
+     * @brief Refill the table from the registered service list.
+     *
+     * Not thread safe with request dispatch; call it while the server is idle.
+     */
+    void rebuildServiceTable(void);
+
+    /*!
+     * @brief Refill the service table, then serve requests until stop() or an error.
+     *
+     * Expired requests are no error.
+     */
+    virtual erpc_status_t run(void) override;
+
+    /*!
+     * @brief Answer calls of the methods marked in @p cache from it; NULL to stop.
+     *
+     * Call this while the server is idle.
+     */
+    void setReplyCache(ReplyCache *cache) { m_replyCache = cache; }
+
+    ReplyCache *getReplyCache(void) { return m_replyCache; }
+
+protected:
+    virtual erpc::Service *findServiceWithId(uint32_t serviceId) override;
+
+    /*!
+     * @brief Dispatch the request through the reply cache.
+     */
+    virtual erpc_status_t processMessage(erpc::Codec *codec, erpc::message_type_t msgType, uint32_t serviceId,
+                                         uint32_t methodId, uint32_t sequence) override;
+
+    /*!
+     * @brief Read the deadline of the request decoded by @p codec.
+     *
+     * @param[in] codec Codec holding the received request.
+     * @param[in] transport Transport the request came from.
+     * @param[out] budgetUs Time the client still allowed, in microseconds, at most INT32_MAX.
+     *
+     * @retval true The request carries a deadline.
+     * @retval false No deadline (it is not a CompactCodec request, or the client set none).
+     */
+    static bool readDeadline(erpc::Codec *codec, erpc::Transport *transport, uint32_t &budgetUs);
+
+    /*!
+     * @brief erpc::Server::processMessage() for a request received on @p transport, through the reply cache.
+     */
+    erpc_status_t dispatch(erpc::Codec *codec, erpc::Transport *transport, erpc::message_type_t msgType,
+                           uint32_t serviceId, uint32_t methodId, uint32_t sequence);
+
+    /*!
+     * @brief Serialise access to the reply cache; servers with several worker threads override these.
+     */
+    virtual void lockReplyCache(void) {}
+    virtual void unlockReplyCache(void) {}
+
+private:
+    erpc_status_t dispatchCached(erpc::Service *service, erpc::Codec *codec, erpc::Transport *transport,
+                                 uint32_t serviceId, uint32_t methodId, uint32_t sequence);
+
+    erpc::Service *m_serviceTable[CONFIG_ERPC_SERVICE_TABLE_SIZE];
+    ReplyCache *m_replyCache;
+};
+
+#endif /* _DENSE_SERVER_HPP_ */
@@ -0,0 +1,160 @@
+#ifndef _ERPC_SERVER_EXT_SETUP_H_
+#define _ERPC_SERVER_EXT_SETUP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "erpc_server_setup.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Create a SimpleServer with O(1) service lookup (DenseServer).
+ *
+ * Same as erpc_server_init(), and the handle is used the same way, except
+ * that erpc_server_deinit() must not be called on it. There is one such
+ * server per firmware image.
+ *
+ * @return Server handle, or NULL if it already exists.
+ */
+erpc_server_t erpc_server_dense_init(erpc_transport_t transport, erpc_mbf_t message_buffer_factory);
+
+/*!
+ * @brief Refill the service table of a server created by this module.
+ *
+ * erpc_server_run() does this before it serves. Call it while the server is
+ * idle after adding or removing services without going through
+ * erpc_server_run() again, e.g. when serving with erpc_server_poll().
+ */
+void erpc_server_rebuild_dispatch(erpc_server_t server);
+
+/*!
+ * @brief Create the pool server (RiotPoolServer) on @p transport and start its workers.
+ *
+ * The returned handle works with erpc_add_service_to_server(),
+ * erpc_server_run(), erpc_server_stop() and erpc_server_set_codec(). Do not
+ * use erpc_server_poll() or erpc_server_deinit() on it. There is one pool
+ * server per firmware image.
+ *
+ * @param[in] transport Transport the requests arrive on.
+ * @param[in] message_buffer_factory Factory for request and reply buffers.
+ * @param[in] priority RIOT priority of the CONFIG_ERPC_POOL_WORKERS worker threads.
+ *
+ * @return Server handle, or NULL if it already exists or the workers could not be started.
+ */
+erpc_server_t erpc_server_pool_init(erpc_transport_t transport, erpc_mbf_t message_buffer_factory, uint8_t priority);
+
+/*!
+ * @brief Let the pool server also serve requests arriving on @p transport.
+ *
+ * Call this before erpc_server_run(). @p transport and the transport given
+ * to erpc_server_pool_init() must both be RiotFramedTransport objects, as
+ * every transport of this repository is; their input wakes the server, see
+ * RiotPoolServer::addTransport().
+ *
+ * @retval kErpcStatus_Success Transport attached.
+ * @retval kErpcStatus_InvalidArgument NULL argument or transport already attached.
+ * @retval kErpcStatus_MemoryError CONFIG_ERPC_POOL_TRANSPORTS reached.
+ */
+erpc_status_t erpc_server_pool_add_transport(erpc_server_t server, erpc_transport_t transport);
+
+/*!
+ * @brief erpc_server_pool_set_priority_class(): every method of the service.
+ */
+#define ERPC_POOL_ANY_METHOD (0xFFFFFFFFU)
+
+/*!
+ * @brief Execute calls of @p method_id of service @p service_id in priority lane @p lane.
+ *
+ * Lane n has its own queue and workers at the pool priority minus n, so
+ * calls in higher lanes preempt those in lower ones. See
+ * RiotPoolServer::setPriorityClass(). Call this before erpc_server_run().
+ *
+ * @param[in] server Pool server.
+ * @param[in] service_id Service id as generated from the IDL (e.g. kMultiplyService_service_id).
+ * @param[in] method_id Method id (e.g. kMultiplyService_multiply_id), or ERPC_POOL_ANY_METHOD.
+ * @param[in] lane 0 .. CONFIG_ERPC_POOL_LANES - 1; higher is more urgent.
+ *
+ * @retval kErpcStatus_Success Rule set.
+ * @retval kErpcStatus_InvalidArgument NULL server or no such lane.
+ * @retval kErpcStatus_MemoryError CONFIG_ERPC_POOL_LANE_RULES reached.
+ */
+erpc_status_t erpc_server_pool_set_priority_class(erpc_server_t server, uint32_t service_id, uint32_t method_id,
+                                                  uint8_t lane);
+
+/*!
+ * @brief erpc_server_cache_method(): every method of the service.
+ */
+#define ERPC_CACHE_ANY_METHOD (0xFFFFFFFFU)
+
+/*!
+ * @brief Answer calls of @p method_id of service @p service_id from the reply cache.
+ *
+ * Only for methods whose results depend on their arguments alone: a call
+ * with the same encoded arguments as an earlier one gets that call's results
+ * without running the handler. The first call attaches the cache (one per
+ * firmware image, see ReplyCache) to @p server, which works for every server
+ * created by this module. Call this while the server is idle.
+ *
+ * @param[in] server Server created by this module.
+ * @param[in] service_id Service id as generated from the IDL.
+ * @param[in] method_id Method id, or ERPC_CACHE_ANY_METHOD.
+ *
+ * @retval kErpcStatus_Success Method cached.
+ * @retval kErpcStatus_InvalidArgument NULL server, or the cache belongs to another server.
+ * @retval kErpcStatus_MemoryError CONFIG_ERPC_CACHE_METHODS reached.
+ */
+erpc_status_t erpc_server_cache_method(erpc_server_t server, uint32_t service_id, uint32_t method_id);
+
+/*!
+ * @brief Drop all cached replies, e.g. after the state behind a cached method changed.
+ *
+ * Call this while the server is idle.
+ */
+void erpc_server_cache_clear(erpc_server_t server);
+
+/*!
+ * @brief Read the hit and miss counts of the reply cache; either pointer may be NULL.
+ */
+void erpc_server_cache_stats(erpc_server_t server, uint32_t *hits, uint32_t *misses);
+
+#ifdef CPU_NATIVE
+/*!
+ * @brief Create the native multi-connection TCP server (NativeTcpServer), native builds only.
+ *
+ * Listens on @p port and executes requests on a work-stealing pool of host
+ * threads. Use the handle like erpc_server_pool_init()'s.
+ *
+ * @param[in] port TCP port, bound on all interfaces.
+ * @param[in] message_buffer_factory Factory for request and reply buffers; must be thread safe.
+ * @param[in] workers Worker threads, 0 for one per online core.
+ * @param[in] pin Pin worker i to core i modulo the core count.
+ *
+ * @return Server handle, or NULL if it already exists or the port or workers could not be set up.
+ */
+erpc_server_t erpc_server_native_tcp_init(uint16_t port, erpc_mbf_t message_buffer_factory, unsigned workers, bool pin);
+
+/*!
+ * @brief Run identical concurrent calls of @p method_id of service @p service_id once on the native TCP server.
+ *
+ * Calls with the same encoded arguments that arrive while one of them is
+ * executing share its results; see NativeTcpServer::coalesceMethod(). Only
+ * for methods without side effects. Call this before erpc_server_run().
+ *
+ * @param[in] server Server from erpc_server_native_tcp_init().
+ * @param[in] service_id Service id as generated from the IDL.
+ * @param[in] method_id Method id, or ERPC_CACHE_ANY_METHOD.
+ *
+ * @retval kErpcStatus_Success Method marked.
+ * @retval kErpcStatus_InvalidArgument NULL server.
+ * @retval kErpcStatus_MemoryError CONFIG_ERPC_TCP_COALESCE_METHODS reached.
+ */
+erpc_status_t erpc_server_native_tcp_coalesce(erpc_server_t server, uint32_t service_id, uint32_t method_id);
+#endif /* CPU_NATIVE */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _ERPC_SERVER_EXT_SETUP_H_ */
@@ -0,0 +1,104 @@
+#ifndef _NATIVE_STEAL_EXECUTOR_HPP_
+#define _NATIVE_STEAL_EXECUTOR_HPP_
+
+#include <pthread.h>
+#include <stdint.h>
+#include "erpc_common.h"
+
+/*!
+ * @brief Upper bound for the worker count of a NativeStealExecutor.
+ */
+#ifndef CONFIG_ERPC_STEAL_MAX_WORKERS
+#define CONFIG_ERPC_STEAL_MAX_WORKERS 64
+#endif
+
+/*!
+ * @brief Capacity of each worker's deque.
+ */
+#ifndef CONFIG_ERPC_STEAL_DEQUE
+#define CONFIG_ERPC_STEAL_DEQUE 64
+#endif
+
+/*!
+ * @brief Work-stealing thread pool for native builds (host pthreads).
+ *
+ * Every worker owns a deque. submit() appends to the deque of the given home
+ * worker; the owner takes its oldest task first, and a worker whose deque is
+ * empty steals the newest task of another worker. A producer that keeps the
+ * home of related tasks stable (e.g. one home per connection) therefore gets
+ * cache locality while the load still spreads over all workers.
+ *
+ * Workers can be pinned to CPU cores, worker i to core i modulo the number of
+ * online cores.
+ */
+class NativeStealExecutor {
+public:
+    /*!
+     * @brief Task entry point.
+     */
+    typedef void (*task_fn_t)(void *arg);
+
+    NativeStealExecutor(void);
+    ~NativeStealExecutor(void);
+
+    /*!
+     * @brief Start @p workers threads, one per online core when 0.
+     *
+     * @retval kErpcStatus_Success Workers running.
+     * @retval kErpcStatus_InvalidArgument Already started.
+     * @retval kErpcStatus_MemoryError A thread could not be created.
+     */
+    erpc_status_t start(unsigned workers, bool pin);
+
+    /*!
+     * @brief Let the workers finish the queued tasks, then join them.
+     */
+    void stop(void);
+
+    /*!
+     * @brief Queue @p fn(@p arg) on worker @p home modulo the worker count.
+     *
+     * Falls back to the other deques when the home deque is full.
+     *
+     * @retval kErpcStatus_Success Task queued.
+     * @retval kErpcStatus_MemoryError Every deque is full or the executor is not running.
+     */
+    erpc_status_t submit(unsigned home, task_fn_t fn, void *arg);
+
+    /*!
+     * @brief Number of running workers.
+     */
+    unsigned getWorkerCount(void) const { return m_workerCount; }
+
+private:
+    struct Task {
+        task_fn_t m_fn;
+        void *m_arg;
+    };
+
+    struct Worker {
+        pthread_mutex_t m_lock;
+        pthread_t m_thread;
+        NativeStealExecutor *m_owner;
+        unsigned m_index;
+        unsigned m_head;  /*!< Oldest task. */
+        unsigned m_count;
+        Task m_tasks[CONFIG_ERPC_STEAL_DEQUE];
+    };
+
+    static void *workerEntry(void *arg);
+    void workerLoop(Worker &self);
+    bool push(Worker &w, const Task &task);
+    bool popOldest(Worker &w, Task &task);
+    bool popNewest(Worker &w, Task &task);
+    bool take(Worker &self, Task &task);
+
+    Worker m_workers[CONFIG_ERPC_STEAL_MAX_WORKERS];
+    unsigned m_workerCount;
+    unsigned m_pending;         /*!< Queued tasks over all deques, atomic. */
+    bool m_running;
+    pthread_mutex_t m_idleLock;
+    pthread_cond_t m_idle;      /*!< Signalled on submit() and stop(). */
+};
+
+#endif /* _NATIVE_STEAL_EXECUTOR_HPP_ */
@@ -0,0 +1,254 @@
+#ifndef _NATIVE_TCP_SERVER_HPP_
+#define _NATIVE_TCP_SERVER_HPP_
+
+#include <pthread.h>
+#include "erpc_crc16.hpp"
+#include "dense_server.hpp"
+#include "native_steal_executor.hpp"
+#include "native_socket_transport.hpp"
+
+/*!
+ * @brief TCP connections a NativeTcpServer serves at once; further clients are refused.
+ */
+#ifndef CONFIG_ERPC_TCP_CONNECTIONS
+#define CONFIG_ERPC_TCP_CONNECTIONS 32
+#endif
+
+/*!
+ * @brief Requests a NativeTcpServer holds at once, over all connections.
+ *
+ * When all are taken the server stops reading from its sockets until a reply
+ * has been sent.
+ */
+#ifndef CONFIG_ERPC_TCP_INFLIGHT
+#define CONFIG_ERPC_TCP_INFLIGHT 64
+#endif
+
+/*!
+ * @brief Requests a NativeTcpServer admits for execution at once; 0 for no limit.
+ *
+ * Further requests are answered with kErpcStatus_ServerBusy right away. Keep
+ * it below CONFIG_ERPC_TCP_INFLIGHT, which also holds the rejections while
+ * their replies wait for their turn.
+ */
+#ifndef CONFIG_ERPC_TCP_ADMIT
+#define CONFIG_ERPC_TCP_ADMIT 48
+#endif
+
+/*!
+ * @brief Queue delay a NativeTcpServer tolerates, in microseconds; 0 to disable.
+ *
+ * CoDel-style: once every request a worker started during
+ * CONFIG_ERPC_TCP_CODEL_INTERVAL_US waited longer than this, new requests are
+ * rejected with kErpcStatus_ServerBusy until a request waits less again or
+ * the queue has drained.
+ */
+#ifndef CONFIG_ERPC_TCP_CODEL_TARGET_US
+#define CONFIG_ERPC_TCP_CODEL_TARGET_US 5000
+#endif
+
+/*!
+ * @brief Time the queue delay must stay above target before shedding starts, in microseconds.
+ *
+ * Shorter than CoDel's usual 100 ms: RPC handlers run for milliseconds, and
+ * at twice the capacity the queue would fill CONFIG_ERPC_TCP_ADMIT long before.
+ */
+#ifndef CONFIG_ERPC_TCP_CODEL_INTERVAL_US
+#define CONFIG_ERPC_TCP_CODEL_INTERVAL_US 20000
+#endif
+
+/*!
+ * @brief Methods NativeTcpServer::coalesceMethod() can mark.
+ */
+#ifndef CONFIG_ERPC_TCP_COALESCE_METHODS
+#define CONFIG_ERPC_TCP_COALESCE_METHODS 8
+#endif
+
+/*!
+ * @brief Largest key of a call that is coalesced, in bytes: one byte for the codec plus the encoded arguments.
+ *
+ * Each request slot holds one key.
+ */
+#ifndef CONFIG_ERPC_TCP_COALESCE_ARGS_MAX
+#define CONFIG_ERPC_TCP_COALESCE_ARGS_MAX 32
+#endif
+
+#if CONFIG_ERPC_TCP_INFLIGHT > CONFIG_ERPC_STEAL_DEQUE
+#error "CONFIG_ERPC_TCP_INFLIGHT must not exceed CONFIG_ERPC_STEAL_DEQUE"
+#endif
+
+#if CONFIG_ERPC_TCP_ADMIT >= CONFIG_ERPC_TCP_INFLIGHT
+#error "CONFIG_ERPC_TCP_ADMIT must be below CONFIG_ERPC_TCP_INFLIGHT"
+#endif
+
+/*!
+ * @brief Multi-connection TCP server for native builds, dispatching on a NativeStealExecutor.
+ *
+ * run() accepts clients and polls all their sockets on the calling thread.
+ * Every request is submitted with its connection's worker as home, so one
+ * client's calls stay on one core while idle workers steal from busy ones.
+ * Replies of a connection are sent in the order its requests arrived.
+ * Requests whose deadline runs out before a worker starts them are dropped
+ * without a reply and without closing the connection.
+ *
+ * Admission control keeps overload out of the queue: beyond
+ * CONFIG_ERPC_TCP_ADMIT requests, or while the queue delay exceeds
+ * CONFIG_ERPC_TCP_CODEL_TARGET_US, a request is answered on the receive
+ * thread with a status-only reply (erpc::writeStatusReply()) carrying
+ * kErpcStatus_ServerBusy. Rejected oneway requests are dropped.
+ *
+ * Calls of methods marked with coalesceMethod() are executed once per set of
+ * identical concurrent calls (single flight): a call whose service, method
+ * and encoded arguments match one a worker is running waits for it without
+ * occupying a worker, then gets a copy of its results under its own
+ * sequence number. If the handler fails, every waiting call fails with it.
+ *
+ * The receive thread reads each readable socket without blocking
+ * (NativeSocketTransport::fill()) and takes only whole frames, so a client
+ * that stalls in the middle of a frame delays nobody but itself.
+ */
+class NativeTcpServer : public DenseServer {
+public:
+    static const uint32_t kAnyMethod = 0xFFFFFFFFU; /*!< coalesceMethod(): every method of the service. */
+
+    NativeTcpServer(void);
+    virtual ~NativeTcpServer(void);
+
+    /*!
+     * @brief Listen on @p port on all interfaces.
+     *
+     * @retval kErpcStatus_Success Listening.
+     * @retval kErpcStatus_InitFailed Socket, bind or listen failed.
+     */
+    erpc_status_t open(uint16_t port);
+
+    /*!
+     * @brief Start the executor; see NativeStealExecutor::start().
+     */
+    erpc_status_t start(unsigned workers, bool pin) { return m_executor.start(workers, pin); }
+
+    /*!
+     * @brief Serve connections until stop().
+     *
+     * @retval kErpcStatus_Success Stopped.
+     * @retval kErpcStatus_InitFailed open() or start() was not called.
+     */
+    virtual erpc_status_t run(void) override;
+
+    /*!
+     * @brief Make run() return. Queued requests are still executed.
+     */
+    virtual void stop(void) override;
+
+    /*!
+     * @brief Requests rejected with kErpcStatus_ServerBusy so far.
+     */
+    uint32_t getRejectedCount(void) const { return __atomic_load_n(&m_rejected, __ATOMIC_RELAXED); }
+
+    /*!
+     * @brief Coalesce identical concurrent calls of @p methodId of service @p serviceId.
+     *
+     * Only for methods without side effects, whose results depend on their
+     * arguments alone. Call this before run().
+     *
+     * @param[in] serviceId Service id.
+     * @param[in] methodId Method id, or kAnyMethod.
+     *
+     * @retval kErpcStatus_Success Method marked.
+     * @retval kErpcStatus_MemoryError CONFIG_ERPC_TCP_COALESCE_METHODS reached.
+     */
+    erpc_status_t coalesceMethod(uint32_t serviceId, uint32_t methodId);
+
+    /*!
+     * @brief Calls answered with the results of an identical call so far.
+     */
+    uint32_t getCoalescedCount(void) const { return __atomic_load_n(&m_coalesced, __ATOMIC_RELAXED); }
+
+protected:
+    virtual void lockReplyCache(void) override { pthread_mutex_lock(&m_cacheLock); }
+    virtual void unlockReplyCache(void) override { pthread_mutex_unlock(&m_cacheLock); }
+
+private:
+    struct Connection;
+
+    struct Request {
+        NativeTcpServer *m_server;
+        Connection *m_conn;
+        erpc::Codec *m_codec;
+        Request *m_nextFree;
+        uint32_t m_ticket;
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+        uint32_t m_sequence;
+        uint32_t m_deadline; /*!< erpc_native_now_us() by which the request must start, if m_hasDeadline. */
+        uint32_t m_arrival;  /*!< erpc_native_now_us() when the request was received. */
+        erpc::message_type_t m_msgType;
+        erpc_status_t m_status;
+        bool m_done;
+        bool m_hasDeadline;
+        Request *m_nextFlight; /*!< Next running call in m_flights, or next waiting call of a running one. */
+        Request *m_waiting;    /*!< Identical calls waiting for this one's results. */
+        uint32_t m_hash;
+        uint32_t m_argSize; /*!< Size of m_args; 0 unless the request is in m_flights. */
+        uint8_t m_args[CONFIG_ERPC_TCP_COALESCE_ARGS_MAX]; /*!< Key of a running call of a coalesced method. */
+    };
+
+    struct CoalesceRule {
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+    };
+
+    struct Connection {
+        NativeSocketTransport m_transport;
+        pthread_mutex_t m_lock;
+        Request *m_window[CONFIG_ERPC_TCP_INFLIGHT]; /*!< In-flight requests by ticket. */
+        uint32_t m_nextTicket;
+        uint32_t m_nextReply;
+        unsigned m_inflight;
+        unsigned m_home;  /*!< Home worker of the connection's requests. */
+        bool m_open;      /*!< Socket is polled for requests. */
+        bool m_flushing;  /*!< A worker is sending this connection's replies. */
+    };
+
+    static void runRequest(void *arg);
+    void acceptConnection(void);
+    erpc_status_t receiveRequests(Connection &conn);
+    erpc_status_t receiveRequest(Connection &conn);
+    bool admit(void);
+    void trackQueueDelay(uint32_t delay, uint32_t now);
+    void rejectRequest(Request &req);
+    bool execute(Request &req);
+    bool joinFlight(Request &req);
+    void finishFlight(Request &req);
+    bool isCoalesced(uint32_t serviceId, uint32_t methodId) const;
+    void complete(Request &req);
+    void flushReplies(Connection &conn);
+    void closeConnection(Connection &conn);
+    void releaseSocket(Connection &conn);
+    Request *takeRequest(void);
+    void releaseRequest(Request *req);
+
+    NativeStealExecutor m_executor;
+    erpc::Crc16 m_crc;
+    int m_listenFd;
+    int m_wakeFd[2]; /*!< stop() writes to [1] to interrupt poll(). */
+    Connection m_connections[CONFIG_ERPC_TCP_CONNECTIONS];
+    Request m_requests[CONFIG_ERPC_TCP_INFLIGHT];
+    Request *m_freeRequests;
+    pthread_mutex_t m_requestLock;
+    pthread_cond_t m_requestFree;
+    unsigned m_admitted;      /*!< Admitted requests, queued or running. */
+    uint32_t m_rejected;
+    pthread_mutex_t m_codelLock;
+    pthread_mutex_t m_cacheLock;
+    pthread_mutex_t m_flightLock;
+    Request *m_flights; /*!< Running calls of coalesced methods. */
+    CoalesceRule m_coalesceRules[CONFIG_ERPC_TCP_COALESCE_METHODS];
+    uint8_t m_coalesceRuleCount;
+    uint32_t m_coalesced;
+    uint32_t m_aboveTargetEnd; /*!< When shedding starts if the delay stays above target, if m_aboveTarget. */
+    bool m_aboveTarget;
+    bool m_shedding;
+};
+
+#endif /* _NATIVE_TCP_SERVER_HPP_ */
@@ -0,0 +1,134 @@
+#ifndef _REPLY_CACHE_HPP_
+#define _REPLY_CACHE_HPP_
+
+#include <stdint.h>
+
+/*!
+ * @brief Replies a ReplyCache holds.
+ */
+#ifndef CONFIG_ERPC_CACHE_ENTRIES
+#define CONFIG_ERPC_CACHE_ENTRIES 16
+#endif
+
+/*!
+ * @brief Largest key a ReplyCache holds, in bytes; calls with larger keys bypass the cache.
+ *
+ * DenseServer keys on one byte for the codec plus the encoded arguments.
+ */
+#ifndef CONFIG_ERPC_CACHE_ARGS_MAX
+#define CONFIG_ERPC_CACHE_ARGS_MAX 32
+#endif
+
+/*!
+ * @brief Largest encoded result a ReplyCache keeps, in bytes; larger replies are not cached.
+ */
+#ifndef CONFIG_ERPC_CACHE_REPLY_MAX
+#define CONFIG_ERPC_CACHE_REPLY_MAX 32
+#endif
+
+/*!
+ * @brief Methods that can be marked cacheable in one ReplyCache.
+ */
+#ifndef CONFIG_ERPC_CACHE_METHODS
+#define CONFIG_ERPC_CACHE_METHODS 8
+#endif
+
+/*!
+ * @brief Fixed-size cache of encoded replies of pure methods.
+ *
+ * An entry is keyed by service id, method id and the encoded argument bytes
+ * of the request, and holds the encoded results of the reply. Only methods
+ * marked with addMethod() are cached: their results must depend on the
+ * arguments alone. Eviction is CLOCK (second chance): a hit marks an entry,
+ * the clock hand clears marks and replaces the first unmarked entry.
+ *
+ * Memory is CONFIG_ERPC_CACHE_ENTRIES * (CONFIG_ERPC_CACHE_ARGS_MAX +
+ * CONFIG_ERPC_CACHE_REPLY_MAX + 16) bytes. The cache does not lock; the
+ * server using it does (see DenseServer::setReplyCache()).
+ */
+class ReplyCache {
+public:
+    static const uint32_t kAnyMethod = 0xFFFFFFFFU; /*!< addMethod(): every method of the service. */
+
+    ReplyCache(void);
+
+    /*!
+     * @brief Cache replies of @p methodId of service @p serviceId (or all its methods with kAnyMethod).
+     *
+     * @retval true Marked.
+     * @retval false CONFIG_ERPC_CACHE_METHODS reached.
+     */
+    bool addMethod(uint32_t serviceId, uint32_t methodId);
+
+    /*!
+     * @brief Return true if calls of @p methodId of service @p serviceId are cached.
+     */
+    bool isCacheable(uint32_t serviceId, uint32_t methodId) const;
+
+    /*!
+     * @brief Look up the reply to a call and copy its encoded results to @p reply.
+     *
+     * @param[in] serviceId Service id.
+     * @param[in] methodId Method id.
+     * @param[in] args Encoded arguments.
+     * @param[in] argSize Size of @p args.
+     * @param[out] reply Receives the encoded results, at least CONFIG_ERPC_CACHE_REPLY_MAX bytes.
+     * @param[out] replySize Size of the results.
+     *
+     * @retval true Hit.
+     * @retval false Miss.
+     */
+    bool lookup(uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize, uint8_t *reply,
+                uint32_t &replySize);
+
+    /*!
+     * @brief Remember the encoded results @p reply of a call, evicting an entry if needed.
+     *
+     * Calls with more than CONFIG_ERPC_CACHE_ARGS_MAX argument bytes or more
+     * than CONFIG_ERPC_CACHE_REPLY_MAX result bytes are not stored.
+     */
+    void store(uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize, const uint8_t *reply,
+               uint32_t replySize);
+
+    /*!
+     * @brief Drop all entries, e.g. after the data behind a cached method changed. Statistics are kept.
+     */
+    void clear(void);
+
+    uint32_t getHits(void) const { return m_hits; }
+    uint32_t getMisses(void) const { return m_misses; }
+
+    /*!
+     * @brief FNV-1a hash of a key, as the cache uses it.
+     */
+    static uint32_t hash(uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize);
+
+private:
+    struct Entry {
+        uint32_t m_hash;
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+        uint8_t m_argSize;
+        uint8_t m_replySize;
+        bool m_used;
+        bool m_referenced; /*!< Hit since the clock hand last passed. */
+        uint8_t m_args[CONFIG_ERPC_CACHE_ARGS_MAX];
+        uint8_t m_reply[CONFIG_ERPC_CACHE_REPLY_MAX];
+    };
+
+    struct Method {
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+    };
+
+    Entry *find(uint32_t hash, uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize);
+
+    Entry m_entries[CONFIG_ERPC_CACHE_ENTRIES];
+    Method m_methods[CONFIG_ERPC_CACHE_METHODS];
+    uint8_t m_methodCount;
+    uint16_t m_hand;
+    uint32_t m_hits;
+    uint32_t m_misses;
+};
+
+#endif /* _REPLY_CACHE_HPP_ */
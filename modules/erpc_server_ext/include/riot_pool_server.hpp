@@ -0,0 +1,323 @@
+#ifndef _RIOT_POOL_SERVER_HPP_
+#define _RIOT_POOL_SERVER_HPP_
+
+#include "dense_server.hpp"
+#include "erpc_config_internal.h"
+#include "riot_rx_events.hpp"
+
+extern "C" {
+#include "cond.h"
+#include "mutex.h"
+#include "thread.h"
+#include "thread_flags.h"
+}
+
+/*!
+ * @brief Number of worker threads of the default lane (lane 0), started by RiotPoolServer::start().
+ */
+#ifndef CONFIG_ERPC_POOL_WORKERS
+#define CONFIG_ERPC_POOL_WORKERS 2
+#endif
+
+/*!
+ * @brief Priority lanes of a RiotPoolServer, see RiotPoolServer::setPriorityClass(); 1 for none.
+ */
+#ifndef CONFIG_ERPC_POOL_LANES
+#define CONFIG_ERPC_POOL_LANES 1
+#endif
+
+/*!
+ * @brief Worker threads of each lane above 0.
+ */
+#ifndef CONFIG_ERPC_POOL_LANE_WORKERS
+#define CONFIG_ERPC_POOL_LANE_WORKERS 1
+#endif
+
+/*!
+ * @brief Entries of the table mapping services and methods to lanes.
+ */
+#ifndef CONFIG_ERPC_POOL_LANE_RULES
+#define CONFIG_ERPC_POOL_LANE_RULES 8
+#endif
+
+/*!
+ * @brief Requests a RiotPoolServer holds at once: queued, running or waiting for their reply turn.
+ *
+ * When all slots are taken the receive thread stops reading from the
+ * transport until a reply has been sent.
+ */
+#ifndef CONFIG_ERPC_POOL_QUEUE
+#define CONFIG_ERPC_POOL_QUEUE 4
+#endif
+
+/*!
+ * @brief Stack size of each worker thread. Service handlers run on it.
+ */
+#ifndef CONFIG_ERPC_POOL_STACKSIZE
+#define CONFIG_ERPC_POOL_STACKSIZE (THREAD_STACKSIZE_MAIN + 1024)
+#endif
+
+/*!
+ * @brief Transports one RiotPoolServer can serve, including its own.
+ */
+#ifndef CONFIG_ERPC_POOL_TRANSPORTS
+#define CONFIG_ERPC_POOL_TRANSPORTS 4
+#endif
+
+/*!
+ * @brief Interval, in microseconds, at which a failed RiotPoolServer::start() checks whether its workers ended.
+ */
+#ifndef CONFIG_ERPC_POOL_JOIN_POLL_US
+#define CONFIG_ERPC_POOL_JOIN_POLL_US 1000
+#endif
+
+/*!
+ * @brief Thread flag of the run() thread that the transports' RiotRxEvents set on new input.
+ *
+ * Only used with more than one transport. Pick a bit the thread calling
+ * run() does not wait on otherwise.
+ */
+#ifndef CONFIG_ERPC_POOL_RX_FLAG
+#define CONFIG_ERPC_POOL_RX_FLAG (1U << 8)
+#endif
+
+#if (CONFIG_ERPC_POOL_QUEUE < CONFIG_ERPC_POOL_WORKERS) || (CONFIG_ERPC_POOL_QUEUE > 255)
+#error "CONFIG_ERPC_POOL_QUEUE must be between CONFIG_ERPC_POOL_WORKERS and 255"
+#endif
+
+#if (CONFIG_ERPC_POOL_LANES < 1) || (CONFIG_ERPC_POOL_LANES > 8)
+#error "CONFIG_ERPC_POOL_LANES must be between 1 and 8"
+#endif
+
+#if ERPC_THREADS_IS(NONE)
+#error "RiotPoolServer sends on its workers while run() receives: build eRPC with threads (erpc_threading_riot)"
+#endif
+
+/*!
+ * @brief Worker threads of a RiotPoolServer over all lanes.
+ */
+#define ERPC_POOL_THREADS (CONFIG_ERPC_POOL_WORKERS + (CONFIG_ERPC_POOL_LANES - 1) * CONFIG_ERPC_POOL_LANE_WORKERS)
+
+/*!
+ * @brief Server that receives on the run() thread and executes requests on a pool of RIOT threads.
+ *
+ * A slow handler only occupies its worker; other requests keep being
+ * received and executed. Replies still leave in the order the requests of
+ * their connection arrived, so a peer that pipelines requests sees the same
+ * reply order as with erpc::SimpleServer. Requests received on one transport
+ * form one connection.
+ *
+ * Further transports can be attached with addTransport(); all of them share
+ * the registered services. Each transport then also needs its RiotRxEvents
+ * (every RiotFramedTransport has them): run() sleeps on
+ * CONFIG_ERPC_POOL_RX_FLAG until a transport reports input, and only
+ * receives from a transport once erpc::Transport::hasMessage() reports a
+ * whole message. A peer that stalls in the middle of a frame therefore
+ * holds up nobody else. Replies go out on the transport the request came
+ * from.
+ *
+ * A request whose deadline runs out while it waits for a worker is dropped
+ * without a reply; the client has given up on it already.
+ *
+ * With CONFIG_ERPC_POOL_LANES > 1, setPriorityClass() moves services or
+ * single methods into higher lanes. Every lane has its own queue and its own
+ * workers, one RIOT priority level above the lane below, so a control call
+ * preempts bulk handlers instead of queueing behind them. Replies keep
+ * arrival order within a lane; a reply of a higher lane overtakes waiting
+ * replies of lower lanes. A request is only classified once it has been
+ * received, so CONFIG_ERPC_POOL_QUEUE should leave room beyond the lane 0
+ * workers, or a full pool delays receiving the next urgent request until a
+ * slot frees.
+ *
+ * Service handlers run concurrently and must be reentrant. The transport is
+ * used from two threads at once (receive on run(), send on a worker). The
+ * pool serialises its replies, but a RiotFramedTransport also sends from
+ * receive() (credits, flow control polls, CRC negotiation), and only a
+ * threaded eRPC build locks those against the replies. ERPC_THREADS_NONE is
+ * therefore rejected at compile time.
+ *
+ * The object holds the worker stacks; give it static storage.
+ */
+class RiotPoolServer : public DenseServer {
+public:
+    static const uint32_t kAnyMethod = 0xFFFFFFFFU; /*!< setPriorityClass(): every method of the service. */
+
+    RiotPoolServer(void);
+    virtual ~RiotPoolServer(void);
+
+    /*!
+     * @brief Start the worker threads: lane 0 at @p priority, lane n at @p priority - n.
+     *
+     * Call this once, after setTransport() and before run().
+     *
+     * @retval kErpcStatus_Success Workers running.
+     * @retval kErpcStatus_InvalidArgument Already started, or @p priority too high for the lanes.
+     * @retval kErpcStatus_MemoryError A thread could not be created. The
+     *         workers started before it have ended, so the server may be
+     *         destroyed.
+     */
+    erpc_status_t start(uint8_t priority);
+
+    /*!
+     * @brief Execute requests for @p methodId of service @p serviceId in @p lane.
+     *
+     * A rule for a single method wins over one for kAnyMethod; requests no
+     * rule matches run in lane 0. Call this before run().
+     *
+     * @param[in] serviceId Service id.
+     * @param[in] methodId Method id, or kAnyMethod.
+     * @param[in] lane Lane, 0 .. CONFIG_ERPC_POOL_LANES - 1; higher is more urgent.
+     *
+     * @retval kErpcStatus_Success Rule set (an existing one for the same method is replaced).
+     * @retval kErpcStatus_InvalidArgument No such lane.
+     * @retval kErpcStatus_MemoryError CONFIG_ERPC_POOL_LANE_RULES reached.
+     */
+    erpc_status_t setPriorityClass(uint32_t serviceId, uint32_t methodId, uint8_t lane);
+
+    /*!
+     * @brief Serve requests arriving on @p transport as well; @p rxEvents report its input.
+     *
+     * Call this before run(). A transport without an erpc::Crc16 gets the one
+     * of the server's own transport, whose events must be given to
+     * setRxEvents().
+     *
+     * @retval kErpcStatus_Success Transport attached.
+     * @retval kErpcStatus_InvalidArgument NULL argument or already attached @p transport.
+     * @retval kErpcStatus_MemoryError CONFIG_ERPC_POOL_TRANSPORTS reached.
+     */
+    erpc_status_t addTransport(erpc::Transport *transport, RiotRxEvents *rxEvents);
+
+    /*!
+     * @brief addTransport() for a transport that reports its own input, like a RiotFramedTransport.
+     */
+    template <class T>
+    erpc_status_t addTransport(T *transport)
+    {
+        return addTransport(transport, transport);
+    }
+
+    /*!
+     * @brief Input events of the server's own transport, needed once addTransport() was used.
+     */
+    void setRxEvents(RiotRxEvents *rxEvents) { m_connections[0].m_rxEvents = rxEvents; }
+
+    /*!
+     * @brief Receive requests and hand them to the workers until stop() or an error.
+     *
+     * erpc_server_poll() bypasses the pool and must not be mixed with run().
+     *
+     * @retval kErpcStatus_InitFailed Several transports, but one of them lacks its RiotRxEvents.
+     * @return First receive, decode or handler error on any transport.
+     */
+    virtual erpc_status_t run(void) override;
+
+    /*!
+     * @brief Stop run() after the current receive and let the workers exit once idle.
+     */
+    virtual void stop(void) override;
+
+protected:
+    /*!
+     * @brief Reply ordering state of one transport.
+     */
+    struct Connection {
+        erpc::Transport *m_transport;
+        RiotRxEvents *m_rxEvents; /*!< Input events; only needed with several transports. */
+        uint32_t m_nextTicket[CONFIG_ERPC_POOL_LANES]; /*!< Ticket of the next request received, per lane. */
+        uint32_t m_nextReply[CONFIG_ERPC_POOL_LANES];  /*!< Ticket whose reply goes out next, per lane. */
+        bool m_flushing; /*!< A worker is sending replies of this connection. */
+    };
+
+    /*!
+     * @brief Wait for a free slot, then receive one request from @p conn and queue it.
+     *
+     * @retval kErpcStatus_Success Request queued, or a bad or expired message dropped.
+     * @retval kErpcStatus_ServerIsDown stop() was called.
+     * @return Otherwise the transport or memory error.
+     */
+    erpc_status_t receiveRequest(Connection &conn);
+
+    /*!
+     * @brief Receive one request from every transport that has a message; wait for input if none had.
+     */
+    erpc_status_t pollConnections(void);
+
+    /*!
+     * @brief Prepare @p conn to carry requests received from @p transport.
+     */
+    static void initConnection(Connection &conn, erpc::Transport *transport, RiotRxEvents *rxEvents);
+
+    virtual void lockReplyCache(void) override { mutex_lock(&m_cacheLock); }
+    virtual void unlockReplyCache(void) override { mutex_unlock(&m_cacheLock); }
+
+    Connection m_connections[CONFIG_ERPC_POOL_TRANSPORTS]; /*!< [0] is the server's own transport. */
+    uint8_t m_connectionCount;
+
+private:
+    enum {
+        kSlotFree = 0,
+        kSlotReceiving,
+        kSlotQueued,
+        kSlotDone,
+    };
+
+    struct Slot {
+        erpc::Codec *m_codec;
+        Connection *m_conn;
+        uint32_t m_ticket;   /*!< Arrival order within the connection and lane. */
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+        uint32_t m_sequence;
+        uint32_t m_deadline; /*!< xtimer_now_usec() by which the request must start, if m_hasDeadline. */
+        erpc::message_type_t m_msgType;
+        erpc_status_t m_status;
+        uint8_t m_state;
+        uint8_t m_lane;
+        bool m_hasDeadline;
+    };
+
+    struct LaneRule {
+        uint32_t m_serviceId;
+        uint32_t m_methodId;
+        uint8_t m_lane;
+    };
+
+    struct Lane {
+        cond_t m_work; /*!< Signalled when m_queue gains an entry or the server stops. */
+        uint8_t m_queue[CONFIG_ERPC_POOL_QUEUE]; /*!< Slot indices in arrival order. */
+        uint8_t m_queueHead;
+        uint8_t m_queueCount;
+    };
+
+    struct Worker {
+        RiotPoolServer *m_server;
+        uint8_t m_lane;
+        kernel_pid_t m_pid;
+        thread_t *m_thread; /*!< As created; thread_get(m_pid) differs once it has ended. */
+    };
+
+    static void *workerEntry(void *arg);
+    static void rxEntry(void *arg);
+    void workerLoop(Lane &lane);
+    void stopWorkers(unsigned count);
+    void execute(Slot &slot);
+    void flushReplies(Connection &conn);
+    Slot *findSlot(Connection &conn, uint8_t lane, uint32_t ticket);
+    int takeFreeSlot(void);
+    uint8_t classify(uint32_t serviceId, uint32_t methodId);
+
+    mutex_t m_lock;
+    mutex_t m_cacheLock;
+    cond_t m_space; /*!< Signalled when a slot is freed. */
+    Slot m_slots[CONFIG_ERPC_POOL_QUEUE];
+    Lane m_lanes[CONFIG_ERPC_POOL_LANES];
+    LaneRule m_rules[CONFIG_ERPC_POOL_LANE_RULES];
+    uint8_t m_ruleCount;
+    erpc_status_t m_workerError; /*!< First handler or send error, reported by run(); expiry is none. */
+    bool m_started;
+    thread_t *volatile m_runThread; /*!< Thread in run() waiting on several transports, or NULL. */
+    Worker m_workers[ERPC_POOL_THREADS];
+    char m_stacks[ERPC_POOL_THREADS][CONFIG_ERPC_POOL_STACKSIZE];
+};
+
+#endif /* _RIOT_POOL_SERVER_HPP_ */
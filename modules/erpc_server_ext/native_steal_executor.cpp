@@ -0,0 +1,197 @@
+// native_steal_executor.cpp — work-stealing pthread pool for native builds
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "native_steal_executor.hpp"
+
+#include <sched.h>
+#include <unistd.h>
+
+NativeStealExecutor::NativeStealExecutor(void)
+: m_workerCount(0)
+, m_pending(0)
+, m_running(false)
+{
+    pthread_mutex_init(&m_idleLock, NULL);
+    pthread_cond_init(&m_idle, NULL);
+    for (unsigned i = 0; i < CONFIG_ERPC_STEAL_MAX_WORKERS; ++i) {
+        Worker &w = m_workers[i];
+        pthread_mutex_init(&w.m_lock, NULL);
+        w.m_owner = this;
+        w.m_index = i;
+        w.m_head = 0;
+        w.m_count = 0;
+    }
+}
+
+NativeStealExecutor::~NativeStealExecutor(void)
+{
+    stop();
+    for (unsigned i = 0; i < CONFIG_ERPC_STEAL_MAX_WORKERS; ++i) {
+        pthread_mutex_destroy(&m_workers[i].m_lock);
+    }
+    pthread_cond_destroy(&m_idle);
+    pthread_mutex_destroy(&m_idleLock);
+}
+
+erpc_status_t NativeStealExecutor::start(unsigned workers, bool pin)
+{
+    if (m_running) {
+        return kErpcStatus_InvalidArgument;
+    }
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) {
+        cores = 1;
+    }
+    if (workers == 0) {
+        workers = static_cast<unsigned>(cores);
+    }
+    if (workers > CONFIG_ERPC_STEAL_MAX_WORKERS) {
+        workers = CONFIG_ERPC_STEAL_MAX_WORKERS;
+    }
+
+    m_running = true;
+    for (m_workerCount = 0; m_workerCount < workers; ++m_workerCount) {
+        Worker &w = m_workers[m_workerCount];
+        if (pthread_create(&w.m_thread, NULL, workerEntry, &w) != 0) {
+            stop();
+            return kErpcStatus_MemoryError;
+        }
+        if (pin) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(m_workerCount % static_cast<unsigned>(cores), &set);
+            // Best effort: a restricted cpuset leaves the worker unpinned.
+            (void)pthread_setaffinity_np(w.m_thread, sizeof(set), &set);
+        }
+    }
+    return kErpcStatus_Success;
+}
+
+void NativeStealExecutor::stop(void)
+{
+    pthread_mutex_lock(&m_idleLock);
+    bool wasRunning = m_running;
+    m_running = false;
+    pthread_cond_broadcast(&m_idle);
+    pthread_mutex_unlock(&m_idleLock);
+
+    if (wasRunning) {
+        for (unsigned i = 0; i < m_workerCount; ++i) {
+            pthread_join(m_workers[i].m_thread, NULL);
+        }
+        m_workerCount = 0;
+    }
+}
+
+erpc_status_t NativeStealExecutor::submit(unsigned home, task_fn_t fn, void *arg)
+{
+    if (!m_running || (m_workerCount == 0)) {
+        return kErpcStatus_MemoryError;
+    }
+
+    Task task = { fn, arg };
+    unsigned first = home % m_workerCount;
+    unsigned i = 0;
+    // Count first, so a worker never takes a task m_pending does not include.
+    __atomic_add_fetch(&m_pending, 1U, __ATOMIC_SEQ_CST);
+    while ((i < m_workerCount) && !push(m_workers[(first + i) % m_workerCount], task)) {
+        ++i;
+    }
+    if (i == m_workerCount) {
+        __atomic_sub_fetch(&m_pending, 1U, __ATOMIC_SEQ_CST);
+        return kErpcStatus_MemoryError;
+    }
+
+    pthread_mutex_lock(&m_idleLock);
+    pthread_cond_signal(&m_idle);
+    pthread_mutex_unlock(&m_idleLock);
+    return kErpcStatus_Success;
+}
+
+bool NativeStealExecutor::push(Worker &w, const Task &task)
+{
+    bool ok = false;
+    pthread_mutex_lock(&w.m_lock);
+    if (w.m_count < CONFIG_ERPC_STEAL_DEQUE) {
+        w.m_tasks[(w.m_head + w.m_count) % CONFIG_ERPC_STEAL_DEQUE] = task;
+        ++w.m_count;
+        ok = true;
+    }
+    pthread_mutex_unlock(&w.m_lock);
+    return ok;
+}
+
+bool NativeStealExecutor::popOldest(Worker &w, Task &task)
+{
+    bool ok = false;
+    pthread_mutex_lock(&w.m_lock);
+    if (w.m_count > 0) {
+        task = w.m_tasks[w.m_head];
+        w.m_head = (w.m_head + 1) % CONFIG_ERPC_STEAL_DEQUE;
+        --w.m_count;
+        ok = true;
+    }
+    pthread_mutex_unlock(&w.m_lock);
+    return ok;
+}
+
+bool NativeStealExecutor::popNewest(Worker &w, Task &task)
+{
+    bool ok = false;
+    // Unlocked peek so idle thieves do not contend on empty deques.
+    if (__atomic_load_n(&w.m_count, __ATOMIC_RELAXED) == 0) {
+        return false;
+    }
+    pthread_mutex_lock(&w.m_lock);
+    if (w.m_count > 0) {
+        --w.m_count;
+        task = w.m_tasks[(w.m_head + w.m_count) % CONFIG_ERPC_STEAL_DEQUE];
+        ok = true;
+    }
+    pthread_mutex_unlock(&w.m_lock);
+    return ok;
+}
+
+bool NativeStealExecutor::take(Worker &self, Task &task)
+{
+    if (popOldest(self, task)) {
+        return true;
+    }
+    for (unsigned i = 1; i < m_workerCount; ++i) {
+        if (popNewest(m_workers[(self.m_index + i) % m_workerCount], task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void *NativeStealExecutor::workerEntry(void *arg)
+{
+    Worker *w = static_cast<Worker *>(arg);
+    w->m_owner->workerLoop(*w);
+    return NULL;
+}
+
+void NativeStealExecutor::workerLoop(Worker &self)
+{
+    Task task;
+    for (;;) {
+        if (take(self, task)) {
+            __atomic_sub_fetch(&m_pending, 1U, __ATOMIC_SEQ_CST);
+            task.m_fn(task.m_arg);
+            continue;
+        }
+
+        pthread_mutex_lock(&m_idleLock);
+        while ((__atomic_load_n(&m_pending, __ATOMIC_SEQ_CST) == 0) && m_running) {
+            pthread_cond_wait(&m_idle, &m_idleLock);
+        }
+        bool done = !m_running && (__atomic_load_n(&m_pending, __ATOMIC_SEQ_CST) == 0);
+        pthread_mutex_unlock(&m_idleLock);
+        if (done) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,595 @@
+// native_tcp_server.cpp — multi-connection TCP server on a work-stealing executor (native only)
+#include "native_tcp_server.hpp"
+#include "erpc_basic_codec.hpp"
+#include "erpc_manually_constructed.hpp"
+#include "erpc_server_ext_setup.h"
+#include "erpc_status_reply.hpp"
+#include "native_clock.h"
+
+#include <errno.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace erpc;
+
+////////////////////////////////////////////////////////////////////////////////
+// NativeTcpServer
+////////////////////////////////////////////////////////////////////////////////
+
+const uint32_t NativeTcpServer::kAnyMethod;
+
+NativeTcpServer::NativeTcpServer(void)
+: DenseServer()
+, m_listenFd(-1)
+, m_freeRequests(NULL)
+, m_admitted(0)
+, m_rejected(0)
+, m_flights(NULL)
+, m_coalesceRuleCount(0)
+, m_coalesced(0)
+, m_aboveTargetEnd(0)
+, m_aboveTarget(false)
+, m_shedding(false)
+{
+    m_wakeFd[0] = -1;
+    m_wakeFd[1] = -1;
+    pthread_mutex_init(&m_requestLock, NULL);
+    pthread_cond_init(&m_requestFree, NULL);
+    pthread_mutex_init(&m_codelLock, NULL);
+    pthread_mutex_init(&m_cacheLock, NULL);
+    pthread_mutex_init(&m_flightLock, NULL);
+
+    for (unsigned i = 0; i < CONFIG_ERPC_TCP_CONNECTIONS; ++i) {
+        Connection &conn = m_connections[i];
+        conn.m_transport.setCrc16(&m_crc);
+        pthread_mutex_init(&conn.m_lock, NULL);
+        conn.m_inflight = 0;
+        conn.m_home = i;
+        conn.m_open = false;
+        conn.m_flushing = false;
+        for (unsigned j = 0; j < CONFIG_ERPC_TCP_INFLIGHT; ++j) {
+            conn.m_window[j] = NULL;
+        }
+    }
+    for (unsigned i = 0; i < CONFIG_ERPC_TCP_INFLIGHT; ++i) {
+        m_requests[i].m_server = this;
+        releaseRequest(&m_requests[i]);
+    }
+}
+
+NativeTcpServer::~NativeTcpServer(void)
+{
+    m_executor.stop();
+    for (unsigned i = 0; i < CONFIG_ERPC_TCP_CONNECTIONS; ++i) {
+        if (m_connections[i].m_transport.getSocket() >= 0) {
+            ::close(m_connections[i].m_transport.getSocket());
+        }
+        pthread_mutex_destroy(&m_connections[i].m_lock);
+    }
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        ::close(m_wakeFd[0]);
+        ::close(m_wakeFd[1]);
+    }
+    pthread_mutex_destroy(&m_flightLock);
+    pthread_mutex_destroy(&m_cacheLock);
+    pthread_mutex_destroy(&m_codelLock);
+    pthread_cond_destroy(&m_requestFree);
+    pthread_mutex_destroy(&m_requestLock);
+}
+
+erpc_status_t NativeTcpServer::open(uint16_t port)
+{
+    if (m_listenFd >= 0) {
+        return kErpcStatus_InitFailed;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return kErpcStatus_InitFailed;
+    }
+    int yes = 1;
+    (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if ((::bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) ||
+        (::listen(fd, CONFIG_ERPC_TCP_CONNECTIONS) != 0) || (::pipe(m_wakeFd) != 0)) {
+        ::close(fd);
+        return kErpcStatus_InitFailed;
+    }
+    m_listenFd = fd;
+    return kErpcStatus_Success;
+}
+
+erpc_status_t NativeTcpServer::run(void)
+{
+    if ((m_listenFd < 0) || (m_executor.getWorkerCount() == 0)) {
+        return kErpcStatus_InitFailed;
+    }
+
+    // The C API registers services through the erpc::Server methods; workers are idle until we submit.
+    rebuildServiceTable();
+
+    struct pollfd fds[CONFIG_ERPC_TCP_CONNECTIONS + 2];
+    Connection *polled[CONFIG_ERPC_TCP_CONNECTIONS];
+
+    while (m_isServerOn) {
+        fds[0].fd = m_wakeFd[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = m_listenFd;
+        fds[1].events = POLLIN;
+        nfds_t n = 2;
+        for (unsigned i = 0; i < CONFIG_ERPC_TCP_CONNECTIONS; ++i) {
+            Connection &conn = m_connections[i];
+            if (conn.m_open) {
+                polled[n - 2] = &conn;
+                fds[n].fd = conn.m_transport.getSocket();
+                fds[n].events = POLLIN;
+                ++n;
+            }
+        }
+
+        if (::poll(fds, n, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return kErpcStatus_Fail;
+        }
+        if (fds[0].revents != 0) {
+            char drain[16];
+            (void)::read(m_wakeFd[0], drain, sizeof(drain));
+            continue;
+        }
+        if (fds[1].revents != 0) {
+            acceptConnection();
+        }
+        for (nfds_t i = 2; i < n; ++i) {
+            if ((fds[i].revents != 0) && (receiveRequests(*polled[i - 2]) != kErpcStatus_Success)) {
+                closeConnection(*polled[i - 2]);
+            }
+        }
+    }
+    return kErpcStatus_Success;
+}
+
+erpc_status_t NativeTcpServer::coalesceMethod(uint32_t serviceId, uint32_t methodId)
+{
+    if (isCoalesced(serviceId, methodId)) {
+        return kErpcStatus_Success;
+    }
+    if (m_coalesceRuleCount == CONFIG_ERPC_TCP_COALESCE_METHODS) {
+        return kErpcStatus_MemoryError;
+    }
+    m_coalesceRules[m_coalesceRuleCount].m_serviceId = serviceId;
+    m_coalesceRules[m_coalesceRuleCount].m_methodId = methodId;
+    ++m_coalesceRuleCount;
+    return kErpcStatus_Success;
+}
+
+bool NativeTcpServer::isCoalesced(uint32_t serviceId, uint32_t methodId) const
+{
+    for (unsigned i = 0; i < m_coalesceRuleCount; ++i) {
+        const CoalesceRule &rule = m_coalesceRules[i];
+        if ((rule.m_serviceId == serviceId) && ((rule.m_methodId == methodId) || (rule.m_methodId == kAnyMethod))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void NativeTcpServer::stop(void)
+{
+    m_isServerOn = false;
+    if (m_wakeFd[1] >= 0) {
+        char c = 0;
+        (void)::write(m_wakeFd[1], &c, 1);
+    }
+}
+
+void NativeTcpServer::acceptConnection(void)
+{
+    int fd = ::accept(m_listenFd, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+
+    Connection *conn = NULL;
+    for (unsigned i = 0; (i < CONFIG_ERPC_TCP_CONNECTIONS) && (conn == NULL); ++i) {
+        Connection &c = m_connections[i];
+        pthread_mutex_lock(&c.m_lock);
+        if (!c.m_open && (c.m_transport.getSocket() < 0)) {
+            conn = &c;
+        } else {
+            pthread_mutex_unlock(&c.m_lock);
+        }
+    }
+    if (conn == NULL) {
+        ::close(fd);
+        return;
+    }
+
+    int yes = 1;
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    conn->m_transport.setSocket(fd);
+    conn->m_nextTicket = 0;
+    conn->m_nextReply = 0;
+    conn->m_open = true;
+    pthread_mutex_unlock(&conn->m_lock);
+}
+
+void NativeTcpServer::closeConnection(Connection &conn)
+{
+    pthread_mutex_lock(&conn.m_lock);
+    conn.m_open = false;
+    if (conn.m_inflight == 0) {
+        releaseSocket(conn);
+    }
+    pthread_mutex_unlock(&conn.m_lock);
+}
+
+void NativeTcpServer::releaseSocket(Connection &conn)
+{
+    // Called with conn.m_lock held, once the last reply has been sent.
+    ::close(conn.m_transport.getSocket());
+    conn.m_transport.setSocket(-1);
+}
+
+NativeTcpServer::Request *NativeTcpServer::takeRequest(void)
+{
+    pthread_mutex_lock(&m_requestLock);
+    while (m_freeRequests == NULL) {
+        pthread_cond_wait(&m_requestFree, &m_requestLock);
+    }
+    Request *req = m_freeRequests;
+    m_freeRequests = req->m_nextFree;
+    pthread_mutex_unlock(&m_requestLock);
+    return req;
+}
+
+void NativeTcpServer::releaseRequest(Request *req)
+{
+    pthread_mutex_lock(&m_requestLock);
+    req->m_nextFree = m_freeRequests;
+    m_freeRequests = req;
+    pthread_cond_signal(&m_requestFree);
+    pthread_mutex_unlock(&m_requestLock);
+}
+
+erpc_status_t NativeTcpServer::receiveRequests(Connection &conn)
+{
+    // Only whole frames are received, so a stalled peer cannot block this thread.
+    erpc_status_t filled = conn.m_transport.fill();
+    erpc_status_t err = kErpcStatus_Success;
+
+    while ((err == kErpcStatus_Success) && conn.m_transport.hasMessage()) {
+        err = receiveRequest(conn);
+    }
+    return (err != kErpcStatus_Success) ? err : filled;
+}
+
+erpc_status_t NativeTcpServer::receiveRequest(Connection &conn)
+{
+    Request *req = takeRequest();
+    Transport *transport = &conn.m_transport;
+    MessageBuffer buff;
+    Codec *codec = NULL;
+    erpc_status_t err = kErpcStatus_Success;
+
+    // Same steps as SimpleServer::runInternalBegin(), on this connection.
+    if (m_messageFactory->createServerBuffer()) {
+        buff = m_messageFactory->create();
+        if (buff.get() == NULL) {
+            err = kErpcStatus_MemoryError;
+        }
+    }
+    if (err == kErpcStatus_Success) {
+        err = transport->receive(&buff);
+    }
+    if (err == kErpcStatus_Success) {
+        codec = m_codecFactory->create();
+        if (codec == NULL) {
+            err = kErpcStatus_MemoryError;
+        }
+    }
+    if ((err != kErpcStatus_Success) && (buff.get() != NULL)) {
+        m_messageFactory->dispose(&buff);
+    }
+    if (err == kErpcStatus_Success) {
+        codec->setBuffer(buff, transport->reserveHeaderSize());
+        err = readHeadOfMessage(codec, req->m_msgType, req->m_serviceId, req->m_methodId, req->m_sequence);
+        if (err != kErpcStatus_Success) {
+            disposeBufferAndCodec(codec);
+        }
+    }
+    if (err != kErpcStatus_Success) {
+        releaseRequest(req);
+        return err;
+    }
+
+    uint32_t now = erpc_native_now_us();
+    uint32_t budgetUs;
+    req->m_hasDeadline = readDeadline(codec, transport, budgetUs);
+    if (req->m_hasDeadline) {
+        if (budgetUs == 0U) {
+            // Expired on the way; nobody waits for the reply.
+            disposeBufferAndCodec(codec);
+            releaseRequest(req);
+            return kErpcStatus_Success;
+        }
+        req->m_deadline = now + budgetUs;
+    }
+
+    req->m_conn = &conn;
+    req->m_codec = codec;
+    req->m_arrival = now;
+    req->m_status = kErpcStatus_Success;
+    req->m_done = false;
+    bool admitted = admit();
+    if (!admitted) {
+        __atomic_add_fetch(&m_rejected, 1U, __ATOMIC_RELAXED);
+        if (req->m_msgType == message_type_t::kOnewayMessage) {
+            disposeBufferAndCodec(codec);
+            releaseRequest(req);
+            return kErpcStatus_Success;
+        }
+        rejectRequest(*req);
+    }
+
+    pthread_mutex_lock(&conn.m_lock);
+    req->m_ticket = conn.m_nextTicket++;
+    conn.m_window[req->m_ticket % CONFIG_ERPC_TCP_INFLIGHT] = req;
+    ++conn.m_inflight;
+    if (!admitted && !conn.m_flushing && (conn.m_nextReply == req->m_ticket)) {
+        flushReplies(conn);
+    }
+    pthread_mutex_unlock(&conn.m_lock);
+
+    if (admitted) {
+        // Cannot fail: no more than CONFIG_ERPC_TCP_INFLIGHT tasks are ever queued.
+        (void)m_executor.submit(conn.m_home, runRequest, req);
+    }
+    return kErpcStatus_Success;
+}
+
+bool NativeTcpServer::admit(void)
+{
+    unsigned admitted = __atomic_load_n(&m_admitted, __ATOMIC_SEQ_CST);
+    if ((CONFIG_ERPC_TCP_ADMIT != 0) && (admitted >= CONFIG_ERPC_TCP_ADMIT)) {
+        return false;
+    }
+    if (__atomic_load_n(&m_shedding, __ATOMIC_SEQ_CST)) {
+        if (admitted != 0U) {
+            return false;
+        }
+        // Drained: no worker is left to report a short delay.
+        pthread_mutex_lock(&m_codelLock);
+        m_aboveTarget = false;
+        __atomic_store_n(&m_shedding, false, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&m_codelLock);
+    }
+    __atomic_add_fetch(&m_admitted, 1U, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+void NativeTcpServer::trackQueueDelay(uint32_t delay, uint32_t now)
+{
+    if (CONFIG_ERPC_TCP_CODEL_TARGET_US == 0) {
+        return;
+    }
+    pthread_mutex_lock(&m_codelLock);
+    if (delay < CONFIG_ERPC_TCP_CODEL_TARGET_US) {
+        m_aboveTarget = false;
+        __atomic_store_n(&m_shedding, false, __ATOMIC_SEQ_CST);
+    } else if (!m_aboveTarget) {
+        m_aboveTarget = true;
+        m_aboveTargetEnd = now + CONFIG_ERPC_TCP_CODEL_INTERVAL_US;
+    } else if (static_cast<int32_t>(now - m_aboveTargetEnd) >= 0) {
+        __atomic_store_n(&m_shedding, true, __ATOMIC_SEQ_CST);
+    }
+    pthread_mutex_unlock(&m_codelLock);
+}
+
+void NativeTcpServer::rejectRequest(Request &req)
+{
+    // No dispatch: the request buffer becomes the reply right here.
+    req.m_status = writeStatusReply(req.m_codec->getBufferRef(), req.m_conn->m_transport.reserveHeaderSize(),
+                                    req.m_serviceId, req.m_methodId, req.m_sequence, kErpcStatus_ServerBusy);
+    req.m_done = true;
+}
+
+void NativeTcpServer::runRequest(void *arg)
+{
+    Request *req = static_cast<Request *>(arg);
+    NativeTcpServer *server = req->m_server;
+    bool finished = server->execute(*req);
+    __atomic_sub_fetch(&server->m_admitted, 1U, __ATOMIC_SEQ_CST);
+    if (finished) {
+        server->complete(*req);
+    }
+}
+
+bool NativeTcpServer::execute(Request &req)
+{
+    uint32_t now = erpc_native_now_us();
+    trackQueueDelay(now - req.m_arrival, now);
+    if (req.m_hasDeadline && (static_cast<int32_t>(now - req.m_deadline) >= 0)) {
+        req.m_status = kErpcStatus_DeadlineExceeded;
+        return true;
+    }
+
+    if (joinFlight(req)) {
+        // The running identical call completes this one.
+        return false;
+    }
+    req.m_status = dispatch(req.m_codec, &req.m_conn->m_transport, req.m_msgType, req.m_serviceId, req.m_methodId,
+                            req.m_sequence);
+    finishFlight(req);
+    return true;
+}
+
+bool NativeTcpServer::joinFlight(Request &req)
+{
+    req.m_waiting = NULL;
+    req.m_argSize = 0;
+    if ((m_coalesceRuleCount == 0) || (req.m_msgType != message_type_t::kInvocationMessage) ||
+        !isCoalesced(req.m_serviceId, req.m_methodId)) {
+        return false;
+    }
+    MessageBuffer &buff = req.m_codec->getBufferRef();
+    uint32_t offset = req.m_conn->m_transport.reserveHeaderSize();
+    uint32_t header = messageHeaderSize(buff, offset);
+    uint32_t argSize = buff.getUsed() - offset - header;
+    if ((header == 0U) || (argSize >= CONFIG_ERPC_TCP_COALESCE_ARGS_MAX)) {
+        return false;
+    }
+
+    // Key as in DenseServer's reply cache: the codec, then the encoded
+    // arguments. The handler overwrites them, so the running call keeps a copy.
+    uint8_t key[CONFIG_ERPC_TCP_COALESCE_ARGS_MAX];
+    key[0] = isCompactMessage(buff, offset) ? 1U : 0U;
+    memcpy(key + 1, buff.get() + offset + header, argSize);
+    ++argSize;
+
+    uint32_t h = ReplyCache::hash(req.m_serviceId, req.m_methodId, key, argSize);
+
+    pthread_mutex_lock(&m_flightLock);
+    Request *leader = m_flights;
+    while ((leader != NULL) &&
+           ((leader->m_hash != h) || (leader->m_serviceId != req.m_serviceId) ||
+            (leader->m_methodId != req.m_methodId) || (leader->m_argSize != argSize) ||
+            (memcmp(leader->m_args, key, argSize) != 0))) {
+        leader = leader->m_nextFlight;
+    }
+    if (leader != NULL) {
+        req.m_nextFlight = leader->m_waiting;
+        leader->m_waiting = &req;
+    } else {
+        req.m_hash = h;
+        req.m_argSize = argSize;
+        memcpy(req.m_args, key, argSize);
+        req.m_nextFlight = m_flights;
+        m_flights = &req;
+    }
+    pthread_mutex_unlock(&m_flightLock);
+    return (leader != NULL);
+}
+
+void NativeTcpServer::finishFlight(Request &req)
+{
+    if (req.m_argSize == 0U) {
+        // Not in m_flights: not coalesced, or the arguments were too large.
+        return;
+    }
+
+    pthread_mutex_lock(&m_flightLock);
+    Request **link = &m_flights;
+    while (*link != &req) {
+        link = &(*link)->m_nextFlight;
+    }
+    *link = req.m_nextFlight;
+    Request *waiting = req.m_waiting;
+    req.m_waiting = NULL;
+    pthread_mutex_unlock(&m_flightLock);
+
+    MessageBuffer &out = req.m_codec->getBufferRef();
+    uint32_t offset = req.m_conn->m_transport.reserveHeaderSize();
+    uint32_t header = messageHeaderSize(out, offset);
+    while (waiting != NULL) {
+        Request *next = waiting->m_nextFlight;
+        if ((req.m_status == kErpcStatus_Success) && (header != 0U)) {
+            // Same encoded results, the waiting call's own header and sequence.
+            waiting->m_status = writeReply(waiting->m_codec->getBufferRef(), offset, waiting->m_serviceId,
+                                           waiting->m_methodId, waiting->m_sequence, out.get() + offset + header,
+                                           out.getUsed() - offset - header);
+        } else {
+            waiting->m_status = (req.m_status != kErpcStatus_Success) ? req.m_status : kErpcStatus_Fail;
+        }
+        __atomic_add_fetch(&m_coalesced, 1U, __ATOMIC_RELAXED);
+        complete(*waiting);
+        waiting = next;
+    }
+}
+
+void NativeTcpServer::complete(Request &req)
+{
+    Connection &conn = *req.m_conn;
+    pthread_mutex_lock(&conn.m_lock);
+    req.m_done = true;
+    if (!conn.m_flushing && (conn.m_nextReply == req.m_ticket)) {
+        flushReplies(conn);
+    }
+    pthread_mutex_unlock(&conn.m_lock);
+}
+
+void NativeTcpServer::flushReplies(Connection &conn)
+{
+    // Called with conn.m_lock held; same scheme as RiotPoolServer::flushReplies().
+    conn.m_flushing = true;
+    for (;;) {
+        Request *req = conn.m_window[conn.m_nextReply % CONFIG_ERPC_TCP_INFLIGHT];
+        if ((req == NULL) || (req->m_ticket != conn.m_nextReply) || !req->m_done) {
+            break;
+        }
+        conn.m_window[conn.m_nextReply % CONFIG_ERPC_TCP_INFLIGHT] = NULL;
+        pthread_mutex_unlock(&conn.m_lock);
+
+        erpc_status_t err = req->m_status;
+        if ((err == kErpcStatus_Success) && (req->m_msgType != message_type_t::kOnewayMessage)) {
+            err = conn.m_transport.send(&req->m_codec->getBufferRef());
+        }
+        if ((err != kErpcStatus_Success) && (err != kErpcStatus_DeadlineExceeded)) {
+            // Like SimpleServer, an error ends the session; poll() reports the shutdown.
+            (void)::shutdown(conn.m_transport.getSocket(), SHUT_RDWR);
+        }
+        disposeBufferAndCodec(req->m_codec);
+        releaseRequest(req);
+
+        pthread_mutex_lock(&conn.m_lock);
+        ++conn.m_nextReply;
+        --conn.m_inflight;
+    }
+    conn.m_flushing = false;
+    if (!conn.m_open && (conn.m_inflight == 0) && (conn.m_transport.getSocket() >= 0)) {
+        releaseSocket(conn);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// External C Interface
+////////////////////////////////////////////////////////////////////////////////
+
+ERPC_MANUALLY_CONSTRUCTED_STATIC(NativeTcpServer, s_tcpServer);
+ERPC_MANUALLY_CONSTRUCTED_STATIC(BasicCodecFactory, s_tcpCodecFactory);
+
+erpc_server_t erpc_server_native_tcp_init(uint16_t port, erpc_mbf_t message_buffer_factory, unsigned workers, bool pin)
+{
+    if ((message_buffer_factory == NULL) || s_tcpServer.isUsed()) {
+        return NULL;
+    }
+
+    s_tcpCodecFactory.construct();
+    s_tcpServer.construct();
+    NativeTcpServer *server = s_tcpServer.get();
+    server->setCodecFactory(s_tcpCodecFactory.get());
+    server->setMessageBufferFactory(reinterpret_cast<MessageBufferFactory *>(message_buffer_factory));
+    if ((server->open(port) != kErpcStatus_Success) || (server->start(workers, pin) != kErpcStatus_Success)) {
+        s_tcpServer.destroy();
+        return NULL;
+    }
+    return reinterpret_cast<erpc_server_t>(server);
+}
+
+erpc_status_t erpc_server_native_tcp_coalesce(erpc_server_t server, uint32_t service_id, uint32_t method_id)
+{
+    if (server == NULL) {
+        return kErpcStatus_InvalidArgument;
+    }
+    return reinterpret_cast<NativeTcpServer *>(server)->coalesceMethod(service_id, method_id);
+}
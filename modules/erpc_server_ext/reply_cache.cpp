@@ -0,0 +1,125 @@
+// reply_cache.cpp — CLOCK-evicted cache of encoded replies for pure methods
+#include "reply_cache.hpp"
+
+#include <string.h>
+
+#if (CONFIG_ERPC_CACHE_ARGS_MAX > 255) || (CONFIG_ERPC_CACHE_REPLY_MAX > 255)
+#error "CONFIG_ERPC_CACHE_ARGS_MAX and CONFIG_ERPC_CACHE_REPLY_MAX must not exceed 255"
+#endif
+
+const uint32_t ReplyCache::kAnyMethod;
+
+ReplyCache::ReplyCache(void)
+: m_methodCount(0)
+, m_hand(0)
+, m_hits(0)
+, m_misses(0)
+{
+    clear();
+}
+
+bool ReplyCache::addMethod(uint32_t serviceId, uint32_t methodId)
+{
+    if (isCacheable(serviceId, methodId)) {
+        return true;
+    }
+    if (m_methodCount == CONFIG_ERPC_CACHE_METHODS) {
+        return false;
+    }
+    m_methods[m_methodCount].m_serviceId = serviceId;
+    m_methods[m_methodCount].m_methodId = methodId;
+    ++m_methodCount;
+    return true;
+}
+
+bool ReplyCache::isCacheable(uint32_t serviceId, uint32_t methodId) const
+{
+    for (unsigned i = 0; i < m_methodCount; ++i) {
+        const Method &m = m_methods[i];
+        if ((m.m_serviceId == serviceId) && ((m.m_methodId == methodId) || (m.m_methodId == kAnyMethod))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ReplyCache::hash(uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize)
+{
+    // FNV-1a
+    uint32_t h = 2166136261U;
+    h = (h ^ serviceId) * 16777619U;
+    h = (h ^ methodId) * 16777619U;
+    for (uint32_t i = 0; i < argSize; ++i) {
+        h = (h ^ args[i]) * 16777619U;
+    }
+    return h;
+}
+
+ReplyCache::Entry *ReplyCache::find(uint32_t h, uint32_t serviceId, uint32_t methodId, const uint8_t *args,
+                                    uint32_t argSize)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_CACHE_ENTRIES; ++i) {
+        Entry &e = m_entries[i];
+        if (e.m_used && (e.m_hash == h) && (e.m_serviceId == serviceId) && (e.m_methodId == methodId) &&
+            (e.m_argSize == argSize) && (memcmp(e.m_args, args, argSize) == 0)) {
+            return &e;
+        }
+    }
+    return NULL;
+}
+
+bool ReplyCache::lookup(uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize,
+                        uint8_t *reply, uint32_t &replySize)
+{
+    Entry *e = NULL;
+    if (argSize <= CONFIG_ERPC_CACHE_ARGS_MAX) {
+        e = find(hash(serviceId, methodId, args, argSize), serviceId, methodId, args, argSize);
+    }
+    if (e == NULL) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    e->m_referenced = true;
+    memcpy(reply, e->m_reply, e->m_replySize);
+    replySize = e->m_replySize;
+    return true;
+}
+
+void ReplyCache::store(uint32_t serviceId, uint32_t methodId, const uint8_t *args, uint32_t argSize,
+                       const uint8_t *reply, uint32_t replySize)
+{
+    if ((argSize > CONFIG_ERPC_CACHE_ARGS_MAX) || (replySize > CONFIG_ERPC_CACHE_REPLY_MAX)) {
+        return;
+    }
+    uint32_t h = hash(serviceId, methodId, args, argSize);
+    // Two workers may have missed on the same call; keep one entry.
+    Entry *e = find(h, serviceId, methodId, args, argSize);
+    while (e == NULL) {
+        Entry &candidate = m_entries[m_hand];
+        m_hand = static_cast<uint16_t>((m_hand + 1) % CONFIG_ERPC_CACHE_ENTRIES);
+        if (candidate.m_used && candidate.m_referenced) {
+            candidate.m_referenced = false;
+        } else {
+            e = &candidate;
+        }
+    }
+
+    e->m_hash = h;
+    e->m_serviceId = serviceId;
+    e->m_methodId = methodId;
+    e->m_argSize = static_cast<uint8_t>(argSize);
+    e->m_replySize = static_cast<uint8_t>(replySize);
+    e->m_used = true;
+    e->m_referenced = false;
+    memcpy(e->m_args, args, argSize);
+    memcpy(e->m_reply, reply, replySize);
+}
+
+void ReplyCache::clear(void)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_CACHE_ENTRIES; ++i) {
+        m_entries[i].m_used = false;
+        m_entries[i].m_referenced = false;
+    }
+}
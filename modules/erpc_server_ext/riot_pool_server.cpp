@@ -0,0 +1,402 @@
+// riot_pool_server.cpp — eRPC server dispatching requests to a pool of RIOT threads
+#include "riot_pool_server.hpp"
+
+extern "C" {
+#include "xtimer.h"
+}
+
+using namespace erpc;
+
+const uint32_t RiotPoolServer::kAnyMethod;
+
+RiotPoolServer::RiotPoolServer(void)
+: DenseServer()
+, m_connectionCount(1)
+, m_ruleCount(0)
+, m_workerError(kErpcStatus_Success)
+, m_started(false)
+, m_runThread(NULL)
+{
+    mutex_init(&m_lock);
+    mutex_init(&m_cacheLock);
+    cond_init(&m_space);
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_LANES; ++i) {
+        cond_init(&m_lanes[i].m_work);
+        m_lanes[i].m_queueHead = 0;
+        m_lanes[i].m_queueCount = 0;
+    }
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_TRANSPORTS; ++i) {
+        initConnection(m_connections[i], NULL, NULL);
+    }
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_QUEUE; ++i) {
+        m_slots[i].m_state = kSlotFree;
+    }
+}
+
+RiotPoolServer::~RiotPoolServer(void) {}
+
+void RiotPoolServer::initConnection(Connection &conn, Transport *transport, RiotRxEvents *rxEvents)
+{
+    conn.m_transport = transport;
+    conn.m_rxEvents = rxEvents;
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_LANES; ++i) {
+        conn.m_nextTicket[i] = 0;
+        conn.m_nextReply[i] = 0;
+    }
+    conn.m_flushing = false;
+}
+
+erpc_status_t RiotPoolServer::start(uint8_t priority)
+{
+    // Lower RIOT priority numbers are more urgent; priority 0 is left to the system.
+    if (m_started || (priority < CONFIG_ERPC_POOL_LANES)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    m_started = true;
+    initConnection(m_connections[0], m_transport, m_connections[0].m_rxEvents);
+
+    for (unsigned i = 0; i < ERPC_POOL_THREADS; ++i) {
+        Worker &w = m_workers[i];
+        w.m_server = this;
+        w.m_lane = (i < CONFIG_ERPC_POOL_WORKERS) ?
+                       0 :
+                       static_cast<uint8_t>(1 + (i - CONFIG_ERPC_POOL_WORKERS) / CONFIG_ERPC_POOL_LANE_WORKERS);
+        kernel_pid_t pid = thread_create(m_stacks[i], sizeof(m_stacks[i]), static_cast<uint8_t>(priority - w.m_lane),
+                                         THREAD_CREATE_STACKTEST, workerEntry, &w, "erpc_worker");
+        if (pid < 0) {
+            // The caller may destroy the server now, stacks included.
+            stopWorkers(i);
+            return kErpcStatus_MemoryError;
+        }
+        w.m_pid = pid;
+        w.m_thread = thread_get(pid);
+    }
+    return kErpcStatus_Success;
+}
+
+void RiotPoolServer::stopWorkers(unsigned count)
+{
+    stop();
+    // RIOT has no join: each worker runs on m_stacks until the scheduler has
+    // removed it. Its thread_t lies on that stack, so a thread reusing the
+    // PID does not match.
+    for (unsigned i = 0; i < count; ++i) {
+        while ((m_workers[i].m_thread != NULL) && (thread_get(m_workers[i].m_pid) == m_workers[i].m_thread)) {
+            xtimer_usleep(CONFIG_ERPC_POOL_JOIN_POLL_US);
+        }
+    }
+}
+
+erpc_status_t RiotPoolServer::setPriorityClass(uint32_t serviceId, uint32_t methodId, uint8_t lane)
+{
+    if (lane >= CONFIG_ERPC_POOL_LANES) {
+        return kErpcStatus_InvalidArgument;
+    }
+    for (unsigned i = 0; i < m_ruleCount; ++i) {
+        if ((m_rules[i].m_serviceId == serviceId) && (m_rules[i].m_methodId == methodId)) {
+            m_rules[i].m_lane = lane;
+            return kErpcStatus_Success;
+        }
+    }
+    if (m_ruleCount == CONFIG_ERPC_POOL_LANE_RULES) {
+        return kErpcStatus_MemoryError;
+    }
+    m_rules[m_ruleCount].m_serviceId = serviceId;
+    m_rules[m_ruleCount].m_methodId = methodId;
+    m_rules[m_ruleCount].m_lane = lane;
+    ++m_ruleCount;
+    return kErpcStatus_Success;
+}
+
+uint8_t RiotPoolServer::classify(uint32_t serviceId, uint32_t methodId)
+{
+    uint8_t lane = 0;
+    for (unsigned i = 0; i < m_ruleCount; ++i) {
+        const LaneRule &rule = m_rules[i];
+        if (rule.m_serviceId != serviceId) {
+            continue;
+        }
+        if (rule.m_methodId == methodId) {
+            return rule.m_lane;
+        }
+        if (rule.m_methodId == kAnyMethod) {
+            lane = rule.m_lane;
+        }
+    }
+    return lane;
+}
+
+erpc_status_t RiotPoolServer::addTransport(Transport *transport, RiotRxEvents *rxEvents)
+{
+    if ((transport == NULL) || (rxEvents == NULL) || (transport == m_transport)) {
+        return kErpcStatus_InvalidArgument;
+    }
+    for (unsigned i = 1; i < m_connectionCount; ++i) {
+        if (m_connections[i].m_transport == transport) {
+            return kErpcStatus_InvalidArgument;
+        }
+    }
+    if (m_connectionCount == CONFIG_ERPC_POOL_TRANSPORTS) {
+        return kErpcStatus_MemoryError;
+    }
+    if ((transport->getCrc16() == NULL) && (m_transport != NULL)) {
+        transport->setCrc16(m_transport->getCrc16());
+    }
+    initConnection(m_connections[m_connectionCount], transport, rxEvents);
+    ++m_connectionCount;
+    return kErpcStatus_Success;
+}
+
+erpc_status_t RiotPoolServer::run(void)
+{
+    erpc_status_t err = kErpcStatus_Success;
+
+    // The C API registers services through the erpc::Server methods; workers are idle until we queue.
+    rebuildServiceTable();
+
+    // A single transport may block in receive(); several wake us through their events.
+    if (m_connectionCount > 1) {
+        for (unsigned i = 0; i < m_connectionCount; ++i) {
+            if (m_connections[i].m_rxEvents == NULL) {
+                return kErpcStatus_InitFailed;
+            }
+        }
+        m_runThread = thread_get_active();
+        for (unsigned i = 0; i < m_connectionCount; ++i) {
+            m_connections[i].m_rxEvents->setRxHandler(rxEntry, this);
+        }
+    }
+
+    while ((err == kErpcStatus_Success) && m_isServerOn) {
+        err = (m_connectionCount == 1) ? receiveRequest(m_connections[0]) : pollConnections();
+        if (err == kErpcStatus_Success) {
+            mutex_lock(&m_lock);
+            err = m_workerError;
+            m_workerError = kErpcStatus_Success;
+            mutex_unlock(&m_lock);
+        }
+    }
+    m_runThread = NULL;
+    return err;
+}
+
+void RiotPoolServer::rxEntry(void *arg)
+{
+    thread_t *thread = static_cast<RiotPoolServer *>(arg)->m_runThread;
+    if (thread != NULL) {
+        thread_flags_set(thread, CONFIG_ERPC_POOL_RX_FLAG);
+    }
+}
+
+erpc_status_t RiotPoolServer::pollConnections(void)
+{
+    // Input arriving from here on sets the flag again, so none is missed.
+    thread_flags_clear(CONFIG_ERPC_POOL_RX_FLAG);
+
+    bool idle = true;
+    for (unsigned i = 0; i < m_connectionCount; ++i) {
+        Connection &conn = m_connections[i];
+        if (!conn.m_transport->hasMessage()) {
+            continue;
+        }
+        idle = false;
+        erpc_status_t err = receiveRequest(conn);
+        if (err != kErpcStatus_Success) {
+            return err;
+        }
+    }
+    if (idle && m_isServerOn) {
+        (void)thread_flags_wait_any(CONFIG_ERPC_POOL_RX_FLAG);
+    }
+    return kErpcStatus_Success;
+}
+
+void RiotPoolServer::stop(void)
+{
+    mutex_lock(&m_lock);
+    m_isServerOn = false;
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_LANES; ++i) {
+        cond_broadcast(&m_lanes[i].m_work);
+    }
+    cond_broadcast(&m_space);
+    mutex_unlock(&m_lock);
+    rxEntry(this);
+}
+
+int RiotPoolServer::takeFreeSlot(void)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_QUEUE; ++i) {
+        if (m_slots[i].m_state == kSlotFree) {
+            m_slots[i].m_state = kSlotReceiving;
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+RiotPoolServer::Slot *RiotPoolServer::findSlot(Connection &conn, uint8_t lane, uint32_t ticket)
+{
+    for (unsigned i = 0; i < CONFIG_ERPC_POOL_QUEUE; ++i) {
+        Slot &slot = m_slots[i];
+        if ((slot.m_state >= kSlotQueued) && (slot.m_conn == &conn) && (slot.m_lane == lane) &&
+            (slot.m_ticket == ticket)) {
+            return &slot;
+        }
+    }
+    return NULL;
+}
+
+erpc_status_t RiotPoolServer::receiveRequest(Connection &conn)
+{
+    int index = -1;
+    mutex_lock(&m_lock);
+    while (m_isServerOn && ((index = takeFreeSlot()) < 0)) {
+        cond_wait(&m_space, &m_lock);
+    }
+    mutex_unlock(&m_lock);
+    if (index < 0) {
+        return kErpcStatus_ServerIsDown;
+    }
+
+    // Same steps as SimpleServer::runInternalBegin(), but on the connection's transport.
+    Slot &slot = m_slots[index];
+    MessageBuffer buff;
+    Codec *codec = NULL;
+    erpc_status_t err = kErpcStatus_Success;
+
+    if (m_messageFactory->createServerBuffer()) {
+        buff = m_messageFactory->create();
+        if (buff.get() == NULL) {
+            err = kErpcStatus_MemoryError;
+        }
+    }
+    if (err == kErpcStatus_Success) {
+        err = conn.m_transport->receive(&buff);
+    }
+    if (err == kErpcStatus_Success) {
+        codec = m_codecFactory->create();
+        if (codec == NULL) {
+            err = kErpcStatus_MemoryError;
+        }
+    }
+    if ((err != kErpcStatus_Success) && (buff.get() != NULL)) {
+        m_messageFactory->dispose(&buff);
+    }
+    bool expired = false;
+    if (err == kErpcStatus_Success) {
+        codec->setBuffer(buff, conn.m_transport->reserveHeaderSize());
+        err = readHeadOfMessage(codec, slot.m_msgType, slot.m_serviceId, slot.m_methodId, slot.m_sequence);
+    }
+    if (err == kErpcStatus_Success) {
+        uint32_t budgetUs;
+        slot.m_hasDeadline = readDeadline(codec, conn.m_transport, budgetUs);
+        slot.m_deadline = xtimer_now_usec() + budgetUs;
+        expired = slot.m_hasDeadline && (budgetUs == 0U);
+        slot.m_lane = classify(slot.m_serviceId, slot.m_methodId);
+    }
+    if ((codec != NULL) && ((err != kErpcStatus_Success) || expired)) {
+        disposeBufferAndCodec(codec);
+    }
+
+    mutex_lock(&m_lock);
+    if ((err == kErpcStatus_Success) && !expired) {
+        Lane &lane = m_lanes[slot.m_lane];
+        slot.m_codec = codec;
+        slot.m_conn = &conn;
+        slot.m_ticket = conn.m_nextTicket[slot.m_lane]++;
+        slot.m_status = kErpcStatus_Success;
+        slot.m_state = kSlotQueued;
+        lane.m_queue[(lane.m_queueHead + lane.m_queueCount) % CONFIG_ERPC_POOL_QUEUE] = static_cast<uint8_t>(index);
+        ++lane.m_queueCount;
+        cond_signal(&lane.m_work);
+    } else {
+        slot.m_state = kSlotFree;
+    }
+    mutex_unlock(&m_lock);
+    return err;
+}
+
+void *RiotPoolServer::workerEntry(void *arg)
+{
+    Worker *w = static_cast<Worker *>(arg);
+    w->m_server->workerLoop(w->m_server->m_lanes[w->m_lane]);
+    return NULL;
+}
+
+void RiotPoolServer::workerLoop(Lane &lane)
+{
+    mutex_lock(&m_lock);
+    for (;;) {
+        while ((lane.m_queueCount == 0) && m_isServerOn) {
+            cond_wait(&lane.m_work, &m_lock);
+        }
+        if (lane.m_queueCount == 0) {
+            break;
+        }
+        Slot &slot = m_slots[lane.m_queue[lane.m_queueHead]];
+        lane.m_queueHead = static_cast<uint8_t>((lane.m_queueHead + 1) % CONFIG_ERPC_POOL_QUEUE);
+        --lane.m_queueCount;
+        mutex_unlock(&m_lock);
+
+        execute(slot);
+
+        mutex_lock(&m_lock);
+        slot.m_state = kSlotDone;
+        Connection &conn = *slot.m_conn;
+        if (!conn.m_flushing && (conn.m_nextReply[slot.m_lane] == slot.m_ticket)) {
+            flushReplies(conn);
+        }
+    }
+    mutex_unlock(&m_lock);
+}
+
+void RiotPoolServer::execute(Slot &slot)
+{
+    if (slot.m_hasDeadline && (static_cast<int32_t>(xtimer_now_usec() - slot.m_deadline) >= 0)) {
+        slot.m_status = kErpcStatus_DeadlineExceeded;
+        return;
+    }
+
+    // Server::processMessage() with the transport the request came from.
+    slot.m_status = dispatch(slot.m_codec, slot.m_conn->m_transport, slot.m_msgType, slot.m_serviceId,
+                             slot.m_methodId, slot.m_sequence);
+}
+
+void RiotPoolServer::flushReplies(Connection &conn)
+{
+    // Called with m_lock held. Only one worker at a time sends for a
+    // connection; it keeps going while the next reply in order of some lane
+    // is ready, and a worker finishing a later request leaves its reply here
+    // for it. After every send the most urgent lane is looked at first.
+    conn.m_flushing = true;
+    for (;;) {
+        Slot *slot = NULL;
+        for (unsigned lane = CONFIG_ERPC_POOL_LANES; (lane > 0) && (slot == NULL); --lane) {
+            slot = findSlot(conn, static_cast<uint8_t>(lane - 1), conn.m_nextReply[lane - 1]);
+            if ((slot != NULL) && (slot->m_state != kSlotDone)) {
+                slot = NULL;
+            }
+        }
+        if (slot == NULL) {
+            break;
+        }
+
+        mutex_unlock(&m_lock);
+        erpc_status_t err = slot->m_status;
+        if ((err == kErpcStatus_Success) && (slot->m_msgType != message_type_t::kOnewayMessage)) {
+            err = conn.m_transport->send(&slot->m_codec->getBufferRef());
+        }
+        disposeBufferAndCodec(slot->m_codec);
+        mutex_lock(&m_lock);
+
+        if ((err != kErpcStatus_Success) && (err != kErpcStatus_DeadlineExceeded) &&
+            (m_workerError == kErpcStatus_Success)) {
+            m_workerError = err;
+            rxEntry(this); // run() reports it without waiting for input
+        }
+        slot->m_state = kSlotFree;
+        ++conn.m_nextReply[slot->m_lane];
+        cond_signal(&m_space);
+    }
+    conn.m_flushing = false;
+}
@@ -0,0 +1,244 @@
+// erpc_threading_riot.cpp — eRPC Thread, Mutex and Semaphore on RIOT threads, rmutex and sema
+#include "erpc_threading.h"
+
+#if ERPC_THREADS_IS(RIOT)
+
+#include <new>
+
+extern "C" {
+#include "mutex.h"
+#include "thread_flags.h"
+#include "ztimer.h"
+}
+
+#if (CONFIG_ERPC_THREAD_FLAG_START & THREAD_FLAG_PREDEFINED_MASK) != 0
+#error "CONFIG_ERPC_THREAD_FLAG_START must not be one of RIOT's predefined thread flags"
+#endif
+
+using namespace erpc;
+
+// Thread objects of the running threads started by Thread::start(), by PID.
+static Thread *s_threads[MAXTHREADS];
+
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_STATIC
+static char s_stacks[CONFIG_ERPC_THREAD_STATIC_STACKS][CONFIG_ERPC_THREAD_STACKSIZE];
+static bool s_stackUsed[CONFIG_ERPC_THREAD_STATIC_STACKS];
+static mutex_t s_stackLock = MUTEX_INIT;
+#endif
+
+static char *allocStack(uint32_t size)
+{
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    return new (std::nothrow) char[size];
+#else
+    char *stack = NULL;
+    if (size <= CONFIG_ERPC_THREAD_STACKSIZE) {
+        mutex_lock(&s_stackLock);
+        for (unsigned i = 0; i < CONFIG_ERPC_THREAD_STATIC_STACKS; ++i) {
+            if (!s_stackUsed[i]) {
+                s_stackUsed[i] = true;
+                stack = s_stacks[i];
+                break;
+            }
+        }
+        mutex_unlock(&s_stackLock);
+    }
+    return stack;
+#endif
+}
+
+static void freeStack(char *stack)
+{
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    delete[] stack;
+#else
+    mutex_lock(&s_stackLock);
+    for (unsigned i = 0; i < CONFIG_ERPC_THREAD_STATIC_STACKS; ++i) {
+        if (s_stacks[i] == stack) {
+            s_stackUsed[i] = false;
+        }
+    }
+    mutex_unlock(&s_stackLock);
+#endif
+}
+
+Thread::Thread(const char *name)
+: m_name(name)
+, m_entry(0)
+, m_arg(0)
+, m_stackSize(0)
+, m_priority(0)
+, m_stackPtr(0)
+, m_stack(NULL)
+, m_ownsStack(false)
+, m_pid(KERNEL_PID_UNDEF)
+, m_thread(NULL)
+{
+}
+
+Thread::Thread(thread_entry_t entry, uint32_t priority, uint32_t stackSize, const char *name,
+               thread_stack_pointer stackPtr)
+: m_name(name)
+, m_entry(entry)
+, m_arg(0)
+, m_stackSize(stackSize)
+, m_priority(priority)
+, m_stackPtr(stackPtr)
+, m_stack(NULL)
+, m_ownsStack(false)
+, m_pid(KERNEL_PID_UNDEF)
+, m_thread(NULL)
+{
+}
+
+Thread::~Thread(void)
+{
+    if ((m_pid != KERNEL_PID_UNDEF) && (m_pid == thread_getpid())) {
+        return; // still running on m_stack
+    }
+    // The thread runs on m_stack, and its stub uses this object, until RIOT
+    // has removed it from the scheduler.
+    while ((m_thread != NULL) && (thread_get(m_pid) == m_thread)) {
+        ztimer_sleep(ZTIMER_USEC, CONFIG_ERPC_THREAD_JOIN_POLL_US);
+    }
+    if (m_ownsStack) {
+        freeStack(m_stack);
+    }
+}
+
+void Thread::init(thread_entry_t entry, uint32_t priority, uint32_t stackSize, thread_stack_pointer stackPtr)
+{
+    m_entry = entry;
+    m_priority = priority;
+    m_stackSize = stackSize;
+    m_stackPtr = stackPtr;
+}
+
+void Thread::start(void *arg)
+{
+    if (m_pid != KERNEL_PID_UNDEF) {
+        return;
+    }
+    m_arg = arg;
+
+    uint32_t stackSize = (m_stackSize != 0U) ? m_stackSize : CONFIG_ERPC_THREAD_STACKSIZE;
+    if (m_stackPtr != 0) {
+        m_stack = static_cast<char *>(m_stackPtr);
+    } else if (m_stack == NULL) {
+        m_stack = allocStack(stackSize);
+        m_ownsStack = (m_stack != NULL);
+    }
+    if (m_stack == NULL) {
+        return;
+    }
+
+    uint8_t priority = static_cast<uint8_t>((m_priority != 0U) ? m_priority : CONFIG_ERPC_THREAD_PRIORITY);
+    kernel_pid_t pid = thread_create(m_stack, static_cast<int>(stackSize), priority, THREAD_CREATE_STACKTEST,
+                                     threadEntryPointStub, this, (m_name != NULL) ? m_name : "erpc");
+    if (pid < 0) {
+        return;
+    }
+
+    // A more urgent thread has already run up to its wait for the flag: register it before letting it go.
+    m_pid = pid;
+    m_thread = thread_get(pid);
+    s_threads[pid - KERNEL_PID_FIRST] = this;
+    thread_flags_set(thread_get(pid), CONFIG_ERPC_THREAD_FLAG_START);
+}
+
+void *Thread::threadEntryPointStub(void *arg)
+{
+    Thread *thread = static_cast<Thread *>(arg);
+    kernel_pid_t pid = thread_getpid();
+    (void)thread_flags_wait_any(CONFIG_ERPC_THREAD_FLAG_START);
+
+    thread->threadEntryPoint();
+
+    // Not thread->m_pid: an entry point may have deleted its Thread.
+    s_threads[pid - KERNEL_PID_FIRST] = NULL;
+    return NULL;
+}
+
+void Thread::threadEntryPoint(void)
+{
+    if (m_entry != NULL) {
+        m_entry(m_arg);
+    }
+}
+
+void Thread::sleep(uint32_t usecs)
+{
+    ztimer_sleep(ZTIMER_USEC, usecs);
+}
+
+Thread::thread_id_t Thread::getThreadId(void) const
+{
+    return (m_pid != KERNEL_PID_UNDEF) ? static_cast<thread_id_t>(thread_get(m_pid)) : NULL;
+}
+
+Thread::thread_id_t Thread::getCurrentThreadId(void)
+{
+    return static_cast<thread_id_t>(thread_get_active());
+}
+
+Thread *Thread::getCurrentThread(void)
+{
+    return s_threads[thread_getpid() - KERNEL_PID_FIRST];
+}
+
+Mutex::Mutex(void)
+{
+    rmutex_init(&m_mutex);
+}
+
+Mutex::~Mutex(void) {}
+
+bool Mutex::tryLock(void)
+{
+    return rmutex_trylock(&m_mutex) != 0;
+}
+
+bool Mutex::lock(void)
+{
+    rmutex_lock(&m_mutex);
+    return true;
+}
+
+bool Mutex::unlock(void)
+{
+    rmutex_unlock(&m_mutex);
+    return true;
+}
+
+Semaphore::Semaphore(int count)
+{
+    sema_create(&m_sema, static_cast<unsigned>(count));
+}
+
+Semaphore::~Semaphore(void)
+{
+    sema_destroy(&m_sema);
+}
+
+void Semaphore::put(void)
+{
+    (void)sema_post(&m_sema);
+}
+
+bool Semaphore::get(uint32_t timeoutUsecs)
+{
+    if (timeoutUsecs == kWaitForever) {
+        return sema_wait(&m_sema) == 0;
+    }
+    if (timeoutUsecs == 0U) {
+        return sema_try_wait(&m_sema) == 0;
+    }
+    return sema_wait_timed_ztimer(&m_sema, ZTIMER_USEC, timeoutUsecs) == 0;
+}
+
+int Semaphore::getCount(void) const
+{
+    return static_cast<int>(sema_get_value(&m_sema));
+}
+
+#endif /* ERPC_THREADS_IS(RIOT) */
@@ -0,0 +1,260 @@
+/*
+ * eRPC threading classes for ERPC_THREADS_RIOT.
+ *
+ * Found before eRPC's own erpc_threading.h (see Makefile.include): with the
+ * RIOT model it declares the same Mutex, Semaphore and Thread classes, built
+ * on RIOT kernel objects; with any other model it includes eRPC's header.
+ */
+#include "erpc_config_internal.h"
+
+#if !ERPC_THREADS_IS(RIOT)
+#include_next "erpc_threading.h"
+#elif !defined(_EMBEDDED_RPC__THREADING_H_)
+#define _EMBEDDED_RPC__THREADING_H_
+
+#include <stdint.h>
+
+extern "C" {
+#include "rmutex.h"
+#include "sema.h"
+#include "thread.h"
+}
+
+/*!
+ * @brief Stack size, in bytes, of an erpc::Thread created with stack size 0.
+ */
+#ifndef CONFIG_ERPC_THREAD_STACKSIZE
+#define CONFIG_ERPC_THREAD_STACKSIZE (THREAD_STACKSIZE_MAIN + 1024)
+#endif
+
+/*!
+ * @brief RIOT priority of an erpc::Thread created with priority 0.
+ *
+ * Any other priority is used as a RIOT priority: lower numbers are more urgent.
+ */
+#ifndef CONFIG_ERPC_THREAD_PRIORITY
+#define CONFIG_ERPC_THREAD_PRIORITY (THREAD_PRIORITY_MAIN - 1)
+#endif
+
+/*!
+ * @brief Stacks of CONFIG_ERPC_THREAD_STACKSIZE for threads started without a stack (static allocation policy).
+ *
+ * With ERPC_ALLOCATION_POLICY_DYNAMIC such stacks are allocated instead.
+ */
+#ifndef CONFIG_ERPC_THREAD_STATIC_STACKS
+#define CONFIG_ERPC_THREAD_STATIC_STACKS 2
+#endif
+
+/*!
+ * @brief Thread flag a started erpc::Thread waits for before running its entry point.
+ *
+ * Must not be one of RIOT's predefined flags; the thread's code may use the
+ * other flags freely.
+ */
+#ifndef CONFIG_ERPC_THREAD_FLAG_START
+#define CONFIG_ERPC_THREAD_FLAG_START (1U << 13)
+#endif
+
+/*!
+ * @brief Interval, in microseconds, at which the destructor of a running erpc::Thread checks whether it ended.
+ *
+ * RIOT has no join; the destructor sleeps until the thread is gone.
+ */
+#ifndef CONFIG_ERPC_THREAD_JOIN_POLL_US
+#define CONFIG_ERPC_THREAD_JOIN_POLL_US 1000
+#endif
+
+namespace erpc {
+
+/*!
+ * @brief Stack a thread runs on, see Thread::Thread().
+ */
+typedef void *thread_stack_pointer;
+
+/*!
+ * @brief Thread on a RIOT thread.
+ *
+ * Either pass an entry function or derive and override threadEntryPoint().
+ * The RIOT thread ends when the entry point returns; the destructor waits
+ * for that.
+ */
+class Thread
+{
+public:
+    /*!
+     * @brief Thread function type.
+     */
+    typedef void (*thread_entry_t)(void *arg);
+
+    /*!
+     * @brief Thread ID type: the RIOT thread_t of the thread.
+     */
+    typedef void *thread_id_t;
+
+    /*!
+     * @brief Thread to be set up with init().
+     */
+    Thread(const char *name = 0);
+
+    /*!
+     * @brief Thread running @p entry once started.
+     *
+     * @param[in] entry Entry function, called with the argument of start().
+     * @param[in] priority RIOT priority, 0 for CONFIG_ERPC_THREAD_PRIORITY.
+     * @param[in] stackSize Stack size in bytes, 0 for CONFIG_ERPC_THREAD_STACKSIZE.
+     * @param[in] name Thread name.
+     * @param[in] stackPtr Stack of @p stackSize bytes, or 0 to allocate one when started.
+     */
+    Thread(thread_entry_t entry, uint32_t priority = 0, uint32_t stackSize = 0, const char *name = 0,
+           thread_stack_pointer stackPtr = 0);
+
+    /*!
+     * @brief Wait until the started thread has ended, then give back the stack start() took.
+     *
+     * Called on the thread itself, it cannot wait: that stack is then left taken.
+     */
+    virtual ~Thread(void);
+
+    void setName(const char *name) { m_name = name; }
+
+    const char *getName(void) const { return m_name; }
+
+    /*!
+     * @brief Set the entry point, priority and stack, as the constructor does.
+     */
+    void init(thread_entry_t entry, uint32_t priority = 0, uint32_t stackSize = 0, thread_stack_pointer stackPtr = 0);
+
+    /*!
+     * @brief Create the RIOT thread and run the entry point on it with @p arg.
+     *
+     * Nothing starts if no stack can be allocated or RIOT has no thread slot
+     * left; getThreadId() then stays 0.
+     */
+    void start(void *arg = 0);
+
+    /*!
+     * @brief Put the calling thread to sleep for @p usecs microseconds.
+     */
+    static void sleep(uint32_t usecs);
+
+    /*!
+     * @brief ID of this thread, 0 until started.
+     */
+    thread_id_t getThreadId(void) const;
+
+    /*!
+     * @brief ID of the calling thread; any RIOT thread has one.
+     */
+    static thread_id_t getCurrentThreadId(void);
+
+    /*!
+     * @brief Thread object of the calling thread, or NULL if it was not started by a Thread.
+     */
+    static Thread *getCurrentThread(void);
+
+    bool operator==(Thread &o) { return getThreadId() == o.getThreadId(); }
+
+protected:
+    /*!
+     * @brief Runs on the new thread; calls the entry function.
+     */
+    virtual void threadEntryPoint(void);
+
+private:
+    const char *m_name;
+    thread_entry_t m_entry;
+    void *m_arg;
+    uint32_t m_stackSize;
+    uint32_t m_priority;
+    thread_stack_pointer m_stackPtr;
+    char *m_stack;  /*!< Stack the thread runs on. */
+    bool m_ownsStack; /*!< m_stack was taken by start() and is given back by the destructor. */
+    kernel_pid_t m_pid;
+    thread_t *m_thread; /*!< RIOT thread of m_pid; it lies on m_stack, so no later thread gets its address. */
+
+    static void *threadEntryPointStub(void *arg);
+
+    Thread(const Thread &o);
+    Thread &operator=(const Thread &o);
+};
+
+/*!
+ * @brief Recursive mutex on a RIOT rmutex_t.
+ *
+ * Recursive like the mutexes of eRPC's other ports; the owning thread may
+ * lock it again.
+ */
+class Mutex
+{
+public:
+    /*!
+     * @brief Locks a mutex for the lifetime of the guard.
+     */
+    class Guard
+    {
+    public:
+        Guard(Mutex &mutex)
+        : m_mutex(mutex)
+        {
+            (void)m_mutex.lock();
+        }
+
+        ~Guard(void) { (void)m_mutex.unlock(); }
+
+    private:
+        Mutex &m_mutex;
+    };
+
+    Mutex(void);
+
+    ~Mutex(void);
+
+    bool tryLock(void);
+
+    bool lock(void);
+
+    bool unlock(void);
+
+private:
+    rmutex_t m_mutex;
+
+    Mutex(const Mutex &o);
+    Mutex &operator=(const Mutex &o);
+};
+
+/*!
+ * @brief Counting semaphore on a RIOT sema_t.
+ *
+ * put() may be called from interrupt context.
+ */
+class Semaphore
+{
+public:
+    static const uint32_t kWaitForever = 0xffffffffU;
+
+    Semaphore(int count = 0);
+
+    ~Semaphore(void);
+
+    void put(void);
+
+    /*!
+     * @brief Take the semaphore, waiting up to @p timeoutUsecs microseconds for it.
+     *
+     * @retval true Taken.
+     * @retval false Timed out; or not available, with a timeout of 0.
+     */
+    bool get(uint32_t timeoutUsecs = kWaitForever);
+
+    int getCount(void) const;
+
+private:
+    sema_t m_sema;
+
+    Semaphore(const Semaphore &o);
+    Semaphore &operator=(const Semaphore &o);
+};
+
+} // namespace erpc
+
+#endif /* ERPC_THREADS_IS(RIOT) */